@@ -92,6 +92,12 @@ AS_IF([test "x$bistro_hooks_happy" = "xyes"],
 
 AC_CHECK_FUNCS([__curbrk], [], [], [])
 
+#
+# userfaultfd memory events
+#
+AC_CHECK_HEADERS([linux/userfaultfd.h])
+AC_CHECK_DECLS([SYS_userfaultfd], [], [], [#include <sys/syscall.h>])
+
 #
 # tcmalloc library - for testing only
 #
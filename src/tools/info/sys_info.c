@@ -58,7 +58,14 @@ static const char* cpu_vendor_names[] = {
     [UCS_CPU_VENDOR_NVIDIA]           = "Nvidia"
 };
 
-static double measure_memcpy_bandwidth(size_t size)
+typedef void* (*memcpy_func_t)(void *dst, const void *src, size_t size);
+
+static void *memcpy_relaxed(void *dst, const void *src, size_t size)
+{
+    return ucs_memcpy_relaxed(dst, src, size);
+}
+
+static double measure_memcpy_bandwidth(memcpy_func_t memcpy_func, size_t size)
 {
     ucs_time_t start_time, end_time;
     void *src, *dst;
@@ -82,10 +89,10 @@ static double measure_memcpy_bandwidth(size_t size)
     iter = 0;
     start_time = ucs_get_time();
     do {
-        ucs_memcpy_relaxed(dst, src, size);
+        memcpy_func(dst, src, size);
         end_time = ucs_get_time();
         ++iter;
-    } while (end_time < start_time + ucs_time_from_sec(0.5));
+    } while (end_time < start_time + ucs_time_from_sec(0.25));
 
     result = size * iter / ucs_time_to_sec(end_time - start_time);
 
@@ -261,8 +268,10 @@ void print_sys_info(int print_opts)
         ucs_arch_print_memcpy_limits(&ucs_global_opts.arch);
         printf("# Memcpy bandwidth:\n");
         for (size = 4096; size <= 256 * UCS_MBYTE; size *= 2) {
-            printf("#     %10zu bytes: %.3f MB/s\n", size,
-                   measure_memcpy_bandwidth(size) / UCS_MBYTE);
+            printf("#     %10zu bytes: %.3f MB/s (libc memcpy: %.3f MB/s)\n",
+                   size,
+                   measure_memcpy_bandwidth(memcpy_relaxed, size) / UCS_MBYTE,
+                   measure_memcpy_bandwidth(memcpy, size) / UCS_MBYTE);
         }
     }
 }
@@ -125,6 +125,8 @@ void print_type_info(const char * tl_name)
         PRINT_SIZE(ucs_timer_queue_t);
         PRINT_SIZE(ucs_twheel_t);
         PRINT_SIZE(ucs_wtimer_t);
+        PRINT_SIZE(ucs_hwheel_t);
+        PRINT_SIZE(ucs_hwtimer_t);
         PRINT_SIZE(ucs_arbiter_t);
         PRINT_SIZE(ucs_arbiter_group_t);
         PRINT_SIZE(ucs_arbiter_elem_t);
@@ -18,6 +18,8 @@
 
 
 #define MAX_BATCH_FILES         32
+#define MAX_CALIB_ENTRIES       16
+#define MAX_CALIB_SAMPLES       32
 #define MAX_CPUS                1024
 #define TL_RESOURCE_NAME_NONE   "<none>"
 #define TEST_PARAMS_ARGS        "t:n:s:W:O:w:D:i:H:oSCIqM:r:E:T:d:x:A:BUem:R:lyzg:G:"
@@ -55,6 +57,16 @@ typedef struct test_type {
     unsigned                     window_size;
 } test_type_t;
 
+/* Measured performance of a transport operation, for the calibration file */
+typedef struct perftest_calib_entry {
+    char                         name[UCT_TL_NAME_MAX + UCT_DEVICE_NAME_MAX +
+                                      16]; /* "<tl>/<dev> <op>" */
+    unsigned                     num_samples;
+    size_t                       sizes[MAX_CALIB_SAMPLES]; /* Message sizes */
+    double                       times[MAX_CALIB_SAMPLES]; /* Latencies */
+    double                       bandwidth; /* Best streaming bandwidth */
+} perftest_calib_entry_t;
+
 typedef struct perftest_params {
     ucx_perf_params_t            super;
     int                          test_id;
@@ -75,6 +87,10 @@ struct perftest_context {
     char                         *test_names[MAX_BATCH_FILES];
     const char                   *mad_port;
 
+    const char                   *calib_file;
+    unsigned                     num_calib_entries;
+    perftest_calib_entry_t       calib_entries[MAX_CALIB_ENTRIES];
+
     sock_rte_group_t             sock_rte_group;
 };
 
@@ -97,6 +97,10 @@ static void usage(const struct perftest_context *ctx, const char *program)
     printf("     -P <0|1>       disable/enable MPI mode (%d)\n", ctx->mpi);
 #endif
     printf("     -K <ca:port>   use MAD for test setup and synchronization\n");
+    printf("     -L <file>      append the measured performance of UCT tests to a\n");
+    printf("                    protocol calibration file (UCX_PROTO_PERF_CALIB_FILE);\n");
+    printf("                    latency tests of several sizes in a batch file (-b) are\n");
+    printf("                    written as samples to fit latency and bandwidth\n");
     printf("     -h             show this help message\n");
     printf("\n");
     printf("  Output format:\n");
@@ -616,16 +620,18 @@ ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized,
         return status;
     }
 
-    ctx->server_addr     = NULL;
-    ctx->num_batch_files = 0;
-    ctx->port            = 13337;
-    ctx->af              = AF_INET;
-    ctx->flags           = 0;
-    ctx->mpi             = mpi_initialized;
-    ctx->mad_port        = NULL;
+    ctx->server_addr       = NULL;
+    ctx->num_batch_files   = 0;
+    ctx->port              = 13337;
+    ctx->af                = AF_INET;
+    ctx->flags             = 0;
+    ctx->mpi               = mpi_initialized;
+    ctx->mad_port          = NULL;
+    ctx->calib_file        = NULL;
+    ctx->num_calib_entries = 0;
 
     optind = 1;
-    while ((c = getopt_long(argc, argv, "p:b:6NfvIc:P:hK:" TEST_PARAMS_ARGS,
+    while ((c = getopt_long(argc, argv, "p:b:6NfvIc:P:hK:L:" TEST_PARAMS_ARGS,
                             TEST_PARAMS_ARGS_LONG, NULL)) != -1) {
         switch (c) {
         case 'p':
@@ -664,6 +670,9 @@ ucs_status_t parse_opts(struct perftest_context *ctx, int mpi_initialized,
         case 'K':
             ctx->mad_port = optarg;
             break;
+        case 'L':
+            ctx->calib_file = optarg;
+            break;
         case 'P':
 #ifdef HAVE_MPI
             ctx->mpi = atoi(optarg) && mpi_initialized;
@@ -260,6 +260,136 @@ static ucs_status_t read_batch_file(FILE *batch_file, const char *file_name,
     return UCS_OK;
 }
 
+static const char *calib_op_name(const ucx_perf_params_t *params)
+{
+    static const char *layout_names[] = {
+        [UCT_PERF_DATA_LAYOUT_SHORT]     = "short",
+        [UCT_PERF_DATA_LAYOUT_SHORT_IOV] = "short",
+        [UCT_PERF_DATA_LAYOUT_BCOPY]     = "bcopy",
+        [UCT_PERF_DATA_LAYOUT_ZCOPY]     = "zcopy"
+    };
+    static char op_name[32];
+    const char *cmd_name;
+
+    switch (params->command) {
+    case UCX_PERF_CMD_ADD:
+        return "atomic_post";
+    case UCX_PERF_CMD_FADD:
+    case UCX_PERF_CMD_SWAP:
+    case UCX_PERF_CMD_CSWAP:
+        return "atomic_fetch";
+    case UCX_PERF_CMD_AM:
+        cmd_name = "am";
+        break;
+    case UCX_PERF_CMD_PUT:
+        cmd_name = "put";
+        break;
+    case UCX_PERF_CMD_GET:
+        cmd_name = "get";
+        break;
+    default:
+        return NULL;
+    }
+
+    ucs_snprintf_safe(op_name, sizeof(op_name), "%s_%s", cmd_name,
+                      layout_names[params->uct.data_layout]);
+    return op_name;
+}
+
+/* Record the result of a UCT test: latency of ping-pong tests as a sample of
+ * operation time by message size, and bandwidth of streaming tests */
+static void calib_add_result(struct perftest_context *ctx,
+                             const ucx_perf_params_t *params,
+                             const ucx_perf_result_t *result)
+{
+    perftest_calib_entry_t *entry;
+    char name[sizeof(entry->name)];
+    const char *op_name;
+
+    if ((ctx->calib_file == NULL) || !(ctx->flags & TEST_FLAG_PRINT_RESULTS) ||
+        (params->api != UCX_PERF_API_UCT) ||
+        (params->test_type == UCX_PERF_TEST_TYPE_STREAM_BI)) {
+        return;
+    }
+
+    op_name = calib_op_name(params);
+    if (op_name == NULL) {
+        return;
+    }
+
+    ucs_snprintf_safe(name, sizeof(name), UCT_PERF_TEST_PARAMS_FMT " %s",
+                      UCT_PERF_TEST_PARAMS_ARG(params), op_name);
+    for (entry = ctx->calib_entries;
+         entry < ctx->calib_entries + ctx->num_calib_entries; ++entry) {
+        if (!strcmp(entry->name, name)) {
+            break;
+        }
+    }
+
+    if (entry == ctx->calib_entries + ctx->num_calib_entries) {
+        if (ctx->num_calib_entries == MAX_CALIB_ENTRIES) {
+            ucs_warn("too many calibrated operations, ignoring %s", name);
+            return;
+        }
+
+        ++ctx->num_calib_entries;
+        ucs_strncpy_safe(entry->name, name, sizeof(entry->name));
+        entry->num_samples = 0;
+        entry->bandwidth   = 0;
+    }
+
+    if (params->test_type == UCX_PERF_TEST_TYPE_STREAM_UNI) {
+        entry->bandwidth = ucs_max(entry->bandwidth,
+                                   result->bandwidth.total_average);
+    } else if (entry->num_samples < MAX_CALIB_SAMPLES) {
+        entry->sizes[entry->num_samples] = ucx_perf_get_message_size(params);
+        entry->times[entry->num_samples] = result->latency.total_average;
+        ++entry->num_samples;
+    }
+}
+
+static ucs_status_t calib_write(struct perftest_context *ctx)
+{
+    const perftest_calib_entry_t *entry;
+    FILE *stream;
+    unsigned i;
+
+    if ((ctx->calib_file == NULL) || (ctx->num_calib_entries == 0)) {
+        return UCS_OK;
+    }
+
+    stream = fopen(ctx->calib_file, "a");
+    if (stream == NULL) {
+        ucs_error("failed to open calibration file '%s': %m",
+                  ctx->calib_file);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    fprintf(stream, "# measured by ucx_perftest\n");
+    for (entry = ctx->calib_entries;
+         entry < ctx->calib_entries + ctx->num_calib_entries; ++entry) {
+        fprintf(stream, "%s", entry->name);
+        if (entry->bandwidth > 0) {
+            fprintf(stream, " bw=%.2fMBs",
+                    entry->bandwidth / (1024.0 * 1024.0));
+        }
+
+        /* A single sample is the latency, several ones are fitted by size */
+        if (entry->num_samples == 1) {
+            fprintf(stream, " lat=%.3fus", entry->times[0] * 1e6);
+        } else {
+            for (i = 0; i < entry->num_samples; ++i) {
+                fprintf(stream, " sample=%zu:%.3fus", entry->sizes[i],
+                        entry->times[i] * 1e6);
+            }
+        }
+        fprintf(stream, "\n");
+    }
+
+    fclose(stream);
+    return UCS_OK;
+}
+
 static ucs_status_t run_test_recurs(struct perftest_context *ctx,
                                     const perftest_params_t *parent_params,
                                     unsigned depth)
@@ -279,7 +409,12 @@ static ucs_status_t run_test_recurs(struct perftest_context *ctx,
             return status;
         }
 
-        return ucx_perf_run(&parent_params->super, &result);
+        status = ucx_perf_run(&parent_params->super, &result);
+        if (status == UCS_OK) {
+            calib_add_result(ctx, &parent_params->super, &result);
+        }
+
+        return status;
     }
 
     batch_file = fopen(ctx->batch_files[depth], "r");
@@ -341,7 +476,8 @@ ucs_status_t run_test(struct perftest_context *ctx)
     status = run_test_recurs(ctx, &ctx->params, 0);
     if (status != UCS_OK) {
         ucs_error("Failed to run test: %s", ucs_status_string(status));
+        return status;
     }
 
-    return status;
+    return calib_write(ctx);
 }
@@ -66,6 +66,7 @@ typedef enum ucm_mmap_hook_mode {
     UCM_MMAP_HOOK_NONE,
     UCM_MMAP_HOOK_RELOC,
     UCM_MMAP_HOOK_BISTRO,
+    UCM_MMAP_HOOK_UFFD,
     UCM_MMAP_HOOK_LAST
 } ucm_mmap_hook_mode_t;
 
@@ -372,6 +373,47 @@ ucs_status_t ucm_test_events(int events);
 ucs_status_t ucm_test_external_events(int events);
 
 
+/**
+ * @brief Request memory unmap events for a memory range.
+ *
+ * When the mmap hook mode is "uffd", memory unmap events are detected with
+ * userfaultfd(2) instead of patching the memory mapping functions, and the
+ * kernel reports only unmaps of memory ranges which were registered with the
+ * userfaultfd object. This routine registers all the memory mappings which
+ * contain the given range, so that @ref UCM_EVENT_VM_UNMAPPED is reported when
+ * any part of them is released by munmap(), mremap(), madvise() or brk().
+ * Such events are dispatched asynchronously, from a helper thread, after the
+ * memory is already released; see @ref ucm_mem_sync.
+ *
+ * In other hook modes unmap events are reported for all memory ranges, and
+ * this routine does nothing.
+ *
+ * @param [in]  address   Start of the memory range.
+ * @param [in]  length    Length of the memory range.
+ *
+ * @return UCS_OK if @ref UCM_EVENT_VM_UNMAPPED will be reported for the range,
+ *         or an error code if the range cannot be watched (for example, if it
+ *         is a file mapping which does not support userfaultfd).
+ */
+ucs_status_t ucm_mem_watch(void *address, size_t length);
+
+
+/**
+ * @brief Dispatch the pending memory unmap events.
+ *
+ * When the mmap hook mode is "uffd", the thread which released a watched
+ * memory range may resume before @ref UCM_EVENT_VM_UNMAPPED is dispatched
+ * for it, and map new memory at the same address. This routine dispatches all
+ * the unmap events which are pending, and waits for the helper thread to
+ * complete dispatching the events it has already received, so the handlers
+ * are called for any memory release which completed before it.
+ *
+ * In other hook modes the events are dispatched synchronously, and this
+ * routine does nothing.
+ */
+void ucm_mem_sync();
+
+
 /**
  * @brief Call the original implementation of @ref mmap without triggering events.
  */
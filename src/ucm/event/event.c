@@ -537,15 +537,19 @@ static ucs_status_t ucm_event_install(int events)
 
     ucm_debug("mmap hooks are ready");
 
-    malloc_events = events & ~(UCM_EVENT_MEM_TYPE_ALLOC |
-                               UCM_EVENT_MEM_TYPE_FREE);
-    status = ucm_malloc_install(malloc_events);
-    if (status != UCS_OK) {
-        ucm_debug("failed to install malloc events");
-        goto out_unlock;
-    }
+    /* userfaultfd reports memory released by the allocator as well, so
+     * malloc hooks are not needed */
+    if (ucm_mmap_hook_mode() != UCM_MMAP_HOOK_UFFD) {
+        malloc_events = events & ~(UCM_EVENT_MEM_TYPE_ALLOC |
+                                   UCM_EVENT_MEM_TYPE_FREE);
+        status = ucm_malloc_install(malloc_events);
+        if (status != UCS_OK) {
+            ucm_debug("failed to install malloc events");
+            goto out_unlock;
+        }
 
-    ucm_debug("malloc hooks are ready");
+        ucm_debug("malloc hooks are ready");
+    }
 
     /* Call extra event installers */
     UCS_MODULE_FRAMEWORK_LOAD(ucm, UCS_MODULE_LOAD_FLAG_NODELETE);
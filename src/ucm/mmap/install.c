@@ -100,6 +100,9 @@ const char *ucm_mmap_hook_modes[] = {
     [UCM_MMAP_HOOK_RELOC]  = UCM_MMAP_HOOK_RELOC_STR,
 #if UCM_BISTRO_HOOKS
     [UCM_MMAP_HOOK_BISTRO] = UCM_MMAP_HOOK_BISTRO_STR,
+#endif
+#if UCM_UFFD_HOOKS
+    [UCM_MMAP_HOOK_UFFD]   = UCM_MMAP_HOOK_UFFD_STR,
 #endif
     [UCM_MMAP_HOOK_LAST]   = NULL
 };
@@ -415,6 +418,12 @@ ucs_status_t ucm_mmap_install(int events, int exclusive)
     ucs_status_t status;
     int native_events;
 
+    if (ucm_mmap_hook_mode() == UCM_MMAP_HOOK_UFFD) {
+        /* Memory type events are installed separately */
+        return ucm_uffd_install(events & ~(UCM_EVENT_MEM_TYPE_ALLOC |
+                                           UCM_EVENT_MEM_TYPE_FREE));
+    }
+
     pthread_mutex_lock(&ucm_mmap_install_mutex);
 
     /* Replace aggregate events with the native events which make them */
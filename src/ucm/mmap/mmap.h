@@ -13,6 +13,13 @@
 
 #define UCM_MMAP_HOOK_RELOC_STR  "reloc"
 #define UCM_MMAP_HOOK_BISTRO_STR "bistro"
+#define UCM_MMAP_HOOK_UFFD_STR   "uffd"
+
+#if defined(HAVE_LINUX_USERFAULTFD_H) && HAVE_DECL_SYS_USERFAULTFD
+#  define UCM_UFFD_HOOKS 1
+#else
+#  define UCM_UFFD_HOOKS 0
+#endif
 
 #if UCM_BISTRO_HOOKS
 #  define UCM_DEFAULT_HOOK_MODE UCM_MMAP_HOOK_BISTRO
@@ -23,6 +30,7 @@
 #endif
 
 ucs_status_t ucm_mmap_install(int events, int exclusive);
+ucs_status_t ucm_uffd_install(int events);
 
 void *ucm_override_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset);
 int ucm_override_munmap(void *addr, size_t length);
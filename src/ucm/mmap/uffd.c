@@ -0,0 +1,327 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2024. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "mmap.h"
+
+#include <ucm/api/ucm.h>
+#include <ucm/event/event.h>
+#include <ucm/util/log.h>
+#include <ucm/util/sys.h>
+#include <ucs/sys/math.h>
+
+#if UCM_UFFD_HOOKS
+#include <linux/userfaultfd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <sys/poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+
+
+/* Events which are reported to the monitor thread */
+#define UCM_UFFD_FEATURES (UFFD_FEATURE_EVENT_UNMAP | \
+                           UFFD_FEATURE_EVENT_REMOVE | \
+                           UFFD_FEATURE_EVENT_REMAP)
+
+/* Maximal number of messages to read from the userfaultfd object at once */
+#define UCM_UFFD_MAX_MSGS 16
+
+
+static pthread_mutex_t ucm_uffd_install_mutex  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t ucm_uffd_dispatch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static volatile int ucm_uffd_fd                 = -1;
+static pthread_t ucm_uffd_thread;
+
+
+/* Parameters for watching all the memory mappings which overlap a range */
+typedef struct {
+    uintptr_t    start;
+    uintptr_t    end;
+    ucs_status_t status;
+} ucm_uffd_watch_ctx_t;
+
+
+static void ucm_uffd_pagefault(const struct uffd_msg *msg)
+{
+#ifdef UFFDIO_WRITEPROTECT
+    struct uffdio_writeprotect wp;
+
+    /* Memory ranges are never write-protected, but in case a fault is
+     * reported, do not leave the faulting thread blocked */
+    wp.range.start = ucs_align_down_pow2(msg->arg.pagefault.address,
+                                         ucm_get_page_size());
+    wp.range.len   = ucm_get_page_size();
+    wp.mode        = 0;
+    if (ioctl(ucm_uffd_fd, UFFDIO_WRITEPROTECT, &wp) < 0) {
+        ucm_warn("failed to resolve userfaultfd fault at 0x%llx: %m",
+                 msg->arg.pagefault.address);
+    }
+#else
+    ucm_warn("unexpected userfaultfd fault at 0x%llx",
+             msg->arg.pagefault.address);
+#endif
+}
+
+static void ucm_uffd_dispatch(const struct uffd_msg *msg)
+{
+    switch (msg->event) {
+    case UFFD_EVENT_UNMAP:
+    case UFFD_EVENT_REMOVE:
+        ucm_dispatch_vm_munmap((void*)(uintptr_t)msg->arg.remove.start,
+                               msg->arg.remove.end - msg->arg.remove.start);
+        break;
+    case UFFD_EVENT_REMAP:
+        /* The old range is not mapped anymore */
+        ucm_dispatch_vm_munmap((void*)(uintptr_t)msg->arg.remap.from,
+                               msg->arg.remap.len);
+        break;
+    case UFFD_EVENT_PAGEFAULT:
+        ucm_uffd_pagefault(msg);
+        break;
+    default:
+        ucm_debug("ignoring userfaultfd event %d", msg->event);
+        break;
+    }
+}
+
+/*
+ * The kernel resumes the thread which released the memory as soon as its
+ * event is read, before it is dispatched. So the events are read and dispatched
+ * under one lock: once ucm_mem_sync() acquires it, all the events which were
+ * already read - including those of any munmap() which has returned - are
+ * dispatched as well.
+ */
+static int ucm_uffd_read_dispatch()
+{
+    struct uffd_msg msgs[UCM_UFFD_MAX_MSGS];
+    unsigned i, count;
+    ssize_t nread;
+
+    pthread_mutex_lock(&ucm_uffd_dispatch_mutex);
+    for (;;) {
+        nread = read(ucm_uffd_fd, msgs, sizeof(msgs));
+        if (nread < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        count = nread / sizeof(msgs[0]);
+        ucm_event_enter();
+        for (i = 0; i < count; ++i) {
+            ucm_uffd_dispatch(&msgs[i]);
+        }
+        ucm_event_leave();
+    }
+    pthread_mutex_unlock(&ucm_uffd_dispatch_mutex);
+
+    return (errno == EAGAIN) ? 0 : -1;
+}
+
+static void *ucm_uffd_thread_func(void *arg)
+{
+    struct pollfd pfd;
+
+    pfd.fd     = ucm_uffd_fd;
+    pfd.events = POLLIN;
+    for (;;) {
+        if ((poll(&pfd, 1, -1) < 0) && (errno != EINTR)) {
+            ucm_warn("failed to poll userfaultfd events: %m");
+            break;
+        }
+
+        if (ucm_uffd_read_dispatch() < 0) {
+            ucm_warn("failed to read userfaultfd events: %m");
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static int ucm_uffd_open()
+{
+    int fd;
+
+#ifdef UFFD_USER_MODE_ONLY
+    /* Unprivileged processes may create only user-mode userfaultfd objects,
+     * which are enough since faults are not handled */
+    fd = syscall(SYS_userfaultfd,
+                 O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY);
+    if (fd >= 0) {
+        return fd;
+    }
+#endif
+
+    return syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+}
+
+/* Called with lock held */
+static ucs_status_t ucm_uffd_init()
+{
+    sigset_t sigmask, orig_sigmask;
+    struct uffdio_api api;
+    int fd, ret;
+
+    fd = ucm_uffd_open();
+    if (fd < 0) {
+        ucm_debug("userfaultfd() failed: %m");
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    api.api      = UFFD_API;
+    api.features = UCM_UFFD_FEATURES;
+    api.ioctls   = 0;
+    if (ioctl(fd, UFFDIO_API, &api) < 0) {
+        ucm_debug("userfaultfd does not support features 0x%x: %m",
+                  UCM_UFFD_FEATURES);
+        goto err_close;
+    }
+
+    ucm_uffd_fd = fd;
+
+    /* Do not deliver application signals to the monitor thread */
+    sigfillset(&sigmask);
+    pthread_sigmask(SIG_SETMASK, &sigmask, &orig_sigmask);
+    ret = pthread_create(&ucm_uffd_thread, NULL, ucm_uffd_thread_func, NULL);
+    pthread_sigmask(SIG_SETMASK, &orig_sigmask, NULL);
+    if (ret != 0) {
+        ucm_warn("failed to create userfaultfd monitor thread: %s",
+                 strerror(ret));
+        ucm_uffd_fd = -1;
+        goto err_close;
+    }
+
+    pthread_detach(ucm_uffd_thread);
+    ucm_debug("userfaultfd %d is monitored by thread 0x%lx", fd,
+              (unsigned long)ucm_uffd_thread);
+    return UCS_OK;
+
+err_close:
+    close(fd);
+    return UCS_ERR_UNSUPPORTED;
+}
+
+ucs_status_t ucm_uffd_install(int events)
+{
+    ucs_status_t status;
+
+    if (events == 0) {
+        return UCS_OK;
+    }
+
+    if (events & ~UCM_EVENT_VM_UNMAPPED) {
+        ucm_debug("events 0x%x are not supported in %s hook mode",
+                  events & ~UCM_EVENT_VM_UNMAPPED, UCM_MMAP_HOOK_UFFD_STR);
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    pthread_mutex_lock(&ucm_uffd_install_mutex);
+    status = (ucm_uffd_fd < 0) ? ucm_uffd_init() : UCS_OK;
+    pthread_mutex_unlock(&ucm_uffd_install_mutex);
+
+    return status;
+}
+
+static int ucm_uffd_watch_cb(void *arg, void *addr, size_t length, int prot,
+                             const char *path)
+{
+    ucm_uffd_watch_ctx_t *ctx = arg;
+    struct uffdio_register reg;
+
+    if (((uintptr_t)addr >= ctx->end) ||
+        (((uintptr_t)addr + length) <= ctx->start)) {
+        return 0;
+    }
+
+    if ((uintptr_t)addr > ctx->start) {
+        /* The range is not fully mapped */
+        return 1;
+    }
+
+    /* Register the whole mapping, since registering a part of it would split
+     * it in two. Registering in write-protect mode does not protect any page,
+     * so the mapping is not affected except for reporting the unmap events. */
+    reg.range.start = (uintptr_t)addr;
+    reg.range.len   = length;
+    reg.mode        = UFFDIO_REGISTER_MODE_WP;
+    if (ioctl(ucm_uffd_fd, UFFDIO_REGISTER, &reg) < 0) {
+        ucm_debug("failed to watch mapping %p..%p [%s]: %m", addr,
+                  UCS_PTR_BYTE_OFFSET(addr, length), path);
+        ctx->status = UCS_ERR_UNSUPPORTED;
+        return 1;
+    }
+
+    ctx->start = (uintptr_t)addr + length;
+    return ctx->start >= ctx->end;
+}
+
+ucs_status_t ucm_mem_watch(void *address, size_t length)
+{
+    size_t page_size = ucm_get_page_size();
+    ucm_uffd_watch_ctx_t ctx;
+
+    if (ucm_mmap_hook_mode() != UCM_MMAP_HOOK_UFFD) {
+        return UCS_OK;
+    }
+
+    if (ucm_uffd_fd < 0) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    ctx.start  = ucs_align_down_pow2((uintptr_t)address, page_size);
+    ctx.end    = ucs_align_up_pow2((uintptr_t)address + length, page_size);
+    ctx.status = UCS_OK;
+    ucm_parse_proc_self_maps(ucm_uffd_watch_cb, &ctx);
+
+    if ((ctx.status == UCS_OK) && (ctx.start < ctx.end)) {
+        ucm_debug("address range %p..%p is not fully mapped", address,
+                  UCS_PTR_BYTE_OFFSET(address, length));
+        return UCS_ERR_INVALID_ADDR;
+    }
+
+    return ctx.status;
+}
+
+void ucm_mem_sync()
+{
+    if ((ucm_mmap_hook_mode() != UCM_MMAP_HOOK_UFFD) || (ucm_uffd_fd < 0)) {
+        return;
+    }
+
+    if (ucm_uffd_read_dispatch() < 0) {
+        ucm_debug("failed to read userfaultfd events: %m");
+    }
+}
+
+#else
+
+ucs_status_t ucm_uffd_install(int events)
+{
+    ucm_debug("%s hook mode is not supported", UCM_MMAP_HOOK_UFFD_STR);
+    return UCS_ERR_UNSUPPORTED;
+}
+
+ucs_status_t ucm_mem_watch(void *address, size_t length)
+{
+    return (ucm_mmap_hook_mode() == UCM_MMAP_HOOK_UFFD) ?
+           UCS_ERR_UNSUPPORTED : UCS_OK;
+}
+
+void ucm_mem_sync()
+{
+}
+
+#endif
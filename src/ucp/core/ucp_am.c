@@ -949,6 +949,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_am_send_nbx,
     UCP_REQUEST_CHECK_PARAM(param);
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+    ucp_ep_usage_touch(ep);
 
     status = ucp_am_send_nbx_check_header_length(worker, header_length);
     if (status != UCS_OK) {
@@ -406,6 +406,41 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "(inf - check all endpoints on every round, must be greater than 0)",
    ucs_offsetof(ucp_context_config_t, keepalive_num_eps), UCS_CONFIG_TYPE_UINT},
 
+  {"EP_IDLE_TIMEOUT", "inf",
+   "Release the resources which an endpoint caches for its peer after the\n"
+   "endpoint did not use them for this time: remote keys and mapped remote\n"
+   "memory of the pipelined rendezvous protocol, and per-lane statistics. The\n"
+   "resources are allocated again on the next use, so the endpoint stays\n"
+   "connected. It is useful for applications with many mostly idle peers.\n"
+   "The value must be longer than any single transfer. inf means never.",
+   ucs_offsetof(ucp_context_config_t, ep_idle_timeout),
+   UCS_CONFIG_TYPE_TIME_UNITS},
+
+  {"HOT_EPS_NUM", "0",
+   "Maximal number of the most active endpoints of a worker which are promoted\n"
+   "to hot endpoints. The activity of an endpoint is sampled from its send\n"
+   "operations and scored with an exponential decay, so an endpoint is promoted\n"
+   "after being used during several intervals, and demoted only when other\n"
+   "endpoints become significantly more active. Hot endpoints keep their cached\n"
+   "resources regardless of UCX_EP_IDLE_TIMEOUT. 0 disables the tracking.",
+   ucs_offsetof(ucp_context_config_t, hot_eps_num), UCS_CONFIG_TYPE_UINT},
+
+  {"HOT_EPS_INTERVAL", "100ms",
+   "Time interval between updates of the endpoints activity scores, used when\n"
+   "UCX_HOT_EPS_NUM is not 0.",
+   ucs_offsetof(ucp_context_config_t, hot_eps_interval),
+   UCS_CONFIG_TYPE_TIME_UNITS},
+
+  {"WAIT_SPIN_MAX", "0us",
+   "Maximal time ucp_worker_wait() progresses the worker in a busy loop before\n"
+   "arming the transports and sleeping on events. The actual spin time is\n"
+   "tuned in runtime: it grows if an event arrives soon after the worker went\n"
+   "to sleep, and shrinks if the worker sleeps for a long time. It saves the\n"
+   "event notification latency without occupying a core when the worker is\n"
+   "idle. 0 means always sleep.",
+   ucs_offsetof(ucp_context_config_t, wait_spin_max),
+   UCS_CONFIG_TYPE_TIME_UNITS},
+
   {"RESOLVE_REMOTE_EP_ID", "n",
    "Defines whether resolving remote endpoint ID is required or not when\n"
    "creating a local endpoint. 'auto' means resolving remote endpoint ID only\n"
@@ -427,6 +462,15 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "lane without waiting for remote completion.",
    ucs_offsetof(ucp_context_config_t, rndv_put_force_flush), UCS_CONFIG_TYPE_BOOL},
 
+  {"RNDV_ADAPTIVE_STRIPING", "n",
+   "When sending rendezvous data over multiple lanes, split the data according\n"
+   "to the current progress of every lane, instead of a fixed split by lane\n"
+   "bandwidth. A lane which is out of send resources is skipped, and the\n"
+   "remaining fragments are sent on the other lanes. Per-lane utilization is\n"
+   "reported by the endpoint's \"lane_stats\" VFS file.",
+   ucs_offsetof(ucp_context_config_t, rndv_adaptive_striping),
+   UCS_CONFIG_TYPE_BOOL},
+
   {"SA_DATA_VERSION", "v2",
    "Defines the minimal header version the client will use for establishing\n"
    "client/server connection",
@@ -445,6 +489,17 @@ static ucs_config_field_t ucp_context_config_table[] = {
    ucs_offsetof(ucp_context_config_t, worker_addr_version),
    UCS_CONFIG_TYPE_ENUM(ucp_object_versions)},
 
+  {"ADDRESS_CACHE", "y",
+   "Keep packed worker addresses and parsed remote worker addresses, so repeated\n"
+   "address exchanges and connections to the same peer do not gather the local\n"
+   "resources or parse the remote address again.",
+   ucs_offsetof(ucp_context_config_t, address_cache), UCS_CONFIG_TYPE_BOOL},
+
+  {"LANES_SELECT_CACHE", "y",
+   "Reuse the lanes selected for a remote worker address when connecting to\n"
+   "another worker with the same transports, devices and attributes.",
+   ucs_offsetof(ucp_context_config_t, lanes_select_cache), UCS_CONFIG_TYPE_BOOL},
+
   {"PROTO_INFO", "n",
    "Enable printing protocols information. The value is interpreted as follows:\n"
    " 'y'          : Print information for all protocols\n"
@@ -463,6 +518,18 @@ static ucs_config_field_t ucp_context_config_table[] = {
    "directory.",
    ucs_offsetof(ucp_context_config_t, proto_info_dir), UCS_CONFIG_TYPE_STRING},
 
+  {"PROTO_PERF_CALIB_FILE", "",
+   "If non-empty, path to a file with calibrated transport performance, which\n"
+   "overrides the estimations reported by transports when selecting protocols.\n"
+   "Every line has the format \"<tl>/<dev> <op> [key=value]...\", where <tl>/<dev>\n"
+   "is a wildcard pattern, <op> is a transport operation name (e.g am_bcopy) or\n"
+   "'*', and the keys are send_pre, send_post, recv, lat (time), bw (bandwidth),\n"
+   "and sample=<size>:<time>, which may be repeated to derive latency and\n"
+   "bandwidth from measured operation times. Such a file can be produced by\n"
+   "running UCT tests of ucx_perftest with the -L option.",
+   ucs_offsetof(ucp_context_config_t, proto_perf_calib_file),
+   UCS_CONFIG_TYPE_STRING},
+
   {"REG_NONBLOCK_MEM_TYPES", "",
    "Perform only non-blocking memory registration for these memory types:\n"
    "page registration may be deferred until it is accessed by the CPU or a transport.",
@@ -2139,8 +2206,16 @@ static ucs_status_t ucp_fill_config(ucp_context_h context,
              ((context->config.ext.max_rma_lanes > 1) ||
               context->config.ext.proto_enable));
 
+    status = ucp_proto_calib_load(context->config.ext.proto_perf_calib_file,
+                                  &context->proto_calib);
+    if (status != UCS_OK) {
+        goto err_free_am_mpools;
+    }
+
     return UCS_OK;
 
+err_free_am_mpools:
+    ucs_free(context->config.am_mpools.sizes);
 err_free_key_list:
     ucp_cached_key_list_release(&context->cached_key_list);
 err_free_alloc_methods:
@@ -2156,6 +2231,7 @@ err:
 
 static void ucp_free_config(ucp_context_h context)
 {
+    ucp_proto_calib_cleanup(&context->proto_calib);
     ucs_free(context->config.am_mpools.sizes);
     ucp_cached_key_list_release(&context->cached_key_list);
     ucs_free(context->config.alloc_methods);
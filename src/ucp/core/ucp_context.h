@@ -16,6 +16,7 @@
 #include <ucp/api/ucp.h>
 #include <ucp/dt/dt.h>
 #include <ucp/proto/proto.h>
+#include <ucp/proto/proto_calib.h>
 #include <uct/api/uct.h>
 #include <uct/api/v2/uct_v2.h>
 #include <ucs/datastruct/mpool.h>
@@ -138,6 +139,16 @@ typedef struct ucp_context_config {
     /** Maximal number of endpoints to check on every keepalive round
      * (0 - disabled, inf - check all endpoints on every round) */
     unsigned                               keepalive_num_eps;
+    /** Time after which the cached resources of an unused endpoint are
+     *  released (inf - disabled) */
+    ucs_time_t                             ep_idle_timeout;
+    /** Maximal number of the most active endpoints to promote (0 - disabled) */
+    unsigned                               hot_eps_num;
+    /** Time period between updates of endpoints activity scores */
+    ucs_time_t                             hot_eps_interval;
+    /** Maximal time to spin on progress in ucp_worker_wait() before arming
+     *  the events and sleeping (0 - disabled) */
+    ucs_time_t                             wait_spin_max;
     /** Defines whether resolving remote endpoint ID is required or not when
      *  creating a local endpoint */
     ucs_on_off_auto_value_t                resolve_remote_ep_id;
@@ -147,6 +158,8 @@ typedef struct ucp_context_config {
     unsigned                               reg_whole_alloc_bitmap;
     /** Always use flush operation in rendezvous put */
     int                                    rndv_put_force_flush;
+    /** Rebalance rendezvous multi-lane data split according to lane progress */
+    int                                    rndv_adaptive_striping;
     /** Maximum size of mem type direct rndv*/
     size_t                                 rndv_memtype_direct_size;
     /** UCP sockaddr private data format version */
@@ -156,6 +169,10 @@ typedef struct ucp_context_config {
     int                                    rkey_mpool_max_md;
     /** Worker address format version */
     ucp_object_version_t                   worker_addr_version;
+    /** Cache packed worker addresses and memoize unpacked remote addresses */
+    int                                    address_cache;
+    /** Reuse lanes selected for remote addresses with identical layout */
+    int                                    lanes_select_cache;
     /** Threshold for enabling RNDV data split alignment */
     size_t                                 rndv_align_thresh;
     /** Print protocols information */
@@ -164,6 +181,8 @@ typedef struct ucp_context_config {
     char                                   *select_distance_md;
     /** Directory to write protocol selection information */
     char                                   *proto_info_dir;
+    /** File with calibrated transport performance for protocol selection */
+    char                                   *proto_perf_calib_file;
     /** Memory types that perform non-blocking registration by default */
     uint64_t                               reg_nb_mem_types;
     /** Prefer native RMA transports for RMA/AMO protocols */
@@ -328,6 +347,9 @@ typedef struct ucp_context {
 
     ucp_proto_id_mask_t           proto_bitmap;  /* Enabled protocols */
 
+    /* Calibrated transport performance, overriding transport estimations */
+    ucp_proto_calib_array_t       proto_calib;
+
     /* Mem handle registration cache */
     ucs_rcache_t                  *rcache;
 
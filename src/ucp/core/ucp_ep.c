@@ -183,6 +183,7 @@ static void ucp_ep_deallocate(ucp_ep_h ep)
 {
     UCS_STATS_NODE_FREE(ep->stats);
     ucs_free(ep->ext->uct_eps);
+    ucs_free(ep->ext->lane_stats);
     ucs_free(ep->ext);
     ucs_strided_alloc_put(&ep->worker->ep_alloc, ep);
 }
@@ -227,6 +228,8 @@ static ucp_ep_h ucp_ep_allocate(ucp_worker_h worker, const char *peer_name)
     ep->ext->ka_last_round                = 0;
 #endif
     ep->ext->peer_mem                     = NULL;
+    ep->ext->lane_stats                   = NULL;
+    ep->ext->cache_used                   = 0;
     ep->ext->uct_eps                      = NULL;
 
     UCS_STATIC_ASSERT(sizeof(ep->ext->ep_match) >=
@@ -302,8 +305,10 @@ ucp_ep_peer_mem_get(ucp_context_h context, ucp_ep_h ep, uint64_t address,
 
     ucs_assert(local_mem_type != UCS_MEMORY_TYPE_UNKNOWN);
 
+    ep->ext->cache_used = 1;
     if (ucs_unlikely(peer_mem == NULL)) {
         ep->ext->peer_mem = peer_mem = kh_init(ucp_ep_peer_mem_hash);
+        ucp_worker_ep_compact_add_ep(ep);
     }
 
     iter = kh_put(ucp_ep_peer_mem_hash, peer_mem, address, &ret);
@@ -486,10 +491,52 @@ static int ucp_ep_remove_filter(const ucs_callbackq_elem_t *elem, void *arg)
     return 0;
 }
 
+ucp_ep_lane_stats_t *ucp_ep_lane_stats_get(ucp_ep_h ep)
+{
+    ep->ext->cache_used = 1;
+    if (ucs_unlikely(ep->ext->lane_stats == NULL)) {
+        ep->ext->lane_stats = ucs_calloc(UCP_MAX_LANES,
+                                         sizeof(*ep->ext->lane_stats),
+                                         "ucp_ep_lane_stats");
+        ucp_worker_ep_compact_add_ep(ep);
+    }
+
+    return ep->ext->lane_stats;
+}
+
+static void ucp_ep_peer_mem_cleanup(ucp_ep_h ep)
+{
+    ucp_ep_peer_mem_data_t data;
+
+    kh_foreach_value(ep->ext->peer_mem, data, {
+        ucp_ep_peer_mem_destroy(ep->worker->context, &data);
+    });
+
+    kh_destroy(ucp_ep_peer_mem_hash, ep->ext->peer_mem);
+    ep->ext->peer_mem = NULL;
+}
+
+int ucp_ep_compact(ucp_ep_h ep)
+{
+    int compacted = 0;
+
+    if (ep->ext->peer_mem != NULL) {
+        ucp_ep_peer_mem_cleanup(ep);
+        compacted = 1;
+    }
+
+    if (ep->ext->lane_stats != NULL) {
+        ucs_free(ep->ext->lane_stats);
+        ep->ext->lane_stats = NULL;
+        compacted           = 1;
+    }
+
+    return compacted;
+}
+
 void ucp_ep_destroy_base(ucp_ep_h ep)
 {
     ucp_worker_h worker = ep->worker;
-    ucp_ep_peer_mem_data_t data;
 
     ucp_ep_refcount_field_assert(ep, refcount, ==, 0);
     ucp_ep_refcount_assert(ep, create, ==, 0);
@@ -503,6 +550,7 @@ void ucp_ep_destroy_base(ucp_ep_h ep)
     }
 
     ucp_worker_keepalive_remove_ep(ep);
+    ucp_worker_hot_eps_remove_ep(ep);
     ucp_ep_release_id(ep);
     ucs_list_del(&ep->ext->ep_list);
 
@@ -511,11 +559,7 @@ void ucp_ep_destroy_base(ucp_ep_h ep)
                                  ucp_ep_remove_filter, ep);
     UCS_STATS_NODE_FREE(ep->stats);
     if (ep->ext->peer_mem != NULL) {
-        kh_foreach_value(ep->ext->peer_mem, data, {
-            ucp_ep_peer_mem_destroy(worker->context, &data);
-        });
-
-        kh_destroy(ucp_ep_peer_mem_hash, ep->ext->peer_mem);
+        ucp_ep_peer_mem_cleanup(ep);
     }
     ucp_ep_deallocate(ep);
 }
@@ -2603,10 +2647,14 @@ ucs_status_t ucp_ep_config_init(ucp_worker_h worker, ucp_ep_config_t *config,
 
         cmpt_attr = ucp_cmpt_attr_by_md_index(context, config->md_index[lane]);
         if (cmpt_attr->flags & UCT_COMPONENT_FLAG_RKEY_PTR) {
+            /* Skip unpacking the rkey on rendezvous, unless GET/PUT zcopy
+             * on the lane needs it */
             dst_md_index = config->key.lanes[lane].dst_md_index;
+            iface_attr   = ucp_worker_iface_get_attr(worker, rsc_index);
             if (lane == key->rkey_ptr_lane) {
                 config->rndv.rkey_ptr_lane_dst_mds     = UCS_BIT(dst_md_index);
-            } else {
+            } else if (!(iface_attr->cap.flags & (UCT_IFACE_FLAG_GET_ZCOPY |
+                                                  UCT_IFACE_FLAG_PUT_ZCOPY))) {
                 config->rndv.proto_rndv_rkey_skip_mds |= UCS_BIT(dst_md_index);
             }
         }
@@ -113,6 +113,8 @@ enum {
     UCP_EP_FLAG_INDIRECT_ID            = UCS_BIT(14),/* protocols on this endpoint will send
                                                         indirect endpoint id instead of pointer,
                                                         can be replaced with looking at local ID */
+    UCP_EP_FLAG_HOT                    = UCS_BIT(15),/* EP is one of the most active
+                                                        endpoints of the worker */
 
     /* DEBUG bits */
     UCP_EP_FLAG_CONNECT_REQ_SENT       = UCS_BIT(16),/* DEBUG: Connection request was sent */
@@ -489,6 +491,17 @@ typedef struct {
 } ucp_ep_flush_state_t;
 
 
+/**
+ * Per-lane statistics of multi-lane protocols
+ */
+typedef struct {
+    uint64_t bytes;  /* Number of bytes sent on the lane */
+    uint64_t frags;  /* Number of fragments sent on the lane */
+    uint64_t stalls; /* Number of times the lane was skipped because it was
+                        out of send resources */
+} ucp_ep_lane_stats_t;
+
+
 /**
  * Endpoint extension
  */
@@ -503,6 +516,12 @@ typedef struct ucp_ep_ext {
     ucp_request_t                 *close_req;    /* Close protocol request */
     khash_t(ucp_ep_peer_mem_hash) *peer_mem;     /* Hash of remote memory segments
                                                     used by 2-stage ppln rndv proto */
+    ucp_ep_lane_stats_t           *lane_stats;   /* Per-lane statistics of adaptive
+                                                    multi-lane protocols, allocated
+                                                    on first use */
+    uint8_t                       cache_used;    /* Cached peer resources were used
+                                                    since the last idle endpoints
+                                                    check */
     /* List of requests which are waiting for remote completion */
     ucs_hlist_head_t              proto_reqs;
 #if UCS_ENABLE_ASSERT
@@ -815,6 +834,16 @@ ucp_ep_peer_mem_get(ucp_context_h context, ucp_ep_h ep, uint64_t address,
                     ucs_memory_type_t local_mem_type,
                     ucp_md_index_t rkey_ptr_md_index);
 
+ucp_ep_lane_stats_t *ucp_ep_lane_stats_get(ucp_ep_h ep);
+
+/**
+ * Release the resources which the endpoint caches for its peer, they are
+ * allocated again on next use.
+ *
+ * @return Nonzero if any resource was released.
+ */
+int ucp_ep_compact(ucp_ep_h ep);
+
 /**
  * @brief Indicates AM-based keepalive necessity.
  * 
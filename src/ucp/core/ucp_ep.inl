@@ -311,4 +311,14 @@ static UCS_F_ALWAYS_INLINE int ucp_ep_use_indirect_id(ucp_ep_h ep)
     return ep->flags & UCP_EP_FLAG_INDIRECT_ID;
 }
 
+/* Account a send operation in the activity of the endpoint */
+static UCS_F_ALWAYS_INLINE void ucp_ep_usage_touch(ucp_ep_h ep)
+{
+    ucs_usage_tracker_h tracker = ep->worker->hot_eps.tracker;
+
+    if (ucs_unlikely(tracker != NULL)) {
+        ucs_usage_tracker_touch_key(tracker, ep);
+    }
+}
+
 #endif
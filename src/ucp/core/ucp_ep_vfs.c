@@ -109,6 +109,39 @@ static void ucp_ep_vfs_init_address(ucp_ep_h ep)
     }
 }
 
+static void ucp_ep_vfs_read_lane_stats(void *obj, ucs_string_buffer_t *strb,
+                                       void *arg_ptr, uint64_t arg_u64)
+{
+    ucp_ep_h ep                           = obj;
+    const ucp_ep_lane_stats_t *lane_stats = ep->ext->lane_stats;
+    uint64_t total_bytes                  = 0;
+    ucp_lane_index_t lane;
+
+    if (lane_stats == NULL) {
+        return;
+    }
+
+    for (lane = 0; lane < UCP_MAX_LANES; ++lane) {
+        total_bytes += lane_stats[lane].bytes;
+    }
+
+    for (lane = 0; lane < UCP_MAX_LANES; ++lane) {
+        if ((lane_stats[lane].frags == 0) && (lane_stats[lane].stalls == 0)) {
+            continue;
+        }
+
+        ucs_string_buffer_appendf(strb,
+                                  "lane %u: bytes %" PRIu64 " frags %" PRIu64
+                                  " stalls %" PRIu64 " share %.1f%%\n",
+                                  lane, lane_stats[lane].bytes,
+                                  lane_stats[lane].frags,
+                                  lane_stats[lane].stalls,
+                                  (total_bytes == 0) ? 0.0 :
+                                  (lane_stats[lane].bytes * 100.0) /
+                                  total_bytes);
+    }
+}
+
 void ucp_ep_vfs_init(ucp_ep_h ep)
 {
     ucp_err_handling_mode_t err_mode;
@@ -129,5 +162,8 @@ void ucp_ep_vfs_init(ucp_ep_h ep)
                             (void*)ucp_err_handling_mode_names[err_mode],
                             UCS_VFS_TYPE_STRING, "error_mode");
 
+    ucs_vfs_obj_add_ro_file(ep, ucp_ep_vfs_read_lane_stats, NULL, 0,
+                            "lane_stats");
+
     ucp_ep_vfs_init_address(ep);
 }
@@ -16,6 +16,7 @@
 #include <ucp/proto/proto_am.h>
 #include <ucp/proto/proto_debug.h>
 #include <ucp/tag/tag_rndv.h>
+#include <ucp/wireup/wireup.h>
 #include <uct/api/v2/uct_v2.h>
 #include <ucs/datastruct/mpool.inl>
 #include <ucs/debug/debug_int.h>
@@ -321,13 +322,26 @@ ucs_mpool_ops_t ucp_rndv_get_mpool_ops = {
     .obj_str       = NULL
 };
 
+/* Priority hint for the transport pending queue */
+static unsigned ucp_request_pending_flags(ucp_request_t *req)
+{
+    if (req->send.uct.func == ucp_wireup_msg_progress) {
+        return UCT_CB_FLAG_PRIO_HIGH;
+    } else if (req->flags & UCP_REQUEST_FLAG_RNDV_FRAG) {
+        return UCT_CB_FLAG_PRIO_BULK;
+    }
+
+    return 0;
+}
+
 int ucp_request_pending_add(ucp_request_t *req)
 {
     ucs_status_t status;
     uct_ep_h uct_ep;
 
     uct_ep = ucp_ep_get_lane(req->send.ep, req->send.lane);
-    status = uct_ep_pending_add(uct_ep, &req->send.uct, 0);
+    status = uct_ep_pending_add(uct_ep, &req->send.uct,
+                                ucp_request_pending_flags(req));
     if (status == UCS_OK) {
         ucs_trace_data("ep %p: added pending uct request %p to lane[%d]=%p",
                        req->send.ep, req, req->send.lane, uct_ep);
@@ -67,6 +67,8 @@ typedef struct ucp_recv_desc          ucp_recv_desc_t;
 typedef struct ucp_address_iface_attr ucp_address_iface_attr_t;
 typedef struct ucp_address_entry      ucp_address_entry_t;
 typedef struct ucp_unpacked_address   ucp_unpacked_address_t;
+typedef struct ucp_address_cache      ucp_address_cache_t;
+typedef struct ucp_wireup_select_cache ucp_wireup_select_cache_t;
 typedef struct ucp_wireup_ep          ucp_wireup_ep_t;
 typedef struct ucp_request_send_proto ucp_request_send_proto_t;
 typedef struct ucp_worker_iface       ucp_worker_iface_t;
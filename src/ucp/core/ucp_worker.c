@@ -41,6 +41,16 @@
 
 #define UCP_WORKER_KEEPALIVE_ITER_SKIP 32
 
+/* Spin time of ucp_worker_wait() is adjusted after every sleep:
+ * - It is multiplied by the grow factor if the event arrived before the
+ *   maximal spin time elapsed, since a longer spin would have caught it.
+ * - It is divided by the shrink factor if the worker slept longer than the
+ *   maximal spin time, since spinning only wastes CPU for such a rate of
+ *   events. */
+#define UCP_WORKER_WAIT_SPIN_MIN_USEC   1 /* Spin time to grow from zero */
+#define UCP_WORKER_WAIT_SPIN_GROW       2 /* Spin time *= grow factor */
+#define UCP_WORKER_WAIT_SPIN_SHRINK     2 /* Spin time /= shrink factor */
+
 #define UCP_WORKER_MAX_DEBUG_STRING_SIZE 200
 
 #define UCP_WIFACE_FMT "iface %p (" UCT_TL_RESOURCE_DESC_FMT ")"
@@ -94,7 +104,10 @@ static ucs_stats_class_t ucp_worker_stats_class = {
         [UCP_WORKER_STAT_RNDV_PUT_ZCOPY]           = "rndv_put_zcopy",
         [UCP_WORKER_STAT_RNDV_GET_ZCOPY]           = "rndv_get_zcopy",
         [UCP_WORKER_STAT_RNDV_RTR]                 = "rndv_rtr",
-        [UCP_WORKER_STAT_RNDV_RKEY_PTR]            = "rndv_rkey_ptr"
+        [UCP_WORKER_STAT_RNDV_RKEY_PTR]            = "rndv_rkey_ptr",
+        [UCP_WORKER_STAT_PROTO_SELECT_CACHE_HITS]  = "proto_select_cache_hits",
+        [UCP_WORKER_STAT_PROTO_SELECT_CACHE_MISSES] =
+                "proto_select_cache_misses"
     }
 };
 #endif
@@ -1102,6 +1115,10 @@ ucs_status_t ucp_worker_add_resource_ifaces(ucp_worker_h worker,
     ucs_status_t status;
     int is_uct_thread_safe = 1;
 
+    /* Packed addresses and selected lanes are going to change */
+    ucp_address_cache_invalidate(worker);
+    ucp_wireup_select_cache_invalidate(worker);
+
     /* If tl_bitmap is already set, just use it. Otherwise open ifaces on all
      * available resources and then select the best ones. */
     ctx_tl_bitmap  = context->tl_bitmap;
@@ -1251,6 +1268,9 @@ void ucp_worker_del_resource_ifaces(ucp_worker_h worker,
         return;
     }
 
+    ucp_address_cache_invalidate(worker);
+    ucp_wireup_select_cache_invalidate(worker);
+
     UCS_BITMAP_FOR_EACH_BIT(coll_tl_bitmap, tl_id) {
         ucs_assert(ucp_worker_is_tl_coll(worker, tl_id));
         ucp_worker_iface_cleanup(worker->ifaces[iface_index_base]);
@@ -1370,6 +1390,9 @@ ucs_status_t ucp_worker_iface_estimate_perf(const ucp_worker_iface_t *wiface,
         return status;
     }
 
+    ucp_proto_calib_apply(wiface->worker->context, wiface->rsc_index,
+                          perf_attr);
+
     if ((perf_attr->field_mask &
          (UCT_PERF_ATTR_FIELD_LATENCY | UCT_PERF_ATTR_FIELD_BANDWIDTH)) != 0) {
         ucp_worker_iface_get_memory_distance(wiface, &distance);
@@ -2478,6 +2501,23 @@ void ucp_worker_create_vfs(ucp_context_h context, ucp_worker_h worker)
     ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
                             &worker->counters.ep_failures, UCS_VFS_TYPE_ULONG,
                             "counters/ep_failures");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.lanes_select_cache_hits,
+                            UCS_VFS_TYPE_ULONG,
+                            "counters/lanes_select_cache_hits");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.lanes_select_cache_misses,
+                            UCS_VFS_TYPE_ULONG,
+                            "counters/lanes_select_cache_misses");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.ep_compactions,
+                            UCS_VFS_TYPE_ULONG, "counters/ep_compactions");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.ep_promotions,
+                            UCS_VFS_TYPE_ULONG, "counters/ep_promotions");
+    ucs_vfs_obj_add_ro_file(worker, ucp_worker_vfs_show_primitive,
+                            &worker->counters.ep_demotions,
+                            UCS_VFS_TYPE_ULONG, "counters/ep_demotions");
 }
 
 static void ucp_worker_set_max_am_header(ucp_worker_h worker)
@@ -2526,6 +2566,104 @@ static void ucp_worker_set_max_am_header(ucp_worker_h worker)
                             ucs_min(max_am_header, UINT32_MAX) : 0ul;
 }
 
+static void ucp_worker_hot_ep_promote(void *entry, void *arg)
+{
+    ucp_ep_h ep = (ucp_ep_h)entry;
+
+    ucs_trace("ep %p: promoted to hot endpoint", ep);
+    ucp_ep_update_flags(ep, UCP_EP_FLAG_HOT, 0);
+    ++ep->worker->counters.ep_promotions;
+}
+
+static void ucp_worker_hot_ep_demote(void *entry, void *arg)
+{
+    ucp_ep_h ep = (ucp_ep_h)entry;
+
+    ucs_trace("ep %p: demoted from hot endpoint", ep);
+    ucp_ep_update_flags(ep, 0, UCP_EP_FLAG_HOT);
+    ++ep->worker->counters.ep_demotions;
+}
+
+static unsigned ucp_worker_hot_eps_progress(void *arg)
+{
+    ucp_worker_h worker = (ucp_worker_h)arg;
+    ucs_time_t now;
+
+    if ((worker->hot_eps.iter_count++ % UCP_WORKER_KEEPALIVE_ITER_SKIP) != 0) {
+        return 0;
+    }
+
+    now = ucs_get_time();
+    if (ucs_likely((now - worker->hot_eps.last_round) <
+                   worker->context->config.ext.hot_eps_interval)) {
+        return 0;
+    }
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    ucs_usage_tracker_progress(worker->hot_eps.tracker);
+    worker->hot_eps.last_round = now;
+    UCS_ASYNC_UNBLOCK(&worker->async);
+
+    return 0;
+}
+
+static ucs_status_t ucp_worker_hot_eps_init(ucp_worker_h worker)
+{
+    unsigned hot_eps_num = worker->context->config.ext.hot_eps_num;
+    ucs_usage_tracker_params_t params;
+    ucs_status_t status;
+
+    worker->hot_eps.tracker    = NULL;
+    worker->hot_eps.cb_id      = UCS_CALLBACKQ_ID_NULL;
+    worker->hot_eps.last_round = ucs_get_time();
+    worker->hot_eps.iter_count = 0;
+
+    if (hot_eps_num == 0) {
+        return UCS_OK;
+    }
+
+    /* An endpoint which is used on every update converges to score 1, and
+     * replaces a hot endpoint only if it leads by remove_thresh */
+    params.promote_capacity = hot_eps_num;
+    params.promote_thresh   = hot_eps_num;
+    params.remove_thresh    = 0.1;
+    params.promote_cb       = ucp_worker_hot_ep_promote;
+    params.promote_arg      = worker;
+    params.demote_cb        = ucp_worker_hot_ep_demote;
+    params.demote_arg       = worker;
+    params.exp_decay.m      = 0.8;
+    params.exp_decay.c      = 0.2;
+
+    status = ucs_usage_tracker_create(&params, &worker->hot_eps.tracker);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    uct_worker_progress_register_safe(worker->uct, ucp_worker_hot_eps_progress,
+                                      worker, 0, &worker->hot_eps.cb_id);
+    return UCS_OK;
+}
+
+static void ucp_worker_hot_eps_cleanup(ucp_worker_h worker)
+{
+    if (worker->hot_eps.tracker == NULL) {
+        return;
+    }
+
+    uct_worker_progress_unregister_safe(worker->uct, &worker->hot_eps.cb_id);
+    ucs_usage_tracker_destroy(worker->hot_eps.tracker);
+    worker->hot_eps.tracker = NULL;
+}
+
+void ucp_worker_hot_eps_remove_ep(ucp_ep_h ep)
+{
+    ucs_usage_tracker_h tracker = ep->worker->hot_eps.tracker;
+
+    if (tracker != NULL) {
+        ucs_usage_tracker_remove(tracker, ep);
+    }
+}
+
 ucs_status_t ucp_worker_create(ucp_context_h context,
                                const ucp_worker_params_t *params,
                                ucp_worker_h *worker_p)
@@ -2550,7 +2688,11 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->am_message_id        = ucs_generate_uuid(0);
     worker->rkey_ptr_cb_id       = UCS_CALLBACKQ_ID_NULL;
     worker->num_all_eps          = 0;
+    worker->wait_spin.budget     = context->config.ext.wait_spin_max;
     ucp_worker_keepalive_reset(worker);
+    worker->ep_compact.cb_id      = UCS_CALLBACKQ_ID_NULL;
+    worker->ep_compact.last_round = 0;
+    worker->ep_compact.iter_count = 0;
     ucs_queue_head_init(&worker->rkey_ptr_reqs);
     ucs_list_head_init(&worker->arm_ifaces);
     ucs_list_head_init(&worker->stream_ready_eps);
@@ -2562,6 +2704,11 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     worker->counters.ep_creation_failures = 0;
     worker->counters.ep_closures          = 0;
     worker->counters.ep_failures          = 0;
+    worker->counters.lanes_select_cache_hits   = 0;
+    worker->counters.lanes_select_cache_misses = 0;
+    worker->counters.ep_compactions            = 0;
+    worker->counters.ep_promotions             = 0;
+    worker->counters.ep_demotions              = 0;
 
     /* Copy user flags, and mask-out unsupported flags for compatibility */
     worker->flags = UCP_PARAM_VALUE(WORKER, params, flags, FLAGS, 0) &
@@ -2718,6 +2865,12 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
         goto err_tag_match_cleanup;
     }
 
+    /* Initialize tracking of the most active endpoints */
+    status = ucp_worker_hot_eps_init(worker);
+    if (status != UCS_OK) {
+        goto err_am_cleanup;
+    }
+
     /* Select atomic resources */
     ucp_worker_init_atomic_tls(worker);
 
@@ -2736,6 +2889,8 @@ ucs_status_t ucp_worker_create(ucp_context_h context,
     *worker_p = worker;
     return UCS_OK;
 
+err_am_cleanup:
+    ucp_am_cleanup(worker);
 err_tag_match_cleanup:
     ucp_tag_match_cleanup(&worker->tm);
 err_destroy_mpools:
@@ -2746,6 +2901,8 @@ err_close_cms:
     ucp_worker_close_cms(worker);
 err_close_ifaces:
     ucp_worker_close_ifaces(worker);
+    ucp_address_cache_cleanup(worker);
+    ucp_wireup_select_cache_cleanup(worker);
 err_conn_match_cleanup:
     ucs_conn_match_cleanup(&worker->conn_match_ctx);
     ucp_worker_wakeup_cleanup(worker);
@@ -2968,9 +3125,11 @@ void ucp_worker_destroy(ucp_worker_h worker)
 
     UCS_ASYNC_BLOCK(&worker->async);
     uct_worker_progress_unregister_safe(worker->uct, &worker->keepalive.cb_id);
+    uct_worker_progress_unregister_safe(worker->uct, &worker->ep_compact.cb_id);
     ucp_worker_discard_uct_ep_cleanup(worker);
     ucp_worker_destroy_eps(worker, &worker->all_eps, "all");
     ucp_worker_destroy_eps(worker, &worker->internal_eps, "internal");
+    ucp_worker_hot_eps_cleanup(worker);
     ucp_am_cleanup(worker);
     /* Put ucp_worker_remove_am_handlers after ucp_worker_discard_uct_ep_cleanup
      * to make sure iface->am[] always cleared.
@@ -3006,6 +3165,8 @@ void ucp_worker_destroy(ucp_worker_h worker)
     ucp_worker_destroy_mpools(worker);
     ucp_worker_close_cms(worker);
     ucp_worker_close_ifaces(worker);
+    ucp_address_cache_cleanup(worker);
+    ucp_wireup_select_cache_cleanup(worker);
     ucs_conn_match_cleanup(&worker->conn_match_ctx);
     ucp_worker_wakeup_cleanup(worker);
     uct_worker_destroy(worker->uct);
@@ -3255,11 +3416,52 @@ void ucp_worker_wait_mem(ucp_worker_h worker, void *address)
     ucs_arch_wait_mem(address);
 }
 
+static int ucp_worker_wait_spin(ucp_worker_h worker, ucs_time_t start)
+{
+    ucs_time_t deadline = start + worker->wait_spin.budget;
+
+    if (worker->wait_spin.budget == 0) {
+        return 0;
+    }
+
+    do {
+        if (ucp_worker_progress(worker) != 0) {
+            return 1;
+        }
+    } while (ucs_get_time() < deadline);
+
+    return 0;
+}
+
+static void ucp_worker_wait_spin_adjust(ucp_worker_h worker,
+                                        ucs_time_t wait_time)
+{
+    ucs_time_t spin_max = worker->context->config.ext.wait_spin_max;
+    ucs_time_t budget;
+
+    if (spin_max == 0) {
+        return;
+    }
+
+    if (wait_time < spin_max) {
+        budget = ucs_max(worker->wait_spin.budget * UCP_WORKER_WAIT_SPIN_GROW,
+                         ucs_time_from_usec(UCP_WORKER_WAIT_SPIN_MIN_USEC));
+        worker->wait_spin.budget = ucs_min(budget, spin_max);
+    } else {
+        worker->wait_spin.budget /= UCP_WORKER_WAIT_SPIN_SHRINK;
+    }
+
+    ucs_trace("worker %p: waited %.2f usec, spin time %.2f usec", worker,
+              ucs_time_to_usec(wait_time),
+              ucs_time_to_usec(worker->wait_spin.budget));
+}
+
 ucs_status_t ucp_worker_wait(ucp_worker_h worker)
 {
     ucp_worker_iface_t *wiface;
     struct pollfd *pfd;
     ucs_status_t status;
+    ucs_time_t start;
     nfds_t nfds;
     int ret;
 
@@ -3268,6 +3470,13 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
     UCP_CONTEXT_CHECK_FEATURE_FLAGS(worker->context, UCP_FEATURE_WAKEUP,
                                     return UCS_ERR_INVALID_PARAM);
 
+    /* Events which arrive shortly are caught by busy polling, which saves
+     * arming the transports and the wakeup latency */
+    start = ucs_get_time();
+    if (ucp_worker_wait_spin(worker, start)) {
+        return UCS_OK;
+    }
+
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
 
     status = ucp_worker_arm(worker);
@@ -3309,6 +3518,7 @@ ucs_status_t ucp_worker_wait(ucp_worker_h worker)
         ret = poll(pfd, nfds, -1);
         if (ret >= 0) {
             ucs_assertv(ret == 1, "ret=%d", ret);
+            ucp_worker_wait_spin_adjust(worker, ucs_get_time() - start);
             status = UCS_OK;
             goto out;
         } else {
@@ -3652,6 +3862,71 @@ void ucp_worker_keepalive_remove_ep(ucp_ep_h ep)
     }
 }
 
+static unsigned ucp_worker_ep_compact_progress(void *arg)
+{
+    ucp_worker_h worker       = (ucp_worker_h)arg;
+    ucs_time_t idle_timeout   = worker->context->config.ext.ep_idle_timeout;
+    unsigned compacted_count  = 0;
+    int has_cached            = 0;
+    ucp_ep_ext_t *ep_ext;
+    ucs_time_t now;
+    ucp_ep_h ep;
+
+    if ((worker->ep_compact.iter_count++ % UCP_WORKER_KEEPALIVE_ITER_SKIP) !=
+        0) {
+        return 0;
+    }
+
+    now = ucs_get_time();
+    if (ucs_likely((now - worker->ep_compact.last_round) < idle_timeout)) {
+        return 0;
+    }
+
+    /* An endpoint is idle if it did not use its cached resources since the
+     * previous check, so the resources are released after at least one and
+     * at most two timeout periods without use */
+    UCS_ASYNC_BLOCK(&worker->async);
+    ucs_list_for_each(ep_ext, &worker->all_eps, ep_list) {
+        ep = ep_ext->ep;
+        if (ep_ext->cache_used || (ep->flags & UCP_EP_FLAG_HOT)) {
+            /* Hot endpoints keep their resources even if not used lately */
+            ep_ext->cache_used = 0;
+            has_cached = 1;
+        } else if (ucp_ep_compact(ep)) {
+            ucs_trace("worker %p: ep %p released idle cached resources",
+                      worker, ep);
+            ++compacted_count;
+        }
+    }
+
+    worker->counters.ep_compactions += compacted_count;
+    worker->ep_compact.last_round    = now;
+    if (!has_cached) {
+        ucs_trace("worker %p: no endpoints with cached resources - disabling "
+                  "idle check", worker);
+        uct_worker_progress_unregister_safe(worker->uct,
+                                            &worker->ep_compact.cb_id);
+    }
+    UCS_ASYNC_UNBLOCK(&worker->async);
+
+    return compacted_count;
+}
+
+void ucp_worker_ep_compact_add_ep(ucp_ep_h ep)
+{
+    ucp_worker_h worker = ep->worker;
+
+    if ((worker->context->config.ext.ep_idle_timeout == UCS_TIME_INFINITY) ||
+        (worker->ep_compact.cb_id != UCS_CALLBACKQ_ID_NULL)) {
+        return;
+    }
+
+    worker->ep_compact.last_round = ucs_get_time();
+    uct_worker_progress_register_safe(worker->uct,
+                                      ucp_worker_ep_compact_progress, worker,
+                                      0, &worker->ep_compact.cb_id);
+}
+
 static ucs_status_t
 ucp_worker_discard_tl_uct_ep(ucp_ep_h ucp_ep, uct_ep_h uct_ep,
                              ucp_rsc_index_t rsc_index,
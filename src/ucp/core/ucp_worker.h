@@ -21,6 +21,7 @@
 #include <ucs/datastruct/strided_alloc.h>
 #include <ucs/datastruct/conn_match.h>
 #include <ucs/datastruct/ptr_map.h>
+#include <ucs/datastruct/usage_tracker.h>
 #include <ucs/datastruct/bitmap.h>
 #include <ucs/arch/bitops.h>
 
@@ -152,6 +153,10 @@ enum {
     UCP_WORKER_STAT_RNDV_RTR,
     UCP_WORKER_STAT_RNDV_RKEY_PTR,
 
+    /* Protocol selection lookups served by the cache, or by the hash */
+    UCP_WORKER_STAT_PROTO_SELECT_CACHE_HITS,
+    UCP_WORKER_STAT_PROTO_SELECT_CACHE_MISSES,
+
     UCP_WORKER_STAT_LAST
 };
 
@@ -313,6 +318,12 @@ typedef struct ucp_worker {
     unsigned                         num_ifaces;          /* Number of elements in ifaces array  */
     unsigned                         num_active_ifaces;   /* Number of activated ifaces  */
     ucp_tl_bitmap_t                  scalable_tl_bitmap;  /* Map of scalable tl resources */
+    ucp_address_cache_t              *address_cache;      /* Packed local and unpacked
+                                                           * remote addresses, allocated
+                                                           * on first use */
+    ucp_wireup_select_cache_t        *select_cache;       /* Lanes selected for remote
+                                                           * addresses, allocated on
+                                                           * first use */
     ucp_worker_cm_t                  *cms;                /* Array of CMs, one for each component */
     ucs_mpool_set_t                  am_mps;              /* Memory pool set for AM receives */
     ucs_mpool_t                      reg_mp;              /* Registered memory pool */
@@ -358,6 +369,28 @@ typedef struct ucp_worker {
         size_t                       round_count;         /* Number of rounds done */
     } keepalive;
 
+    struct {
+        uct_worker_cb_id_t           cb_id;               /* Idle endpoints check callback id */
+        ucs_time_t                   last_round;          /* Last check timestamp */
+        unsigned                     iter_count;          /* Number of progress iterations to skip,
+                                                           * used to minimize call of ucs_get_time */
+    } ep_compact;
+
+    struct {
+        ucs_usage_tracker_h          tracker;             /* Activity of endpoints, NULL if
+                                                           * the tracking is disabled */
+        uct_worker_cb_id_t           cb_id;               /* Tracker update callback id */
+        ucs_time_t                   last_round;          /* Last update timestamp */
+        unsigned                     iter_count;          /* Number of progress iterations to skip,
+                                                           * used to minimize call of ucs_get_time */
+    } hot_eps;
+
+    struct {
+        ucs_time_t                   budget;              /* Current time to spin in
+                                                           * ucp_worker_wait() before
+                                                           * sleeping */
+    } wait_spin;
+
     struct {
         /* Number of requests to create endpoint */
         uint64_t                     ep_creations;
@@ -367,6 +400,16 @@ typedef struct ucp_worker {
         uint64_t                     ep_closures;
         /* Number of failed endpoints */
         uint64_t                     ep_failures;
+        /* Number of lane selections served by the selection cache */
+        uint64_t                     lanes_select_cache_hits;
+        /* Number of lane selections which were not found in the cache */
+        uint64_t                     lanes_select_cache_misses;
+        /* Number of times idle endpoints released their cached resources */
+        uint64_t                     ep_compactions;
+        /* Number of endpoints promoted to hot endpoints */
+        uint64_t                     ep_promotions;
+        /* Number of hot endpoints demoted by more active ones */
+        uint64_t                     ep_demotions;
     } counters;
 } ucp_worker_t;
 
@@ -413,6 +456,12 @@ void ucp_worker_keepalive_add_ep(ucp_ep_h );
 /* EP should be removed from worker all_eps prior to call this function */
 void ucp_worker_keepalive_remove_ep(ucp_ep_h ep);
 
+/* Start checking for idle endpoints, called when EP caches a resource */
+void ucp_worker_ep_compact_add_ep(ucp_ep_h ep);
+
+/* Stop tracking the activity of EP, called when EP is destroyed */
+void ucp_worker_hot_eps_remove_ep(ucp_ep_h ep);
+
 /* must be called with async lock held */
 int ucp_worker_is_uct_ep_discarding(ucp_worker_h worker, uct_ep_h uct_ep);
 
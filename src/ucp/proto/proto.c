@@ -44,6 +44,7 @@
     _macro(ucp_rndv_am_zcopy_proto) \
     _macro(ucp_rndv_get_zcopy_proto) \
     _macro(ucp_rndv_get_mtype_proto) \
+    _macro(ucp_rndv_get_stage_proto) \
     _macro(ucp_rndv_ats_proto) \
     _macro(ucp_rndv_rtr_proto) \
     _macro(ucp_rndv_rtr_mtype_proto) \
@@ -51,6 +52,7 @@
     _macro(ucp_rndv_recv_ppln_proto) \
     _macro(ucp_rndv_put_zcopy_proto) \
     _macro(ucp_rndv_put_mtype_proto) \
+    _macro(ucp_rndv_put_stage_proto) \
     _macro(ucp_rndv_rkey_ptr_proto) \
     _macro(ucp_rndv_rkey_ptr_mtype_proto) \
     _macro(ucp_tag_rndv_offload_proto) \
@@ -0,0 +1,354 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2023. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "proto_calib.h"
+
+#include <ucp/core/ucp_context.h>
+#include <ucs/config/parser.h>
+#include <ucs/debug/log.h>
+#include <ucs/sys/string.h>
+#include <fnmatch.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+
+#define UCP_PROTO_CALIB_LINE_MAX 1024
+#define UCP_PROTO_CALIB_DELIMS   " \t\r\n"
+
+
+/* Least-squares linear fit of time as a function of message size */
+typedef struct {
+    unsigned count;
+    double   sum_x;
+    double   sum_y;
+    double   sum_xx;
+    double   sum_xy;
+} ucp_proto_calib_fit_t;
+
+
+static const char *ucp_proto_calib_op_names[] = {
+    [UCT_EP_OP_AM_SHORT]     = "am_short",
+    [UCT_EP_OP_AM_BCOPY]     = "am_bcopy",
+    [UCT_EP_OP_AM_ZCOPY]     = "am_zcopy",
+    [UCT_EP_OP_PUT_SHORT]    = "put_short",
+    [UCT_EP_OP_PUT_BCOPY]    = "put_bcopy",
+    [UCT_EP_OP_PUT_ZCOPY]    = "put_zcopy",
+    [UCT_EP_OP_GET_SHORT]    = "get_short",
+    [UCT_EP_OP_GET_BCOPY]    = "get_bcopy",
+    [UCT_EP_OP_GET_ZCOPY]    = "get_zcopy",
+    [UCT_EP_OP_EAGER_SHORT]  = "eager_short",
+    [UCT_EP_OP_EAGER_BCOPY]  = "eager_bcopy",
+    [UCT_EP_OP_EAGER_ZCOPY]  = "eager_zcopy",
+    [UCT_EP_OP_RNDV_ZCOPY]   = "rndv_zcopy",
+    [UCT_EP_OP_ATOMIC_POST]  = "atomic_post",
+    [UCT_EP_OP_ATOMIC_FETCH] = "atomic_fetch",
+    [UCT_EP_OP_LAST]         = NULL
+};
+
+
+static int ucp_proto_calib_parse_op(const char *str, uct_ep_operation_t *op_p)
+{
+    ssize_t index;
+
+    if (!strcmp(str, "*")) {
+        *op_p = UCT_EP_OP_LAST;
+        return 1;
+    }
+
+    index = ucs_string_find_in_list(str, ucp_proto_calib_op_names, 0);
+    if (index < 0) {
+        return 0;
+    }
+
+    *op_p = (uct_ep_operation_t)index;
+    return 1;
+}
+
+static int ucp_proto_calib_parse_sample(const char *str,
+                                        ucp_proto_calib_fit_t *fit)
+{
+    char size_str[64];
+    const char *delim;
+    size_t size;
+    double time;
+
+    delim = strchr(str, ':');
+    if ((delim == NULL) || ((delim - str) >= sizeof(size_str))) {
+        return 0;
+    }
+
+    ucs_strncpy_zero(size_str, str, delim - str + 1);
+    if (!ucs_config_sscanf_memunits(size_str, &size, NULL) ||
+        !ucs_config_sscanf_time(delim + 1, &time, NULL)) {
+        return 0;
+    }
+
+    ++fit->count;
+    fit->sum_x  += size;
+    fit->sum_y  += time;
+    fit->sum_xx += (double)size * size;
+    fit->sum_xy += size * time;
+    return 1;
+}
+
+static ucs_status_t
+ucp_proto_calib_apply_fit(const ucp_proto_calib_fit_t *fit,
+                          ucp_proto_calib_entry_t *entry)
+{
+    double denom, m, c;
+
+    if (fit->count == 0) {
+        return UCS_OK;
+    }
+
+    denom = (fit->count * fit->sum_xx) - (fit->sum_x * fit->sum_x);
+    if ((fit->count < 2) || (denom <= 0)) {
+        ucs_error("at least 2 samples of different sizes are required");
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    m = ((fit->count * fit->sum_xy) - (fit->sum_x * fit->sum_y)) / denom;
+    c = (fit->sum_y - (m * fit->sum_x)) / fit->count;
+
+    if (!(entry->field_mask & UCT_PERF_ATTR_FIELD_BANDWIDTH) && (m > 0)) {
+        entry->bandwidth   = 1.0 / m;
+        entry->field_mask |= UCT_PERF_ATTR_FIELD_BANDWIDTH;
+    }
+
+    if (!(entry->field_mask & UCT_PERF_ATTR_FIELD_LATENCY)) {
+        /* The measured time includes the overheads, which are accounted
+         * separately by the protocol performance model */
+        entry->latency     = ucs_max(c - entry->send_pre_overhead -
+                                     entry->send_post_overhead -
+                                     entry->recv_overhead, 0.0);
+        entry->field_mask |= UCT_PERF_ATTR_FIELD_LATENCY;
+    }
+
+    return UCS_OK;
+}
+
+static ucs_status_t
+ucp_proto_calib_parse_value(char *token, ucp_proto_calib_entry_t *entry,
+                            ucp_proto_calib_fit_t *fit)
+{
+    char *value;
+    int ret;
+
+    value = strchr(token, '=');
+    if (value == NULL) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    *(value++) = '\0';
+    if (!strcmp(token, "send_pre")) {
+        ret                = ucs_config_sscanf_time(value,
+                                                    &entry->send_pre_overhead,
+                                                    NULL);
+        entry->field_mask |= UCT_PERF_ATTR_FIELD_SEND_PRE_OVERHEAD;
+    } else if (!strcmp(token, "send_post")) {
+        ret                = ucs_config_sscanf_time(value,
+                                                    &entry->send_post_overhead,
+                                                    NULL);
+        entry->field_mask |= UCT_PERF_ATTR_FIELD_SEND_POST_OVERHEAD;
+    } else if (!strcmp(token, "recv")) {
+        ret                = ucs_config_sscanf_time(value, &entry->recv_overhead,
+                                                    NULL);
+        entry->field_mask |= UCT_PERF_ATTR_FIELD_RECV_OVERHEAD;
+    } else if (!strcmp(token, "lat")) {
+        ret                = ucs_config_sscanf_time(value, &entry->latency,
+                                                    NULL);
+        entry->field_mask |= UCT_PERF_ATTR_FIELD_LATENCY;
+    } else if (!strcmp(token, "bw")) {
+        ret                = ucs_config_sscanf_bw(value, &entry->bandwidth,
+                                                  NULL) &&
+                             (entry->bandwidth > 0) &&
+                             !UCS_CONFIG_DBL_IS_AUTO(entry->bandwidth);
+        entry->field_mask |= UCT_PERF_ATTR_FIELD_BANDWIDTH;
+    } else if (!strcmp(token, "sample")) {
+        ret = ucp_proto_calib_parse_sample(value, fit);
+    } else {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    return ret ? UCS_OK : UCS_ERR_INVALID_PARAM;
+}
+
+static ucs_status_t
+ucp_proto_calib_parse_line(char *line, ucp_proto_calib_entry_t *entry)
+{
+    ucp_proto_calib_fit_t fit = {0};
+    char *token, *saveptr;
+    ucs_status_t status;
+
+    memset(entry, 0, sizeof(*entry));
+
+    token = strtok_r(line, UCP_PROTO_CALIB_DELIMS, &saveptr);
+    if ((token == NULL) || (strchr(token, '/') == NULL)) {
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    entry->tl_pattern = ucs_strdup(token, "proto_calib_tl");
+    if (entry->tl_pattern == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    token = strtok_r(NULL, UCP_PROTO_CALIB_DELIMS, &saveptr);
+    if ((token == NULL) || !ucp_proto_calib_parse_op(token, &entry->op)) {
+        status = UCS_ERR_INVALID_PARAM;
+        goto err_free;
+    }
+
+    while ((token = strtok_r(NULL, UCP_PROTO_CALIB_DELIMS, &saveptr)) != NULL) {
+        status = ucp_proto_calib_parse_value(token, entry, &fit);
+        if (status != UCS_OK) {
+            goto err_free;
+        }
+    }
+
+    status = ucp_proto_calib_apply_fit(&fit, entry);
+    if (status != UCS_OK) {
+        goto err_free;
+    }
+
+    return UCS_OK;
+
+err_free:
+    ucs_free(entry->tl_pattern);
+    return status;
+}
+
+ucs_status_t
+ucp_proto_calib_load(const char *filename, ucp_proto_calib_array_t *calib)
+{
+    char line[UCP_PROTO_CALIB_LINE_MAX];
+    ucp_proto_calib_entry_t *entry;
+    unsigned line_num;
+    ucs_status_t status;
+    FILE *stream;
+    char *p;
+
+    ucs_array_init_dynamic(calib);
+
+    if (!strcmp(filename, "")) {
+        return UCS_OK;
+    }
+
+    stream = fopen(filename, "r");
+    if (stream == NULL) {
+        ucs_error("failed to open performance calibration file '%s': %m",
+                  filename);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    line_num = 0;
+    while (fgets(line, sizeof(line), stream) != NULL) {
+        ++line_num;
+
+        p = line + strspn(line, UCP_PROTO_CALIB_DELIMS);
+        if ((*p == '\0') || (*p == '#')) {
+            continue;
+        }
+
+        entry = ucs_array_append(calib, status = UCS_ERR_NO_MEMORY;
+                                 goto err_cleanup);
+        status = ucp_proto_calib_parse_line(p, entry);
+        if (status != UCS_OK) {
+            ucs_array_pop_back(calib);
+            ucs_error("%s:%u: invalid performance calibration entry",
+                      filename, line_num);
+            goto err_cleanup;
+        }
+
+        ucs_debug("%s:%u: calibrated %s %s field_mask 0x%" PRIx64, filename,
+                  line_num, entry->tl_pattern,
+                  (entry->op == UCT_EP_OP_LAST) ?
+                          "*" : ucp_proto_calib_op_names[entry->op],
+                  entry->field_mask);
+    }
+
+    fclose(stream);
+    return UCS_OK;
+
+err_cleanup:
+    fclose(stream);
+    ucp_proto_calib_cleanup(calib);
+    return status;
+}
+
+void ucp_proto_calib_cleanup(ucp_proto_calib_array_t *calib)
+{
+    ucp_proto_calib_entry_t *entry;
+
+    ucs_array_for_each(entry, calib) {
+        ucs_free(entry->tl_pattern);
+    }
+
+    ucs_array_cleanup_dynamic(calib);
+}
+
+void ucp_proto_calib_apply(ucp_context_h context, ucp_rsc_index_t rsc_index,
+                           uct_perf_attr_t *perf_attr)
+{
+    const uct_tl_resource_desc_t *tl_rsc = &context->tl_rscs[rsc_index].tl_rsc;
+    uint64_t field_mask                  = perf_attr->field_mask;
+    const ucp_proto_calib_entry_t *entry;
+    char tl_name[UCT_TL_NAME_MAX + UCT_DEVICE_NAME_MAX + 2];
+    uint64_t entry_mask;
+
+    if (ucs_array_is_empty(&context->proto_calib)) {
+        return;
+    }
+
+    ucs_snprintf_zero(tl_name, sizeof(tl_name), "%s/%s", tl_rsc->tl_name,
+                      tl_rsc->dev_name);
+
+    ucs_array_for_each(entry, &context->proto_calib) {
+        if ((entry->op != UCT_EP_OP_LAST) &&
+            (!(field_mask & UCT_PERF_ATTR_FIELD_OPERATION) ||
+             (entry->op != perf_attr->operation))) {
+            continue;
+        }
+
+        if (fnmatch(entry->tl_pattern, tl_name, 0) != 0) {
+            continue;
+        }
+
+        /* First matching entry of every field takes effect */
+        entry_mask  = entry->field_mask & field_mask;
+        field_mask &= ~entry_mask;
+
+        if (entry_mask & UCT_PERF_ATTR_FIELD_SEND_PRE_OVERHEAD) {
+            perf_attr->send_pre_overhead = entry->send_pre_overhead;
+        }
+
+        if (entry_mask & UCT_PERF_ATTR_FIELD_SEND_POST_OVERHEAD) {
+            perf_attr->send_post_overhead = entry->send_post_overhead;
+        }
+
+        if (entry_mask & UCT_PERF_ATTR_FIELD_RECV_OVERHEAD) {
+            perf_attr->recv_overhead = entry->recv_overhead;
+        }
+
+        if (entry_mask & UCT_PERF_ATTR_FIELD_LATENCY) {
+            perf_attr->latency.c = entry->latency;
+        }
+
+        if (entry_mask & UCT_PERF_ATTR_FIELD_BANDWIDTH) {
+            perf_attr->bandwidth.dedicated = entry->bandwidth;
+            perf_attr->bandwidth.shared    = 0;
+        }
+
+        if (entry_mask != 0) {
+            ucs_trace("%s: applied calibration %s field_mask 0x%" PRIx64,
+                      tl_name, entry->tl_pattern, entry_mask);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2023. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifndef UCP_PROTO_CALIB_H_
+#define UCP_PROTO_CALIB_H_
+
+#include <ucp/core/ucp_types.h>
+#include <uct/api/v2/uct_v2.h>
+#include <ucs/datastruct/array.h>
+
+
+/*
+ * Calibrated performance model for protocol selection.
+ *
+ * The transport performance estimations reported by UCT are static per-device
+ * numbers, which can be off by a large factor on a given system. A calibration
+ * file allows overriding them with values measured on the actual system (for
+ * example, by ucx_perftest). Every non-empty line which does not start with
+ * '#' has the format:
+ *
+ *   <tl>/<dev> <op> [key=value]...
+ *
+ * - <tl>/<dev> is a shell wildcard pattern matched against the transport and
+ *   device names, for example "rc_mlx5/mlx5_0:1" or "tcp/eth*".
+ * - <op> is the UCT operation name (am_short, am_bcopy, am_zcopy, put_short,
+ *   put_bcopy, put_zcopy, get_short, get_bcopy, get_zcopy, eager_short,
+ *   eager_bcopy, eager_zcopy, rndv_zcopy, atomic_post, atomic_fetch), or "*"
+ *   to match any operation.
+ * - Supported keys are:
+ *     send_pre=<time>   Overhead of posting the operation on the sender.
+ *     send_post=<time>  Overhead of completing the operation on the sender.
+ *     recv=<time>       Overhead of receiving the operation.
+ *     lat=<time>        Wire latency.
+ *     bw=<bandwidth>    Bandwidth, for example 12.5GBs.
+ *     sample=<size>:<time>
+ *                       Measured time of a single operation of a given size.
+ *                       When two or more samples are given, latency and
+ *                       bandwidth are derived from a least-squares linear fit
+ *                       of the samples, unless set explicitly by "lat"/"bw".
+ *
+ * When several lines match the same transport and operation, the first match
+ * of every key takes effect.
+ */
+
+
+/* Calibrated performance of a transport operation */
+typedef struct {
+    char               *tl_pattern;         /* Transport/device pattern */
+    uct_ep_operation_t op;                  /* Operation, UCT_EP_OP_LAST - any */
+    uint64_t           field_mask;          /* Calibrated UCT_PERF_ATTR_FIELD_xx */
+    double             send_pre_overhead;   /* Sender posting overhead */
+    double             send_post_overhead;  /* Sender completion overhead */
+    double             recv_overhead;       /* Receiver overhead */
+    double             latency;             /* Latency of a zero-size message */
+    double             bandwidth;           /* Dedicated bandwidth */
+} ucp_proto_calib_entry_t;
+
+
+UCS_ARRAY_DECLARE_TYPE(ucp_proto_calib_array_t, unsigned,
+                       ucp_proto_calib_entry_t);
+
+
+/**
+ * Load performance calibration entries from a file.
+ *
+ * @param [in]  filename  Calibration file path. If empty, no entries are
+ *                        loaded.
+ * @param [out] calib     Array to fill with calibration entries.
+ *
+ * @return UCS_OK if the file was loaded successfully, or an error code if the
+ *         file could not be read or contains a malformed line.
+ */
+ucs_status_t
+ucp_proto_calib_load(const char *filename, ucp_proto_calib_array_t *calib);
+
+
+/**
+ * Release calibration entries loaded by @ref ucp_proto_calib_load.
+ *
+ * @param [in]  calib     Calibration entries to release.
+ */
+void ucp_proto_calib_cleanup(ucp_proto_calib_array_t *calib);
+
+
+/**
+ * Override transport performance estimation by calibrated values.
+ *
+ * @param [in]    context    UCP context holding the calibration entries.
+ * @param [in]    rsc_index  Transport resource index.
+ * @param [inout] perf_attr  Performance estimation to update. Only the fields
+ *                           requested by perf_attr->field_mask are updated.
+ */
+void ucp_proto_calib_apply(ucp_context_h context, ucp_rsc_index_t rsc_index,
+                           uct_perf_attr_t *perf_attr);
+
+#endif
@@ -166,7 +166,8 @@ ucp_proto_request_set_stage(ucp_request_t *req, uint8_t proto_stage)
     ucs_assert(proto->progress[proto_stage] != NULL);
 
     ucp_trace_req(req, "set to stage %u, progress function '%s'", proto_stage,
-                  ucs_debug_get_symbol_name(proto->progress[proto_stage]));
+                  ucs_debug_get_symbol_name(
+                          (void*)proto->progress[proto_stage]));
     req->send.proto_stage = proto_stage;
 
     /* Set pointer to progress function */
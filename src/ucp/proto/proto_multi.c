@@ -131,6 +131,7 @@ ucs_status_t ucp_proto_multi_init(const ucp_proto_multi_init_params_t *params,
     mpriv->reg_md_map   = reg_md_map | params->initial_reg_md_map;
     mpriv->lane_map     = lane_map;
     mpriv->num_lanes    = 0;
+    mpriv->adaptive     = 0;
     mpriv->min_frag     = 0;
     mpriv->max_frag_sum = 0;
     mpriv->align_thresh = 1;
@@ -314,6 +315,24 @@ void ucp_proto_multi_query_config(const ucp_proto_query_params_t *params,
     attr->lane_map = mpriv->lane_map;
 }
 
+void ucp_proto_multi_lane_account(ucp_ep_h ep, ucp_lane_index_t lane,
+                                  size_t length, int stalled)
+{
+    ucp_ep_lane_stats_t *lane_stats = ucp_ep_lane_stats_get(ep);
+
+    if (lane_stats == NULL) {
+        return;
+    }
+
+    ucs_assert(lane < UCP_MAX_LANES);
+    if (stalled) {
+        ++lane_stats[lane].stalls;
+    } else {
+        lane_stats[lane].bytes += length;
+        ++lane_stats[lane].frags;
+    }
+}
+
 void ucp_proto_multi_query(const ucp_proto_query_params_t *params,
                            ucp_proto_query_attr_t *attr)
 {
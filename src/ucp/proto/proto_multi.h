@@ -63,6 +63,9 @@ typedef struct {
     size_t                      max_frag_sum; /* 'max_frag' sum of all lanes */
     ucp_lane_map_t              lane_map;     /* Map of used lanes */
     ucp_lane_index_t            num_lanes;    /* Number of lanes to use */
+    uint8_t                     adaptive;     /* Skip lanes which are out of
+                                                 resources, and let the other
+                                                 lanes send their share */
     size_t                      align_thresh; /* Cached value of threshold for
                                                  enabling data split alignment */
     ucp_proto_multi_lane_priv_t lanes[0];     /* Array of lanes */
@@ -125,6 +128,10 @@ typedef ucs_status_t (*ucp_proto_multi_lane_send_func_t)(ucp_request_t *req,
                                                          ucp_lane_index_t lane);
 
 
+void ucp_proto_multi_lane_account(ucp_ep_h ep, ucp_lane_index_t lane,
+                                  size_t length, int stalled);
+
+
 ucs_status_t ucp_proto_multi_init(const ucp_proto_multi_init_params_t *params,
                                   ucp_proto_multi_priv_t *mpriv,
                                   size_t *priv_size_p);
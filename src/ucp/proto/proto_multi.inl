@@ -107,9 +107,11 @@ ucp_proto_multi_no_resource(ucp_request_t *req, ucp_lane_index_t lane)
         return UCS_ERR_NO_RESOURCE;
     }
 
-    /* failed to send on another lane - add to its pending queue */
+    /* failed to send on another lane - add to its pending queue. A request
+     * which is striped over several lanes is a bulk transfer, so let other
+     * endpoints' pending requests go first */
     uct_ep = ucp_ep_get_lane(req->send.ep, lane);
-    status = uct_ep_pending_add(uct_ep, &req->send.uct, 0);
+    status = uct_ep_pending_add(uct_ep, &req->send.uct, UCT_CB_FLAG_PRIO_BULK);
     if (status == UCS_ERR_BUSY) {
         /* try sending again */
         return UCS_INPROGRESS;
@@ -160,21 +162,32 @@ ucp_proto_multi_progress(ucp_request_t *req,
                          ucp_proto_complete_cb_t complete_func,
                          unsigned dt_mask)
 {
-    ucp_lane_index_t lane_shift = 1;
+    ucp_lane_index_t lane_shift  = 1;
+    ucp_lane_index_t num_skipped = 0;
     const ucp_proto_multi_lane_priv_t *lpriv;
     ucp_datatype_iter_t next_iter;
-    ucp_lane_index_t lane_idx;
     ucs_status_t status;
 
     ucs_assertv(req->send.multi_lane_idx < mpriv->num_lanes,
                 "lane_idx=%d num_lanes=%d", req->send.multi_lane_idx,
                 mpriv->num_lanes);
 
-    lane_idx = req->send.multi_lane_idx;
-    lpriv    = &mpriv->lanes[lane_idx];
+    for (;;) {
+        lpriv = &mpriv->lanes[req->send.multi_lane_idx];
+
+        /* send the next fragment */
+        status = send_func(req, lpriv, &next_iter, &lane_shift);
+        if (ucs_likely(status != UCS_ERR_NO_RESOURCE) || !mpriv->adaptive ||
+            (++num_skipped >= mpriv->num_lanes)) {
+            break;
+        }
+
+        /* the lane is congested, let the next lane send this fragment */
+        ucp_proto_multi_lane_account(req->send.ep, lpriv->super.lane, 0, 1);
+        ucp_proto_multi_advance_lane_idx(req, mpriv->num_lanes, 1);
+        lane_shift = 1;
+    }
 
-    /* send the next fragment */
-    status = send_func(req, lpriv, &next_iter, &lane_shift);
     if (ucs_likely(status == UCS_OK)) {
         /* fast path is OK */
     } else if (status == UCS_INPROGRESS) {
@@ -185,6 +198,12 @@ ucp_proto_multi_progress(ucp_request_t *req,
                                                  status);
     }
 
+    if (mpriv->adaptive) {
+        ucp_proto_multi_lane_account(req->send.ep, lpriv->super.lane,
+                                     next_iter.offset -
+                                     req->send.state.dt_iter.offset, 0);
+    }
+
     /* advance position in send buffer */
     ucp_datatype_iter_copy_position(&req->send.state.dt_iter, &next_iter,
                                     dt_mask);
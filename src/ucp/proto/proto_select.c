@@ -678,8 +678,13 @@ ucp_proto_select_elem_cleanup(ucp_proto_select_elem_t *select_elem)
 
 static void ucp_proto_select_cache_reset(ucp_proto_select_t *proto_select)
 {
-    proto_select->cache.key   = UINT64_MAX;
-    proto_select->cache.value = NULL;
+    ucp_proto_select_cache_entry_t *entry;
+
+    ucs_carray_for_each(entry, proto_select->cache.entries,
+                        UCP_PROTO_SELECT_CACHE_SIZE) {
+        entry->key   = UINT64_MAX;
+        entry->value = NULL;
+    }
 }
 
 ucp_proto_select_elem_t *
@@ -39,6 +39,11 @@
 #define UCP_PROTO_SELECT_PARAM_STR_MAX 128
 
 
+/* Number of entries in the direct-mapped lookup cache, as a power of 2 */
+#define UCP_PROTO_SELECT_CACHE_BITS    3
+#define UCP_PROTO_SELECT_CACHE_SIZE    UCS_BIT(UCP_PROTO_SELECT_CACHE_BITS)
+
+
 /**
  * Key for looking up protocol configuration by operation parameters
  */
@@ -123,6 +128,16 @@ typedef struct {
 KHASH_TYPE(ucp_proto_select_hash, khint64_t, ucp_proto_select_elem_t)
 
 
+/**
+ * Entry of the protocol selection lookup cache
+ */
+typedef struct {
+    uint64_t                      key;   /* Packed selection parameters */
+    const ucp_proto_select_elem_t *value; /* Protocol selection, NULL if the
+                                             entry is not used */
+} ucp_proto_select_cache_entry_t;
+
+
 /**
  * Top-level data structure to select protocols for various buffer types
  */
@@ -130,10 +145,11 @@ typedef struct {
     /* Lookup from protocol selection key to thresholds array */
     khash_t(ucp_proto_select_hash)    *hash;
 
-    /* cache the last used protocol, for fast lookup */
+    /* Direct-mapped cache of recently used protocol selections, indexed by a
+     * hash of the selection key, to avoid hash lookups when several operation
+     * types are used in turn */
     struct {
-        uint64_t                      key;
-        const ucp_proto_select_elem_t *value;
+        ucp_proto_select_cache_entry_t entries[UCP_PROTO_SELECT_CACHE_SIZE];
     } cache;
 } ucp_proto_select_t;
 
@@ -92,6 +92,14 @@ ucp_proto_select_op_flags(const ucp_proto_select_param_t *select_param)
     return select_param->op_id_flags & ~(UCP_PROTO_SELECT_OP_FLAGS_BASE - 1);
 }
 
+static UCS_F_ALWAYS_INLINE ucp_proto_select_cache_entry_t *
+ucp_proto_select_cache_entry(ucp_proto_select_t *proto_select, uint64_t key)
+{
+    /* Multiplicative hashing, so the index depends on all fields of the key */
+    return &proto_select->cache.entries[(key * 0x9e3779b97f4a7c15ul) >>
+                                        (64 - UCP_PROTO_SELECT_CACHE_BITS)];
+}
+
 static UCS_F_ALWAYS_INLINE const ucp_proto_threshold_elem_t*
 ucp_proto_select_lookup(ucp_worker_h worker, ucp_proto_select_t *proto_select,
                         ucp_worker_cfg_index_t ep_cfg_index,
@@ -100,15 +108,21 @@ ucp_proto_select_lookup(ucp_worker_h worker, ucp_proto_select_t *proto_select,
                         size_t msg_length)
 {
     const ucp_proto_select_elem_t *select_elem;
+    ucp_proto_select_cache_entry_t *cache_entry;
     ucp_proto_select_key_t key;
     khiter_t khiter;
 
     UCS_STATIC_ASSERT(sizeof(key.param) == sizeof(key.u64));
-    key.param = *select_param;
+    key.param   = *select_param;
+    cache_entry = ucp_proto_select_cache_entry(proto_select, key.u64);
 
-    if (ucs_likely(proto_select->cache.key == key.u64)) {
-        select_elem = proto_select->cache.value;
+    if (ucs_likely(cache_entry->key == key.u64)) {
+        select_elem = cache_entry->value;
+        UCS_STATS_UPDATE_COUNTER(worker->stats,
+                                 UCP_WORKER_STAT_PROTO_SELECT_CACHE_HITS, 1);
     } else {
+        UCS_STATS_UPDATE_COUNTER(worker->stats,
+                                 UCP_WORKER_STAT_PROTO_SELECT_CACHE_MISSES, 1);
         khiter = kh_get(ucp_proto_select_hash, proto_select->hash, key.u64);
         if (ucs_likely(khiter != kh_end(proto_select->hash))) {
             /* key was found in hash - select by message size */
@@ -121,10 +135,13 @@ ucp_proto_select_lookup(ucp_worker_h worker, ucp_proto_select_t *proto_select,
             if (ucs_unlikely(select_elem == NULL)) {
                 return NULL;
             }
+
+            /* The slow path may have reset the cache */
+            cache_entry = ucp_proto_select_cache_entry(proto_select, key.u64);
         }
 
-        proto_select->cache.key   = key.u64;
-        proto_select->cache.value = select_elem;
+        cache_entry->key   = key.u64;
+        cache_entry->value = select_elem;
     }
 
     return ucp_proto_select_thresholds_search(select_elem, msg_length);
@@ -213,6 +213,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_atomic_op_nbx,
                             UCP_ATOMIC_OP_LAST,
                             return UCS_STATUS_PTR(UCS_ERR_INVALID_PARAM));
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+    ucp_ep_usage_touch(ep);
 
     ucs_trace_req("atomic_op_nbx opcode %d buffer %p result %p "
                   "datatype 0x%" PRIx64 " remote_addr 0x%" PRIx64
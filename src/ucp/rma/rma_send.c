@@ -219,6 +219,7 @@ ucs_status_ptr_t ucp_put_nbx(ucp_ep_h ep, const void *buffer, size_t count,
     UCP_REQUEST_CHECK_PARAM(param);
     UCP_RMA_CHECK_PTR(worker->context, buffer, count);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+    ucp_ep_usage_touch(ep);
 
     ucs_trace_req("put_nbx buffer %p count %zu remote_addr %" PRIx64
                   " rkey %p to %s cb %p",
@@ -368,6 +369,7 @@ ucs_status_ptr_t ucp_get_nbx(ucp_ep_h ep, void *buffer, size_t count,
     UCP_REQUEST_CHECK_PARAM(param);
     UCP_RMA_CHECK_PTR(worker->context, buffer, count);
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+    ucp_ep_usage_touch(ep);
 
     ucs_trace_req("get_nbx buffer %p count %zu remote_addr %" PRIx64
                   " rkey %p from %s cb %p",
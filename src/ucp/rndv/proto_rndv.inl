@@ -246,7 +246,18 @@ ucp_proto_rndv_bulk_max_payload(ucp_request_t *req,
     size_t lane_offset, max_payload, scaled_length;
     size_t min_rndv_chunk_size;
 
-    if (ucs_likely(total_length < max_frag_sum)) {
+    if (rpriv->mpriv.adaptive) {
+        /**
+         * Fragments may be sent on any lane, so the fragment size depends only
+         * on the lane weight and not on the current position
+         */
+        min_rndv_chunk_size =
+                req->send.ep->worker->context->config.ext.min_rndv_chunk_size;
+        scaled_length = ucp_proto_multi_scaled_length(lpriv->weight,
+                                                      total_length);
+        max_payload   = ucs_min(ucs_max(min_rndv_chunk_size, scaled_length),
+                                lpriv->max_frag);
+    } else if (ucs_likely(total_length < max_frag_sum)) {
         /**
          * Each lane sends less than its maximal fragment size but more than the
          * minimal chunk size
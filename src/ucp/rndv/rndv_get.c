@@ -357,3 +357,92 @@ ucp_proto_t ucp_rndv_get_mtype_proto = {
     .abort    = ucp_proto_abort_fatal_not_implemented,
     .reset    = ucp_proto_rndv_get_mtype_reset
 };
+
+static void
+ucp_proto_rndv_get_stage_fetch_completion(uct_completion_t *uct_comp)
+{
+    ucp_request_t *req = ucs_container_of(uct_comp, ucp_request_t,
+                                          send.state.uct_comp);
+    ucp_request_t *rreq;
+    ucs_status_t status;
+
+    status = ucp_proto_rndv_stage_unpack(req);
+    if (ucs_unlikely(status != UCS_OK)) {
+        rreq         = ucp_request_get_super(ucp_request_get_super(req));
+        rreq->status = status;
+    }
+
+    ucs_mpool_put_inline(req->send.rndv.mdesc);
+    ucp_proto_rndv_ppln_recv_frag_complete(req, 1, 0);
+}
+
+static ucs_status_t
+ucp_proto_rndv_get_stage_fetch_progress(uct_pending_req_t *uct_req)
+{
+    ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
+    const ucp_proto_rndv_bulk_priv_t *rpriv;
+    ucs_status_t status;
+
+    if (!(req->flags & UCP_REQUEST_FLAG_PROTO_INITIALIZED)) {
+        status = ucp_proto_rndv_mtype_request_init(req);
+        if (status != UCS_OK) {
+            ucp_proto_request_abort(req, status);
+            return UCS_OK;
+        }
+
+        ucp_proto_rndv_get_common_request_init(req);
+        ucp_proto_completion_init(&req->send.state.uct_comp,
+                                  ucp_proto_rndv_get_stage_fetch_completion);
+        req->flags |= UCP_REQUEST_FLAG_PROTO_INITIALIZED;
+    }
+
+    /* coverity[tainted_data_downcast] */
+    rpriv = req->send.proto_config->priv;
+    return ucp_proto_multi_progress(req, &rpriv->mpriv,
+                                    ucp_proto_rndv_get_mtype_send_func,
+                                    ucp_request_invoke_uct_completion_success,
+                                    UCS_BIT(UCP_DATATYPE_CONTIG));
+}
+
+static ucs_status_t
+ucp_proto_rndv_get_stage_init(const ucp_proto_init_params_t *init_params)
+{
+    ucp_proto_init_params_t stage_init_params;
+    ucp_proto_select_param_t stage_select_param;
+    ucp_md_map_t mdesc_md_map;
+    ucs_status_t status;
+    size_t frag_size;
+
+    status = ucp_proto_rndv_stage_init(init_params, &stage_select_param,
+                                       &stage_init_params, &mdesc_md_map,
+                                       &frag_size);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    return ucp_proto_rndv_get_common_init(&stage_init_params,
+                                          UCS_BIT(UCP_RNDV_MODE_GET_PIPELINE),
+                                          frag_size, UCT_EP_OP_LAST, 0,
+                                          mdesc_md_map, 1);
+}
+
+static void
+ucp_proto_rndv_get_stage_query(const ucp_proto_query_params_t *params,
+                               ucp_proto_query_attr_t *attr)
+{
+    ucp_proto_rndv_bulk_query(params, attr);
+    ucp_proto_rndv_stage_query_desc(attr, UCP_PROTO_RNDV_GET_DESC);
+}
+
+ucp_proto_t ucp_rndv_get_stage_proto = {
+    .name     = "rndv/get/stage",
+    .desc     = NULL,
+    .flags    = 0,
+    .init     = ucp_proto_rndv_get_stage_init,
+    .query    = ucp_proto_rndv_get_stage_query,
+    .progress = {
+        [UCP_PROTO_RNDV_GET_STAGE_FETCH] = ucp_proto_rndv_get_stage_fetch_progress,
+    },
+    .abort    = ucp_proto_abort_fatal_not_implemented,
+    .reset    = ucp_proto_rndv_get_mtype_reset
+};
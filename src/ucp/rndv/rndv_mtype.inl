@@ -164,4 +164,125 @@ ucp_proto_rndv_mtype_query_desc(const ucp_proto_query_params_t *params,
     }
 }
 
+static UCS_F_ALWAYS_INLINE int
+ucp_proto_rndv_stage_is_supported(const ucp_proto_select_param_t *select_param)
+{
+    return ((select_param->dt_class == UCP_DATATYPE_IOV) ||
+            (select_param->dt_class == UCP_DATATYPE_GENERIC)) &&
+           UCP_MEM_IS_HOST(select_param->mem_type);
+}
+
+/*
+ * Initialize a pipeline fragment protocol which stages non-contiguous host
+ * data through a contiguous bounce buffer. The fragment is packed from (or
+ * unpacked to) the user buffer, so the transport protocol is initialized for
+ * contiguous data.
+ */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_proto_rndv_stage_init(const ucp_proto_init_params_t *init_params,
+                          ucp_proto_select_param_t *stage_select_param,
+                          ucp_proto_init_params_t *stage_init_params,
+                          ucp_md_map_t *mdesc_md_map_p, size_t *frag_size_p)
+{
+    ucp_context_h context = init_params->worker->context;
+
+    if (!ucp_proto_rndv_stage_is_supported(init_params->select_param) ||
+        !ucp_proto_rndv_init_params_is_ppln_frag(init_params) ||
+        !ucp_proto_init_check_op(init_params, UCP_PROTO_RNDV_OP_ID_MASK)) {
+        return UCS_ERR_UNSUPPORTED;
+    }
+
+    *stage_select_param             = *init_params->select_param;
+    stage_select_param->dt_class    = UCP_DATATYPE_CONTIG;
+    stage_select_param->sg_count    = 1;
+    *stage_init_params              = *init_params;
+    stage_init_params->select_param = stage_select_param;
+
+    *mdesc_md_map_p = context->reg_md_map[UCS_MEMORY_TYPE_HOST];
+    *frag_size_p    = context->config.ext.rndv_frag_size[UCS_MEMORY_TYPE_HOST];
+    return UCS_OK;
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_rndv_stage_seek(ucp_datatype_iter_t *dt_iter, size_t offset)
+{
+    if (dt_iter->dt_class != UCP_DATATYPE_IOV) {
+        dt_iter->offset = offset;
+    } else if (offset == dt_iter->length) {
+        /* The end of the data is past the last iov element */
+        dt_iter->offset              = offset;
+        dt_iter->type.iov.iov_index  = dt_iter->type.iov.iov_count;
+        dt_iter->type.iov.iov_offset = 0;
+    } else if (offset != dt_iter->offset) {
+        ucp_datatype_iter_iov_seek_always(dt_iter, offset);
+    }
+}
+
+/*
+ * Initialize the datatype of a staged fragment: the data resides in the
+ * bounce buffer, which is attached when the fragment starts.
+ */
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_rndv_stage_next_slice(const ucp_datatype_iter_t *dt_iter,
+                                size_t max_length,
+                                ucp_datatype_iter_t *frag_dt_iter,
+                                ucp_datatype_iter_t *next_iter)
+{
+    frag_dt_iter->dt_class           = UCP_DATATYPE_CONTIG;
+    frag_dt_iter->mem_info           = dt_iter->mem_info;
+    frag_dt_iter->length             = ucp_datatype_iter_next(dt_iter,
+                                                              max_length,
+                                                              next_iter);
+    frag_dt_iter->offset             = 0;
+    frag_dt_iter->type.contig.buffer = NULL;
+    frag_dt_iter->type.contig.memh   = NULL;
+}
+
+/* Offset of the fragment 'freq' within the data of its parent request */
+static UCS_F_ALWAYS_INLINE size_t
+ucp_proto_rndv_stage_offset(ucp_request_t *freq, ucp_request_t *req)
+{
+    return freq->send.rndv.offset - req->send.rndv.offset;
+}
+
+/* Pack the fragment data from the user buffer to the bounce buffer */
+static UCS_F_ALWAYS_INLINE void ucp_proto_rndv_stage_pack(ucp_request_t *freq)
+{
+    ucp_request_t *req = ucp_request_get_super(freq);
+    ucp_datatype_iter_t dt_iter, next_iter;
+    size_t UCS_V_UNUSED packed_length;
+
+    /* Use a copy, since the parent iterator is advanced by the pipeline */
+    dt_iter = req->send.state.dt_iter;
+    ucp_proto_rndv_stage_seek(&dt_iter, ucp_proto_rndv_stage_offset(freq, req));
+    packed_length = ucp_datatype_iter_next_pack(&dt_iter, freq->send.ep->worker,
+                                                freq->send.state.dt_iter.length,
+                                                &next_iter,
+                                                freq->send.rndv.mdesc->ptr);
+    ucs_assertv(packed_length == freq->send.state.dt_iter.length,
+                "freq=%p packed_length=%zu length=%zu", freq, packed_length,
+                freq->send.state.dt_iter.length);
+}
+
+/* Unpack the fragment data from the bounce buffer to the user buffer */
+static UCS_F_ALWAYS_INLINE ucs_status_t
+ucp_proto_rndv_stage_unpack(ucp_request_t *freq)
+{
+    ucp_request_t *req = ucp_request_get_super(freq);
+    ucp_datatype_iter_t dt_iter;
+
+    dt_iter = req->send.state.dt_iter;
+    return ucp_datatype_iter_unpack(&dt_iter, freq->send.ep->worker,
+                                    freq->send.state.dt_iter.length,
+                                    ucp_proto_rndv_stage_offset(freq, req),
+                                    freq->send.rndv.mdesc->ptr);
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucp_proto_rndv_stage_query_desc(ucp_proto_query_attr_t *attr,
+                                const char *xfer_desc)
+{
+    ucs_snprintf_safe(attr->desc, sizeof(attr->desc), "staged %s", xfer_desc);
+}
+
 #endif
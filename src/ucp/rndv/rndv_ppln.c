@@ -8,6 +8,7 @@
 #endif
 
 #include "proto_rndv.inl"
+#include "rndv_mtype.inl"
 
 #include <ucp/core/ucp_request.inl>
 #include <ucp/proto/proto_debug.h>
@@ -56,7 +57,9 @@ ucp_proto_rndv_ppln_init(const ucp_proto_init_params_t *init_params)
     char frag_size_str[32];
     ucs_status_t status;
 
-    if ((select_param->dt_class != UCP_DATATYPE_CONTIG) ||
+    /* Non-contiguous fragments are staged by the fragment protocol */
+    if (((select_param->dt_class != UCP_DATATYPE_CONTIG) &&
+         !ucp_proto_rndv_stage_is_supported(select_param)) ||
         !ucp_proto_init_check_op(init_params, UCP_PROTO_RNDV_OP_ID_MASK) ||
         !ucp_proto_common_init_check_err_handling(&err_params) ||
         ucp_proto_rndv_init_params_is_ppln_frag(init_params)) {
@@ -117,6 +120,13 @@ ucp_proto_rndv_ppln_init(const ucp_proto_init_params_t *init_params)
     /* Add ATS overhead */
     ppln_overhead = ucs_linear_func_make(frag_overhead,
                                          frag_overhead / frag_max_length);
+
+    /* Add unpack time of staged fragments, which is not accounted by the
+     * fragment protocol since it receives to a registered bounce buffer */
+    if ((select_param->dt_class != UCP_DATATYPE_CONTIG) &&
+        (ucp_proto_select_op_id(select_param) == UCP_OP_ID_RNDV_RECV)) {
+        ppln_overhead.m += 1.0 / worker->context->config.ext.bcopy_bw;
+    }
     status = ucp_proto_rndv_ack_init(init_params, UCP_PROTO_RNDV_ATS_NAME,
                                      &ppln_caps, ppln_overhead, &rpriv->ack, 0);
 
@@ -196,8 +206,8 @@ static ucs_status_t ucp_proto_rndv_recv_ppln_reset(ucp_request_t *req)
         return UCS_OK;
     }
 
-    req->status                    = UCS_OK;
-    req->send.state.dt_iter.offset = 0;
+    req->status = UCS_OK;
+    ucp_datatype_iter_rewind(&req->send.state.dt_iter, UCP_DT_MASK_ALL);
     ucp_proto_request_restart(req);
     return UCS_OK;
 }
@@ -248,9 +258,17 @@ static ucs_status_t ucp_proto_rndv_ppln_progress(uct_pending_req_t *uct_req)
         }
 
         /* Initialize datatype for the fragment */
-        ucp_datatype_iter_next_slice(&req->send.state.dt_iter, rpriv->frag_size,
-                                     &freq->send.state.dt_iter, &next_iter,
-                                     &sg_count);
+        if (req->send.state.dt_iter.dt_class == UCP_DATATYPE_CONTIG) {
+            ucp_datatype_iter_next_slice(&req->send.state.dt_iter,
+                                         rpriv->frag_size,
+                                         &freq->send.state.dt_iter, &next_iter,
+                                         &sg_count);
+        } else {
+            ucp_proto_rndv_stage_next_slice(&req->send.state.dt_iter,
+                                            rpriv->frag_size,
+                                            &freq->send.state.dt_iter,
+                                            &next_iter);
+        }
 
         /* Empty fragments should not happen */
         ucs_assert(freq->send.state.dt_iter.length > 0);
@@ -269,8 +287,16 @@ static ucs_status_t ucp_proto_rndv_ppln_progress(uct_pending_req_t *uct_req)
                       freq->send.rndv.offset, freq->send.state.dt_iter.length);
         UCS_PROFILE_CALL_VOID_ALWAYS(ucp_request_send, freq);
 
-        ucp_datatype_iter_copy_position(&req->send.state.dt_iter, &next_iter,
-                                        UCS_BIT(UCP_DATATYPE_CONTIG));
+        if (req->send.state.dt_iter.dt_class == UCP_DATATYPE_CONTIG) {
+            ucp_datatype_iter_copy_position(&req->send.state.dt_iter,
+                                            &next_iter,
+                                            UCS_BIT(UCP_DATATYPE_CONTIG));
+        } else {
+            /* Keep the cached iov position, used by staged fragments to seek
+             * in the user buffer */
+            ucp_proto_rndv_stage_seek(&req->send.state.dt_iter,
+                                      next_iter.offset);
+        }
     }
 
     return UCS_OK;
@@ -301,9 +327,11 @@ ucp_proto_rndv_send_ppln_atp_progress(uct_pending_req_t *uct_req)
     ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
     const ucp_proto_rndv_ppln_priv_t *rpriv = req->send.proto_config->priv;
 
+    /* The datatype iterator was already released when the last fragment
+     * completed, and a generic datatype must not be finished twice */
     return ucp_proto_rndv_ack_progress(req, &rpriv->ack, UCP_AM_ID_RNDV_ATP,
                                        ucp_proto_rndv_ppln_pack_ack,
-                                       ucp_proto_request_zcopy_complete_success);
+                                       ucp_proto_request_complete_success);
 }
 
 ucp_proto_t ucp_rndv_send_ppln_proto = {
@@ -582,3 +582,77 @@ ucp_proto_t ucp_rndv_put_mtype_proto = {
     .abort    = ucp_proto_abort_fatal_not_implemented,
     .reset    = (ucp_request_reset_func_t)ucp_proto_reset_fatal_not_implemented
 };
+
+static ucs_status_t
+ucp_proto_rndv_put_stage_pack_progress(uct_pending_req_t *uct_req)
+{
+    ucp_request_t *req = ucs_container_of(uct_req, ucp_request_t, send.uct);
+    const ucp_proto_rndv_put_priv_t *rpriv;
+    ucs_status_t status;
+
+    ucs_assert(!(req->flags & UCP_REQUEST_FLAG_PROTO_INITIALIZED));
+
+    status = ucp_proto_rndv_mtype_request_init(req);
+    if (status != UCS_OK) {
+        ucp_proto_request_abort(req, status);
+        return UCS_OK;
+    }
+
+    ucp_proto_rndv_put_common_request_init(req);
+    req->flags |= UCP_REQUEST_FLAG_PROTO_INITIALIZED;
+    ucp_proto_rndv_stage_pack(req);
+
+    rpriv = req->send.proto_config->priv;
+    ucp_proto_completion_init(&req->send.state.uct_comp, rpriv->put_comp_cb);
+    ucp_proto_request_set_stage(req, UCP_PROTO_RNDV_PUT_MTYPE_STAGE_SEND);
+    return ucp_proto_rndv_put_mtype_send_progress(uct_req);
+}
+
+static ucs_status_t
+ucp_proto_rndv_put_stage_init(const ucp_proto_init_params_t *init_params)
+{
+    ucp_proto_init_params_t stage_init_params;
+    ucp_proto_select_param_t stage_select_param;
+    ucp_md_map_t mdesc_md_map;
+    ucs_status_t status;
+    size_t frag_size;
+
+    status = ucp_proto_rndv_stage_init(init_params, &stage_select_param,
+                                       &stage_init_params, &mdesc_md_map,
+                                       &frag_size);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    return ucp_proto_rndv_put_common_init(&stage_init_params,
+                                          UCS_BIT(UCP_RNDV_MODE_PUT_PIPELINE),
+                                          frag_size, UCT_EP_OP_LAST, 0,
+                                          mdesc_md_map,
+                                          ucp_proto_rndv_put_mtype_frag_completion,
+                                          1);
+}
+
+static void
+ucp_proto_rndv_put_stage_query(const ucp_proto_query_params_t *params,
+                               ucp_proto_query_attr_t *attr)
+{
+    ucp_proto_rndv_stage_query_desc(attr, ucp_proto_rndv_put_common_query(
+                                                  params, attr));
+}
+
+ucp_proto_t ucp_rndv_put_stage_proto = {
+    .name     = "rndv/put/stage",
+    .desc     = NULL,
+    .flags    = 0,
+    .init     = ucp_proto_rndv_put_stage_init,
+    .query    = ucp_proto_rndv_put_stage_query,
+    .progress = {
+        [UCP_PROTO_RNDV_PUT_MTYPE_STAGE_COPY] = ucp_proto_rndv_put_stage_pack_progress,
+        [UCP_PROTO_RNDV_PUT_MTYPE_STAGE_SEND] = ucp_proto_rndv_put_mtype_send_progress,
+        [UCP_PROTO_RNDV_PUT_STAGE_FLUSH]      = ucp_proto_rndv_put_common_flush_progress,
+        [UCP_PROTO_RNDV_PUT_STAGE_ATP]        = ucp_proto_rndv_put_common_atp_progress,
+        [UCP_PROTO_RNDV_PUT_STAGE_FENCED_ATP] = ucp_proto_rndv_put_common_fenced_atp_progress,
+    },
+    .abort    = ucp_proto_abort_fatal_not_implemented,
+    .reset    = (ucp_request_reset_func_t)ucp_proto_reset_fatal_not_implemented
+};
@@ -141,6 +141,7 @@ UCS_PROFILE_FUNC(ucs_status_ptr_t, ucp_stream_send_nbx,
     }
 
     UCP_WORKER_THREAD_CS_ENTER_CONDITIONAL(worker);
+    ucp_ep_usage_touch(ep);
 
     ucs_trace_req("stream_send_nbx buffer %p count %zu to %s cb %p", buffer,
                   count, ucp_ep_peer_name(ep),
@@ -229,6 +229,43 @@ enum {
     UCP_ADDRESS_HEADER_FLAG_AM_ONLY     = UCS_BIT(3)   /* Only AM lane info */
 };
 
+/* Number of packed local addresses kept by the address cache */
+#define UCP_ADDRESS_CACHE_PACKED_NUM      4
+
+/* Number of slots for unpacked remote addresses, indexed by a hash of the
+ * remote worker uuid and the unpack flags */
+#define UCP_ADDRESS_CACHE_UNPACKED_NUM    64
+
+
+typedef struct {
+    ucp_tl_bitmap_t             tl_bitmap;      /* Packed resources */
+    unsigned                    iface_id_base;  /* Base interface index */
+    unsigned                    pack_flags;     /* Packing flags */
+    ucp_object_version_t        addr_version;   /* Address format version */
+    unsigned                    max_num_paths;  /* Paths limit per device */
+    size_t                      size;           /* Packed address length */
+    void                        *buffer;        /* Packed address, NULL if the
+                                                   entry is not used */
+} ucp_address_cache_packed_t;
+
+
+typedef struct {
+    unsigned                    unpack_flags;   /* Unpacking flags */
+    size_t                      size;           /* Packed address length */
+    void                        *buffer;        /* Copy of the packed address,
+                                                   NULL if the slot is empty */
+    ucp_unpacked_address_t      unpacked;       /* Parsed address, its entries
+                                                   point into the buffer */
+} ucp_address_cache_unpacked_t;
+
+
+struct ucp_address_cache {
+    ucp_address_cache_packed_t   packed[UCP_ADDRESS_CACHE_PACKED_NUM];
+    unsigned                     packed_next;   /* Next packed entry to replace */
+    ucp_address_cache_unpacked_t unpacked[UCP_ADDRESS_CACHE_UNPACKED_NUM];
+};
+
+
 static size_t ucp_address_iface_attr_size(ucp_worker_t *worker, uint64_t flags,
                                           ucp_object_version_t addr_version)
 {
@@ -1514,6 +1551,348 @@ out:
     return UCS_OK;
 }
 
+static ucp_address_cache_t *ucp_address_cache_get(ucp_worker_h worker)
+{
+    if (!worker->context->config.ext.address_cache) {
+        return NULL;
+    }
+
+    if (worker->address_cache == NULL) {
+        /* Failing to allocate the cache only disables caching */
+        worker->address_cache = ucs_calloc(1, sizeof(*worker->address_cache),
+                                           "ucp_address_cache");
+    }
+
+    return worker->address_cache;
+}
+
+static ucp_address_cache_packed_t *
+ucp_address_cache_find_packed(ucp_address_cache_t *cache,
+                              const ucp_tl_bitmap_t *tl_bitmap,
+                              unsigned iface_id_base, unsigned pack_flags,
+                              ucp_object_version_t addr_version,
+                              unsigned max_num_paths)
+{
+    ucp_address_cache_packed_t *entry;
+
+    ucs_carray_for_each(entry, cache->packed, UCP_ADDRESS_CACHE_PACKED_NUM) {
+        if ((entry->buffer != NULL) &&
+            (entry->iface_id_base == iface_id_base) &&
+            (entry->pack_flags == pack_flags) &&
+            (entry->addr_version == addr_version) &&
+            (entry->max_num_paths == max_num_paths) &&
+            !memcmp(&entry->tl_bitmap, tl_bitmap, sizeof(*tl_bitmap))) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static ucs_status_t
+ucp_address_cache_pack(ucp_worker_h worker, const ucp_tl_bitmap_t *tl_bitmap,
+                       unsigned iface_id_base, unsigned pack_flags,
+                       ucp_object_version_t addr_version,
+                       unsigned max_num_paths, size_t *size_p, void **buffer_p)
+{
+    ucp_address_cache_packed_t *entry;
+    ucs_status_t status;
+    void *buffer;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    if (worker->address_cache == NULL) {
+        status = UCS_ERR_NO_ELEM;
+        goto out;
+    }
+
+    entry = ucp_address_cache_find_packed(worker->address_cache, tl_bitmap,
+                                          iface_id_base, pack_flags,
+                                          addr_version, max_num_paths);
+    if (entry == NULL) {
+        status = UCS_ERR_NO_ELEM;
+        goto out;
+    }
+
+    /* The caller owns the returned address, so hand out a copy */
+    buffer = ucs_malloc(entry->size, "ucp_address");
+    if (buffer == NULL) {
+        status = UCS_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    memcpy(buffer, entry->buffer, entry->size);
+    *size_p   = entry->size;
+    *buffer_p = buffer;
+    status    = UCS_OK;
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return status;
+}
+
+static void
+ucp_address_cache_add_packed(ucp_worker_h worker,
+                             const ucp_tl_bitmap_t *tl_bitmap,
+                             unsigned iface_id_base, unsigned pack_flags,
+                             ucp_object_version_t addr_version,
+                             unsigned max_num_paths, size_t size,
+                             const void *buffer)
+{
+    ucp_address_cache_packed_t *entry;
+    ucp_address_cache_t *cache;
+    void *cached_buffer;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    cache = ucp_address_cache_get(worker);
+    if (cache == NULL) {
+        goto out;
+    }
+
+    cached_buffer = ucs_malloc(size, "ucp_address_cache_packed");
+    if (cached_buffer == NULL) {
+        goto out;
+    }
+
+    memcpy(cached_buffer, buffer, size);
+
+    /* Replace the entries in round-robin order */
+    entry              = &cache->packed[cache->packed_next];
+    cache->packed_next = (cache->packed_next + 1) %
+                         UCP_ADDRESS_CACHE_PACKED_NUM;
+
+    ucs_free(entry->buffer);
+    entry->tl_bitmap     = *tl_bitmap;
+    entry->iface_id_base = iface_id_base;
+    entry->pack_flags    = pack_flags;
+    entry->addr_version  = addr_version;
+    entry->max_num_paths = max_num_paths;
+    entry->size          = size;
+    entry->buffer        = cached_buffer;
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+}
+
+static ucp_address_cache_unpacked_t *
+ucp_address_cache_unpacked_slot(ucp_address_cache_t *cache, const void *buffer,
+                                unsigned unpack_flags)
+{
+    uint64_t key = ucp_address_get_uuid(buffer) ^ unpack_flags;
+
+    return &cache->unpacked[kh_int64_hash_func(key) %
+                            UCP_ADDRESS_CACHE_UNPACKED_NUM];
+}
+
+/*
+ * The packed address is self-delimiting, so if the first 'size' bytes of the
+ * buffer are equal to a cached address of that length, the buffer holds the
+ * same address. Compare byte by byte and stop at the first difference, to never
+ * read beyond the end of a shorter address.
+ */
+static int ucp_address_cache_is_equal(const void *cached, const void *buffer,
+                                      size_t size)
+{
+    const uint8_t *cached_ptr = cached;
+    const uint8_t *ptr        = buffer;
+    size_t i;
+
+    for (i = 0; i < size; ++i) {
+        if (cached_ptr[i] != ptr[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static const void *ucp_address_cache_rebase(const void *ptr, const void *from,
+                                            const void *to)
+{
+    return (ptr == NULL) ? NULL :
+           UCS_PTR_BYTE_OFFSET(to, UCS_PTR_BYTE_DIFF(from, ptr));
+}
+
+static void ucp_address_cache_unpacked_reset(ucp_address_cache_unpacked_t *slot)
+{
+    ucs_free(slot->unpacked.address_list);
+    ucs_free(slot->buffer);
+    slot->unpacked.address_list = NULL;
+    slot->buffer                = NULL;
+}
+
+static ucs_status_t
+ucp_address_cache_unpack(ucp_worker_h worker, const void *buffer,
+                         unsigned unpack_flags,
+                         ucp_unpacked_address_t *unpacked_address)
+{
+    ucp_address_cache_unpacked_t *slot;
+    ucp_address_entry_t *address_list;
+    unsigned i, count;
+    ucs_status_t status;
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    if (worker->address_cache == NULL) {
+        status = UCS_ERR_NO_ELEM;
+        goto out;
+    }
+
+    slot = ucp_address_cache_unpacked_slot(worker->address_cache, buffer,
+                                           unpack_flags);
+    if ((slot->buffer == NULL) || (slot->unpack_flags != unpack_flags) ||
+        !ucp_address_cache_is_equal(slot->buffer, buffer, slot->size)) {
+        status = UCS_ERR_NO_ELEM;
+        goto out;
+    }
+
+    count        = slot->unpacked.address_count;
+    address_list = ucs_malloc(count * sizeof(*address_list),
+                              "ucp_address_list");
+    if (address_list == NULL) {
+        ucs_error("failed to allocate address list");
+        status = UCS_ERR_NO_MEMORY;
+        goto out;
+    }
+
+    /* Cached entries point into the cached copy of the address, make them
+     * point into the caller's buffer instead */
+    memcpy(address_list, slot->unpacked.address_list,
+           count * sizeof(*address_list));
+    for (i = 0; i < count; ++i) {
+        address_list[i].dev_addr   = ucp_address_cache_rebase(
+                address_list[i].dev_addr, slot->buffer, buffer);
+        address_list[i].iface_addr = ucp_address_cache_rebase(
+                address_list[i].iface_addr, slot->buffer, buffer);
+    }
+
+    *unpacked_address              = slot->unpacked;
+    unpacked_address->address_list = address_list;
+    status                         = UCS_OK;
+
+    ucp_address_trace(unpack_flags, "unpacked address of %s from cache",
+                      unpacked_address->name);
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    return status;
+}
+
+static void
+ucp_address_cache_add_unpacked(ucp_worker_h worker, const void *buffer,
+                               size_t size, unsigned unpack_flags,
+                               const ucp_unpacked_address_t *unpacked_address)
+{
+    ucp_address_entry_t *address_list;
+    ucp_address_cache_unpacked_t *slot;
+    ucp_address_cache_t *cache;
+    void *cached_buffer;
+    unsigned i, count;
+
+    count = unpacked_address->address_count;
+    if (count == 0) {
+        return;
+    }
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    cache = ucp_address_cache_get(worker);
+    if (cache == NULL) {
+        goto out;
+    }
+
+    cached_buffer = ucs_malloc(size, "ucp_address_cache_unpacked");
+    if (cached_buffer == NULL) {
+        goto out;
+    }
+
+    address_list = ucs_malloc(count * sizeof(*address_list),
+                              "ucp_address_cache_list");
+    if (address_list == NULL) {
+        ucs_free(cached_buffer);
+        goto out;
+    }
+
+    memcpy(cached_buffer, buffer, size);
+    memcpy(address_list, unpacked_address->address_list,
+           count * sizeof(*address_list));
+    for (i = 0; i < count; ++i) {
+        address_list[i].dev_addr   = ucp_address_cache_rebase(
+                address_list[i].dev_addr, buffer, cached_buffer);
+        address_list[i].iface_addr = ucp_address_cache_rebase(
+                address_list[i].iface_addr, buffer, cached_buffer);
+    }
+
+    slot = ucp_address_cache_unpacked_slot(cache, buffer, unpack_flags);
+    ucp_address_cache_unpacked_reset(slot);
+    slot->unpack_flags          = unpack_flags;
+    slot->size                  = size;
+    slot->buffer                = cached_buffer;
+    slot->unpacked              = *unpacked_address;
+    slot->unpacked.address_list = address_list;
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+}
+
+void ucp_address_cache_invalidate(ucp_worker_h worker)
+{
+    ucp_address_cache_t *cache = worker->address_cache;
+    ucp_address_cache_unpacked_t *slot;
+    ucp_address_cache_packed_t *entry;
+
+    if (cache == NULL) {
+        return;
+    }
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    ucs_carray_for_each(entry, cache->packed, UCP_ADDRESS_CACHE_PACKED_NUM) {
+        ucs_free(entry->buffer);
+        entry->buffer = NULL;
+    }
+
+    ucs_carray_for_each(slot, cache->unpacked, UCP_ADDRESS_CACHE_UNPACKED_NUM) {
+        ucp_address_cache_unpacked_reset(slot);
+    }
+
+    UCS_ASYNC_UNBLOCK(&worker->async);
+}
+
+void ucp_address_cache_count(ucp_worker_h worker, unsigned *packed_count_p,
+                             unsigned *unpacked_count_p)
+{
+    ucp_address_cache_t *cache = worker->address_cache;
+    ucp_address_cache_unpacked_t *slot;
+    ucp_address_cache_packed_t *entry;
+
+    *packed_count_p   = 0;
+    *unpacked_count_p = 0;
+    if (cache == NULL) {
+        return;
+    }
+
+    UCS_ASYNC_BLOCK(&worker->async);
+
+    ucs_carray_for_each(entry, cache->packed, UCP_ADDRESS_CACHE_PACKED_NUM) {
+        *packed_count_p += (entry->buffer != NULL);
+    }
+
+    ucs_carray_for_each(slot, cache->unpacked, UCP_ADDRESS_CACHE_UNPACKED_NUM) {
+        *unpacked_count_p += (slot->buffer != NULL);
+    }
+
+    UCS_ASYNC_UNBLOCK(&worker->async);
+}
+
+void ucp_address_cache_cleanup(ucp_worker_h worker)
+{
+    ucp_address_cache_invalidate(worker);
+    ucs_free(worker->address_cache);
+    worker->address_cache = NULL;
+}
+
 ucs_status_t
 ucp_address_length(ucp_worker_h worker, const ucp_ep_config_key_t *key,
                    const ucp_tl_bitmap_t *tl_bitmap, unsigned pack_flags,
@@ -1563,6 +1942,17 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
         key         = &ucp_ep_config(ep)->key;
     }
 
+    /* Without endpoint addresses, the packed address depends only on the
+     * worker resources */
+    if (ep == NULL) {
+        status = ucp_address_cache_pack(worker, tl_bitmap, iface_id_base,
+                                        pack_flags, addr_version, max_num_paths,
+                                        size_p, buffer_p);
+        if (status != UCS_ERR_NO_ELEM) {
+            goto out;
+        }
+    }
+
     /* Collect all devices we want to pack */
     status = ucp_address_gather_devices(worker, key, tl_bitmap, pack_flags,
                                         addr_version, max_num_paths, &devices,
@@ -1595,6 +1985,12 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
 
     VALGRIND_CHECK_MEM_IS_DEFINED(buffer, size);
 
+    if (ep == NULL) {
+        ucp_address_cache_add_packed(worker, tl_bitmap, iface_id_base,
+                                     pack_flags, addr_version, max_num_paths,
+                                     size, buffer);
+    }
+
     *size_p   = size;
     *buffer_p = buffer;
     status    = UCS_OK;
@@ -1630,9 +2026,10 @@ static ucp_rsc_index_t ucp_address_get_remote_device_index(
     return ucs_array_length(device_array) - 1;
 }
 
-ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
-                                unsigned unpack_flags,
-                                ucp_unpacked_address_t *unpacked_address)
+static ucs_status_t
+ucp_address_do_unpack(ucp_worker_t *worker, const void *buffer,
+                      unsigned unpack_flags,
+                      ucp_unpacked_address_t *unpacked_address, size_t *size_p)
 {
     UCS_ARRAY_DEFINE_ONSTACK(ucp_address_remote_device_array_t,
                              remote_device_array, UCP_MAX_RESOURCES);
@@ -1700,6 +2097,7 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
 
     /* Empty address list */
     if (*(uint8_t*)ptr == UCP_NULL_RESOURCE) {
+        *size_p = UCS_PTR_BYTE_DIFF(buffer, ptr) + sizeof(uint8_t);
         return UCS_OK;
     }
 
@@ -1854,9 +2252,42 @@ ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
     unpacked_address->dst_version   = dst_version;
     unpacked_address->address_count = address - address_list;
     unpacked_address->address_list  = address_list;
+    *size_p                         = UCS_PTR_BYTE_DIFF(buffer, ptr);
     return UCS_OK;
 
 err_free:
     ucs_free(address_list);
     return UCS_ERR_INVALID_PARAM;
 }
+
+ucs_status_t ucp_address_unpack(ucp_worker_t *worker, const void *buffer,
+                                unsigned unpack_flags,
+                                ucp_unpacked_address_t *unpacked_address)
+{
+    /* Endpoint addresses are unique for every connection, so addresses which
+     * are unpacked with them are neither looked up nor kept */
+    int use_cache = !(unpack_flags & UCP_ADDRESS_PACK_FLAG_EP_ADDR);
+    ucs_status_t status;
+    size_t size;
+
+    if (use_cache) {
+        status = ucp_address_cache_unpack(worker, buffer, unpack_flags,
+                                          unpacked_address);
+        if (status != UCS_ERR_NO_ELEM) {
+            return status;
+        }
+    }
+
+    status = ucp_address_do_unpack(worker, buffer, unpack_flags,
+                                   unpacked_address, &size);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    if (use_cache) {
+        ucp_address_cache_add_unpacked(worker, buffer, size, unpack_flags,
+                                       unpacked_address);
+    }
+
+    return UCS_OK;
+}
@@ -235,6 +235,9 @@ ucp_address_length(ucp_worker_h worker, const ucp_ep_config_key_t *key,
  * @param [out] size_p        Filled with buffer size.
  * @param [out] buffer_p      Filled with pointer to packed buffer. It should be
  *                            released by ucs_free().
+ *
+ * @note If ep is NULL, the packed address is cached on the worker, and the next
+ *       calls with the same parameters return a copy of it.
  */
 ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
                               const ucp_tl_bitmap_t *tl_bitmap,
@@ -261,12 +264,43 @@ ucs_status_t ucp_address_pack(ucp_worker_h worker, ucp_ep_h ep,
  *
  * @note The address list inside @ref ucp_remote_address_t should be released
  *       by ucs_free().
+ *
+ * @note Addresses without endpoint addresses are memoized on the worker, so
+ *       unpacking the same address again only copies the parsed entries.
  */
 ucs_status_t ucp_address_unpack(ucp_worker_h worker, const void *buffer,
                                 unsigned unpack_flags,
                                 ucp_unpacked_address_t *unpacked_address);
 
 
+/**
+ * Drop all cached packed and unpacked addresses of the worker. Should be called
+ * whenever the set of worker interfaces changes.
+ *
+ * @param [in]  worker           Worker object.
+ */
+void ucp_address_cache_invalidate(ucp_worker_h worker);
+
+
+/**
+ * Count the cached packed and unpacked addresses of the worker.
+ *
+ * @param [in]  worker           Worker object.
+ * @param [out] packed_count_p   Filled with the number of packed addresses.
+ * @param [out] unpacked_count_p Filled with the number of unpacked addresses.
+ */
+void ucp_address_cache_count(ucp_worker_h worker, unsigned *packed_count_p,
+                             unsigned *unpacked_count_p);
+
+
+/**
+ * Release the address cache of the worker.
+ *
+ * @param [in]  worker           Worker object.
+ */
+void ucp_address_cache_cleanup(ucp_worker_h worker);
+
+
 /**
  * Unpack worker unique id from the given address.
  *
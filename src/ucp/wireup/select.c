@@ -13,6 +13,7 @@
 #include "wireup_cm.h"
 #include "address.h"
 
+#include <ucs/algorithm/crc.h>
 #include <ucs/algorithm/qsort_r.h>
 #include <ucs/datastruct/array.h>
 #include <ucs/datastruct/queue.h>
@@ -40,6 +41,37 @@
         continue;                                                                          \
     }
 
+/* Number of entries in the lane selection cache, as a power of 2 */
+#define UCP_WIREUP_SELECT_CACHE_BITS 6
+#define UCP_WIREUP_SELECT_CACHE_SIZE UCS_BIT(UCP_WIREUP_SELECT_CACHE_BITS)
+
+/* Append a value to the lane selection signature */
+#define ucp_wireup_select_sig_add(_sig, _value) \
+    do { \
+        ucs_typeof(_value) _sig_value = (_value); \
+        ucp_wireup_select_sig_append(_sig, &_sig_value, sizeof(_sig_value)); \
+    } while (0)
+
+
+UCS_ARRAY_DECLARE_TYPE(ucp_wireup_select_sig_t, size_t, uint8_t);
+
+
+typedef struct {
+    uint32_t                  hash;       /* Hash of the signature */
+    size_t                    sig_length; /* Signature length */
+    uint8_t                   *signature; /* Selection parameters, NULL if the
+                                             entry is not used */
+    ucp_ep_config_key_t       key;        /* Selected lanes */
+    unsigned                  addr_indices[UCP_MAX_LANES]; /* Remote address
+                                                              entry per lane */
+} ucp_wireup_select_cache_entry_t;
+
+
+struct ucp_wireup_select_cache {
+    ucp_wireup_select_cache_entry_t entries[UCP_WIREUP_SELECT_CACHE_SIZE];
+};
+
+
 typedef struct ucp_wireup_atomic_flag {
     const char *name;
     const char *fetch;
@@ -2526,12 +2558,189 @@ ucp_wireup_construct_lanes(const ucp_wireup_select_params_t *select_params,
                                                 key);
 }
 
-ucs_status_t
-ucp_wireup_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
-                        ucp_tl_bitmap_t tl_bitmap, unsigned iface_tl_base,
-                        const ucp_unpacked_address_t *remote_address,
-                        unsigned *addr_indices, ucp_ep_config_key_t *key,
-                        int show_error)
+static void ucp_wireup_select_sig_append(ucp_wireup_select_sig_t *sig,
+                                         const void *data, size_t length)
+{
+    ucs_assert(ucs_array_available_length(sig) >= length);
+    memcpy(ucs_array_end(sig), data, length);
+    ucs_array_set_length(sig, ucs_array_length(sig) + length);
+}
+
+/*
+ * Build the signature of a lane selection: everything the selection depends on,
+ * except the remote worker identity and the interface and endpoint addresses,
+ * which differ between peers even with identical transports and devices. The
+ * local resources which can reach every address entry are part of the
+ * signature instead of the interface addresses.
+ */
+static ucs_status_t
+ucp_wireup_select_sig_build(ucp_ep_h ep, unsigned ep_init_flags,
+                            const ucp_tl_bitmap_t *tl_bitmap,
+                            unsigned iface_tl_base,
+                            const ucp_unpacked_address_t *remote_address,
+                            const ucp_ep_config_key_t *key,
+                            ucp_wireup_select_sig_t *sig)
+{
+    ucp_context_h context = ep->worker->context;
+    ucp_tl_bitmap_t local_tl_bitmap, reachable_tl_bitmap;
+    const ucp_address_entry_t *ae;
+    ucp_rsc_index_t rsc_index;
+    ucs_status_t status;
+    size_t length;
+    unsigned i;
+
+    /* Upper bound of the signature length */
+    length = sizeof(*key) + sizeof(*tl_bitmap) + sizeof(*remote_address);
+    ucp_unpacked_address_for_each(ae, remote_address) {
+        length += sizeof(*ae) + ae->dev_addr_len + sizeof(reachable_tl_bitmap);
+    }
+
+    status = ucs_array_reserve(sig, length);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    ucp_wireup_select_sig_append(sig, key, sizeof(*key));
+    ucp_wireup_select_sig_append(sig, tl_bitmap, sizeof(*tl_bitmap));
+    ucp_wireup_select_sig_add(sig, ep_init_flags);
+    ucp_wireup_select_sig_add(sig, iface_tl_base);
+    ucp_wireup_select_sig_add(sig,
+                              !!(ep->flags & UCP_EP_FLAG_LOCAL_CONNECTED));
+    ucp_wireup_select_sig_add(sig, remote_address->addr_version);
+    ucp_wireup_select_sig_add(sig, remote_address->dst_version);
+    ucp_wireup_select_sig_add(sig, remote_address->address_count);
+
+    local_tl_bitmap = *tl_bitmap;
+    UCS_BITMAP_AND_INPLACE(&local_tl_bitmap, context->tl_bitmap);
+
+    ucp_unpacked_address_for_each(ae, remote_address) {
+        ucp_wireup_select_sig_add(sig, ae->tl_name_csum);
+        ucp_wireup_select_sig_add(sig, ae->md_index);
+        ucp_wireup_select_sig_add(sig, ae->sys_dev);
+        ucp_wireup_select_sig_add(sig, ae->dev_index);
+        ucp_wireup_select_sig_add(sig, ae->dev_num_paths);
+        ucp_wireup_select_sig_add(sig, (uint8_t)(ae->iface_addr != NULL));
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.flags);
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.overhead);
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.bandwidth);
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.priority);
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.lat_ovh);
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.dst_rsc_index);
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.atomic);
+        ucp_wireup_select_sig_add(sig, ae->iface_attr.seg_size);
+        ucp_wireup_select_sig_add(sig, ae->num_ep_addrs);
+        for (i = 0; i < ae->num_ep_addrs; ++i) {
+            ucp_wireup_select_sig_add(sig, ae->ep_addrs[i].lane);
+        }
+
+        /* Reachability depends on the device address */
+        ucp_wireup_select_sig_add(sig, ae->dev_addr_len);
+        if (ae->dev_addr != NULL) {
+            ucp_wireup_select_sig_append(sig, ae->dev_addr, ae->dev_addr_len);
+        }
+
+        /* ... and on the interface address */
+        UCS_BITMAP_CLEAR(&reachable_tl_bitmap);
+        UCS_BITMAP_FOR_EACH_BIT(local_tl_bitmap, rsc_index) {
+            if (ucp_wireup_is_reachable(ep, ep_init_flags, rsc_index,
+                                        *tl_bitmap, iface_tl_base, ae)) {
+                UCS_BITMAP_SET(reachable_tl_bitmap, rsc_index);
+            }
+        }
+        ucp_wireup_select_sig_append(sig, &reachable_tl_bitmap,
+                                     sizeof(reachable_tl_bitmap));
+    }
+
+    return UCS_OK;
+}
+
+static ucp_wireup_select_cache_entry_t *
+ucp_wireup_select_cache_entry(ucp_wireup_select_cache_t *cache, uint32_t hash)
+{
+    return &cache->entries[hash & (UCP_WIREUP_SELECT_CACHE_SIZE - 1)];
+}
+
+static int
+ucp_wireup_select_cache_lookup(ucp_worker_h worker,
+                               const ucp_wireup_select_sig_t *sig,
+                               uint32_t hash, unsigned *addr_indices,
+                               ucp_ep_config_key_t *key)
+{
+    ucp_wireup_select_cache_entry_t *entry;
+
+    if (worker->select_cache == NULL) {
+        return 0;
+    }
+
+    entry = ucp_wireup_select_cache_entry(worker->select_cache, hash);
+    if ((entry->signature == NULL) || (entry->hash != hash) ||
+        (entry->sig_length != ucs_array_length(sig)) ||
+        memcmp(entry->signature, ucs_array_begin(sig), entry->sig_length)) {
+        return 0;
+    }
+
+    *key = entry->key;
+    memcpy(addr_indices, entry->addr_indices,
+           entry->key.num_lanes * sizeof(*addr_indices));
+    return 1;
+}
+
+static void ucp_wireup_select_cache_add(ucp_worker_h worker,
+                                        ucp_wireup_select_sig_t *sig,
+                                        uint32_t hash,
+                                        const unsigned *addr_indices,
+                                        const ucp_ep_config_key_t *key)
+{
+    ucp_wireup_select_cache_entry_t *entry;
+
+    if (worker->select_cache == NULL) {
+        /* Failing to allocate the cache only disables caching */
+        worker->select_cache = ucs_calloc(1, sizeof(*worker->select_cache),
+                                          "ucp_wireup_select_cache");
+        if (worker->select_cache == NULL) {
+            return;
+        }
+    }
+
+    entry = ucp_wireup_select_cache_entry(worker->select_cache, hash);
+    ucs_free(entry->signature);
+    entry->hash       = hash;
+    entry->sig_length = ucs_array_length(sig);
+    entry->signature  = ucs_array_extract_buffer(sig);
+    entry->key        = *key;
+    memcpy(entry->addr_indices, addr_indices,
+           key->num_lanes * sizeof(*addr_indices));
+}
+
+void ucp_wireup_select_cache_invalidate(ucp_worker_h worker)
+{
+    ucp_wireup_select_cache_entry_t *entry;
+
+    if (worker->select_cache == NULL) {
+        return;
+    }
+
+    ucs_carray_for_each(entry, worker->select_cache->entries,
+                        UCP_WIREUP_SELECT_CACHE_SIZE) {
+        ucs_free(entry->signature);
+        entry->signature = NULL;
+    }
+}
+
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker)
+{
+    ucp_wireup_select_cache_invalidate(worker);
+    ucs_free(worker->select_cache);
+    worker->select_cache = NULL;
+}
+
+static ucs_status_t
+ucp_wireup_select_lanes_uncached(ucp_ep_h ep, unsigned ep_init_flags,
+                                 ucp_tl_bitmap_t tl_bitmap,
+                                 unsigned iface_tl_base,
+                                 const ucp_unpacked_address_t *remote_address,
+                                 unsigned *addr_indices,
+                                 ucp_ep_config_key_t *key, int show_error)
 {
     ucp_worker_h worker                = ep->worker;
     ucp_tl_bitmap_t scalable_tl_bitmap = worker->scalable_tl_bitmap;
@@ -2582,6 +2791,64 @@ out:
     return UCS_OK;
 }
 
+ucs_status_t
+ucp_wireup_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
+                        ucp_tl_bitmap_t tl_bitmap, unsigned iface_tl_base,
+                        const ucp_unpacked_address_t *remote_address,
+                        unsigned *addr_indices, ucp_ep_config_key_t *key,
+                        int show_error)
+{
+    ucp_worker_h worker = ep->worker;
+    ucp_wireup_select_sig_t sig;
+    ucs_status_t status;
+    uint32_t hash;
+
+    /* The selection depends on the current lanes of the endpoint, unless it is
+     * a new endpoint or it can be reconfigured by CM */
+    if (!worker->context->config.ext.lanes_select_cache ||
+        ((ep->cfg_index != UCP_WORKER_CFG_INDEX_NULL) &&
+         !ucp_ep_has_cm_lane(ep))) {
+        return ucp_wireup_select_lanes_uncached(ep, ep_init_flags, tl_bitmap,
+                                                iface_tl_base, remote_address,
+                                                addr_indices, key, show_error);
+    }
+
+    ucs_array_init_dynamic(&sig);
+    status = ucp_wireup_select_sig_build(ep, ep_init_flags, &tl_bitmap,
+                                         iface_tl_base, remote_address, key,
+                                         &sig);
+    if (status != UCS_OK) {
+        ucs_array_cleanup_dynamic(&sig);
+        return ucp_wireup_select_lanes_uncached(ep, ep_init_flags, tl_bitmap,
+                                                iface_tl_base, remote_address,
+                                                addr_indices, key, show_error);
+    }
+
+    hash = ucs_crc32(0, ucs_array_begin(&sig), ucs_array_length(&sig));
+
+    UCS_ASYNC_BLOCK(&worker->async);
+    if (ucp_wireup_select_cache_lookup(worker, &sig, hash, addr_indices,
+                                       key)) {
+        ++worker->counters.lanes_select_cache_hits;
+        ucs_trace("ep %p: using cached lanes selection", ep);
+        status = UCS_OK;
+        goto out;
+    }
+
+    ++worker->counters.lanes_select_cache_misses;
+    status = ucp_wireup_select_lanes_uncached(ep, ep_init_flags, tl_bitmap,
+                                              iface_tl_base, remote_address,
+                                              addr_indices, key, show_error);
+    if (status == UCS_OK) {
+        ucp_wireup_select_cache_add(worker, &sig, hash, addr_indices, key);
+    }
+
+out:
+    UCS_ASYNC_UNBLOCK(&worker->async);
+    ucs_array_cleanup_dynamic(&sig);
+    return status;
+}
+
 ucs_status_t
 ucp_wireup_select_aux_transport(ucp_ep_h ep, unsigned ep_init_flags,
                                 ucp_tl_bitmap_t tl_bitmap,
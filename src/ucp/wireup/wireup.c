@@ -1769,7 +1769,7 @@ ucs_status_t ucp_wireup_connect_remote(ucp_ep_h ep, ucp_lane_index_t lane)
         status = uct_ep_pending_add(ucp_ep_get_lane(ep, lane), &req->send.uct,
                                     (req->send.uct.func == ucp_wireup_msg_progress) ||
                                     (req->send.uct.func == ucp_wireup_ep_progress_pending) ?
-                                    UCT_CB_FLAG_ASYNC : 0);
+                                    (UCT_CB_FLAG_ASYNC | UCT_CB_FLAG_PRIO_HIGH) : 0);
         if (status != UCS_OK) {
             ucs_fatal("wireup proxy function must always return UCS_OK");
         }
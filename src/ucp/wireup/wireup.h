@@ -195,6 +195,10 @@ ucp_wireup_select_lanes(ucp_ep_h ep, unsigned ep_init_flags,
                         unsigned *addr_indices, ucp_ep_config_key_t *key,
                         int show_error);
 
+void ucp_wireup_select_cache_invalidate(ucp_worker_h worker);
+
+void ucp_wireup_select_cache_cleanup(ucp_worker_h worker);
+
 void ucp_wireup_replay_pending_requests(ucp_ep_h ucp_ep,
                                         ucs_queue_head_t *tmp_pending_queue);
 
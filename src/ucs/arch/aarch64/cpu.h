@@ -305,7 +305,8 @@ memcpy_aarch64_sve(void *dest, int nontemporal_dst, const void *src,
 }
 #endif
 
-static inline void *ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
+static inline void *ucs_arch_memcpy_relaxed(void *dst, const void *src,
+                                            size_t len)
 {
 #if defined(HAVE_AARCH64_THUNDERX2)
     return __memcpy_thunderx2(dst, src, len);
@@ -16,6 +16,7 @@
 
 #include <ucs/sys/compiler_def.h>
 #include <stddef.h>
+#include <string.h>
 
 BEGIN_C_DECLS
 
@@ -57,7 +58,8 @@ typedef enum ucs_cpu_flag {
     UCS_CPU_FLAG_SSE41      = UCS_BIT(7),
     UCS_CPU_FLAG_SSE42      = UCS_BIT(8),
     UCS_CPU_FLAG_AVX        = UCS_BIT(9),
-    UCS_CPU_FLAG_AVX2       = UCS_BIT(10)
+    UCS_CPU_FLAG_AVX2       = UCS_BIT(10),
+    UCS_CPU_FLAG_ERMS       = UCS_BIT(11)  /* Enhanced REP MOVSB */
 } ucs_cpu_flag_t;
 
 
@@ -99,6 +101,11 @@ typedef struct ucs_cpu_builtin_memcpy {
 #define UCS_SYS_PCI_MAX_PAYLOAD    512
 
 
+/* Maximal length of a memory copy which is always inlined when the length is
+ * known at compile time */
+#define UCS_MEMCPY_INLINE_MAX      256
+
+
 #if defined(__x86_64__)
 #  include "x86_64/cpu.h"
 #elif defined(__powerpc64__)
@@ -184,6 +191,29 @@ static inline int ucs_cpu_prefer_relaxed_order()
              (cpu_model == UCS_CPU_MODEL_AMD_GENOA)));
 }
 
+/**
+ * Copy a memory buffer, without any ordering guarantee with respect to other
+ * memory accesses. Small copies of a length known at compile time, such as
+ * transport headers, are inlined by the compiler; other copies are dispatched
+ * by their length to the best copy method of the CPU, as configured by
+ * UCX_BUILTIN_MEMCPY_MIN/MAX and UCX_NT_MEMCPY_MIN.
+ *
+ * @param dst  Destination buffer.
+ * @param src  Source buffer.
+ * @param len  Number of bytes to copy.
+ *
+ * @return @a dst.
+ */
+static UCS_F_ALWAYS_INLINE void *
+ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
+{
+    if (__builtin_constant_p(len) && (len <= UCS_MEMCPY_INLINE_MAX)) {
+        return memcpy(dst, src, len);
+    }
+
+    return ucs_arch_memcpy_relaxed(dst, src, len);
+}
+
 static inline int ucs_cpu_cache_line_is_equal(const void* restrict a,
                                               const void* restrict b)
 {
@@ -98,7 +98,8 @@ static inline void ucs_arch_clear_cache(void *start, void *end)
 }
 #endif
 
-static inline void *ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
+static inline void *ucs_arch_memcpy_relaxed(void *dst, const void *src,
+                                            size_t len)
 {
     return memcpy(dst, src, len);
 }
@@ -17,6 +17,7 @@
 #include <ucs/time/time.h>
 #include <ucs/sys/sys.h>
 #include <ucs/sys/string.h>
+#include <emmintrin.h>
 
 #define X86_CPUID_GENUINEINTEL    "GenuntelineI" /* GenuineIntel in magic notation */
 #define X86_CPUID_AUTHENTICAMD    "AuthcAMDenti" /* AuthenticAMD in magic notation */
@@ -540,6 +541,9 @@ int ucs_arch_get_cpu_flag()
                     result |= UCS_CPU_FLAG_AVX2;
                 }
             }
+            if (_ebx & (1 << 9)) {
+                result |= UCS_CPU_FLAG_ERMS;
+            }
             // if (_ecx & (1 << 25)) {
             //     result |= UCS_CPU_FLAG_CLDEMOTE;
             // }
@@ -579,6 +583,11 @@ static size_t ucs_cpu_memcpy_thresh(size_t user_val, size_t auto_val)
         return user_val;
     }
 
+    if (!(ucs_arch_get_cpu_flag() & UCS_CPU_FLAG_ERMS)) {
+        /* rep movsb is slower than libc memcpy without ERMS */
+        return UCS_MEMUNITS_INF;
+    }
+
     if (((ucs_arch_get_cpu_vendor() == UCS_CPU_VENDOR_INTEL) &&
          (ucs_arch_get_cpu_model() >= UCS_CPU_MODEL_INTEL_HASWELL)) ||
         (ucs_arch_get_cpu_vendor() == UCS_CPU_VENDOR_AMD) ||
@@ -590,8 +599,60 @@ static size_t ucs_cpu_memcpy_thresh(size_t user_val, size_t auto_val)
 }
 #endif
 
+static size_t ucs_cpu_nt_memcpy_thresh(size_t user_val)
+{
+    size_t llc_size;
+
+    if (user_val != UCS_MEMUNITS_AUTO) {
+        return user_val;
+    }
+
+    /* A copy which does not fit in the last level cache would evict the data
+     * anyway, so write it directly to memory and keep the cache for others */
+    llc_size = ucs_cpu_get_cache_size(UCS_CPU_CACHE_L3);
+    if (llc_size == 0) {
+        return UCS_MEMUNITS_INF;
+    }
+
+    return (llc_size * 3) / 4;
+}
+
+void ucs_x86_memcpy_nt(void *dst, const void *src, size_t len)
+{
+    size_t head = ucs_padding((uintptr_t)dst, sizeof(__m128i));
+    __m128i *d;
+    const __m128i *s;
+    __m128i x0, x1, x2, x3;
+
+    /* Align the destination, as required by the streaming stores */
+    head = ucs_min(head, len);
+    memcpy(dst, src, head);
+    d    = (__m128i*)UCS_PTR_BYTE_OFFSET(dst, head);
+    s    = (const __m128i*)UCS_PTR_BYTE_OFFSET(src, head);
+    len -= head;
+
+    for (; len >= UCS_ARCH_CACHE_LINE_SIZE; len -= UCS_ARCH_CACHE_LINE_SIZE) {
+        x0 = _mm_loadu_si128(s + 0);
+        x1 = _mm_loadu_si128(s + 1);
+        x2 = _mm_loadu_si128(s + 2);
+        x3 = _mm_loadu_si128(s + 3);
+        _mm_stream_si128(d + 0, x0);
+        _mm_stream_si128(d + 1, x1);
+        _mm_stream_si128(d + 2, x2);
+        _mm_stream_si128(d + 3, x3);
+        s += 4;
+        d += 4;
+    }
+
+    /* Make the streaming stores globally visible before returning */
+    _mm_sfence();
+    memcpy(d, s, len);
+}
+
 void ucs_cpu_init()
 {
+    ucs_global_opts.arch.nt_memcpy_min =
+        ucs_cpu_nt_memcpy_thresh(ucs_global_opts.arch.nt_memcpy_min);
 #if ENABLE_BUILTIN_MEMCPY
     ucs_global_opts.arch.builtin_memcpy_min =
         ucs_cpu_memcpy_thresh(ucs_global_opts.arch.builtin_memcpy_min,
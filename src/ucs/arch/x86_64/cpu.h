@@ -56,6 +56,7 @@ ucs_cpu_flag_t ucs_arch_get_cpu_flag() UCS_F_NOOPTIMIZE;
 ucs_cpu_vendor_t ucs_arch_get_cpu_vendor();
 void ucs_cpu_init();
 ucs_status_t ucs_arch_get_cache_size(size_t *cache_sizes);
+void ucs_x86_memcpy_nt(void *dst, const void *src, size_t len);
 
 static UCS_F_ALWAYS_INLINE int ucs_arch_x86_rdtsc_enabled()
 {
@@ -111,13 +112,23 @@ static inline void ucs_arch_share_cache(void *addr)
 #endif
 }
 
-static inline void *ucs_memcpy_relaxed(void *dst, const void *src, size_t len)
+static inline void *ucs_arch_memcpy_relaxed(void *dst, const void *src,
+                                            size_t len)
 {
+#if ENABLE_BUILTIN_MEMCPY
+    void *end;
+#endif
+
+    if (ucs_unlikely(len >= ucs_global_opts.arch.nt_memcpy_min)) {
+        ucs_x86_memcpy_nt(dst, src, len);
+        return dst;
+    }
+
 #if ENABLE_BUILTIN_MEMCPY
     if (ucs_unlikely((len > ucs_global_opts.arch.builtin_memcpy_min) &&
                      (len < ucs_global_opts.arch.builtin_memcpy_max))) {
         asm volatile ("rep movsb"
-                      : "=D" (dst),
+                      : "=D" (end),
                       "=S" (src),
                       "=c" (len)
                       : "0" (dst),
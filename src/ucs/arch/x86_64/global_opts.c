@@ -23,12 +23,20 @@ ucs_config_field_t ucs_arch_global_opts_table[] = {
    "Maximal threshold of buffer length for using built-in memcpy.",
    ucs_offsetof(ucs_arch_global_opts_t, builtin_memcpy_max), UCS_CONFIG_TYPE_MEMUNITS},
 #endif
+
+  {"NT_MEMCPY_MIN", "auto",
+   "Minimal threshold of buffer length for copying with non-temporal stores,\n"
+   "which bypass the CPU cache. \"auto\" selects a threshold according to the\n"
+   "size of the last level cache, \"inf\" disables non-temporal copy.",
+   ucs_offsetof(ucs_arch_global_opts_t, nt_memcpy_min), UCS_CONFIG_TYPE_MEMUNITS},
+
   {NULL}
 };
 
 
 void ucs_arch_print_memcpy_limits(ucs_arch_global_opts_t *config)
 {
+    char nt_thresh_str[32];
 #if ENABLE_BUILTIN_MEMCPY
     char min_thresh_str[32];
     char max_thresh_str[32];
@@ -39,6 +47,10 @@ void ucs_arch_print_memcpy_limits(ucs_arch_global_opts_t *config)
                                 &config->builtin_memcpy_max, NULL);
     printf("# Using built-in memcpy() for size %s..%s\n", min_thresh_str, max_thresh_str);
 #endif
+
+    ucs_config_sprintf_memunits(nt_thresh_str, sizeof(nt_thresh_str),
+                                &config->nt_memcpy_min, NULL);
+    printf("# Using non-temporal memcpy() for size %s..inf\n", nt_thresh_str);
 }
 
 #endif
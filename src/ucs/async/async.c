@@ -26,6 +26,7 @@
 
 #define UCS_ASYNC_MISSED_QUEUE_SHIFT    32
 #define UCS_ASYNC_MISSED_QUEUE_MASK     UCS_MASK(UCS_ASYNC_MISSED_QUEUE_SHIFT)
+#define UCS_ASYNC_TIMERQ_DISPATCH_BATCH 64
 
 /* Hash table for all event and timer handlers */
 KHASH_MAP_INIT_INT(ucs_async_handler, ucs_async_handler_t *);
@@ -316,22 +317,29 @@ ucs_status_t ucs_async_dispatch_handlers(int *handler_ids, size_t count,
 ucs_status_t ucs_async_dispatch_timerq(ucs_timer_queue_t *timerq,
                                        ucs_time_t current_time)
 {
-    size_t max_timers, num_timers = 0;
-    int *expired_timers;
+    int expired_timers[UCS_ASYNC_TIMERQ_DISPATCH_BATCH];
+    ucs_status_t status = UCS_OK;
+    ucs_status_t tmp_status;
+    size_t num_timers;
     ucs_timer_t *timer;
 
-    max_timers     = ucs_max(1, ucs_timerq_size(timerq));
-    expired_timers = ucs_alloca(max_timers * sizeof(*expired_timers));
+    do {
+        num_timers = 0;
+        ucs_timerq_for_each_expired(timer, timerq, current_time, {
+            expired_timers[num_timers++] = timer->id;
+            if (num_timers >= UCS_ASYNC_TIMERQ_DISPATCH_BATCH) {
+                break; /* Keep the rest of the timers for the next batch */
+            }
+        })
 
-    ucs_timerq_for_each_expired(timer, timerq, current_time, {
-        expired_timers[num_timers++] = timer->id;
-        if (num_timers >= max_timers) {
-            break; /* Keep timers which we don't have room for in the queue */
+        tmp_status = ucs_async_dispatch_handlers(expired_timers, num_timers,
+                                                 UCS_ASYNC_EVENT_DUMMY);
+        if (tmp_status != UCS_OK) {
+            status = tmp_status;
         }
-    })
+    } while (num_timers == UCS_ASYNC_TIMERQ_DISPATCH_BATCH);
 
-    return ucs_async_dispatch_handlers(expired_timers, num_timers,
-                                       UCS_ASYNC_EVENT_DUMMY);
+    return status;
 }
 
 ucs_status_t ucs_async_context_init(ucs_async_context_t *async, ucs_async_mode_t mode)
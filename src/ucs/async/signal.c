@@ -459,8 +459,12 @@ ucs_async_signal_timerq_add_timer(ucs_async_signal_timer_t *timer, int tid,
     int uid;
 
     if (timer->tid == 0) {
+        status = ucs_timerq_init(&timer->timerq);
+        if (status != UCS_OK) {
+            return status;
+        }
+
         timer->tid = tid;
-        ucs_timerq_init(&timer->timerq);
 
         uid = (timer - ucs_async_signal_global_context.timers);
         status = ucs_async_signal_sys_timer_create(uid, timer->tid,
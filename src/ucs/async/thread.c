@@ -13,6 +13,8 @@
 #include "pipe.h"
 
 #include <ucs/arch/atomic.h>
+#include <ucs/config/global_opts.h>
+#include <ucs/memory/numa.h>
 #include <ucs/sys/checker.h>
 #include <ucs/sys/stubs.h>
 #include <ucs/sys/event_set.h>
@@ -21,6 +23,7 @@
 
 #define UCS_ASYNC_EPOLL_MAX_EVENTS      16
 #define UCS_ASYNC_EPOLL_MIN_TIMEOUT_MS  2.0
+#define UCS_ASYNC_THREAD_MAX_SHARDS     64
 
 
 typedef struct ucs_async_thread {
@@ -30,13 +33,20 @@ typedef struct ucs_async_thread {
     pthread_t           thread_id;
     int                 stop;
     uint32_t            refcnt;
+    unsigned            shard;
 } ucs_async_thread_t;
 
 
-typedef struct ucs_async_thread_global_context {
+typedef struct ucs_async_thread_shard {
     ucs_async_thread_t *thread;
     unsigned           use_count;
-    pthread_mutex_t    lock;
+} ucs_async_thread_shard_t;
+
+
+typedef struct ucs_async_thread_global_context {
+    ucs_async_thread_shard_t shards[UCS_ASYNC_THREAD_MAX_SHARDS];
+    uint32_t                 next_shard; /* Shard of the next async context */
+    pthread_mutex_t          lock;
 } ucs_async_thread_global_context_t;
 
 
@@ -47,12 +57,99 @@ typedef struct ucs_async_thread_callback_arg {
 
 
 static ucs_async_thread_global_context_t ucs_async_thread_global_context = {
-    .thread    = NULL,
-    .use_count = 0,
-    .lock      = PTHREAD_MUTEX_INITIALIZER
+    .next_shard = 0,
+    .lock       = PTHREAD_MUTEX_INITIALIZER
 };
 
 
+static unsigned ucs_async_thread_shard(ucs_async_context_t *async)
+{
+    /* Handlers without an async context are served by the first thread */
+    return (async == NULL) ? 0 : async->thread.shard;
+}
+
+static ucs_async_thread_t *ucs_async_thread_get(ucs_async_context_t *async)
+{
+    unsigned shard = ucs_async_thread_shard(async);
+
+    return ucs_async_thread_global_context.shards[shard].thread;
+}
+
+static void ucs_async_thread_context_assign(ucs_async_context_t *async)
+{
+    unsigned num_shards = ucs_max(1, ucs_min(ucs_global_opts.async_threads,
+                                             UCS_ASYNC_THREAD_MAX_SHARDS));
+
+    async->thread.shard = ucs_atomic_fadd32(
+                            &ucs_async_thread_global_context.next_shard, 1) %
+                          num_shards;
+}
+
+/* The CPUs allowed by the affinity and NUMA configuration, if any */
+static int ucs_async_thread_cpu_mask(ucs_cpu_set_t *cpu_mask)
+{
+    const ucs_cpu_set_t *affinity   = &ucs_global_opts.async_thread_affinity;
+    const ucs_cpu_set_t *numa_nodes = &ucs_global_opts.async_thread_numa_nodes;
+    int has_affinity, has_numa_nodes, num_cpus, cpu;
+
+    has_affinity   = ucs_cpu_set_count(affinity) > 0;
+    has_numa_nodes = ucs_cpu_set_count(numa_nodes) > 0;
+    if (!has_affinity && !has_numa_nodes) {
+        return 0;
+    }
+
+    num_cpus = ucs_min(ucs_numa_num_configured_cpus(), UCS_CPU_SETSIZE);
+    num_cpus = ucs_min(num_cpus, CPU_SETSIZE);
+
+    UCS_CPU_ZERO(cpu_mask);
+    for (cpu = 0; cpu < num_cpus; ++cpu) {
+        if ((!has_affinity || ucs_cpu_is_set(cpu, affinity)) &&
+            (!has_numa_nodes ||
+             ucs_cpu_is_set(ucs_numa_node_of_cpu(cpu), numa_nodes))) {
+            UCS_CPU_SET(cpu, cpu_mask);
+        }
+    }
+
+    return 1;
+}
+
+/* Called from the async thread */
+static void ucs_async_thread_set_affinity(ucs_async_thread_t *thread)
+{
+    ucs_sys_cpuset_t cpuset;
+    ucs_cpu_set_t cpu_mask;
+    int cpu, index, num_cpus;
+
+    if (!ucs_async_thread_cpu_mask(&cpu_mask)) {
+        return;
+    }
+
+    num_cpus = ucs_cpu_set_count(&cpu_mask);
+    if (num_cpus == 0) {
+        ucs_warn("no CPUs match async thread affinity and NUMA nodes "
+                 "configuration");
+        return;
+    }
+
+    /* Bind every thread to a single CPU, in a round-robin order */
+    index = thread->shard % num_cpus;
+    for (cpu = 0; (cpu < UCS_CPU_SETSIZE) && (index >= 0); ++cpu) {
+        index -= ucs_cpu_is_set(cpu, &cpu_mask);
+    }
+    --cpu;
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    if (ucs_sys_setaffinity(&cpuset) == -1) {
+        ucs_diag("failed to bind async thread %u to cpu %d: %m", thread->shard,
+                 cpu);
+        return;
+    }
+
+    ucs_debug("async thread %u is bound to cpu %d", thread->shard, cpu);
+}
+
+
 static void ucs_async_thread_hold(ucs_async_thread_t *thread)
 {
     ucs_atomic_add32(&thread->refcnt, 1);
@@ -94,19 +191,18 @@ static void ucs_async_thread_ev_handler(void *callback_data,
 static void *ucs_async_thread_func(void *arg)
 {
     ucs_async_thread_t *thread = arg;
-    ucs_time_t last_time, curr_time, timer_interval, time_spent;
+    ucs_time_t curr_time, next_expiration, time_left;
     int is_missed, timeout_ms;
     ucs_status_t status;
     unsigned num_events;
     ucs_async_thread_callback_arg_t cb_arg;
 
     is_missed        = 0;
-    curr_time        = ucs_get_time();
-    last_time        = ucs_get_time();
     cb_arg.thread    = thread;
     cb_arg.is_missed = &is_missed;
 
     ucs_log_set_thread_name("a");
+    ucs_async_thread_set_affinity(thread);
 
     while (!thread->stop) {
         num_events = ucs_min(UCS_ASYNC_EPOLL_MAX_EVENTS,
@@ -118,14 +214,16 @@ static void *ucs_async_thread_func(void *arg)
             is_missed = 0;
         }
 
-        /* Wait until the remainder of current period */
-        timer_interval = ucs_timerq_min_interval(&thread->timerq);
-        if (timer_interval == UCS_TIME_INFINITY) {
+        /* Wait until the next timer expiration */
+        next_expiration = ucs_timerq_next_expiration(&thread->timerq);
+        if (next_expiration == UCS_TIME_INFINITY) {
             timeout_ms = -1;
         } else {
-            time_spent = curr_time - last_time;
-            timeout_ms = ucs_time_to_msec(timer_interval -
-                                          ucs_min(time_spent, timer_interval));
+            /* Round up, to not wake up before the timer expires */
+            curr_time  = ucs_get_time();
+            time_left  = next_expiration - ucs_min(curr_time, next_expiration);
+            timeout_ms = ucs_div_round_up((uint64_t)ucs_time_to_usec(time_left),
+                                          UCS_USEC_PER_SEC / UCS_MSEC_PER_SEC);
         }
 
         status = ucs_event_set_wait(thread->event_set,
@@ -138,13 +236,11 @@ static void *ucs_async_thread_func(void *arg)
 
         /* Check timers */
         curr_time = ucs_get_time();
-        if (curr_time - last_time > timer_interval) {
+        if (curr_time >= next_expiration) {
             status = ucs_async_dispatch_timerq(&thread->timerq, curr_time);
             if (status == UCS_ERR_NO_PROGRESS) {
                  is_missed = 1;
             }
-
-            last_time = curr_time;
         }
     }
 
@@ -152,22 +248,27 @@ static void *ucs_async_thread_func(void *arg)
     return NULL;
 }
 
-static ucs_status_t ucs_async_thread_start(ucs_async_thread_t **thread_p)
+static ucs_status_t ucs_async_thread_start(unsigned shard_index,
+                                           ucs_async_thread_t **thread_p)
 {
+    ucs_async_thread_shard_t *shard;
     ucs_async_thread_t *thread;
     ucs_status_t status;
     int wakeup_rfd;
 
-    ucs_trace_func("");
+    ucs_trace_func("shard=%u", shard_index);
+
+    ucs_assert(shard_index < UCS_ASYNC_THREAD_MAX_SHARDS);
+    shard = &ucs_async_thread_global_context.shards[shard_index];
 
     pthread_mutex_lock(&ucs_async_thread_global_context.lock);
-    if (ucs_async_thread_global_context.use_count++ > 0) {
+    if (shard->use_count++ > 0) {
         /* Thread already started */
         status = UCS_OK;
         goto out_unlock;
     }
 
-    ucs_assert_always(ucs_async_thread_global_context.thread == NULL);
+    ucs_assert_always(shard->thread == NULL);
 
     thread = ucs_malloc(sizeof(*thread), "async_thread_context");
     if (thread == NULL) {
@@ -177,6 +278,7 @@ static ucs_status_t ucs_async_thread_start(ucs_async_thread_t **thread_p)
 
     thread->stop   = 0;
     thread->refcnt = 1;
+    thread->shard  = shard_index;
 
     status = ucs_timerq_init(&thread->timerq);
     if (status != UCS_OK) {
@@ -204,13 +306,13 @@ static ucs_status_t ucs_async_thread_start(ucs_async_thread_t **thread_p)
     }
 
     status = ucs_pthread_create(&thread->thread_id, ucs_async_thread_func,
-                                thread, "async");
+                                thread, "async%u", shard_index);
     if (status != UCS_OK) {
         goto err_free_event_set;
     }
 
-    ucs_async_thread_global_context.thread = thread;
-    status = UCS_OK;
+    shard->thread = thread;
+    status        = UCS_OK;
     goto out_unlock;
 
 err_free_event_set:
@@ -222,32 +324,48 @@ err_timerq_cleanup:
 err_free:
     ucs_free(thread);
 err:
-    --ucs_async_thread_global_context.use_count;
+    --shard->use_count;
+    pthread_mutex_unlock(&ucs_async_thread_global_context.lock);
+    return status;
+
 out_unlock:
-    ucs_assert_always(ucs_async_thread_global_context.thread != NULL);
-    *thread_p = ucs_async_thread_global_context.thread;
+    ucs_assert_always(shard->thread != NULL);
+    *thread_p = shard->thread;
     pthread_mutex_unlock(&ucs_async_thread_global_context.lock);
     return status;
 }
 
 static int ucs_async_thread_is_from_async()
 {
-    return pthread_self() == ucs_async_thread_global_context.thread->thread_id;
+    pthread_t self = pthread_self();
+    ucs_async_thread_t *thread;
+    unsigned i;
+
+    for (i = 0; i < UCS_ASYNC_THREAD_MAX_SHARDS; ++i) {
+        thread = ucs_async_thread_global_context.shards[i].thread;
+        if ((thread != NULL) && pthread_equal(self, thread->thread_id)) {
+            return 1;
+        }
+    }
+
+    return 0;
 }
 
-static void ucs_async_thread_stop()
+static void ucs_async_thread_stop(unsigned shard_index)
 {
-    ucs_async_thread_t *thread = NULL;
+    ucs_async_thread_shard_t *shard =
+            &ucs_async_thread_global_context.shards[shard_index];
+    ucs_async_thread_t *thread      = NULL;
 
-    ucs_trace_func("");
+    ucs_trace_func("shard=%u", shard_index);
 
     pthread_mutex_lock(&ucs_async_thread_global_context.lock);
-    if (--ucs_async_thread_global_context.use_count == 0) {
-        thread = ucs_async_thread_global_context.thread;
+    if (--shard->use_count == 0) {
+        thread = shard->thread;
         ucs_async_thread_hold(thread);
         thread->stop = 1;
         ucs_async_pipe_push(&thread->wakeup);
-        ucs_async_thread_global_context.thread = NULL;
+        shard->thread = NULL;
     }
     pthread_mutex_unlock(&ucs_async_thread_global_context.lock);
 
@@ -263,6 +381,7 @@ static void ucs_async_thread_stop()
 
 static ucs_status_t ucs_async_thread_spinlock_init(ucs_async_context_t *async)
 {
+    ucs_async_thread_context_assign(async);
     return ucs_recursive_spinlock_init(&async->thread.spinlock, 0);
 }
 
@@ -286,6 +405,8 @@ static ucs_status_t ucs_async_thread_mutex_init(ucs_async_context_t *async)
     pthread_mutexattr_t attr;
     int ret;
 
+    ucs_async_thread_context_assign(async);
+
 #if UCS_ENABLE_ASSERT
     async->thread.mutex.owner = UCS_ASYNC_PTHREAD_ID_NULL;
     async->thread.mutex.count = 0;
@@ -318,7 +439,7 @@ static ucs_status_t ucs_async_thread_add_event_fd(ucs_async_context_t *async,
     ucs_async_thread_t *thread;
     ucs_status_t status;
 
-    status = ucs_async_thread_start(&thread);
+    status = ucs_async_thread_start(ucs_async_thread_shard(async), &thread);
     if (status != UCS_OK) {
         goto err;
     }
@@ -335,7 +456,7 @@ static ucs_status_t ucs_async_thread_add_event_fd(ucs_async_context_t *async,
     return UCS_OK;
 
 err_removed:
-    ucs_async_thread_stop();
+    ucs_async_thread_stop(ucs_async_thread_shard(async));
 err:
     return status;
 }
@@ -343,7 +464,7 @@ err:
 static ucs_status_t ucs_async_thread_remove_event_fd(ucs_async_context_t *async,
                                                      int event_fd)
 {
-    ucs_async_thread_t *thread = ucs_async_thread_global_context.thread;
+    ucs_async_thread_t *thread = ucs_async_thread_get(async);
     ucs_status_t status;
 
     status = ucs_event_set_del(thread->event_set, event_fd);
@@ -351,7 +472,7 @@ static ucs_status_t ucs_async_thread_remove_event_fd(ucs_async_context_t *async,
         return status;
     }
 
-    ucs_async_thread_stop();
+    ucs_async_thread_stop(ucs_async_thread_shard(async));
     return UCS_OK;
 }
 
@@ -360,8 +481,8 @@ ucs_async_thread_modify_event_fd(ucs_async_context_t *async, int event_fd,
                                  ucs_event_set_types_t events)
 {
     /* Store file descriptor into void * storage without memory allocation. */
-    return ucs_event_set_mod(ucs_async_thread_global_context.thread->event_set,
-                             event_fd, events, (void *)(uintptr_t)event_fd);
+    return ucs_event_set_mod(ucs_async_thread_get(async)->event_set, event_fd,
+                             events, (void *)(uintptr_t)event_fd);
 }
 
 static int ucs_async_thread_mutex_try_block(ucs_async_context_t *async)
@@ -398,7 +519,7 @@ static ucs_status_t ucs_async_thread_add_timer(ucs_async_context_t *async,
         goto err;
     }
 
-    status = ucs_async_thread_start(&thread);
+    status = ucs_async_thread_start(ucs_async_thread_shard(async), &thread);
     if (status != UCS_OK) {
         goto err;
     }
@@ -412,7 +533,7 @@ static ucs_status_t ucs_async_thread_add_timer(ucs_async_context_t *async,
     return UCS_OK;
 
 err_stop:
-    ucs_async_thread_stop();
+    ucs_async_thread_stop(ucs_async_thread_shard(async));
 err:
     return status;
 }
@@ -420,18 +541,24 @@ err:
 static ucs_status_t ucs_async_thread_remove_timer(ucs_async_context_t *async,
                                                   int timer_id)
 {
-    ucs_async_thread_t *thread = ucs_async_thread_global_context.thread;
+    ucs_async_thread_t *thread = ucs_async_thread_get(async);
     ucs_timerq_remove(&thread->timerq, timer_id);
     ucs_async_pipe_push(&thread->wakeup);
-    ucs_async_thread_stop();
+    ucs_async_thread_stop(ucs_async_thread_shard(async));
     return UCS_OK;
 }
 
 static void ucs_async_thread_global_cleanup()
 {
-    if (ucs_async_thread_global_context.thread != NULL) {
-        ucs_diag("async thread still running (use count %u)",
-                 ucs_async_thread_global_context.use_count);
+    ucs_async_thread_shard_t *shard;
+    unsigned i;
+
+    for (i = 0; i < UCS_ASYNC_THREAD_MAX_SHARDS; ++i) {
+        shard = &ucs_async_thread_global_context.shards[i];
+        if (shard->thread != NULL) {
+            ucs_diag("async thread %u still running (use count %u)", i,
+                     shard->use_count);
+        }
     }
 }
 
@@ -26,6 +26,7 @@ typedef struct ucs_async_thread_context {
         ucs_recursive_spinlock_t spinlock;
         ucs_async_thread_mutex_t mutex;
     };
+    unsigned                     shard; /* Index of the async thread */
 } ucs_async_thread_context_t;
 
 
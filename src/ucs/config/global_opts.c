@@ -39,6 +39,7 @@ ucs_global_opts_t ucs_global_opts = {
     .warn_unused_env_vars  = 1,
     .enable_memtype_cache  = UCS_TRY,
     .async_signo           = SIGALRM,
+    .async_threads         = 1,
     .stats_dest            = "",
     .tuning_path           = "",
     .memtrack_dest         = "",
@@ -160,6 +161,25 @@ static ucs_config_field_t ucs_global_opts_table[] = {
   "Signal number used for async signaling.",
   ucs_offsetof(ucs_global_opts_t, async_signo), UCS_CONFIG_TYPE_SIGNO},
 
+ {"ASYNC_THREADS", "1",
+  "Number of threads which handle the events and timers of thread mode async\n"
+  "contexts. Every async context is assigned to one of the threads in a\n"
+  "round-robin order.",
+  ucs_offsetof(ucs_global_opts_t, async_threads), UCS_CONFIG_TYPE_UINT},
+
+ {"ASYNC_THREAD_AFFINITY", "none",
+  "CPUs to bind the async threads to. The threads are bound to the CPUs of the\n"
+  "list in a round-robin order, one CPU per thread. If set to \"none\", the\n"
+  "threads inherit the affinity of the thread which created them.",
+  ucs_offsetof(ucs_global_opts_t, async_thread_affinity),
+  UCS_CONFIG_TYPE_CPU_SET},
+
+ {"ASYNC_THREAD_NUMA_NODES", "none",
+  "NUMA nodes to bind the async threads to. Only the CPUs which belong to these\n"
+  "nodes are used, combined with ASYNC_THREAD_AFFINITY if both are set.",
+  ucs_offsetof(ucs_global_opts_t, async_thread_numa_nodes),
+  UCS_CONFIG_TYPE_CPU_SET},
+
  {"MEMTRACK_LIMIT", "inf",
   "Memory limit allocated by memtrack. In case if limit is reached then\n"
   "memtrack report is generated and process is terminated.",
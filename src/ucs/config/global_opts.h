@@ -11,6 +11,7 @@
 
 #include <ucs/stats/stats_fwd.h>
 #include <ucs/type/status.h>
+#include <ucs/type/cpu_set.h>
 #include <ucs/sys/compiler_def.h>
 #include <ucs/arch/global_opts.h>
 #include <stddef.h>
@@ -96,6 +97,15 @@ typedef struct {
     /* Signal number used by async handler (for signal mode) */
     unsigned                   async_signo;
 
+    /* Number of async progress threads (for thread mode) */
+    unsigned                   async_threads;
+
+    /* CPUs to bind the async progress threads to */
+    ucs_cpu_set_t              async_thread_affinity;
+
+    /* NUMA nodes to bind the async progress threads to */
+    ucs_cpu_set_t              async_thread_numa_nodes;
+
     /* Destination for detailed memory tracking results: none / stdout / stderr
      */
     char                       *memtrack_dest;
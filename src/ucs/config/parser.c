@@ -22,6 +22,7 @@
 #include <ucs/config/ini.h>
 #include <ucs/sys/lib.h>
 #include <ucs/type/init_once.h>
+#include <ucs/type/cpu_set.h>
 #include <fnmatch.h>
 #include <ctype.h>
 #include <libgen.h>
@@ -808,6 +809,90 @@ ucs_status_t ucs_config_clone_range_spec(const void *src, void *dest, const void
     return UCS_OK;
 }
 
+int ucs_config_sscanf_cpu_set(const char *buf, void *dest, const void *arg)
+{
+    ucs_cpu_set_t *cpu_set = dest;
+    char *str_dup, *token, *saveptr;
+    unsigned first, last, i;
+    int ret = 1;
+    char dummy;
+
+    UCS_CPU_ZERO(cpu_set);
+    if (!strcasecmp(buf, "none")) {
+        return 1;
+    }
+
+    str_dup = ucs_strdup(buf, "config_scanf_cpu_set");
+    if (str_dup == NULL) {
+        return 0;
+    }
+
+    saveptr = NULL;
+    token   = strtok_r(str_dup, ",", &saveptr);
+    while (token != NULL) {
+        if (sscanf(token, "%u-%u%c", &first, &last, &dummy) != 2) {
+            if (sscanf(token, "%u%c", &first, &dummy) != 1) {
+                ret = 0;
+                goto out;
+            }
+            last = first;
+        }
+
+        if ((first > last) || (last >= UCS_CPU_SETSIZE)) {
+            ret = 0;
+            goto out;
+        }
+
+        for (i = first; i <= last; ++i) {
+            UCS_CPU_SET(i, cpu_set);
+        }
+
+        token = strtok_r(NULL, ",", &saveptr);
+    }
+
+out:
+    ucs_free(str_dup);
+    return ret;
+}
+
+int ucs_config_sprintf_cpu_set(char *buf, size_t max, const void *src,
+                               const void *arg)
+{
+    const ucs_cpu_set_t *cpu_set = src;
+    UCS_STRING_BUFFER_FIXED(strb, buf, max);
+    int first, i;
+
+    for (i = 0; i < UCS_CPU_SETSIZE; ++i) {
+        if (!ucs_cpu_is_set(i, cpu_set)) {
+            continue;
+        }
+
+        for (first = i; (i + 1 < UCS_CPU_SETSIZE) &&
+                        ucs_cpu_is_set(i + 1, cpu_set); ++i) {
+        }
+
+        if (first == i) {
+            ucs_string_buffer_appendf(&strb, "%d,", i);
+        } else {
+            ucs_string_buffer_appendf(&strb, "%d-%d,", first, i);
+        }
+    }
+
+    if (ucs_string_buffer_length(&strb) == 0) {
+        ucs_string_buffer_appendf(&strb, "none");
+    }
+
+    ucs_string_buffer_rtrim(&strb, ",");
+    return 1;
+}
+
+ucs_status_t ucs_config_clone_cpu_set(const void *src, void *dest,
+                                      const void *arg)
+{
+    memcpy(dest, src, sizeof(ucs_cpu_set_t));
+    return UCS_OK;
+}
+
 int ucs_config_sscanf_array(const char *buf, void *dest, const void *arg)
 {
     ucs_config_array_field_t *field = dest;
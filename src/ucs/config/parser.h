@@ -262,6 +262,10 @@ int ucs_config_sscanf_range_spec(const char *buf, void *dest, const void *arg);
 int ucs_config_sprintf_range_spec(char *buf, size_t max, const void *src, const void *arg);
 ucs_status_t ucs_config_clone_range_spec(const void *src, void *dest, const void *arg);
 
+int ucs_config_sscanf_cpu_set(const char *buf, void *dest, const void *arg);
+int ucs_config_sprintf_cpu_set(char *buf, size_t max, const void *src, const void *arg);
+ucs_status_t ucs_config_clone_cpu_set(const void *src, void *dest, const void *arg);
+
 int ucs_config_sscanf_array(const char *buf, void *dest, const void *arg);
 int ucs_config_sprintf_array(char *buf, size_t max, const void *src, const void *arg);
 ucs_status_t ucs_config_clone_array(const void *src, void *dest, const void *arg);
@@ -444,6 +448,11 @@ void ucs_config_help_generic(char *buf, size_t max, const void *arg);
                                     ucs_config_help_generic,     ucs_config_doc_nop, \
                                     "numbers range: <number>-<number>"}
 
+#define UCS_CONFIG_TYPE_CPU_SET    {ucs_config_sscanf_cpu_set,   ucs_config_sprintf_cpu_set, \
+                                    ucs_config_clone_cpu_set,    ucs_config_release_nop, \
+                                    ucs_config_help_generic,     ucs_config_doc_nop, \
+                                    "comma-separated list of numbers and ranges <number>-<number>, or \"none\""}
+
 #define UCS_CONFIG_TYPE_DEPRECATED {(ucs_field_type(ucs_config_parser_t, read))   ucs_empty_function_do_assert, \
                                     (ucs_field_type(ucs_config_parser_t, write))  ucs_empty_function_do_assert, \
                                     (ucs_field_type(ucs_config_parser_t, clone))  ucs_empty_function_do_assert, \
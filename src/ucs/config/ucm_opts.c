@@ -45,6 +45,11 @@ static ucs_config_field_t ucm_global_config_table[] = {
    " reloc  - Use ELF relocation table to set hooks.\n"
 #if UCM_BISTRO_HOOKS
    " bistro - Use binary instrumentation to set hooks.\n"
+#endif
+#if UCM_UFFD_HOOKS
+   " uffd   - Don't set hooks, detect memory unmap with userfaultfd(2).\n"
+   "          Only memory unmap events are supported, and they are reported\n"
+   "          asynchronously, for memory ranges registered by ucm_mem_watch().\n"
 #endif
    ,ucs_offsetof(ucm_global_config_t, mmap_hook_mode),
                  UCS_CONFIG_TYPE_ENUM(ucm_mmap_hook_modes)},
@@ -12,22 +12,75 @@
 
 #include <ucs/debug/assert.h>
 #include <ucs/debug/log.h>
+#include <string.h>
+
+
+static const char *ucs_arbiter_prio_names[] = {
+    [UCS_ARBITER_PRIO_HIGH]   = "high",
+    [UCS_ARBITER_PRIO_NORMAL] = "normal",
+    [UCS_ARBITER_PRIO_BULK]   = "bulk"
+};
+
+#ifdef ENABLE_STATS
+static ucs_stats_class_t ucs_arbiter_stats_class = {
+    .name          = "arbiter",
+    .num_counters  = UCS_ARBITER_PRIO_LAST,
+    .class_id      = UCS_STATS_CLASS_ID_INVALID,
+    .counter_names = {
+        [UCS_ARBITER_PRIO_HIGH]   = "dispatch_high",
+        [UCS_ARBITER_PRIO_NORMAL] = "dispatch_normal",
+        [UCS_ARBITER_PRIO_BULK]   = "dispatch_bulk"
+    }
+};
+#endif
 
 
 void ucs_arbiter_init(ucs_arbiter_t *arbiter)
 {
-    ucs_list_head_init(&arbiter->list);
+    ucs_arbiter_prio_t prio;
+
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        ucs_list_head_init(&arbiter->list[prio]);
+    }
+
+    arbiter->weight[UCS_ARBITER_PRIO_HIGH]   = UCS_ARBITER_PRIO_HIGH_WEIGHT;
+    arbiter->weight[UCS_ARBITER_PRIO_NORMAL] = UCS_ARBITER_PRIO_NORMAL_WEIGHT;
+    arbiter->weight[UCS_ARBITER_PRIO_BULK]   = UCS_ARBITER_PRIO_BULK_WEIGHT;
+    memcpy(arbiter->credits, arbiter->weight, sizeof(arbiter->credits));
+    arbiter->prio_mask   = 0;
+    arbiter->resume_prio = UCS_ARBITER_PRIO_LAST;
+    UCS_STATS_NODE_RESET(&arbiter->stats);
+}
+
+ucs_status_t ucs_arbiter_stats_init(ucs_arbiter_t *arbiter,
+                                    ucs_stats_node_t *stats_parent,
+                                    const char *name)
+{
+    return UCS_STATS_NODE_ALLOC(&arbiter->stats, &ucs_arbiter_stats_class,
+                                stats_parent, "-%s", name);
+}
+
+void ucs_arbiter_set_weight(ucs_arbiter_t *arbiter, ucs_arbiter_prio_t prio,
+                            uint8_t weight)
+{
+    ucs_assert(prio < UCS_ARBITER_PRIO_LAST);
+    arbiter->weight[prio]  = weight;
+    arbiter->credits[prio] = weight;
 }
 
 void ucs_arbiter_group_init(ucs_arbiter_group_t *group)
 {
-    group->tail = NULL;
+    group->tail      = NULL;
+    group->prio_elem = NULL;
+    group->prio      = UCS_ARBITER_PRIO_NORMAL;
+    group->base_prio = UCS_ARBITER_PRIO_NORMAL;
     UCS_ARBITER_GROUP_GUARD_INIT(group);
 }
 
 void ucs_arbiter_cleanup(ucs_arbiter_t *arbiter)
 {
     ucs_assert_always(ucs_arbiter_is_empty(arbiter));
+    UCS_STATS_NODE_FREE(arbiter->stats);
 }
 
 void ucs_arbiter_group_cleanup(ucs_arbiter_group_t *group)
@@ -52,6 +105,30 @@ static inline void ucs_arbiter_elem_set_scheduled(ucs_arbiter_elem_t *elem,
     elem->group = group;
 }
 
+static inline void ucs_arbiter_group_reset_prio(ucs_arbiter_group_t *group)
+{
+    group->prio_elem = NULL;
+    group->prio      = UCS_ARBITER_PRIO_NORMAL;
+    group->base_prio = UCS_ARBITER_PRIO_NORMAL;
+}
+
+/* Update the mask of non-empty classes after removing a group from a class */
+static UCS_F_ALWAYS_INLINE void
+ucs_arbiter_prio_mask_update(ucs_arbiter_t *arbiter, unsigned prio)
+{
+    if (ucs_list_is_empty(&arbiter->list[prio])) {
+        arbiter->prio_mask &= ~UCS_BIT(prio);
+    }
+}
+
+static UCS_F_ALWAYS_INLINE void
+ucs_arbiter_list_add_tail(ucs_arbiter_t *arbiter, unsigned prio,
+                          ucs_arbiter_elem_t *head)
+{
+    ucs_list_add_tail(&arbiter->list[prio], &head->list);
+    arbiter->prio_mask |= UCS_BIT(prio);
+}
+
 void ucs_arbiter_group_push_elem_always(ucs_arbiter_group_t *group,
                                         ucs_arbiter_elem_t *elem)
 {
@@ -60,7 +137,8 @@ void ucs_arbiter_group_push_elem_always(ucs_arbiter_group_t *group,
     if (tail == NULL) {
         /* group is empty */
         ucs_arbiter_group_head_reset(elem);
-        elem->next = elem;        /* Connect to itself */
+        elem->next  = elem;       /* Connect to itself */
+        ucs_arbiter_group_reset_prio(group);
     } else {
         elem->next = tail->next;  /* Point to first element */
         tail->next = elem;        /* Point previous element to new one */
@@ -85,6 +163,7 @@ void ucs_arbiter_group_push_head_elem_always(ucs_arbiter_group_t *group,
     if (tail == NULL) {
         elem->next  = elem;   /* Connect to itself */
         group->tail = elem;   /* Update group tail */
+        ucs_arbiter_group_reset_prio(group);
         return;
     }
 
@@ -105,6 +184,7 @@ void ucs_arbiter_group_purge(ucs_arbiter_t *arbiter,
 {
     ucs_arbiter_elem_t *tail            = group->tail;
     ucs_arbiter_elem_t dummy_group_head = {};
+    ucs_arbiter_elem_t *last_kept       = NULL;
     ucs_arbiter_elem_t *ptr, *next, *prev;
     ucs_arbiter_cb_result_t result;
     ucs_arbiter_elem_t *head;
@@ -135,6 +215,12 @@ void ucs_arbiter_group_purge(ucs_arbiter_t *arbiter,
         result    = cb(arbiter, group, ptr, cb_arg);
 
         if (result == UCS_ARBITER_CB_RESULT_REMOVE_ELEM) {
+            if (ptr == group->prio_elem) {
+                /* the class is raised until the previous element which is
+                 * kept, if any */
+                group->prio_elem = last_kept;
+            }
+
             if (ptr == head) {
                 head = next;
                 if (ptr == tail) {
@@ -142,6 +228,7 @@ void ucs_arbiter_group_purge(ucs_arbiter_t *arbiter,
                     group->tail = NULL;
                     if (sched_group) {
                         ucs_list_del(&dummy_group_head.list);
+                        ucs_arbiter_prio_mask_update(arbiter, group->prio);
                     }
                     /* Break here to avoid further processing of the group */
                     return;
@@ -157,6 +244,7 @@ void ucs_arbiter_group_purge(ucs_arbiter_t *arbiter,
             /* keep the element */
             ucs_arbiter_elem_set_scheduled(ptr, group);
             prev       = ptr;
+            last_kept  = ptr;
         }
     } while (ptr != tail);
 
@@ -169,6 +257,11 @@ void ucs_arbiter_group_purge(ucs_arbiter_t *arbiter,
         /* mark the group head (could be old or new) as unscheduled */
         ucs_arbiter_group_head_reset(head);
     }
+
+    if (group->prio_elem == NULL) {
+        /* all the elements which raised the class of the group are removed */
+        ucs_arbiter_group_set_prio(arbiter, group, group->base_prio);
+    }
 }
 
 size_t ucs_arbiter_group_num_elems(ucs_arbiter_group_t *group)
@@ -207,7 +300,34 @@ ucs_arbiter_schedule_head_if_not_scheduled(ucs_arbiter_t *arbiter,
                                            ucs_arbiter_elem_t *head)
 {
     if (!ucs_arbiter_group_head_is_scheduled(head)) {
-        ucs_list_add_tail(&arbiter->list, &head->list);
+        ucs_arbiter_list_add_tail(arbiter, head->group->prio, head);
+    }
+}
+
+void ucs_arbiter_group_set_prio(ucs_arbiter_t *arbiter,
+                                ucs_arbiter_group_t *group,
+                                ucs_arbiter_prio_t prio)
+{
+    ucs_arbiter_prio_t old_prio = (ucs_arbiter_prio_t)group->prio;
+    ucs_arbiter_elem_t *head;
+
+    ucs_assert(prio < UCS_ARBITER_PRIO_LAST);
+    if (old_prio == prio) {
+        return;
+    }
+
+    group->prio = prio;
+    if (ucs_arbiter_group_is_empty(group)) {
+        return;
+    }
+
+    /* The head may be a dummy element if the group is being dispatched */
+    head = group->tail->next;
+    if (ucs_arbiter_group_head_is_scheduled(head)) {
+        UCS_ARBITER_GROUP_ARBITER_CHECK(group, arbiter);
+        ucs_list_del(&head->list);
+        ucs_arbiter_prio_mask_update(arbiter, old_prio);
+        ucs_arbiter_list_add_tail(arbiter, prio, head);
     }
 }
 
@@ -237,14 +357,17 @@ void ucs_arbiter_group_desched_nonempty(ucs_arbiter_t *arbiter,
     UCS_ARBITER_GROUP_ARBITER_CHECK(group, arbiter);
     UCS_ARBITER_GROUP_ARBITER_SET(group, NULL);
     ucs_list_del(&head->list);
+    ucs_arbiter_prio_mask_update(arbiter, group->prio);
     ucs_arbiter_group_head_reset(head);
 }
 
 static inline void
-ucs_arbiter_remove_and_reset_if_scheduled(ucs_arbiter_elem_t *elem)
+ucs_arbiter_remove_and_reset_if_scheduled(ucs_arbiter_t *arbiter,
+                                          ucs_arbiter_elem_t *elem)
 {
     if (ucs_unlikely(ucs_arbiter_group_head_is_scheduled(elem))) {
          ucs_list_del(&elem->list);
+         ucs_arbiter_prio_mask_update(arbiter, elem->group->prio);
          ucs_arbiter_group_head_reset(elem);
      }
 }
@@ -266,24 +389,69 @@ ucs_arbiter_group_head_replace(ucs_arbiter_group_t *group,
     group->tail->next = new_group_head;
 }
 
+static UCS_F_ALWAYS_INLINE ucs_arbiter_prio_t
+ucs_arbiter_select_prio(ucs_arbiter_t *arbiter)
+{
+    ucs_arbiter_prio_t prio;
+    int UCS_V_UNUSED starved;
+
+    prio = (ucs_arbiter_prio_t)arbiter->resume_prio;
+    if (ucs_unlikely(prio != UCS_ARBITER_PRIO_LAST)) {
+        /* Resume from the group which stopped the previous dispatch, its class
+         * already used a credit for it */
+        arbiter->resume_prio = UCS_ARBITER_PRIO_LAST;
+        if (arbiter->prio_mask & UCS_BIT(prio)) {
+            return prio;
+        }
+    }
+
+    for (;;) {
+        starved = 0;
+        for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+            if (!(arbiter->prio_mask & UCS_BIT(prio))) {
+                continue;
+            }
+
+            if (arbiter->weight[prio] == 0) {
+                return prio; /* strict priority */
+            }
+
+            if (arbiter->credits[prio] > 0) {
+                --arbiter->credits[prio];
+                return prio;
+            }
+
+            starved = 1;
+        }
+
+        /* all scheduled classes used up their share, start a new round */
+        ucs_assert(starved);
+        memcpy(arbiter->credits, arbiter->weight, sizeof(arbiter->credits));
+    }
+}
+
 void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
                                    ucs_arbiter_callback_t cb, void *cb_arg)
 {
-    ucs_arbiter_elem_t *group_head;
+    ucs_arbiter_elem_t *group_head, *next_head;
     ucs_arbiter_cb_result_t result;
     unsigned group_dispatch_count;
     ucs_arbiter_group_t *group;
     UCS_LIST_HEAD(resched_list);
     ucs_arbiter_elem_t dummy;
+    ucs_arbiter_prio_t prio;
+    int demote;
 
-    ucs_assert(!ucs_list_is_empty(&arbiter->list));
+    ucs_assert(!ucs_arbiter_is_empty(arbiter));
 
     ucs_arbiter_group_head_reset(&dummy);
 
     do {
-        group_head = ucs_list_extract_head(&arbiter->list, ucs_arbiter_elem_t,
-                                           list);
+        prio       = ucs_arbiter_select_prio(arbiter);
+        group_head = ucs_list_extract_head(&arbiter->list[prio],
+                                           ucs_arbiter_elem_t, list);
         ucs_assert(group_head != NULL);
+        ucs_arbiter_prio_mask_update(arbiter, prio);
 
         /* Reset group head to allow the group to be moved to another arbiter by
          * the dispatch callback. For example, when a DC endpoint is moved from
@@ -296,6 +464,15 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
         dummy.group          = group;
         UCS_ARBITER_GROUP_GUARD_CHECK(group);
 
+        if (ucs_unlikely((group->prio_elem == NULL) &&
+                         (group->prio != group->base_prio))) {
+            /* The elements which raised the class of the group were already
+             * dispatched, return it to its own class */
+            group->prio = group->base_prio;
+            ucs_arbiter_list_add_tail(arbiter, group->prio, group_head);
+            continue;
+        }
+
         for (;;) {
             ucs_assert(group_head->group   == group);
             ucs_assert(dummy.group         == group);
@@ -315,12 +492,17 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
              */
             ucs_arbiter_group_head_replace(group, group_head, &dummy);
 
+            /* the element may be released by the callback, so only its
+             * address is compared */
+            demote = (group_head == group->prio_elem);
+
             /* dispatch the element */
             ucs_trace_poll("dispatching arbiter element %p", group_head);
             UCS_ARBITER_GROUP_GUARD_ENTER(group);
             result = cb(arbiter, group, group_head, cb_arg);
             UCS_ARBITER_GROUP_GUARD_EXIT(group);
             ucs_trace_poll("dispatch result: %d", result);
+            UCS_STATS_UPDATE_COUNTER(arbiter->stats, prio, 1);
             ++group_dispatch_count;
 
             /* recursive push to head (during dispatch) is not allowed */
@@ -349,18 +531,22 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
                 } else {
                     /* remove a recursively scheduled group, give priority
                      * to the original order */
-                    ucs_arbiter_remove_and_reset_if_scheduled(&dummy);
+                    ucs_arbiter_remove_and_reset_if_scheduled(arbiter, &dummy);
 
                     if (result == UCS_ARBITER_CB_RESULT_NEXT_GROUP) {
                         /* add to arbiter tail */
-                        ucs_list_add_tail(&arbiter->list, &group_head->list);
+                        ucs_arbiter_list_add_tail(arbiter, group->prio,
+                                                  group_head);
                     } else if (result == UCS_ARBITER_CB_RESULT_RESCHED_GROUP) {
                         /* add to resched list */
                         ucs_list_add_tail(&resched_list, &group_head->list);
                     } else if (result == UCS_ARBITER_CB_RESULT_STOP) {
                         /* exit the outmost loop and make sure that next dispatch()
                          * will continue from the current group */
-                        ucs_list_add_head(&arbiter->list, &group_head->list);
+                        ucs_list_add_head(&arbiter->list[group->prio],
+                                          &group_head->list);
+                        arbiter->prio_mask  |= UCS_BIT(group->prio);
+                        arbiter->resume_prio = group->prio;
                         goto out;
                     } else {
                         ucs_bug("unexpected return value from arbiter callback");
@@ -374,7 +560,7 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
             if (dummy.next == &dummy) {
                 group->tail = NULL; /* group is empty now */
                 group_head  = NULL; /* for debugging */
-                ucs_arbiter_remove_and_reset_if_scheduled(&dummy);
+                ucs_arbiter_remove_and_reset_if_scheduled(arbiter, &dummy);
                 UCS_ARBITER_GROUP_ARBITER_SET(group, NULL);
                 break;
             }
@@ -383,65 +569,89 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
             group_head        = dummy.next;  /* Update group head */
             group->tail->next = group_head;  /* Tail points to new head */
 
+            if (ucs_unlikely(demote)) {
+                /* the elements which raised the class of the group are
+                 * dispatched */
+                group->prio_elem = NULL;
+            }
+
             if (ucs_unlikely(ucs_arbiter_group_head_is_scheduled(&dummy))) {
-                /* take over a recursively scheduled group */
+                /* take over a recursively scheduled group, it's returned to
+                 * its own class when selected next time */
                 ucs_list_replace(&dummy.list, &group_head->list);
                 ucs_arbiter_group_head_reset(&dummy);
                 /* the group is already scheduled, continue to next group */
                 break;
-            } else if (group_dispatch_count >= per_group) {
+            } else if ((group_dispatch_count >= per_group) ||
+                       ucs_unlikely(demote)) {
                 /* add to arbiter tail and continue to next group */
-                ucs_list_add_tail(&arbiter->list, &group_head->list);
+                if (demote) {
+                    group->prio = group->base_prio;
+                }
+                ucs_arbiter_list_add_tail(arbiter, group->prio, group_head);
                 break;
             }
 
             /* continue with new group head */
             ucs_arbiter_group_head_reset(group_head);
         }
-    } while (!ucs_list_is_empty(&arbiter->list));
+    } while (!ucs_arbiter_is_empty(arbiter));
 
 out:
-    ucs_list_splice_tail(&arbiter->list, &resched_list);
+    ucs_list_for_each_safe(group_head, next_head, &resched_list, list) {
+        ucs_arbiter_list_add_tail(arbiter, group_head->group->prio, group_head);
+    }
 }
 
 void ucs_arbiter_dump(ucs_arbiter_t *arbiter, FILE *stream)
 {
     static const int max_groups = 100;
     ucs_arbiter_elem_t *group_head, *elem;
+    ucs_arbiter_prio_t prio;
     int count;
 
     fprintf(stream, "-------\n");
-    if (ucs_list_is_empty(&arbiter->list)) {
+    if (ucs_arbiter_is_empty(arbiter)) {
         fprintf(stream, "(empty)\n");
         goto out;
     }
 
     count = 0;
-    ucs_list_for_each(group_head, &arbiter->list, list) {
-        elem = group_head;
-        if (ucs_list_head(&arbiter->list, ucs_arbiter_elem_t, list) == group_head) {
-            fprintf(stream, "=> ");
-        } else {
-            fprintf(stream, " * ");
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; ++prio) {
+        if (ucs_list_is_empty(&arbiter->list[prio])) {
+            continue;
         }
-        do {
-            fprintf(stream, "[%p", elem);
-            if (elem == group_head) {
-                fprintf(stream, " prev_g:%p", elem->list.prev);
-                fprintf(stream, " next_g:%p", elem->list.next);
+
+        fprintf(stream, "%s (weight %u credits %u):\n",
+                ucs_arbiter_prio_names[prio], arbiter->weight[prio],
+                arbiter->credits[prio]);
+        ucs_list_for_each(group_head, &arbiter->list[prio], list) {
+            elem = group_head;
+            if (ucs_list_head(&arbiter->list[prio], ucs_arbiter_elem_t,
+                              list) == group_head) {
+                fprintf(stream, "=> ");
+            } else {
+                fprintf(stream, " * ");
             }
-            fprintf(stream, " next_e:%p grp:%p]", elem->next, elem->group);
-            if (elem->next != group_head) {
-                fprintf(stream, "->");
+            do {
+                fprintf(stream, "[%p", elem);
+                if (elem == group_head) {
+                    fprintf(stream, " prev_g:%p", elem->list.prev);
+                    fprintf(stream, " next_g:%p", elem->list.next);
+                }
+                fprintf(stream, " next_e:%p grp:%p]", elem->next, elem->group);
+                if (elem->next != group_head) {
+                    fprintf(stream, "->");
+                }
+                elem = elem->next;
+            } while (elem != group_head);
+            fprintf(stream, "\n");
+            ++count;
+            if (count > max_groups) {
+                fprintf(stream, "more than %d groups - not printing any more\n",
+                        max_groups);
+                goto out;
             }
-            elem = elem->next;
-        } while (elem != group_head);
-        fprintf(stream, "\n");
-        ++count;
-        if (count > max_groups) {
-            fprintf(stream, "more than %d groups - not printing any more\n",
-                    max_groups);
-            break;
         }
     }
 
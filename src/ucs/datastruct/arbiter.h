@@ -10,6 +10,7 @@
 #include <ucs/sys/compiler_def.h>
 #include <ucs/datastruct/list.h>
 #include <ucs/type/status.h>
+#include <ucs/stats/stats.h>
 #include <stdio.h>
 #include <ucs/debug/assert.h>
 
@@ -26,6 +27,15 @@
  * group is rescheduled, it's moved to the tail of the list. At any point, a
  * group head can be removed from the "middle" of the list.
  *
+ * Every group belongs to a priority class (see @ref ucs_arbiter_prio_t), and
+ * the arbiter holds a separate list for each class. A class with zero weight
+ * is dispatched strictly before the classes that follow it, and the other
+ * classes share the dispatch cycles according to their weights. Since a group
+ * is dispatched in-order, the class is a property of the whole group: pushing
+ * an element with a higher priority raises the class of its group, until that
+ * element is dispatched, and the group returns to the default class once it
+ * becomes empty. The diagram below shows a single class list.
+ *
  * The groups and elements are arranged like this:
  *  - every arbitrated element points to the group (head).
  *  - first element in the group points to previous and next group (list)
@@ -98,9 +108,28 @@ typedef enum {
                                            is finished group automatically
                                            scheduled */
     UCS_ARBITER_CB_RESULT_STOP          /* Stop dispatching work altogether. Next dispatch()
-                                           will start from the group that returned STOP */
+                                           will start from the group that returned STOP,
+                                           regardless of its priority class */
 } ucs_arbiter_cb_result_t;
 
+
+/**
+ * Arbitration priority classes, from the highest to the lowest.
+ */
+typedef enum {
+    UCS_ARBITER_PRIO_HIGH,    /* Latency-sensitive work, such as connection
+                                 establishment and keepalive */
+    UCS_ARBITER_PRIO_NORMAL,  /* Default class */
+    UCS_ARBITER_PRIO_BULK,    /* Large data transfers */
+    UCS_ARBITER_PRIO_LAST
+} ucs_arbiter_prio_t;
+
+
+/* Default weights of the priority classes, 0 means strict priority */
+#define UCS_ARBITER_PRIO_HIGH_WEIGHT    0
+#define UCS_ARBITER_PRIO_NORMAL_WEIGHT  4
+#define UCS_ARBITER_PRIO_BULK_WEIGHT    1
+
 #if UCS_ENABLE_ASSERT
 #define UCS_ARBITER_GROUP_GUARD_DEFINE          int guard
 #define UCS_ARBITER_GROUP_GUARD_INIT(_group)    (_group)->guard = 0
@@ -146,7 +175,15 @@ typedef ucs_arbiter_cb_result_t (*ucs_arbiter_callback_t)(ucs_arbiter_t *arbiter
  * Top-level arbiter.
  */
 struct ucs_arbiter {
-    ucs_list_link_t         list;
+    ucs_list_link_t         list[UCS_ARBITER_PRIO_LAST]; /* Scheduled group
+                                                            heads per class */
+    uint8_t                 weight[UCS_ARBITER_PRIO_LAST];
+    uint8_t                 credits[UCS_ARBITER_PRIO_LAST];
+    uint8_t                 prio_mask;   /* Classes with scheduled groups */
+    uint8_t                 resume_prio; /* Class of the group which stopped
+                                            the last dispatch, or
+                                            UCS_ARBITER_PRIO_LAST */
+    UCS_STATS_NODE_DECLARE(stats)
 };
 
 
@@ -155,6 +192,12 @@ struct ucs_arbiter {
  */
 struct ucs_arbiter_group {
     ucs_arbiter_elem_t      *tail;
+    ucs_arbiter_elem_t      *prio_elem; /* Last element which raised the class
+                                           of the group, or NULL */
+    uint8_t                 prio;       /* Priority class,
+                                           @ref ucs_arbiter_prio_t */
+    uint8_t                 base_prio;  /* Class of the group when it is not
+                                           raised by its elements */
     UCS_ARBITER_GROUP_GUARD_DEFINE;
     UCS_ARBITER_GROUP_ARBITER_DEFINE;
 };
@@ -180,6 +223,32 @@ void ucs_arbiter_init(ucs_arbiter_t *arbiter);
 void ucs_arbiter_cleanup(ucs_arbiter_t *arbiter);
 
 
+/**
+ * Create a statistics node which counts the dispatched elements of every
+ * priority class. The node is released by @ref ucs_arbiter_cleanup.
+ *
+ * @param [in]  arbiter       Arbiter object.
+ * @param [in]  stats_parent  Parent statistics node.
+ * @param [in]  name          Name suffix of the statistics node.
+ */
+ucs_status_t ucs_arbiter_stats_init(ucs_arbiter_t *arbiter,
+                                    ucs_stats_node_t *stats_parent,
+                                    const char *name);
+
+
+/**
+ * Set the weight of a priority class. Classes with non-zero weight share the
+ * dispatch cycles proportionally to their weight, and a class with zero weight
+ * is dispatched strictly before all classes which follow it.
+ *
+ * @param [in]  arbiter  Arbiter object.
+ * @param [in]  prio     Priority class.
+ * @param [in]  weight   New weight of the class.
+ */
+void ucs_arbiter_set_weight(ucs_arbiter_t *arbiter, ucs_arbiter_prio_t prio,
+                            uint8_t weight);
+
+
 /**
  * Initialize a group object.
  *
@@ -220,6 +289,19 @@ void ucs_arbiter_group_push_head_elem_always(ucs_arbiter_group_t *group,
                                              ucs_arbiter_elem_t *elem);
 
 
+/**
+ * Set the current priority class of a group. If the group is scheduled, it's
+ * moved to the tail of the new class list of the arbiter.
+ *
+ * @param [in]  arbiter  Arbiter object the group may be scheduled on.
+ * @param [in]  group    Group to update.
+ * @param [in]  prio     New priority class.
+ */
+void ucs_arbiter_group_set_prio(ucs_arbiter_t *arbiter,
+                                ucs_arbiter_group_t *group,
+                                ucs_arbiter_prio_t prio);
+
+
 /**
  * Call the callback for each element from a group. If the callback returns
  * UCS_ARBITER_CB_RESULT_REMOVE_ELEM, remove it from the group.
@@ -264,7 +346,7 @@ void ucs_arbiter_dispatch_nonempty(ucs_arbiter_t *arbiter, unsigned per_group,
  */
 static inline int ucs_arbiter_is_empty(ucs_arbiter_t *arbiter)
 {
-    return ucs_list_is_empty(&arbiter->list);
+    return arbiter->prio_mask == 0;
 }
 
 
@@ -278,6 +360,28 @@ ucs_arbiter_group_tail(ucs_arbiter_group_t *group)
 }
 
 
+/**
+ * Get the element which follows a given element of a group. It can be used to
+ * look ahead at the queued elements from the dispatch callback of the group.
+ *
+ * @param [in]  group    Non-empty group to look at.
+ * @param [in]  elem     Element of the group, or NULL to start from the head.
+ *
+ * @return The element following @a elem, or NULL if @a elem is the last one.
+ */
+static inline ucs_arbiter_elem_t*
+ucs_arbiter_group_next_elem(ucs_arbiter_group_t *group,
+                            ucs_arbiter_elem_t *elem)
+{
+    if (elem == NULL) {
+        /* during dispatch the head is replaced by a dummy element */
+        elem = group->tail->next;
+    }
+
+    return (elem == group->tail) ? NULL : elem->next;
+}
+
+
 /**
  * @return whether the group does not have any queued elements.
  */
@@ -319,6 +423,16 @@ static inline void ucs_arbiter_group_desched(ucs_arbiter_t *arbiter,
 }
 
 
+/**
+ * @return the priority class of the group.
+ */
+static inline ucs_arbiter_prio_t
+ucs_arbiter_group_prio(ucs_arbiter_group_t *group)
+{
+    return (ucs_arbiter_prio_t)group->prio;
+}
+
+
 /**
  * @return Whether the element is queued in an arbiter group.
  *         (an element can't be queued more than once)
@@ -365,6 +479,40 @@ ucs_arbiter_group_push_head_elem(ucs_arbiter_group_t *group,
 }
 
 
+/**
+ * Add a new work element to a group with a priority hint. If the group was
+ * empty, it gets the class of the element. Otherwise, the class of the group is
+ * raised to @a prio if it's lower, until the element is dispatched.
+ *
+ * @param [in]  arbiter  Arbiter object the group may be scheduled on.
+ * @param [in]  group    Group to add the element to.
+ * @param [in]  elem     Work element to add.
+ * @param [in]  prio     Priority class of the element.
+ */
+static inline void
+ucs_arbiter_group_push_elem_prio(ucs_arbiter_t *arbiter,
+                                 ucs_arbiter_group_t *group,
+                                 ucs_arbiter_elem_t *elem,
+                                 ucs_arbiter_prio_t prio)
+{
+    int was_empty = ucs_arbiter_group_is_empty(group);
+
+    ucs_arbiter_group_push_elem_always(group, elem);
+    if (was_empty) {
+        if (ucs_unlikely(prio != group->prio)) {
+            group->base_prio = prio;
+            ucs_arbiter_group_set_prio(arbiter, group, prio);
+        }
+    } else if (ucs_unlikely(prio < group->prio)) {
+        group->prio_elem = elem;
+        ucs_arbiter_group_set_prio(arbiter, group, prio);
+    } else if ((prio == group->prio) && (group->prio_elem != NULL)) {
+        /* keep the raised class until this element is dispatched as well */
+        group->prio_elem = elem;
+    }
+}
+
+
 /**
  * Dispatch work elements in the arbiter. For every group, up to per_group work
  * elements are dispatched, as long as the callback returns REMOVE_ELEM or
@@ -372,6 +520,8 @@ ucs_arbiter_group_push_head_elem(ucs_arbiter_group_t *group,
  * arbiter becomes empty or the callback returns STOP. If a group is either out
  * of elements, or its callback returns REMOVE_GROUP, it will be removed until
  * ucs_arbiter_group_schedule() is used to put it back on the arbiter.
+ * Groups are selected according to their priority class, and within a class
+ * in round-robin order.
  *
  * @param [in]  arbiter    Arbiter object to dispatch work on.
  * @param [in]  per_group  How many elements to dispatch from each group.
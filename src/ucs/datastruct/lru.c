@@ -49,6 +49,23 @@ void ucs_lru_destroy(ucs_lru_h lru)
     ucs_free(lru);
 }
 
+ucs_status_t ucs_lru_remove(ucs_lru_h lru, void *key)
+{
+    ucs_lru_element_t *item;
+    khint_t iter;
+
+    iter = kh_get(ucs_lru_hash, &lru->hash, (uint64_t)key);
+    if (iter == kh_end(&lru->hash)) {
+        return UCS_ERR_NO_ELEM;
+    }
+
+    item = kh_val(&lru->hash, iter);
+    ucs_list_del(&item->list);
+    kh_del(ucs_lru_hash, &lru->hash, iter);
+    ucs_free(item);
+    return UCS_OK;
+}
+
 void ucs_lru_reset(ucs_lru_h lru)
 {
     ucs_lru_element_t *item;
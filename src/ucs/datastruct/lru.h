@@ -98,6 +98,19 @@ static UCS_F_ALWAYS_INLINE int ucs_lru_is_present(ucs_lru_h lru, void *key)
 }
 
 
+/**
+ * @brief Get the number of elements in the cache.
+ *
+ * @param [in] lru  Handle to the LRU cache.
+ *
+ * @return Number of elements in the cache.
+ */
+static UCS_F_ALWAYS_INLINE size_t ucs_lru_size(ucs_lru_h lru)
+{
+    return kh_size(&lru->hash);
+}
+
+
 /**
  * @brief Insert or update an element in the cache.
  *
@@ -130,6 +143,18 @@ static UCS_F_ALWAYS_INLINE void ucs_lru_push(ucs_lru_h lru, void *key)
 }
 
 
+/**
+ * @brief Remove an element from the cache.
+ *
+ * @param [in] lru  Handle to the LRU cache.
+ * @param [in] key  Element's key.
+ *
+ * @return UCS_OK if the element was removed, UCS_ERR_NO_ELEM if it was not
+ *         found in the cache.
+ */
+ucs_status_t ucs_lru_remove(ucs_lru_h lru, void *key);
+
+
 /**
  * @brief Resets an LRU object.
  *
@@ -141,8 +141,9 @@ ucs_status_t ucs_usage_tracker_get_score(ucs_usage_tracker_h usage_tracker,
     return UCS_OK;
 }
 
-ucs_status_t
-ucs_usage_tracker_remove(ucs_usage_tracker_h usage_tracker, void *key)
+/* Remove an entry from the hash table, keeping its recent usage. */
+static ucs_status_t
+ucs_usage_tracker_hash_remove(ucs_usage_tracker_h usage_tracker, void *key)
 {
     khiter_t iter;
 
@@ -155,6 +156,21 @@ ucs_usage_tracker_remove(ucs_usage_tracker_h usage_tracker, void *key)
     return UCS_OK;
 }
 
+ucs_status_t
+ucs_usage_tracker_remove(ucs_usage_tracker_h usage_tracker, void *key)
+{
+    ucs_status_t lru_status;
+
+    /* The key must not be inserted back by the next progress */
+    lru_status = ucs_lru_remove(usage_tracker->lru, key);
+    if ((ucs_usage_tracker_hash_remove(usage_tracker, key) != UCS_OK) &&
+        (lru_status != UCS_OK)) {
+        return UCS_ERR_NO_ELEM;
+    }
+
+    return UCS_OK;
+}
+
 /* Checks if an entry has high enough score to get promoted. */
 static int ucs_usage_tracker_compare(const void *elem_ptr1,
                                      const void *elem_ptr2, void *arg)
@@ -224,7 +240,7 @@ static void ucs_usage_tracker_promote(ucs_usage_tracker_h usage_tracker)
     for (elem_index = params->promote_capacity; elem_index < elems_count;
          ++elem_index) {
         item = elems_array[elem_index];
-        ucs_usage_tracker_remove(usage_tracker, item->key);
+        ucs_usage_tracker_hash_remove(usage_tracker, item->key);
         if (!item->promoted) {
             continue;
         }
@@ -19,6 +19,8 @@
 #include <stdint.h>
 #include <sched.h>
 #include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #define UCS_NUMA_MIN_DISTANCE       10
 #define UCS_NUMA_NODE_MAX           INT16_MAX
@@ -26,6 +28,12 @@
 #define UCS_NUMA_NODES_DIR_PATH     UCS_SYS_FS_SYSTEM_PATH "/node"
 #define UCS_NUMA_NODE_DISTANCE_PATH UCS_NUMA_NODES_DIR_PATH "/node%d/distance"
 
+/* Memory policy parameters of mbind(), as defined in linux/mempolicy.h */
+#define UCS_NUMA_MPOL_PREFERRED     1
+#define UCS_NUMA_MPOL_MF_MOVE       UCS_BIT(1)
+#define UCS_NUMA_MBIND_MAX_NODES    1024
+#define UCS_NUMA_MASK_WORD_BITS     (sizeof(unsigned long) * 8)
+
 
 KHASH_MAP_INIT_INT(numa_distance, ucs_numa_distance_t);
 
@@ -243,6 +251,49 @@ ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2)
     return distance;
 }
 
+ucs_numa_node_t ucs_numa_node_of_current_cpu()
+{
+    int cpu = sched_getcpu();
+
+    if ((cpu < 0) || (cpu >= __CPU_SETSIZE)) {
+        return UCS_NUMA_NODE_DEFAULT;
+    }
+
+    return ucs_numa_node_of_cpu(cpu);
+}
+
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_node_t node)
+{
+#ifdef __NR_mbind
+    unsigned long nodemask[UCS_NUMA_MBIND_MAX_NODES / UCS_NUMA_MASK_WORD_BITS] = {0};
+    long ret;
+
+    if ((node < 0) || (node >= UCS_NUMA_MBIND_MAX_NODES)) {
+        ucs_debug("cannot bind memory to numa node %d", node);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    nodemask[node / UCS_NUMA_MASK_WORD_BITS] |= UCS_BIT(node % UCS_NUMA_MASK_WORD_BITS);
+
+    /* The kernel takes the number of valid mask bits plus one */
+    ret = syscall(__NR_mbind, address, length, UCS_NUMA_MPOL_PREFERRED,
+                  nodemask, UCS_NUMA_MBIND_MAX_NODES + 1,
+                  UCS_NUMA_MPOL_MF_MOVE);
+    if (ret != 0) {
+        ucs_debug("mbind(address=%p length=%zu node=%d) failed: %m", address,
+                  length, node);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    ucs_trace("bound memory %p..%p to numa node %d", address,
+              UCS_PTR_BYTE_OFFSET(address, length), node);
+    return UCS_OK;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
 void ucs_numa_init()
 {
     ucs_spinlock_init(&ucs_numa_global_ctx.lock, 0);
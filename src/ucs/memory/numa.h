@@ -7,6 +7,8 @@
 #ifndef UCS_NUMA_H_
 #define UCS_NUMA_H_
 
+#include <ucs/type/status.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define UCS_NUMA_NODE_DEFAULT    0
@@ -66,4 +68,24 @@ ucs_numa_node_t ucs_numa_node_of_device(const char *dev_path);
 ucs_numa_distance_t
 ucs_numa_distance(ucs_numa_node_t node1, ucs_numa_node_t node2);
 
+
+/**
+ * @return The NUMA node of the CPU the calling thread is running on.
+ */
+ucs_numa_node_t ucs_numa_node_of_current_cpu();
+
+
+/**
+ * Set a preferred NUMA node for a memory range, and migrate the pages of the
+ * range which are already mapped by the calling process to that node.
+ *
+ * @param [in]  address Page-aligned start address of the memory range.
+ * @param [in]  length  Length of the memory range.
+ * @param [in]  node    NUMA node to place the memory on.
+ *
+ * @return UCS_OK on success, or an error code if the policy could not be set.
+ */
+ucs_status_t ucs_numa_mem_bind(void *address, size_t length,
+                               ucs_numa_node_t node);
+
 #endif
@@ -24,6 +24,9 @@
 #include <ucs/type/spinlock.h>
 #include <ucs/vfs/base/vfs_obj.h>
 #include <ucm/api/ucm.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <fcntl.h>
 
 #include "rcache.h"
 #include "rcache_int.h"
@@ -35,6 +38,29 @@
 #define ucs_rcache_region_pfn_ptr(_region) \
     ((_region)->pfn)
 
+/* Shared memory object which holds the node-wide registered size */
+#define UCS_RCACHE_NODE_SHM_NAME  "/ucx_rcache_node_%u"
+
+/* Maximal number of processes which account their size in the node object */
+#define UCS_RCACHE_NODE_MAX_PROCS 1024
+
+
+/* Byte ranges of the node object used as locks */
+enum {
+    /* Held in shared mode by every attached process, the last process to
+     * detach removes the object */
+    UCS_RCACHE_NODE_LOCK_ATTACH,
+    /* Serializes checking the limit and adding to a process size */
+    UCS_RCACHE_NODE_LOCK_ACCOUNT
+};
+
+
+/* Registered size of one process in the node object */
+typedef struct {
+    volatile pid_t    pid;  /* Owner process, or 0 if the slot is free */
+    volatile uint64_t size; /* Size registered by the owner process */
+} ucs_rcache_node_slot_t;
+
 
 enum {
     /* Need to page table lock while destroying */
@@ -91,6 +117,8 @@ static ucs_stats_class_t ucs_rcache_stats_class = {
         [UCS_RCACHE_PUTS]               = "puts",
         [UCS_RCACHE_REGS]               = "mem_regs",
         [UCS_RCACHE_DEREGS]             = "mem_deregs",
+        [UCS_RCACHE_EVICTIONS]          = "evictions",
+        [UCS_RCACHE_LIMIT_FAILS]        = "node_limit_fails",
     }
 };
 #endif
@@ -121,6 +149,24 @@ ucs_config_field_t ucs_config_rcache_table[] = {
      "Purge registration cache upon fork",
      ucs_offsetof(ucs_rcache_config_t, purge_on_fork), UCS_CONFIG_TYPE_BOOL},
 
+    {"RCACHE_NODE_MAX_SIZE", "inf",
+     "Maximal total size of memory registered on the node by all registration\n"
+     "caches which set this limit, accounted per process in a shared memory\n"
+     "object of the current user. The size of processes which exited without\n"
+     "cleanup is released when the limit is reached, and the object is removed\n"
+     "by the last process using it. Idle regions are evicted to stay below the\n"
+     "limit, and if this is not possible the registration fails without calling\n"
+     "the memory domain.",
+     ucs_offsetof(ucs_rcache_config_t, node_max_size),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
+    {"RCACHE_EVICT_SCAN", "1",
+     "Number of least recently used idle regions to examine when choosing a\n"
+     "region to evict. The region of the largest size class among them is\n"
+     "evicted first, so fewer evictions are needed to satisfy a size limit.\n"
+     "The value 1 means plain LRU order.",
+     ucs_offsetof(ucs_rcache_config_t, evict_scan), UCS_CONFIG_TYPE_UINT},
+
     {NULL}
 };
 
@@ -137,13 +183,23 @@ typedef struct {
 
     /* Used for triggering an rcache cleanup */
     ucs_async_pipe_t pipe;
+
+    /* Node-wide registered sizes, mapped from shared memory while there are
+     * rcaches with a node size limit */
+    struct {
+        ucs_rcache_node_slot_t *slots;    /* Slots of all processes */
+        ucs_rcache_node_slot_t *self;     /* Slot of the current process */
+        int                    fd;        /* Node object file descriptor */
+        unsigned               refcount;  /* Number of rcaches using it */
+    } node;
 } ucs_rcache_global_context_t;
 
 static ucs_rcache_global_context_t ucs_rcache_global_context = {
-    .lock = PTHREAD_MUTEX_INITIALIZER,
-    .list = UCS_LIST_INITIALIZER(&ucs_rcache_global_context.list,
-             &ucs_rcache_global_context.list),
-    .pipe = UCS_ASYNC_PIPE_INITIALIZER
+    .lock      = PTHREAD_MUTEX_INITIALIZER,
+    .list      = UCS_LIST_INITIALIZER(&ucs_rcache_global_context.list,
+                  &ucs_rcache_global_context.list),
+    .pipe      = UCS_ASYNC_PIPE_INITIALIZER,
+    .node      = {NULL, NULL, -1, 0}
 };
 
 void ucs_rcache_region_log(const char *file, int line, const char *function,
@@ -187,6 +243,8 @@ void ucs_rcache_set_default_params(ucs_rcache_params_t *rcache_params)
     rcache_params->max_regions        = UCS_MEMUNITS_INF;
     rcache_params->max_size           = UCS_MEMUNITS_INF;
     rcache_params->max_unreleased     = UCS_MEMUNITS_INF;
+    rcache_params->node_max_size      = UCS_MEMUNITS_INF;
+    rcache_params->evict_scan         = 1;
 }
 
 void ucs_rcache_set_params(ucs_rcache_params_t *rcache_params,
@@ -198,6 +256,8 @@ void ucs_rcache_set_params(ucs_rcache_params_t *rcache_params,
     rcache_params->max_regions        = rcache_config->max_regions;
     rcache_params->max_size           = rcache_config->max_size;
     rcache_params->max_unreleased     = rcache_config->max_unreleased;
+    rcache_params->node_max_size      = rcache_config->node_max_size;
+    rcache_params->evict_scan         = rcache_config->evict_scan;
     rcache_params->flags              = !rcache_config->purge_on_fork ? 0 :
                                         UCS_RCACHE_FLAG_PURGE_ON_FORK;
 }
@@ -388,6 +448,314 @@ ucs_rcache_region_lru_put(ucs_rcache_t *rcache, ucs_rcache_region_t *region)
     ucs_spin_unlock(&rcache->lru.lock);
 }
 
+static int ucs_rcache_has_node_limit(ucs_rcache_t *rcache)
+{
+    return rcache->params.node_max_size != UCS_MEMUNITS_INF;
+}
+
+static void ucs_rcache_node_shm_name(char *shm_name, size_t max)
+{
+    ucs_snprintf_zero(shm_name, max, UCS_RCACHE_NODE_SHM_NAME, getuid());
+}
+
+static int ucs_rcache_node_lock(int lock, short type, int wait)
+{
+    struct flock fl = {
+        .l_type   = type,
+        .l_whence = SEEK_SET,
+        .l_start  = lock,
+        .l_len    = 1
+    };
+
+    /* Open file description locks are released by the kernel if the process
+     * exits without unlocking */
+    return fcntl(ucs_rcache_global_context.node.fd,
+                 wait ? F_OFD_SETLKW : F_OFD_SETLK, &fl);
+}
+
+static void ucs_rcache_node_lock_account()
+{
+    int ret;
+
+    do {
+        ret = ucs_rcache_node_lock(UCS_RCACHE_NODE_LOCK_ACCOUNT, F_WRLCK, 1);
+    } while ((ret < 0) && (errno == EINTR));
+
+    if (ret < 0) {
+        ucs_fatal("failed to lock the rcache node object: %m");
+    }
+}
+
+static void ucs_rcache_node_unlock_account()
+{
+    ucs_rcache_node_lock(UCS_RCACHE_NODE_LOCK_ACCOUNT, F_UNLCK, 0);
+}
+
+static int ucs_rcache_node_slot_is_stale(const ucs_rcache_node_slot_t *slot)
+{
+    return (slot->pid != 0) && (kill(slot->pid, 0) < 0) && (errno == ESRCH);
+}
+
+/* Sum the sizes of all processes, optionally releasing the slots of processes
+ * which exited without detaching. Account lock must be held when releasing. */
+static size_t ucs_rcache_node_total_size(int release_stale)
+{
+    ucs_rcache_node_slot_t *slot;
+    size_t total = 0;
+
+    for (slot = ucs_rcache_global_context.node.slots;
+         slot < ucs_rcache_global_context.node.slots + UCS_RCACHE_NODE_MAX_PROCS;
+         ++slot) {
+        if (slot->pid == 0) {
+            continue;
+        }
+
+        if (release_stale && ucs_rcache_node_slot_is_stale(slot)) {
+            ucs_debug("releasing %" PRIu64 " bytes of exited process %d from "
+                      "the rcache node object", slot->size, slot->pid);
+            slot->size = 0;
+            slot->pid  = 0;
+            continue;
+        }
+
+        total += slot->size;
+    }
+
+    return total;
+}
+
+/* Try to account 'size' bytes of the current process without crossing the
+ * node limit */
+static int ucs_rcache_node_try_add(ucs_rcache_t *rcache, size_t size)
+{
+    size_t max_size = rcache->params.node_max_size;
+    int success;
+
+    ucs_rcache_node_lock_account();
+    /* Sizes of exited processes are released only when they matter, to avoid
+     * checking all processes on every registration */
+    success = ((ucs_rcache_node_total_size(0) + size) <= max_size) ||
+              ((ucs_rcache_node_total_size(1) + size) <= max_size);
+    if (success) {
+        ucs_atomic_add64(&ucs_rcache_global_context.node.self->size, size);
+    }
+    ucs_rcache_node_unlock_account();
+
+    return success;
+}
+
+static void ucs_rcache_node_remove(ucs_rcache_t *rcache, size_t size)
+{
+    if (ucs_rcache_has_node_limit(rcache)) {
+        ucs_atomic_sub64(&ucs_rcache_global_context.node.self->size, size);
+    }
+}
+
+/* Open the node object, and make sure it was not removed by the last process
+ * which detached from it before we locked it */
+static ucs_status_t ucs_rcache_node_open(const char *shm_name)
+{
+    struct stat st_fd, st_name;
+    int fd, ret;
+
+    for (;;) {
+        fd = shm_open(shm_name, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd < 0) {
+            ucs_error("shm_open(%s) failed: %m", shm_name);
+            return UCS_ERR_SHMEM_SEGMENT;
+        }
+
+        ucs_rcache_global_context.node.fd = fd;
+        do {
+            ret = ucs_rcache_node_lock(UCS_RCACHE_NODE_LOCK_ATTACH, F_RDLCK,
+                                       1);
+        } while ((ret < 0) && (errno == EINTR));
+        if (ret < 0) {
+            ucs_error("failed to lock %s: %m", shm_name);
+            goto err_close;
+        }
+
+        ret = fstat(fd, &st_fd);
+        if (ret < 0) {
+            ucs_error("fstat(%s) failed: %m", shm_name);
+            goto err_close;
+        }
+
+        /* Check if the name still refers to the object we locked */
+        fd = shm_open(shm_name, O_RDWR, 0);
+        if (fd >= 0) {
+            ret = fstat(fd, &st_name);
+            close(fd);
+            if ((ret == 0) && (st_name.st_ino == st_fd.st_ino)) {
+                return UCS_OK;
+            }
+        }
+
+        close(ucs_rcache_global_context.node.fd);
+    }
+
+err_close:
+    close(ucs_rcache_global_context.node.fd);
+    ucs_rcache_global_context.node.fd = -1;
+    return UCS_ERR_SHMEM_SEGMENT;
+}
+
+static void ucs_rcache_node_close(const char *shm_name)
+{
+    /* If no other process holds the attach lock, we are the last user */
+    if (ucs_rcache_node_lock(UCS_RCACHE_NODE_LOCK_ATTACH, F_WRLCK, 0) == 0) {
+        ucs_debug("removing rcache node object %s", shm_name);
+        shm_unlink(shm_name);
+    }
+
+    close(ucs_rcache_global_context.node.fd);
+    ucs_rcache_global_context.node.fd = -1;
+}
+
+static ucs_rcache_node_slot_t *ucs_rcache_node_slot_find_free()
+{
+    ucs_rcache_node_slot_t *slot;
+
+    for (slot = ucs_rcache_global_context.node.slots;
+         slot < ucs_rcache_global_context.node.slots + UCS_RCACHE_NODE_MAX_PROCS;
+         ++slot) {
+        if (slot->pid == 0) {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+static ucs_status_t ucs_rcache_node_attach_locked()
+{
+    const size_t size = sizeof(ucs_rcache_node_slot_t) *
+                        UCS_RCACHE_NODE_MAX_PROCS;
+    ucs_rcache_node_slot_t *slot;
+    char shm_name[NAME_MAX];
+    ucs_status_t status;
+    void *ptr;
+
+    if (ucs_rcache_global_context.node.refcount++ > 0) {
+        return UCS_OK;
+    }
+
+    ucs_rcache_node_shm_name(shm_name, sizeof(shm_name));
+    status = ucs_rcache_node_open(shm_name);
+    if (status != UCS_OK) {
+        goto err;
+    }
+
+    /* A newly created object is zero-filled, which means all slots are free.
+     * Extending an existing object to the same size is a no-op. */
+    if (ftruncate(ucs_rcache_global_context.node.fd, size) < 0) {
+        ucs_error("ftruncate(%s) failed: %m", shm_name);
+        status = UCS_ERR_SHMEM_SEGMENT;
+        goto err_close;
+    }
+
+    ptr = ucm_orig_mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        ucs_rcache_global_context.node.fd, 0);
+    if (ptr == MAP_FAILED) {
+        ucs_error("mmap(%s) failed: %m", shm_name);
+        status = UCS_ERR_SHMEM_SEGMENT;
+        goto err_close;
+    }
+
+    ucs_rcache_global_context.node.slots = ptr;
+
+    /* Take a free slot, or if there is none, release the slots of processes
+     * which exited without detaching and try again */
+    ucs_rcache_node_lock_account();
+    slot = ucs_rcache_node_slot_find_free();
+    if (slot == NULL) {
+        ucs_rcache_node_total_size(1);
+        slot = ucs_rcache_node_slot_find_free();
+    }
+    if (slot != NULL) {
+        slot->size = 0;
+        slot->pid  = getpid();
+        ucs_rcache_global_context.node.self = slot;
+    }
+    ucs_rcache_node_unlock_account();
+
+    if (ucs_rcache_global_context.node.self == NULL) {
+        ucs_error("%s: all %d process slots are used", shm_name,
+                  UCS_RCACHE_NODE_MAX_PROCS);
+        status = UCS_ERR_EXCEEDS_LIMIT;
+        goto err_unmap;
+    }
+
+    return UCS_OK;
+
+err_unmap:
+    ucm_orig_munmap(ucs_rcache_global_context.node.slots, size);
+    ucs_rcache_global_context.node.slots = NULL;
+err_close:
+    ucs_rcache_node_close(shm_name);
+err:
+    --ucs_rcache_global_context.node.refcount;
+    return status;
+}
+
+static void ucs_rcache_node_detach_locked()
+{
+    ucs_rcache_node_slot_t *self = ucs_rcache_global_context.node.self;
+    char shm_name[NAME_MAX];
+
+    ucs_assert(ucs_rcache_global_context.node.refcount > 0);
+    if (--ucs_rcache_global_context.node.refcount > 0) {
+        return;
+    }
+
+    /* Regions leaked by the destroyed rcaches are not registered anymore */
+    self->size = 0;
+    self->pid  = 0;
+
+    ucm_orig_munmap(ucs_rcache_global_context.node.slots,
+                    sizeof(ucs_rcache_node_slot_t) * UCS_RCACHE_NODE_MAX_PROCS);
+    ucs_rcache_global_context.node.slots = NULL;
+    ucs_rcache_global_context.node.self  = NULL;
+
+    ucs_rcache_node_shm_name(shm_name, sizeof(shm_name));
+    ucs_rcache_node_close(shm_name);
+}
+
+static ucs_status_t ucs_rcache_node_attach(ucs_rcache_t *rcache)
+{
+    ucs_status_t status;
+
+    if (!ucs_rcache_has_node_limit(rcache)) {
+        return UCS_OK;
+    }
+
+    pthread_mutex_lock(&ucs_rcache_global_context.lock);
+    status = ucs_rcache_node_attach_locked();
+    pthread_mutex_unlock(&ucs_rcache_global_context.lock);
+    return status;
+}
+
+static void ucs_rcache_node_detach(ucs_rcache_t *rcache)
+{
+    if (!ucs_rcache_has_node_limit(rcache)) {
+        return;
+    }
+
+    pthread_mutex_lock(&ucs_rcache_global_context.lock);
+    ucs_rcache_node_detach_locked();
+    pthread_mutex_unlock(&ucs_rcache_global_context.lock);
+}
+
+size_t ucs_rcache_node_registered_size()
+{
+    /* The object stays mapped while the calling rcache exists */
+    if (ucs_rcache_global_context.node.slots == NULL) {
+        return 0;
+    }
+
+    return ucs_rcache_node_total_size(0);
+}
+
 static ucs_rcache_distribution_t *
 ucs_rcache_distribution_get_bin(ucs_rcache_t *rcache, size_t region_size)
 {
@@ -420,8 +788,11 @@ void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
                 region->super.start, region->super.end, rcache->name);
     ucs_assert(!(region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE));
 
+    region_size = region->super.end - region->super.start;
+
     if (region->flags & UCS_RCACHE_REGION_FLAG_REGISTERED) {
         UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_DEREGS, 1);
+        ucs_rcache_node_remove(rcache, region_size);
 
         if (drop_lock) {
             pthread_rwlock_unlock(&rcache->pgt_lock);
@@ -447,7 +818,6 @@ void ucs_mem_region_destroy_internal(ucs_rcache_t *rcache,
     ucs_spin_unlock(&rcache->lru.lock);
 
     --rcache->num_regions;
-    region_size         = region->super.end - region->super.start;
     rcache->total_size -= region_size;
 
     distribution_bin = ucs_rcache_distribution_get_bin(rcache, region_size);
@@ -709,30 +1079,69 @@ static void ucs_rcache_clean(ucs_rcache_t *rcache)
 }
 
 /* Lock must be held in write mode */
-static void ucs_rcache_lru_evict(ucs_rcache_t *rcache)
+static int ucs_rcache_lru_is_over_limit(ucs_rcache_t *rcache, size_t reserve)
 {
-    int num_evicted, num_skipped;
-    ucs_rcache_region_t *region;
+    return (rcache->num_regions > rcache->params.max_regions) ||
+           (rcache->total_size > rcache->params.max_size) ||
+           ((reserve > 0) && ucs_rcache_has_node_limit(rcache) &&
+            ((ucs_rcache_node_registered_size() + reserve) >
+             rcache->params.node_max_size));
+}
 
-    num_evicted = 0;
-    num_skipped = 0;
+/* LRU lock must be held */
+static ucs_rcache_region_t *
+ucs_rcache_lru_evict_candidate(ucs_rcache_t *rcache, int *num_skipped)
+{
+    ucs_rcache_region_t *region, *tmp, *candidate;
+    unsigned num_scanned, size_class, candidate_size_class;
 
-    ucs_spin_lock(&rcache->lru.lock);
-    while (!ucs_list_is_empty(&rcache->lru.list) &&
-           ((rcache->num_regions > rcache->params.max_regions) ||
-            (rcache->total_size > rcache->params.max_size))) {
-        region = ucs_list_head(&rcache->lru.list, ucs_rcache_region_t,
-                               lru_list);
+    candidate            = NULL;
+    candidate_size_class = 0;
+    num_scanned          = 0;
+
+    ucs_list_for_each_safe(region, tmp, &rcache->lru.list, lru_list) {
         ucs_assert(region->lru_flags & UCS_RCACHE_LRU_FLAG_IN_LRU);
 
         if (!(region->flags & UCS_RCACHE_REGION_FLAG_PGTABLE) ||
             (region->refcount > 1)) {
             /* region is in use or not in page table - remove from lru */
             ucs_rcache_region_lru_remove(rcache, region);
-            ++num_skipped;
+            ++(*num_skipped);
             continue;
         }
 
+        /* Prefer a larger size class, and the least recently used region
+         * within the same size class */
+        size_class = ucs_ilog2(region->super.end - region->super.start);
+        if ((candidate == NULL) || (size_class > candidate_size_class)) {
+            candidate            = region;
+            candidate_size_class = size_class;
+        }
+
+        if (++num_scanned >= rcache->params.evict_scan) {
+            break;
+        }
+    }
+
+    return candidate;
+}
+
+/* Lock must be held in write mode */
+static void ucs_rcache_lru_evict(ucs_rcache_t *rcache, size_t reserve)
+{
+    int num_evicted, num_skipped;
+    ucs_rcache_region_t *region;
+
+    num_evicted = 0;
+    num_skipped = 0;
+
+    ucs_spin_lock(&rcache->lru.lock);
+    while (ucs_rcache_lru_is_over_limit(rcache, reserve)) {
+        region = ucs_rcache_lru_evict_candidate(rcache, &num_skipped);
+        if (region == NULL) {
+            break;
+        }
+
         ucs_spin_unlock(&rcache->lru.lock);
 
         /* The region is expected to have refcount=1 and present in pgt, so it
@@ -751,12 +1160,38 @@ static void ucs_rcache_lru_evict(ucs_rcache_t *rcache)
     ucs_spin_unlock(&rcache->lru.lock);
 
     if (num_evicted > 0) {
-        ucs_debug("evicted %d regions, skipped %d regions, usage: %lu (%lu)",
-                  num_evicted, num_skipped, rcache->num_regions,
-                  rcache->params.max_regions);
+        UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_EVICTIONS,
+                                 num_evicted);
+        rcache->counters.evictions += num_evicted;
+        ucs_debug("evicted %d regions, skipped %d regions, usage: %lu (%lu) "
+                  "size: %zu (%zu)", num_evicted, num_skipped,
+                  rcache->num_regions, rcache->params.max_regions,
+                  rcache->total_size, rcache->params.max_size);
     }
 }
 
+/* Lock must be held in write mode */
+static ucs_status_t ucs_rcache_node_reserve(ucs_rcache_t *rcache, size_t size)
+{
+    if (!ucs_rcache_has_node_limit(rcache) ||
+        ucs_rcache_node_try_add(rcache, size)) {
+        return UCS_OK;
+    }
+
+    /* Release idle regions of this cache and retry */
+    ucs_rcache_lru_evict(rcache, size);
+    if (ucs_rcache_node_try_add(rcache, size)) {
+        return UCS_OK;
+    }
+
+    UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_LIMIT_FAILS, 1);
+    ++rcache->counters.limit_fails;
+    ucs_debug("%s: cannot register %zu bytes, node usage: %zu (%zu)",
+              rcache->name, size, ucs_rcache_node_registered_size(),
+              rcache->params.node_max_size);
+    return UCS_ERR_EXCEEDS_LIMIT;
+}
+
 /* Lock must be held */
 static ucs_status_t
 ucs_rcache_check_overlap_one(ucs_rcache_t *rcache, ucs_pgt_addr_t *start,
@@ -924,7 +1359,7 @@ ucs_status_t ucs_rcache_create_region(ucs_rcache_t *rcache, void *address,
     ucs_rcache_region_t *region;
     ucs_pgt_addr_t start, end;
     ucs_status_t status;
-    int error, merged;
+    int error, merged, watched;
     size_t region_size;
     ucs_rcache_distribution_t *distribution_bin;
 
@@ -951,6 +1386,7 @@ retry:
         ucs_rcache_region_validate_pfn(rcache, region);
         status = region->status;
         UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_SLOW, 1);
+        ucs_atomic_add64(&rcache->counters.hits, 1);
         goto out_set_region;
     } else if (status != UCS_OK) {
         /* Could not create a region because there are overlapping regions which
@@ -959,6 +1395,13 @@ retry:
         goto out_unlock;
     }
 
+    /* Account the region in the node limit before registering it, so that we
+     * do not pay for a registration which would exceed the limit */
+    status = ucs_rcache_node_reserve(rcache, end - start);
+    if (status != UCS_OK) {
+        goto out_unlock;
+    }
+
     /* Allocate structure for new region */
     error = ucs_posix_memalign((void **)&region,
                                ucs_max(sizeof(void *), UCS_PGT_ENTRY_MIN_ALIGN),
@@ -967,6 +1410,7 @@ retry:
     if (error != 0) {
         ucs_error("failed to allocate rcache region descriptor: %m");
         status = UCS_ERR_NO_MEMORY;
+        ucs_rcache_node_remove(rcache, end - start);
         goto out_unlock;
     }
 
@@ -980,6 +1424,7 @@ retry:
         ucs_error("failed to insert region " UCS_PGT_REGION_FMT ": %s",
                   UCS_PGT_REGION_ARG(&region->super), ucs_status_string(status));
         ucs_free(region);
+        ucs_rcache_node_remove(rcache, end - start);
         goto out_unlock;
     }
 
@@ -1004,10 +1449,19 @@ retry:
     ++distribution_bin->count;
     distribution_bin->total_size += region_size;
 
+    /* With userfaultfd memory events, unmap is reported only for the memory
+     * ranges which were explicitly watched */
+    watched = !(rcache->params.ucm_events & UCM_EVENT_VM_UNMAPPED) ||
+              (ucm_mem_watch((void*)region->super.start, region_size) ==
+               UCS_OK);
+
     region->status = status = UCS_PROFILE_NAMED_CALL_ALWAYS(
             "mem_reg", rcache->params.ops->mem_reg, rcache->params.context,
             rcache, arg, region, merged ? UCS_RCACHE_MEM_REG_HIDE_ERRORS : 0);
     if (status != UCS_OK) {
+        /* Region is not registered, so destroying it does not release the
+         * node limit reservation */
+        ucs_rcache_node_remove(rcache, end - start);
         if (merged) {
             /* failure may be due to merge, because memory of the merged
              * regions has different access permission.
@@ -1032,6 +1486,14 @@ retry:
     region->flags   |= UCS_RCACHE_REGION_FLAG_REGISTERED;
     region->refcount = 2; /* Page-table + user */
 
+    if (!watched) {
+        /* Unmap of this memory would not be reported, so do not keep the
+         * region in the cache after the user releases it */
+        ucs_rcache_region_debug(rcache, region, "not cached");
+        ucs_rcache_region_invalidate_internal(
+                rcache, region, UCS_RCACHE_REGION_PUT_FLAG_IN_PGTABLE);
+    }
+
     if (!(rcache->params.flags & UCS_RCACHE_FLAG_NO_PFN_CHECK)) {
         status = ucs_rcache_fill_pfn(region);
         if (status != UCS_OK) {
@@ -1040,10 +1502,11 @@ retry:
             goto out_unlock;
         }
 
-        ucs_rcache_lru_evict(rcache);
+        ucs_rcache_lru_evict(rcache, 0);
     }
 
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_MISSES, 1);
+    ucs_atomic_add64(&rcache->counters.misses, 1);
 
     ucs_rcache_region_trace(rcache, region, "created");
 
@@ -1072,6 +1535,13 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
     ucs_trace_func("rcache=%s, address=%p, length=%zu", rcache->name, address,
                    length);
 
+    if (ucs_unlikely(ucm_global_opts.mmap_hook_mode == UCM_MMAP_HOOK_UFFD) &&
+        (rcache->params.ucm_events & UCM_EVENT_VM_UNMAPPED)) {
+        /* The memory could be released and mapped again before its unmap event
+         * was dispatched, so invalidate the released regions first */
+        ucm_mem_sync();
+    }
+
     pthread_rwlock_rdlock(&rcache->pgt_lock);
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_GETS, 1);
     if (ucs_queue_is_empty(&rcache->inv_q)) {
@@ -1086,6 +1556,7 @@ ucs_status_t ucs_rcache_get(ucs_rcache_t *rcache, void *address, size_t length,
                 ucs_rcache_region_lru_get(rcache, region);
                 *region_p = region;
                 UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_FAST, 1);
+                ucs_atomic_add64(&rcache->counters.hits, 1);
                 pthread_rwlock_unlock(&rcache->pgt_lock);
                 return UCS_OK;
             }
@@ -1326,6 +1797,7 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
     ucs_list_head_init(&self->gc_list);
     self->num_regions = 0;
     self->total_size  = 0;
+    memset(&self->counters, 0, sizeof(self->counters));
     ucs_list_head_init(&self->lru.list);
     ucs_spinlock_init(&self->lru.lock, 0);
 
@@ -1338,11 +1810,16 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
         goto err_destroy_mp;
     }
 
-    status = ucs_rcache_global_list_add(self);
+    status = ucs_rcache_node_attach(self);
     if (status != UCS_OK) {
         goto err_destroy_dist;
     }
 
+    status = ucs_rcache_global_list_add(self);
+    if (status != UCS_OK) {
+        goto err_node_detach;
+    }
+
     ucs_rcache_vfs_init(self);
 
     status = ucm_set_event_handler(params->ucm_events, params->ucm_event_priority,
@@ -1358,6 +1835,8 @@ static UCS_CLASS_INIT_FUNC(ucs_rcache_t, const ucs_rcache_params_t *params,
 err_remove_vfs:
     ucs_vfs_obj_remove(self);
     ucs_rcache_global_list_remove(self);
+err_node_detach:
+    ucs_rcache_node_detach(self);
 err_destroy_dist:
     ucs_free(self->distribution);
 err_destroy_mp:
@@ -1385,6 +1864,7 @@ static UCS_CLASS_CLEANUP_FUNC(ucs_rcache_t)
     ucs_rcache_check_inv_queue(self, 0);
     ucs_rcache_check_gc_list(self, 0);
     ucs_rcache_purge(self);
+    ucs_rcache_node_detach(self);
 
     if (!ucs_list_is_empty(&self->lru.list)) {
         ucs_warn(
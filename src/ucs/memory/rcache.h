@@ -142,6 +142,17 @@ struct ucs_rcache_params {
     unsigned long          max_regions;         /**< Maximal number of regions */
     size_t                 max_size;            /**< Maximal total size of regions */
     size_t                 max_unreleased;      /**< Threshold for triggering a cleanup */
+    size_t                 node_max_size;       /**< Maximal total size of regions
+                                                     registered on the node by all
+                                                     rcaches which set this limit.
+                                                     Registration fails with
+                                                     UCS_ERR_EXCEEDS_LIMIT if the
+                                                     limit cannot be kept. */
+    unsigned               evict_scan;          /**< Number of least recently used
+                                                     regions to examine when
+                                                     choosing a region to evict;
+                                                     the one with the largest size
+                                                     class is evicted first */
 };
 
 
@@ -156,6 +167,9 @@ struct ucs_rcache_config {
     size_t        max_size;       /**< Maximal size of mapped memory */
     size_t        max_unreleased; /**< Threshold for triggering a cleanup */
     int           purge_on_fork;  /**< Enable/disable rcache purge on fork */
+    size_t        node_max_size;  /**< Maximal size of memory registered on the
+                                       node by all processes */
+    unsigned      evict_scan;     /**< Regions examined per eviction */
 };
 
 
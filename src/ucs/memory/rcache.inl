@@ -77,6 +77,7 @@ ucs_rcache_lookup_unsafe(ucs_rcache_t *rcache, void *address, size_t length,
     region->refcount++;
     ucs_rcache_region_lru_remove(rcache, region);
     UCS_STATS_UPDATE_COUNTER(rcache->stats, UCS_RCACHE_HITS_FAST, 1);
+    ucs_atomic_add64(&rcache->counters.hits, 1);
     return region;
 }
 
@@ -50,6 +50,10 @@ enum {
     UCS_RCACHE_PUTS,                /* number of put operations */
     UCS_RCACHE_REGS,                /* number of memory registrations */
     UCS_RCACHE_DEREGS,              /* number of memory deregistrations */
+    UCS_RCACHE_EVICTIONS,           /* number of regions evicted because of
+                                       size or count limits */
+    UCS_RCACHE_LIMIT_FAILS,         /* number of registrations refused because
+                                       the node size limit was reached */
     UCS_RCACHE_STAT_LAST
 };
 
@@ -99,6 +103,16 @@ struct ucs_rcache {
                                               is the most recently used region. */
     } lru;
 
+    struct {
+        uint64_t        hits;            /**< Number of lookups served from the
+                                              cache */
+        uint64_t        misses;          /**< Number of lookups which required a
+                                              new registration */
+        uint64_t        evictions;       /**< Number of evicted regions */
+        uint64_t        limit_fails;     /**< Number of registrations refused
+                                              by the node size limit */
+    } counters;
+
     char                *name;           /**< Name of the cache, for debug purpose */
 
     UCS_STATS_NODE_DECLARE(stats)
@@ -118,6 +132,16 @@ struct ucs_rcache {
 void ucs_rcache_vfs_init(ucs_rcache_t *rcache);
 
 
+/**
+ * @brief Get the total size of memory registered on the node by all rcaches
+ *        which enforce a node size limit.
+ *
+ * @return Registered size in bytes, or 0 if no node size limit is used by the
+ *         current process.
+ */
+size_t ucs_rcache_node_registered_size();
+
+
 /* Disable any atfork hooks created by registration caches in the program */
 void ucs_rcache_atfork_disable();
 
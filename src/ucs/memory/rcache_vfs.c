@@ -59,6 +59,43 @@ static void ucs_rcache_vfs_show_primitive(void *obj, ucs_string_buffer_t *strb,
     pthread_rwlock_unlock(&rcache->pgt_lock);
 }
 
+static void ucs_rcache_vfs_read_hit_rate(void *obj, ucs_string_buffer_t *strb,
+                                         void *arg_ptr, uint64_t arg_u64)
+{
+    ucs_rcache_t *rcache = obj;
+    uint64_t hits        = rcache->counters.hits;
+    uint64_t lookups     = hits + rcache->counters.misses;
+
+    ucs_string_buffer_appendf(strb, "%.2f\n",
+                              (lookups == 0) ? 0.0 :
+                                               (100.0 * hits) / lookups);
+}
+
+static void ucs_rcache_vfs_read_node_size(void *obj, ucs_string_buffer_t *strb,
+                                          void *arg_ptr, uint64_t arg_u64)
+{
+    ucs_string_buffer_appendf(strb, "%zu\n",
+                              ucs_rcache_node_registered_size());
+}
+
+static void ucs_rcache_vfs_init_counters(ucs_rcache_t *rcache)
+{
+    ucs_vfs_obj_add_ro_file(rcache, ucs_vfs_show_primitive,
+                            &rcache->counters.hits, UCS_VFS_TYPE_ULONG,
+                            "counters/hits");
+    ucs_vfs_obj_add_ro_file(rcache, ucs_vfs_show_primitive,
+                            &rcache->counters.misses, UCS_VFS_TYPE_ULONG,
+                            "counters/misses");
+    ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_show_primitive,
+                            &rcache->counters.evictions, UCS_VFS_TYPE_ULONG,
+                            "counters/evictions");
+    ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_show_primitive,
+                            &rcache->counters.limit_fails, UCS_VFS_TYPE_ULONG,
+                            "counters/node_limit_fails");
+    ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_read_hit_rate, NULL, 0,
+                            "counters/hit_rate");
+}
+
 static void ucs_rcache_vfs_init_regions_distribution(ucs_rcache_t *rcache)
 {
     size_t num_bins = ucs_rcache_distribution_get_num_bins();
@@ -96,10 +133,15 @@ void ucs_rcache_vfs_init(ucs_rcache_t *rcache)
                             &rcache->params.max_regions, 0, "max_regions");
     ucs_vfs_obj_add_ro_file(rcache, ucs_vfs_show_memunits,
                             &rcache->params.max_size, 0, "max_size");
+    ucs_vfs_obj_add_ro_file(rcache, ucs_vfs_show_memunits,
+                            &rcache->params.node_max_size, 0, "node_max_size");
+    ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_read_node_size, NULL, 0,
+                            "node_registered_size");
     ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_read_inv_q_length, NULL, 0,
                             "inv_q/length");
     ucs_vfs_obj_add_ro_file(rcache, ucs_rcache_vfs_read_gc_list_length, NULL, 0,
                             "gc_list/length");
 
+    ucs_rcache_vfs_init_counters(rcache);
     ucs_rcache_vfs_init_regions_distribution(rcache);
 }
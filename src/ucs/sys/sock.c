@@ -608,8 +608,9 @@ ucs_socket_do_io_b(int fd, void *data, size_t length,
 }
 
 static inline ucs_status_t
-ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p,
-                     ucs_socket_iov_func_t iov_func, const char *name)
+ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, int flags,
+                     size_t *length_p, ucs_socket_iov_func_t iov_func,
+                     const char *name)
 {
     struct msghdr msg = {
         .msg_iov    = iov,
@@ -617,7 +618,7 @@ ucs_socket_do_iov_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p
     };
     ssize_t ret;
 
-    ret = iov_func(fd, &msg, MSG_NOSIGNAL);
+    ret = iov_func(fd, &msg, flags | MSG_NOSIGNAL);
     return ucs_socket_handle_io(fd, iov, iov_cnt, length_p, 1, ret, errno, name);
 }
 
@@ -653,7 +654,15 @@ ucs_status_t ucs_socket_recv(int fd, void *data, size_t length)
 ucs_status_t
 ucs_socket_sendv_nb(int fd, struct iovec *iov, size_t iov_cnt, size_t *length_p)
 {
-    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, length_p, sendmsg, "sendv");
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, 0, length_p, sendmsg,
+                                "sendv");
+}
+
+ucs_status_t ucs_socket_sendmsg_nb(int fd, struct iovec *iov, size_t iov_cnt,
+                                   int flags, size_t *length_p)
+{
+    return ucs_socket_do_iov_nb(fd, iov, iov_cnt, flags, length_p, sendmsg,
+                                "sendmsg");
 }
 
 ucs_status_t ucs_sockaddr_sizeof(const struct sockaddr *addr, size_t *size_p)
@@ -103,3 +103,175 @@ void __ucs_twheel_sweep(ucs_twheel_t *t, ucs_time_t current_time)
         }
     }
 }
+
+static UCS_F_ALWAYS_INLINE unsigned ucs_hwheel_level_shift(unsigned level)
+{
+    return level * UCS_HWHEEL_SLOT_BITS;
+}
+
+static void ucs_hwheel_insert(ucs_hwheel_t *hwheel, ucs_hwtimer_t *timer)
+{
+    unsigned level, index;
+
+    if (timer->expiration <= hwheel->now) {
+        timer->slot = UCS_HWHEEL_EXPIRED;
+        ucs_list_add_tail(&hwheel->expired, &timer->list);
+        return;
+    }
+
+    /* The lowest level whose slots span the distance to the expiration */
+    level       = ucs_ilog2(timer->expiration - hwheel->now) /
+                  UCS_HWHEEL_SLOT_BITS;
+    index       = (timer->expiration >> ucs_hwheel_level_shift(level)) &
+                  (UCS_HWHEEL_SLOTS - 1);
+    timer->slot = (level * UCS_HWHEEL_SLOTS) + index;
+
+    ucs_list_add_tail(&hwheel->slots[timer->slot], &timer->list);
+    hwheel->slot_map[level] |= UCS_BIT(index);
+    ++hwheel->count;
+}
+
+/* Time when the wheel reaches the next non-empty slot of the given level */
+static ucs_time_t ucs_hwheel_level_next(ucs_hwheel_t *hwheel, unsigned level)
+{
+    unsigned shift  = ucs_hwheel_level_shift(level);
+    uint64_t map    = hwheel->slot_map[level];
+    ucs_time_t base = hwheel->now >> shift;
+    unsigned first, dist;
+
+    UCS_STATIC_ASSERT(UCS_HWHEEL_SLOTS == 64);
+
+    /* Rotate the map so the slot following the current one becomes bit 0 */
+    first = (base + 1) & (UCS_HWHEEL_SLOTS - 1);
+    if (first != 0) {
+        map = (map >> first) | (map << (UCS_HWHEEL_SLOTS - first));
+    }
+
+    dist = ucs_ffs64(map) + 1;
+    if (base > ((UCS_TIME_INFINITY >> shift) - dist)) {
+        return UCS_TIME_INFINITY;
+    }
+
+    return (base + dist) << shift;
+}
+
+static ucs_time_t ucs_hwheel_slots_next(ucs_hwheel_t *hwheel)
+{
+    ucs_time_t next = UCS_TIME_INFINITY;
+    unsigned level;
+
+    for (level = 0; level < UCS_HWHEEL_LEVELS; ++level) {
+        if (hwheel->slot_map[level] != 0) {
+            next = ucs_min(next, ucs_hwheel_level_next(hwheel, level));
+        }
+    }
+
+    return next;
+}
+
+/* Move the timers of a slot to the lower levels or to the expired list */
+static void
+ucs_hwheel_cascade(ucs_hwheel_t *hwheel, unsigned level, unsigned index)
+{
+    ucs_list_link_t *head = &hwheel->slots[(level * UCS_HWHEEL_SLOTS) + index];
+    ucs_hwtimer_t *timer, *tmp;
+    ucs_list_link_t timers;
+
+    ucs_list_head_init(&timers);
+    ucs_list_splice_tail(&timers, head);
+    ucs_list_head_init(head);
+    hwheel->slot_map[level] &= ~UCS_BIT(index);
+
+    ucs_list_for_each_safe(timer, tmp, &timers, list) {
+        --hwheel->count;
+        ucs_hwheel_insert(hwheel, timer);
+    }
+}
+
+ucs_status_t ucs_hwheel_init(ucs_hwheel_t *hwheel, ucs_time_t current_time)
+{
+    unsigned i;
+
+    hwheel->slots = ucs_malloc(sizeof(*hwheel->slots) * UCS_HWHEEL_LEVELS *
+                               UCS_HWHEEL_SLOTS, "hwheel");
+    if (hwheel->slots == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    for (i = 0; i < UCS_HWHEEL_LEVELS * UCS_HWHEEL_SLOTS; ++i) {
+        ucs_list_head_init(&hwheel->slots[i]);
+    }
+
+    for (i = 0; i < UCS_HWHEEL_LEVELS; ++i) {
+        hwheel->slot_map[i] = 0;
+    }
+
+    ucs_list_head_init(&hwheel->expired);
+    hwheel->now   = current_time;
+    hwheel->count = 0;
+    return UCS_OK;
+}
+
+void ucs_hwheel_cleanup(ucs_hwheel_t *hwheel)
+{
+    ucs_free(hwheel->slots);
+}
+
+void ucs_hwtimer_add(ucs_hwheel_t *hwheel, ucs_hwtimer_t *timer,
+                     ucs_time_t expiration)
+{
+    timer->expiration = expiration;
+    ucs_hwheel_insert(hwheel, timer);
+}
+
+void ucs_hwtimer_remove(ucs_hwheel_t *hwheel, ucs_hwtimer_t *timer)
+{
+    int slot = timer->slot;
+
+    ucs_list_del(&timer->list);
+    if (slot == UCS_HWHEEL_EXPIRED) {
+        return;
+    }
+
+    ucs_assert(hwheel->count > 0);
+    --hwheel->count;
+    if (ucs_list_is_empty(&hwheel->slots[slot])) {
+        hwheel->slot_map[slot / UCS_HWHEEL_SLOTS] &=
+                ~UCS_BIT(slot % UCS_HWHEEL_SLOTS);
+    }
+}
+
+void ucs_hwheel_advance(ucs_hwheel_t *hwheel, ucs_time_t current_time)
+{
+    ucs_time_t next;
+    int level;
+
+    while (hwheel->count > 0) {
+        next = ucs_hwheel_slots_next(hwheel);
+        if (next > current_time) {
+            break;
+        }
+
+        /* Process the levels whose slot begins at this time, starting from the
+         * highest one, since its timers may be moved to the lower levels */
+        hwheel->now = next;
+        level       = ucs_min(ucs_count_trailing_zero_bits(next) /
+                              UCS_HWHEEL_SLOT_BITS, UCS_HWHEEL_LEVELS - 1);
+        for (; level >= 0; --level) {
+            ucs_hwheel_cascade(hwheel, level,
+                               (next >> ucs_hwheel_level_shift(level)) &
+                               (UCS_HWHEEL_SLOTS - 1));
+        }
+    }
+
+    hwheel->now = ucs_max(hwheel->now, current_time);
+}
+
+ucs_time_t ucs_hwheel_next_expiration(ucs_hwheel_t *hwheel)
+{
+    if (!ucs_list_is_empty(&hwheel->expired)) {
+        return hwheel->now;
+    }
+
+    return ucs_hwheel_slots_next(hwheel);
+}
@@ -10,6 +10,7 @@
 #include <ucs/datastruct/list.h>
 #include <ucs/time/time.h>
 #include <ucs/debug/log.h>
+#include <ucs/sys/math.h>
 
 
 /* Forward declarations */
@@ -141,4 +142,123 @@ static inline void ucs_wtimer_remove(ucs_twheel_t *t, ucs_wtimer_t *timer)
     }
 }
 
+/*
+ * Hierarchical timer wheel
+ *
+ * Every level has UCS_HWHEEL_SLOTS slots, and a slot in level L covers
+ * 2^(UCS_HWHEEL_SLOT_BITS * L) time units. A timer is placed in the lowest
+ * level which can hold its distance from the current time, and is moved to a
+ * lower level ("cascaded") when the wheel reaches the beginning of its slot.
+ * The levels cover the whole range of ucs_time_t with a resolution of a single
+ * time unit, so timers never expire early or late, and empty slots are skipped
+ * by looking up a bitmap of non-empty slots in every level.
+ */
+#define UCS_HWHEEL_SLOT_BITS  6
+#define UCS_HWHEEL_SLOTS      UCS_BIT(UCS_HWHEEL_SLOT_BITS)
+#define UCS_HWHEEL_LEVELS     ucs_div_round_up(64, UCS_HWHEEL_SLOT_BITS)
+#define UCS_HWHEEL_EXPIRED    -1 /* Slot index of expired timers */
+
+
+/**
+ * Hierarchical wheel timer.
+ */
+typedef struct ucs_hwtimer {
+    ucs_list_link_t        list;       /* Link in a slot or in expired list */
+    ucs_time_t             expiration; /* Absolute expiration time */
+    int                    slot;       /* Slot index, or UCS_HWHEEL_EXPIRED */
+} ucs_hwtimer_t;
+
+
+/**
+ * Hierarchical timer wheel.
+ */
+typedef struct ucs_hwheel {
+    ucs_time_t             now;        /* When wheel was last advanced */
+    unsigned               count;      /* Number of timers in the slots */
+    ucs_list_link_t        expired;    /* Timers which already expired */
+    ucs_list_link_t        *slots;     /* UCS_HWHEEL_LEVELS * UCS_HWHEEL_SLOTS */
+    uint64_t               slot_map[UCS_HWHEEL_LEVELS]; /* Non-empty slots */
+} ucs_hwheel_t;
+
+
+/**
+ * Initialize a hierarchical timer wheel.
+ *
+ * @param hwheel        Timer wheel to initialize.
+ * @param current_time  Current time to initialize the wheel with.
+ */
+ucs_status_t ucs_hwheel_init(ucs_hwheel_t *hwheel, ucs_time_t current_time);
+
+
+/**
+ * Cleanup a hierarchical timer wheel.
+ *
+ * @param hwheel    Timer wheel to clean up.
+ */
+void ucs_hwheel_cleanup(ucs_hwheel_t *hwheel);
+
+
+/**
+ * Schedule a timer. The timer must not be scheduled already.
+ *
+ * @param hwheel      Timer wheel to schedule on.
+ * @param timer       Timer to schedule.
+ * @param expiration  Absolute expiration time. If it is not later than the
+ *                    time the wheel was advanced to, the timer is moved to
+ *                    the expired list right away.
+ */
+void ucs_hwtimer_add(ucs_hwheel_t *hwheel, ucs_hwtimer_t *timer,
+                     ucs_time_t expiration);
+
+
+/**
+ * Remove a scheduled or an expired timer.
+ *
+ * @param hwheel    Timer wheel the timer was scheduled on.
+ * @param timer     Timer to remove.
+ */
+void ucs_hwtimer_remove(ucs_hwheel_t *hwheel, ucs_hwtimer_t *timer);
+
+
+/**
+ * Advance the wheel to the given time, and move all timers which expire until
+ * then to the expired list. The cost depends on the number of non-empty slots
+ * passed, rather than the length of the time interval.
+ *
+ * @param hwheel        Timer wheel to advance.
+ * @param current_time  Time to advance the wheel to.
+ */
+void ucs_hwheel_advance(ucs_hwheel_t *hwheel, ucs_time_t current_time);
+
+
+/**
+ * @return The earliest time the wheel must be advanced to, so it would make
+ *         progress: the time the wheel was advanced to if there are expired
+ *         timers, or UCS_TIME_INFINITY if there are no timers at all.
+ *
+ * @note The returned time may be earlier than the expiration time of any timer,
+ *       if a timer has to be moved to a lower level first.
+ */
+ucs_time_t ucs_hwheel_next_expiration(ucs_hwheel_t *hwheel);
+
+
+/**
+ * Remove the next timer from the expired list.
+ *
+ * @return Expired timer, or NULL if there are no expired timers.
+ */
+static UCS_F_ALWAYS_INLINE ucs_hwtimer_t *
+ucs_hwheel_get_expired(ucs_hwheel_t *hwheel)
+{
+    ucs_hwtimer_t *timer;
+
+    if (ucs_list_is_empty(&hwheel->expired)) {
+        return NULL;
+    }
+
+    timer = ucs_list_extract_head(&hwheel->expired, ucs_hwtimer_t, list);
+    ucs_list_head_init(&timer->list);
+    return timer;
+}
+
 #endif
@@ -16,104 +16,189 @@
 #include <stdlib.h>
 
 
+KHASH_IMPL(ucs_timerq_timers, int, ucs_timer_t*, 1, kh_int_hash_func,
+           kh_int_hash_equal);
+
+
 ucs_status_t ucs_timerq_init(ucs_timer_queue_t *timerq)
 {
+    ucs_status_t status;
+
     ucs_trace_func("timerq=%p", timerq);
 
+    status = ucs_hwheel_init(&timerq->wheel, 0);
+    if (status != UCS_OK) {
+        return status;
+    }
+
     ucs_recursive_spinlock_init(&timerq->lock, 0);
-    timerq->timers       = NULL;
-    timerq->num_timers   = 0;
+    kh_init_inplace(ucs_timerq_timers, &timerq->timers);
     /* coverity[missing_lock] */
     timerq->min_interval = UCS_TIME_INFINITY;
+    timerq->min_count    = 0;
     return UCS_OK;
 }
 
 void ucs_timerq_cleanup(ucs_timer_queue_t *timerq)
 {
+    ucs_timer_t *timer;
+
     ucs_trace_func("timerq=%p", timerq);
 
-    if (timerq->num_timers > 0) {
-        ucs_warn("timer queue with %d timers being destroyed", timerq->num_timers);
+    if (ucs_timerq_size(timerq) > 0) {
+        ucs_warn("timer queue with %d timers being destroyed",
+                 ucs_timerq_size(timerq));
     }
-    ucs_free(timerq->timers);
+
+    kh_foreach_value(&timerq->timers, timer, {
+        ucs_free(timer);
+    })
+    kh_destroy_inplace(ucs_timerq_timers, &timerq->timers);
+    ucs_hwheel_cleanup(&timerq->wheel);
     ucs_recursive_spinlock_destroy(&timerq->lock);
 }
 
+/* Called with lock held */
+static void ucs_timerq_update_min_interval(ucs_timer_queue_t *timerq)
+{
+    ucs_timer_t *timer;
+
+    timerq->min_interval = UCS_TIME_INFINITY;
+    timerq->min_count    = 0;
+    kh_foreach_value(&timerq->timers, timer, {
+        if (timer->interval < timerq->min_interval) {
+            timerq->min_interval = timer->interval;
+            timerq->min_count    = 1;
+        } else if (timer->interval == timerq->min_interval) {
+            ++timerq->min_count;
+        }
+    })
+}
+
 ucs_status_t ucs_timerq_add(ucs_timer_queue_t *timerq, int timer_id,
                             ucs_time_t interval)
 {
     ucs_status_t status;
-    ucs_timer_t *ptr;
+    ucs_timer_t *timer;
+    khiter_t iter;
+    int ret;
 
     ucs_trace_func("timerq=%p interval=%.2fus timer_id=%d", timerq,
                    ucs_time_to_usec(interval), timer_id);
 
+    timer = ucs_malloc(sizeof(*timer), "timerq_timer");
+    if (timer == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    timer->interval = interval;
+    timer->id       = timer_id;
+
     ucs_recursive_spin_lock(&timerq->lock);
 
     /* Make sure ID is unique */
-    for (ptr = timerq->timers; ptr < timerq->timers + timerq->num_timers; ++ptr) {
-        if (ptr->id == timer_id) {
-            status = UCS_ERR_ALREADY_EXISTS;
-            goto out_unlock;
-        }
+    iter = kh_put(ucs_timerq_timers, &timerq->timers, timer_id, &ret);
+    if (ret == UCS_KH_PUT_FAILED) {
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free;
+    } else if (ret == UCS_KH_PUT_KEY_PRESENT) {
+        status = UCS_ERR_ALREADY_EXISTS;
+        goto err_free;
     }
 
-    /* Resize timer array */
-    ptr = ucs_realloc(timerq->timers, (timerq->num_timers + 1) * sizeof(ucs_timer_t),
-                      "timerq");
-    if (ptr == NULL) {
-        status = UCS_ERR_NO_MEMORY;
-        goto out_unlock;
+    kh_value(&timerq->timers, iter) = timer;
+
+    if (interval < timerq->min_interval) {
+        timerq->min_interval = interval;
+        timerq->min_count    = 1;
+    } else if (interval == timerq->min_interval) {
+        ++timerq->min_count;
     }
-    timerq->timers = ptr;
-    ++timerq->num_timers;
-    timerq->min_interval = ucs_min(interval, timerq->min_interval);
     ucs_assert(timerq->min_interval != UCS_TIME_INFINITY);
 
-    /* Initialize the new timer */
-    ptr = &timerq->timers[timerq->num_timers - 1];
-    ptr->expiration = 0; /* will fire the next time sweep is called */
-    ptr->interval   = interval;
-    ptr->id         = timer_id;
+    /* will fire the next time sweep is called */
+    ucs_hwtimer_add(&timerq->wheel, &timer->wtimer, 0);
 
-    status = UCS_OK;
+    ucs_recursive_spin_unlock(&timerq->lock);
+    return UCS_OK;
 
-out_unlock:
+err_free:
     ucs_recursive_spin_unlock(&timerq->lock);
+    ucs_free(timer);
     return status;
 }
 
 ucs_status_t ucs_timerq_remove(ucs_timer_queue_t *timerq, int timer_id)
 {
     ucs_status_t status;
-    ucs_timer_t *ptr;
+    ucs_timer_t *timer;
+    khiter_t iter;
 
     ucs_trace_func("timerq=%p timer_id=%d", timerq, timer_id);
 
-    status = UCS_ERR_NO_ELEM;
-
     ucs_recursive_spin_lock(&timerq->lock);
-    timerq->min_interval = UCS_TIME_INFINITY;
-    ptr = timerq->timers;
-    while (ptr < timerq->timers + timerq->num_timers) {
-        if (ptr->id == timer_id) {
-            *ptr = timerq->timers[--timerq->num_timers];
-            status = UCS_OK;
-        } else {
-            timerq->min_interval = ucs_min(timerq->min_interval, ptr->interval);
-            ++ptr;
-        }
+
+    iter = kh_get(ucs_timerq_timers, &timerq->timers, timer_id);
+    if (iter == kh_end(&timerq->timers)) {
+        status = UCS_ERR_NO_ELEM;
+        goto out_unlock;
     }
 
-    /* TODO realloc - shrink */
-    if (timerq->num_timers == 0) {
+    timer = kh_value(&timerq->timers, iter);
+    kh_del(ucs_timerq_timers, &timerq->timers, iter);
+    ucs_hwtimer_remove(&timerq->wheel, &timer->wtimer);
+
+    /* Rescan the timers only when the last one with minimal interval is gone */
+    if ((timer->interval == timerq->min_interval) &&
+        (--timerq->min_count == 0)) {
+        ucs_timerq_update_min_interval(timerq);
+    }
+
+    if (ucs_timerq_is_empty(timerq)) {
         ucs_assert(timerq->min_interval == UCS_TIME_INFINITY);
-        ucs_free(timerq->timers);
-        timerq->timers = NULL;
     } else {
         ucs_assert(timerq->min_interval != UCS_TIME_INFINITY);
     }
 
+    ucs_free(timer);
+    status = UCS_OK;
+
+out_unlock:
     ucs_recursive_spin_unlock(&timerq->lock);
     return status;
 }
+
+ucs_time_t ucs_timerq_next_expiration(ucs_timer_queue_t *timerq)
+{
+    ucs_time_t expiration;
+
+    ucs_recursive_spin_lock(&timerq->lock);
+    expiration = ucs_hwheel_next_expiration(&timerq->wheel);
+    ucs_recursive_spin_unlock(&timerq->lock);
+
+    return expiration;
+}
+
+ucs_timer_t *ucs_timerq_get_expired(ucs_timer_queue_t *timerq,
+                                    ucs_time_t current_time)
+{
+    ucs_hwtimer_t *wtimer;
+    ucs_timer_t *timer;
+
+    wtimer = ucs_hwheel_get_expired(&timerq->wheel);
+    if (wtimer == NULL) {
+        ucs_hwheel_advance(&timerq->wheel, current_time);
+        wtimer = ucs_hwheel_get_expired(&timerq->wheel);
+        if (wtimer == NULL) {
+            return NULL;
+        }
+    }
+
+    /* Reschedule after the time the wheel was advanced to, so the timer would
+     * not expire again in the same dispatch round */
+    timer = ucs_container_of(wtimer, ucs_timer_t, wtimer);
+    ucs_hwtimer_add(&timerq->wheel, wtimer,
+                    ucs_max(current_time, timerq->wheel.now) +
+                    ucs_max(timer->interval, 1));
+    return timer;
+}
@@ -7,25 +7,30 @@
 #ifndef UCS_TIMERQ_H
 #define UCS_TIMERQ_H
 
-#include <ucs/datastruct/queue.h>
+#include <ucs/datastruct/khash.h>
 #include <ucs/time/time.h>
+#include <ucs/time/timer_wheel.h>
 #include <ucs/type/status.h>
 #include <ucs/sys/preprocessor.h>
 #include <ucs/type/spinlock.h>
 
 
 typedef struct ucs_timer {
-    ucs_time_t                 expiration;/* Absolute timer expiration time */
+    ucs_hwtimer_t              wtimer;    /* Entry in the timer wheel */
     ucs_time_t                 interval;  /* Re-scheduling interval */
     int                        id;
 } ucs_timer_t;
 
 
+KHASH_TYPE(ucs_timerq_timers, int, ucs_timer_t*);
+
+
 typedef struct ucs_timer_queue {
     ucs_recursive_spinlock_t   lock;
-    ucs_time_t                 min_interval; /* Expiration of next timer */
-    ucs_timer_t                *timers;      /* Array of timers */
-    unsigned                   num_timers;   /* Number of timers */
+    ucs_time_t                 min_interval; /* Minimal timer interval */
+    unsigned                   min_count;    /* Timers with minimal interval */
+    ucs_hwheel_t               wheel;        /* Wheel of scheduled timers */
+    khash_t(ucs_timerq_timers) timers;       /* Timers by ID */
 } ucs_timer_queue_t;
 
 
@@ -77,7 +82,7 @@ static inline ucs_time_t ucs_timerq_min_interval(ucs_timer_queue_t *timerq) {
  * @return Number of timers in the queue.
  */
 static inline int ucs_timerq_size(ucs_timer_queue_t *timerq) {
-    return timerq->num_timers;
+    return kh_size(&timerq->timers);
 }
 
 
@@ -89,6 +94,24 @@ static inline int ucs_timerq_is_empty(ucs_timer_queue_t *timerq) {
 }
 
 
+/**
+ * @return The earliest time the timer queue should be dispatched at, or
+ *         UCS_TIME_INFINITY if there are no timers.
+ */
+ucs_time_t ucs_timerq_next_expiration(ucs_timer_queue_t *timerq);
+
+
+/**
+ * Advance the timer queue to the given time, and return the next timer which
+ * has expired until then, after rescheduling it. Must be called with the
+ * timer queue lock held.
+ *
+ * @return Expired timer, or NULL if there are no more expired timers.
+ */
+ucs_timer_t *ucs_timerq_get_expired(ucs_timer_queue_t *timerq,
+                                    ucs_time_t current_time);
+
+
 /**
  * Go through the expired timers in the timer queue.
  *
@@ -98,20 +121,17 @@ static inline int ucs_timerq_is_empty(ucs_timer_queue_t *timerq) {
  *
  * @note Timers which expired between calls to this function will also be dispatched.
  * @note There is no guarantee on the order of dispatching.
+ * @note Expired timers which were not reached because the loop was stopped
+ *       are dispatched by the next call.
  */
 #define ucs_timerq_for_each_expired(_timer, _timerq, _current_time, _code) \
     { \
         ucs_time_t __current_time = _current_time; \
         ucs_recursive_spin_lock(&(_timerq)->lock); /* Grab lock */ \
-        for (_timer = (_timerq)->timers; \
-             _timer != (_timerq)->timers + (_timerq)->num_timers; \
-             ++_timer) \
+        while ((_timer = ucs_timerq_get_expired(_timerq, \
+                                                __current_time)) != NULL) \
         { \
-            if (__current_time >= (_timer)->expiration) { \
-                /* Update expiration time */ \
-                (_timer)->expiration = __current_time + (_timer)->interval; \
-                _code; \
-            } \
+            _code; \
         } \
         ucs_recursive_spin_unlock(&(_timerq)->lock); /* Release lock  */ \
     }
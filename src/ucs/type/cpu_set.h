@@ -74,4 +74,14 @@ static inline int ucs_cpu_set_find_lcs(const ucs_cpu_set_t * cpu_mask)
     return 0;
 }
 
+static inline int ucs_cpu_set_count(const ucs_cpu_set_t *cpu_mask)
+{
+    int i, count = 0;
+
+    for (i = 0; i < (int)(UCS_CPU_SETSIZE / UCS_NCPUBITS); ++i) {
+        count += __builtin_popcountl(cpu_mask->ucs_bits[i]);
+    }
+    return count;
+}
+
 #endif
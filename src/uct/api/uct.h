@@ -627,23 +627,34 @@ enum uct_msg_flags {
  * List of flags for a callback.
  */
 enum uct_cb_flags {
-    UCT_CB_FLAG_RESERVED = UCS_BIT(1), /**< Reserved for future use. */
-    UCT_CB_FLAG_ASYNC    = UCS_BIT(2), /**< Callback is allowed to be called
-                                            from any thread in the process, and
-                                            therefore should be thread-safe. For
-                                            example, it may be called from a
-                                            transport async progress thread. To
-                                            guarantee async invocation, the
-                                            interface must have the @ref
-                                            UCT_IFACE_FLAG_CB_ASYNC flag set. If
-                                            async callback is requested on an
-                                            interface which only supports sync
-                                            callback (i.e., only the @ref
-                                            UCT_IFACE_FLAG_CB_SYNC flag is set),
-                                            the callback will be invoked only
-                                            from the context that called @ref
-                                            uct_iface_progress). */
-    UCT_CB_FLAG_ALT_ARG  = UCS_BIT(3)  /**< Alternative callback argument. */
+    UCT_CB_FLAG_RESERVED  = UCS_BIT(1), /**< Reserved for future use. */
+    UCT_CB_FLAG_ASYNC     = UCS_BIT(2), /**< Callback is allowed to be called
+                                             from any thread in the process, and
+                                             therefore should be thread-safe. For
+                                             example, it may be called from a
+                                             transport async progress thread. To
+                                             guarantee async invocation, the
+                                             interface must have the @ref
+                                             UCT_IFACE_FLAG_CB_ASYNC flag set. If
+                                             async callback is requested on an
+                                             interface which only supports sync
+                                             callback (i.e., only the @ref
+                                             UCT_IFACE_FLAG_CB_SYNC flag is set),
+                                             the callback will be invoked only
+                                             from the context that called @ref
+                                             uct_iface_progress). */
+    UCT_CB_FLAG_ALT_ARG   = UCS_BIT(3), /**< Alternative callback argument. */
+    UCT_CB_FLAG_PRIO_HIGH = UCS_BIT(4), /**< Pending request is latency
+                                             sensitive, for example connection
+                                             establishment or keepalive.
+                                             Transports which support it
+                                             dispatch the pending queue of the
+                                             endpoint before the pending queues
+                                             of other endpoints. */
+    UCT_CB_FLAG_PRIO_BULK = UCS_BIT(5)  /**< Pending request is a part of a
+                                             large data transfer, and may be
+                                             dispatched after the pending
+                                             requests of other endpoints. */
 };
 
 
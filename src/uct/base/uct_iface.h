@@ -720,6 +720,37 @@ uct_pending_req_priv_arb_elem(uct_pending_req_t *req)
     } while (0)
 
 
+/**
+ * @return Arbiter priority class according to the priority hint in the flags
+ *         passed to @ref uct_ep_pending_add.
+ */
+static UCS_F_ALWAYS_INLINE ucs_arbiter_prio_t
+uct_pending_req_arb_prio(unsigned flags)
+{
+    if (ucs_unlikely(flags & UCT_CB_FLAG_PRIO_HIGH)) {
+        return UCS_ARBITER_PRIO_HIGH;
+    } else if (ucs_unlikely(flags & UCT_CB_FLAG_PRIO_BULK)) {
+        return UCS_ARBITER_PRIO_BULK;
+    }
+
+    return UCS_ARBITER_PRIO_NORMAL;
+}
+
+
+/**
+ * Add a pending request to the arbiter, with the priority hint from the flags
+ * passed to @ref uct_ep_pending_add.
+ */
+#define uct_pending_req_arb_group_push_prio(_arbiter, _arbiter_group, _req, \
+                                            _flags) \
+    do { \
+        ucs_arbiter_elem_init(uct_pending_req_priv_arb_elem(_req)); \
+        ucs_arbiter_group_push_elem_prio(_arbiter, _arbiter_group, \
+                                         uct_pending_req_priv_arb_elem(_req), \
+                                         uct_pending_req_arb_prio(_flags)); \
+    } while (0)
+
+
 /**
  * Add a pending request to the head of group in arbiter.
  */
@@ -883,6 +914,18 @@ ucs_status_t uct_iface_mpool_init(uct_base_iface_t *iface, ucs_mpool_t *mp,
                                   const char *name);
 
 
+/**
+ * Change the interface which owns a memory pool created by
+ * @ref uct_iface_mpool_init. The new interface is used to allocate and release
+ * the following chunks and to initialize their objects, so it must use the
+ * same memory domain as the original one.
+ *
+ * @param mp     Memory pool to update.
+ * @param iface  New owner interface.
+ */
+void uct_iface_mpool_set_iface(ucs_mpool_t *mp, uct_base_iface_t *iface);
+
+
 /**
  * Dump active message contents using the user-defined tracer callback.
  */
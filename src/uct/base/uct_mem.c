@@ -539,3 +539,8 @@ ucs_status_t uct_iface_mpool_init(uct_base_iface_t *iface, ucs_mpool_t *mp,
     uct_iface_mp_priv(mp)->init_obj_cb = init_obj_cb;
     return UCS_OK;
 }
+
+void uct_iface_mpool_set_iface(ucs_mpool_t *mp, uct_base_iface_t *iface)
+{
+    uct_iface_mp_priv(mp)->iface = iface;
+}
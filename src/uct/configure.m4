@@ -27,6 +27,30 @@ AC_CHECK_DECLS([IPPROTO_TCP, SOL_SOCKET, SO_KEEPALIVE,
 AS_IF([test "x$tcp_keepalive_happy" != "xno"],
       [AC_DEFINE([UCT_TCP_EP_KEEPALIVE], 1, [Enable TCP keepalive configuration])]);
 
+#
+# TCP io_uring engine
+#
+AC_CHECK_DECLS([__NR_io_uring_setup, IORING_RECV_MULTISHOT,
+                IORING_REGISTER_PBUF_RING, IORING_CQE_F_BUFFER],
+               [],
+               [tcp_io_uring_happy=no],
+               [[#include <sys/syscall.h>]
+                [#include <linux/io_uring.h>]])
+AS_IF([test "x$tcp_io_uring_happy" != "xno"],
+      [AC_DEFINE([UCT_TCP_IO_URING], 1, [Enable TCP io_uring engine])]);
+
+#
+# TCP MSG_ZEROCOPY send
+#
+AC_CHECK_DECLS([SO_ZEROCOPY, MSG_ZEROCOPY, SO_EE_ORIGIN_ZEROCOPY,
+                SO_EE_CODE_ZEROCOPY_COPIED],
+               [],
+               [tcp_msg_zcopy_happy=no],
+               [[#include <sys/socket.h>]
+                [#include <linux/errqueue.h>]])
+AS_IF([test "x$tcp_msg_zcopy_happy" != "xno"],
+      [AC_DEFINE([UCT_TCP_MSG_ZEROCOPY], 1, [Enable TCP MSG_ZEROCOPY send])]);
+
 #
 # Shared-memory Collectives Support
 #
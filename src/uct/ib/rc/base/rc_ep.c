@@ -352,7 +352,8 @@ ucs_status_t uct_rc_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *n,
 
     UCS_STATIC_ASSERT(sizeof(uct_pending_req_priv_arb_t) <=
                       UCT_PENDING_REQ_PRIV_LEN);
-    uct_pending_req_arb_group_push(&ep->arb_group, n);
+    uct_pending_req_arb_group_push_prio(&iface->tx.arbiter, &ep->arb_group, n,
+                                        flags);
     UCT_TL_EP_STAT_PEND(&ep->super);
 
     if (uct_rc_ep_has_tx_resources(ep)) {
@@ -635,7 +636,8 @@ uct_rc_ep_check(uct_ep_h tl_ep, unsigned flags, uct_completion_t *comp)
 
     req->ep          = &ep->super.super;
     req->super.func  = uct_rc_ep_check_progress;
-    status           = uct_rc_ep_pending_add(tl_ep, &req->super, 0);
+    status           = uct_rc_ep_pending_add(tl_ep, &req->super,
+                                             UCT_CB_FLAG_PRIO_HIGH);
     ep->flags       |= UCT_RC_EP_FLAG_KEEPALIVE_PENDING;
     ucs_assert_always(status == UCS_OK);
 
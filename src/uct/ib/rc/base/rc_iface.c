@@ -700,6 +700,12 @@ UCS_CLASS_INIT_FUNC(uct_rc_iface_t, uct_iface_ops_t *tl_ops,
         goto err_cleanup_tx_ops;
     }
 
+    status = ucs_arbiter_stats_init(&self->tx.arbiter,
+                                    UCS_STATS_RVAL(self->stats), "tx");
+    if (status != UCS_OK) {
+        goto err_destroy_stats;
+    }
+
     /* Initialize RX resources (SRQ) */
     status = ops->init_rx(self, config);
     if (status != UCS_OK) {
@@ -741,6 +747,7 @@ UCS_CLASS_INIT_FUNC(uct_rc_iface_t, uct_iface_ops_t *tl_ops,
 err_cleanup_rx:
     ops->cleanup_rx(self);
 err_destroy_stats:
+    ucs_arbiter_cleanup(&self->tx.arbiter);
     UCS_STATS_NODE_FREE(self->stats);
 err_cleanup_tx_ops:
     uct_rc_iface_tx_ops_cleanup(self);
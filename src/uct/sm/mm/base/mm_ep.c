@@ -434,7 +434,8 @@ ucs_status_t uct_mm_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *n,
 
     UCS_STATIC_ASSERT(sizeof(uct_pending_req_priv_arb_t) <=
                       UCT_PENDING_REQ_PRIV_LEN);
-    uct_pending_req_arb_group_push(&ep->arb_group, n);
+    uct_pending_req_arb_group_push_prio(&iface->super.arbiter, &ep->arb_group,
+                                        n, flags);
     /* add the ep's group to the arbiter */
     ucs_arbiter_group_schedule(&iface->super.arbiter, &ep->arb_group);
     UCT_TL_EP_STAT_PEND(&ep->super);
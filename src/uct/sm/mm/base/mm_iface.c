@@ -27,6 +27,12 @@
 #define UCT_MM_IFACE_OVERHEAD 10e-9
 #define UCT_MM_IFACE_LATENCY  ucs_linear_func_make(80e-9, 0)
 
+
+/* Receive descriptor pools of all the workers, protected by the lock below */
+static UCS_LIST_HEAD(uct_mm_iface_recv_pools);
+static pthread_mutex_t uct_mm_iface_recv_pools_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
 ucs_config_field_t uct_mm_iface_config_table[] = {
     {"SM_", "ALLOC=md,mmap,heap;BW=15360MBs", NULL,
      ucs_offsetof(uct_mm_iface_config_t, super),
@@ -67,6 +73,22 @@ ucs_config_field_t uct_mm_iface_config_table[] = {
     {"ERROR_HANDLING", "n", "Expose error handling support capability",
      ucs_offsetof(uct_mm_iface_config_t, error_handling), UCS_CONFIG_TYPE_BOOL},
 
+    {"FIFO_RX_BATCH", "y",
+     "Receive FIFO elements in batches: check the owner bits of the following\n"
+     "ready elements, prefetch their payloads, and then dispatch them all with\n"
+     "a single release of the FIFO tail to the senders.",
+     ucs_offsetof(uct_mm_iface_config_t, fifo_rx_batch), UCS_CONFIG_TYPE_BOOL},
+
+    {"SHARED_RX_POOL", "n",
+     "Share the receive descriptors memory pool between all the memory-map\n"
+     "interfaces of the same worker which use the same memory domain and the\n"
+     "same descriptor layout. The receive FIFO of every interface keeps only\n"
+     "the indexes of its descriptors, so the peers of all the interfaces draw\n"
+     "from a single set of shared memory segments instead of one per interface.\n"
+     "The pool is configured by the first interface which creates it, and a\n"
+     "shared pool is protected by a lock of its own.",
+     ucs_offsetof(uct_mm_iface_config_t, shared_rx_pool), UCS_CONFIG_TYPE_BOOL},
+
     {NULL}
 };
 
@@ -124,12 +146,55 @@ uct_mm_iface_is_reachable_v2(const uct_iface_h tl_iface,
            uct_iface_scope_is_reachable(tl_iface, params);
 }
 
+static UCS_F_ALWAYS_INLINE uct_mm_recv_desc_t*
+uct_mm_iface_recv_desc_get(uct_mm_base_iface_t *iface)
+{
+    uct_mm_recv_pool_t *pool = iface->recv_pool;
+    uct_mm_recv_desc_t *desc;
+
+    if (!pool->shared) {
+        return ucs_mpool_get_inline(&pool->mp);
+    }
+
+    ucs_spin_lock(&pool->lock);
+    desc = ucs_mpool_get_inline(&pool->mp);
+    ucs_spin_unlock(&pool->lock);
+    return desc;
+}
+
+static UCS_F_ALWAYS_INLINE void uct_mm_iface_recv_desc_put(void *desc)
+{
+    uct_mm_recv_pool_t *pool = ucs_container_of(ucs_mpool_obj_owner(desc),
+                                                uct_mm_recv_pool_t, mp);
+
+    if (!pool->shared) {
+        ucs_mpool_put_inline(desc);
+        return;
+    }
+
+    ucs_spin_lock(&pool->lock);
+    ucs_mpool_put_inline(desc);
+    ucs_spin_unlock(&pool->lock);
+}
+
+#define UCT_MM_IFACE_GET_RX_DESC(_iface, _desc, _failure) \
+    { \
+        _desc = uct_mm_iface_recv_desc_get(_iface); \
+        if (ucs_unlikely((_desc) == NULL)) { \
+            uct_iface_mpool_empty_warn(&(_iface)->super.super, \
+                                       (_iface)->recv_desc_mp); \
+            _failure; \
+        } \
+        \
+        VALGRIND_MAKE_MEM_DEFINED(_desc, sizeof(*(_desc))); \
+    }
+
 void uct_mm_iface_release_desc(uct_recv_desc_t *self, void *desc)
 {
     void *mm_desc;
 
     mm_desc = UCS_PTR_BYTE_OFFSET(desc, -sizeof(uct_mm_recv_desc_t));
-    ucs_mpool_put(mm_desc);
+    uct_mm_iface_recv_desc_put(mm_desc);
 }
 
 ucs_status_t uct_mm_iface_flush(uct_iface_h tl_iface, unsigned flags,
@@ -246,8 +311,7 @@ uct_mm_assign_desc_to_fifo_elem(uct_mm_base_iface_t *iface,
     if (!need_new_desc) {
         desc = iface->last_recv_desc;
     } else {
-        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp, desc,
-                                 return UCS_ERR_NO_RESOURCE);
+        UCT_MM_IFACE_GET_RX_DESC(iface, desc, return UCS_ERR_NO_RESOURCE);
     }
 
     elem->desc      = desc->info;
@@ -273,8 +337,7 @@ uct_mm_iface_process_recv(uct_mm_base_iface_t *iface,
 
     /* check the memory pool to make sure that there is a new descriptor available */
     if (ucs_unlikely(iface->last_recv_desc == NULL)) {
-        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
-                                 iface->last_recv_desc, return);
+        UCT_MM_IFACE_GET_RX_DESC(iface, iface->last_recv_desc, return);
     }
 
     /* read bcopy messages from the receive descriptors */
@@ -290,8 +353,8 @@ uct_mm_iface_process_recv(uct_mm_base_iface_t *iface,
         /* assign a new receive descriptor to this FIFO element.*/
         uct_mm_assign_desc_to_fifo_elem(iface, elem, 0);
         /* the last_recv_desc is in use. get a new descriptor for it */
-        UCT_TL_IFACE_GET_RX_DESC(&iface->super.super, &iface->recv_desc_mp,
-                                 iface->last_recv_desc, ucs_debug("recv mpool is empty"));
+        UCT_MM_IFACE_GET_RX_DESC(iface, iface->last_recv_desc,
+                                 ucs_debug("recv mpool is empty"));
     }
 }
 
@@ -324,6 +387,90 @@ uct_mm_iface_poll_fifo(uct_mm_base_iface_t *iface)
     return 1;
 }
 
+/* Count the FIFO elements, starting from read_index, which were already
+ * posted by the senders, and prefetch the data of every one of them. Since the
+ * elements are processed only after the whole batch is detected, the cache
+ * misses on the descriptors and payloads overlap with each other. */
+static UCS_F_ALWAYS_INLINE unsigned
+uct_mm_iface_fifo_batch_prefetch(uct_mm_base_iface_t *iface,
+                                 unsigned max_count)
+{
+    uct_mm_fifo_check_t *recv_check = &iface->recv_check;
+    uct_mm_fifo_element_t *elem;
+    uint64_t read_index;
+    unsigned count, i;
+
+    if (!uct_mm_iface_fifo_has_new_data(recv_check, 1)) {
+        return 0;
+    }
+
+    for (count = 1; count < max_count; ++count) {
+        read_index = recv_check->read_index + count;
+        elem       = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems,
+                                                read_index & iface->fifo_mask);
+        if (uct_mm_iface_fifo_flag_no_new_data(elem->flags, read_index,
+                                               recv_check->fifo_size)) {
+            break;
+        }
+    }
+
+    /* read the elements contents only after all the owner bits */
+    ucs_memory_cpu_load_fence();
+
+    for (i = 0; i < count; ++i) {
+        elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems,
+                                          (recv_check->read_index + i) &
+                                          iface->fifo_mask);
+        if (elem->flags & UCT_MM_FIFO_ELEM_FLAG_INLINE) {
+            ucs_prefetch_read(elem + 1);
+        } else {
+            ucs_prefetch_read(elem->desc_data);
+        }
+    }
+
+    return count;
+}
+
+static UCS_F_ALWAYS_INLINE unsigned
+uct_mm_iface_poll_fifo_batch(uct_mm_base_iface_t *iface, unsigned max_count)
+{
+    uct_mm_fifo_check_t *recv_check = &iface->recv_check;
+    uint64_t release_mask           = recv_check->fifo_release_factor_mask;
+    uint64_t prev_read_index        = recv_check->read_index;
+    unsigned count, i;
+
+    count = uct_mm_iface_fifo_batch_prefetch(iface, max_count);
+    if (count == 0) {
+        return 0;
+    }
+
+    ucs_assert((recv_check->read_index + count - 1) <
+               (recv_check->fifo_ctl->head &
+                ~UCT_MM_IFACE_FIFO_HEAD_EVENT_ARMED));
+
+    for (i = 0; i < count; ++i) {
+        uct_mm_iface_process_recv(iface, recv_check->read_elem);
+
+        ++recv_check->read_index;
+        recv_check->read_elem =
+            UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems,
+                                       recv_check->read_index &
+                                       iface->fifo_mask);
+    }
+
+    recv_check->is_flag_cached = 0;
+
+    /* release the whole batch with a single tail update, if it crossed a
+     * release boundary which uct_mm_progress_fifo_tail() would stop at */
+    if ((prev_read_index & ~release_mask) !=
+        (recv_check->read_index & ~release_mask)) {
+        ucs_memory_cpu_store_fence();
+        recv_check->fifo_ctl->tail = recv_check->read_index;
+    }
+
+    return count;
+}
+
 unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
 {
     uct_mm_base_iface_t *iface = ucs_derived_of(tl_iface, uct_mm_base_iface_t);
@@ -335,12 +482,21 @@ unsigned uct_mm_iface_progress(uct_iface_h tl_iface)
     UCT_BASE_IFACE_LOCK(iface);
 
     /* progress receive */
-    do {
-        count = uct_mm_iface_poll_fifo(iface);
-        ucs_assert(count < 2);
-        total_count += count;
-        ucs_assert(total_count < UINT_MAX);
-    } while ((count != 0) && (total_count < iface->fifo_poll_count));
+    if (iface->config.fifo_rx_batch) {
+        do {
+            count = uct_mm_iface_poll_fifo_batch(iface, iface->fifo_poll_count -
+                                                        total_count);
+            total_count += count;
+            ucs_assert(total_count <= iface->fifo_poll_count);
+        } while ((count != 0) && (total_count < iface->fifo_poll_count));
+    } else {
+        do {
+            count = uct_mm_iface_poll_fifo(iface);
+            ucs_assert(count < 2);
+            total_count += count;
+            ucs_assert(total_count < UINT_MAX);
+        } while ((count != 0) && (total_count < iface->fifo_poll_count));
+    }
 
     uct_mm_iface_fifo_window_adjust(iface, total_count);
 
@@ -575,7 +731,7 @@ static void uct_mm_iface_free_rx_descs(uct_mm_base_iface_t *iface, unsigned num_
         elem = UCT_MM_IFACE_GET_FIFO_ELEM(iface, iface->recv_fifo_elems, i);
         desc = (uct_mm_recv_desc_t*)UCS_PTR_BYTE_OFFSET(elem->desc_data,
                                                         -iface->rx_headroom) - 1;
-        ucs_mpool_put(desc);
+        uct_mm_iface_recv_desc_put(desc);
     }
 }
 
@@ -668,6 +824,96 @@ static void uct_mm_iface_log_created(uct_mm_base_iface_t *iface)
               iface->config.fifo_elem_size, iface->config.fifo_size);
 }
 
+static ucs_status_t
+uct_mm_iface_recv_pool_get(uct_mm_base_iface_t *iface,
+                           const uct_mm_iface_config_t *mm_config,
+                           size_t elem_size, size_t align_offset,
+                           size_t alignment)
+{
+    uct_priv_worker_t *worker = iface->super.super.worker;
+    uct_md_h md               = iface->super.super.md;
+    uct_mm_recv_pool_t *pool;
+    ucs_status_t status;
+
+    pthread_mutex_lock(&uct_mm_iface_recv_pools_lock);
+
+    if (mm_config->shared_rx_pool) {
+        ucs_list_for_each(pool, &uct_mm_iface_recv_pools, list) {
+            if (pool->shared && (pool->worker == worker) &&
+                (pool->md == md) && (pool->elem_size == elem_size) &&
+                (pool->align_offset == align_offset) &&
+                (pool->alignment == alignment) &&
+                (pool->rx_headroom == iface->rx_headroom)) {
+                goto out_add_iface;
+            }
+        }
+    }
+
+    pool = ucs_malloc(sizeof(*pool), "mm_recv_pool");
+    if (pool == NULL) {
+        status = UCS_ERR_NO_MEMORY;
+        goto out_unlock;
+    }
+
+    status = uct_iface_mpool_init(&iface->super.super, &pool->mp, elem_size,
+                                  align_offset, alignment, &mm_config->mp,
+                                  mm_config->mp.bufs_grow,
+                                  uct_mm_iface_recv_desc_init, "mm_recv_desc");
+    if (status != UCS_OK) {
+        ucs_free(pool);
+        goto out_unlock;
+    }
+
+    ucs_spinlock_init(&pool->lock, 0);
+    pool->worker       = worker;
+    pool->md           = md;
+    pool->elem_size    = elem_size;
+    pool->align_offset = align_offset;
+    pool->alignment    = alignment;
+    pool->rx_headroom  = iface->rx_headroom;
+    pool->shared       = mm_config->shared_rx_pool;
+    ucs_list_head_init(&pool->ifaces);
+    ucs_list_add_tail(&uct_mm_iface_recv_pools, &pool->list);
+
+out_add_iface:
+    ucs_list_add_tail(&pool->ifaces, &iface->recv_pool_list);
+    iface->recv_pool    = pool;
+    iface->recv_desc_mp = &pool->mp;
+    status              = UCS_OK;
+out_unlock:
+    pthread_mutex_unlock(&uct_mm_iface_recv_pools_lock);
+    return status;
+}
+
+static void uct_mm_iface_recv_pool_put(uct_mm_base_iface_t *iface)
+{
+    uct_mm_recv_pool_t *pool = iface->recv_pool;
+    uct_mm_base_iface_t *owner;
+
+    pthread_mutex_lock(&uct_mm_iface_recv_pools_lock);
+
+    ucs_list_del(&iface->recv_pool_list);
+    if (ucs_list_is_empty(&pool->ifaces)) {
+        ucs_list_del(&pool->list);
+        ucs_mpool_cleanup(&pool->mp, 1);
+        ucs_spinlock_destroy(&pool->lock);
+        ucs_free(pool);
+    } else {
+        /* The pool may grow after this interface is gone, so pass the chunks
+         * allocation to one of the remaining interfaces */
+        owner = ucs_list_head(&pool->ifaces, uct_mm_base_iface_t,
+                              recv_pool_list);
+        ucs_spin_lock(&pool->lock);
+        uct_iface_mpool_set_iface(&pool->mp, &owner->super.super);
+        ucs_spin_unlock(&pool->lock);
+    }
+
+    pthread_mutex_unlock(&uct_mm_iface_recv_pools_lock);
+
+    iface->recv_pool    = NULL;
+    iface->recv_desc_mp = NULL;
+}
+
 UCS_CLASS_INIT_FUNC(uct_mm_base_iface_t, uct_iface_ops_t *ops,
                     uct_iface_internal_ops_t *internal_ops, uct_md_h md,
                     uct_worker_h worker, const uct_iface_params_t *params,
@@ -721,6 +967,7 @@ UCS_CLASS_INIT_FUNC(uct_mm_base_iface_t, uct_iface_ops_t *ops,
                                       /* trim by the maximum unsigned integer value */
                                       ucs_min(mm_config->fifo_max_poll, UINT_MAX));
 
+    self->config.fifo_rx_batch     = mm_config->fifo_rx_batch;
     self->config.extra_cap_flags   = (mm_config->error_handling == UCS_YES) ?
                                      UCT_IFACE_FLAG_ERRHANDLE_PEER_FAILURE :
                                      0ul;
@@ -781,19 +1028,17 @@ UCS_CLASS_INIT_FUNC(uct_mm_base_iface_t, uct_iface_ops_t *ops,
         goto err_close_signal_fd;
     }
 
-    /* create a memory pool for receive descriptors */
-    status = uct_iface_mpool_init(&self->super.super, &self->recv_desc_mp,
-                                  payload_offset + self->config.seg_size,
-                                  align_offset, alignment, &mm_config->mp,
-                                  mm_config->mp.bufs_grow,
-                                  uct_mm_iface_recv_desc_init, "mm_recv_desc");
+    /* create or join a memory pool for receive descriptors */
+    status = uct_mm_iface_recv_pool_get(self, mm_config,
+                                        payload_offset + self->config.seg_size,
+                                        align_offset, alignment);
     if (status != UCS_OK) {
         ucs_error("failed to create a receive descriptor memory pool for the MM transport");
         goto err_close_signal_fd;
     }
 
     /* set the first receive descriptor */
-    self->last_recv_desc = ucs_mpool_get(&self->recv_desc_mp);
+    self->last_recv_desc = uct_mm_iface_recv_desc_get(self);
     VALGRIND_MAKE_MEM_DEFINED(self->last_recv_desc, sizeof(*(self->last_recv_desc)));
     if (self->last_recv_desc == NULL) {
         ucs_error("failed to get the first receive descriptor");
@@ -814,15 +1059,22 @@ UCS_CLASS_INIT_FUNC(uct_mm_base_iface_t, uct_iface_ops_t *ops,
         }
     }
 
+    status = ucs_arbiter_stats_init(&self->arbiter,
+                                    UCS_STATS_RVAL(self->super.super.stats),
+                                    "pending");
+    if (status != UCS_OK) {
+        goto destroy_descs;
+    }
+
     uct_mm_iface_log_created(self);
 
     return UCS_OK;
 
 destroy_descs:
     uct_mm_iface_free_rx_descs(self, i);
-    ucs_mpool_put(self->last_recv_desc);
+    uct_mm_iface_recv_desc_put(self->last_recv_desc);
 destroy_recv_mpool:
-    ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+    uct_mm_iface_recv_pool_put(self);
 err_close_signal_fd:
     close(self->signal_fd);
 err_free_fifo:
@@ -846,8 +1098,8 @@ static UCS_CLASS_CLEANUP_FUNC(uct_mm_base_iface_t)
      * to their mpool */
     uct_mm_iface_free_rx_descs(self, self->config.fifo_size);
 
-    ucs_mpool_put(self->last_recv_desc);
-    ucs_mpool_cleanup(&self->recv_desc_mp, 1);
+    uct_mm_iface_recv_desc_put(self->last_recv_desc);
+    uct_mm_iface_recv_pool_put(self);
     close(self->signal_fd);
     uct_iface_mem_free(&self->recv_fifo_mem);
 }
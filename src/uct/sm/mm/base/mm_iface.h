@@ -16,6 +16,7 @@
 #include <ucs/debug/memtrack_int.h>
 #include <ucs/datastruct/arbiter.h>
 #include <ucs/sys/compiler.h>
+#include <ucs/type/spinlock.h>
 #include <ucs/sys/sys.h>
 #include <sys/shm.h>
 #include <sys/un.h>
@@ -104,6 +105,9 @@ typedef struct uct_mm_iface_config {
                                                    * shared memory buffers */
     unsigned                 fifo_elem_size;      /* Size of the FIFO element size */
     int                      error_handling; /* Exposing of error handling cap */
+    int                      fifo_rx_batch;  /* Batched FIFO receive */
+    int                      shared_rx_pool; /* Share receive descriptors
+                                              * with other interfaces */
     uct_iface_mpool_config_t mp;
 } uct_mm_iface_config_t;
 
@@ -200,6 +204,27 @@ typedef struct uct_mm_fifo_check {
 } uct_mm_fifo_check_t;
 
 
+/**
+ * Receive descriptor pool, which can be shared by all the MM interfaces of the
+ * same worker whose descriptors have an identical layout.
+ */
+typedef struct uct_mm_recv_pool {
+    ucs_mpool_t             mp;
+    ucs_spinlock_t          lock;         /* Serializes a shared pool, since the
+                                             interfaces using it may be
+                                             progressed by different threads */
+    ucs_list_link_t         list;         /* Entry in the global pools list */
+    ucs_list_link_t         ifaces;       /* Interfaces using this pool */
+    uct_priv_worker_t       *worker;
+    uct_md_h                md;
+    size_t                  elem_size;
+    size_t                  align_offset;
+    size_t                  alignment;
+    size_t                  rx_headroom;
+    int                     shared;       /* Can be used by other interfaces */
+} uct_mm_recv_pool_t;
+
+
 /**
  * MM transport interface
  */
@@ -220,7 +245,9 @@ typedef struct uct_mm_base_iface {
     int                     fifo_prev_wnd_cons;  /* Was FIFO window size fully consumed by
                                                   * the previous call to iface progress */
 
-    ucs_mpool_t             recv_desc_mp;
+    ucs_mpool_t             *recv_desc_mp;    /* Receive descriptors pool */
+    uct_mm_recv_pool_t      *recv_pool;       /* Pool which holds recv_desc_mp */
+    ucs_list_link_t         recv_pool_list;   /* Entry in recv_pool->ifaces */
     uct_mm_recv_desc_t      *last_recv_desc;  /* next receive descriptor to use */
 
     int                     signal_fd;        /* Unix socket for receiving remote signal */
@@ -234,6 +261,8 @@ typedef struct uct_mm_base_iface {
         unsigned            fifo_elem_size;
         unsigned            seg_size;         /* size of the receive descriptor (for payload)*/
         unsigned            fifo_max_poll;
+        int                 fifo_rx_batch;    /* Detect and prefetch ready FIFO
+                                                 elements before processing */
         uint64_t            extra_cap_flags;
     } config;
 } uct_mm_base_iface_t;
@@ -12,6 +12,9 @@
 #include "mm_md.h"
 
 #include <ucs/debug/log.h>
+#include <ucs/memory/numa.h>
+#include <ucs/sys/sys.h>
+#include <sys/mman.h>
 #include <inttypes.h>
 #include <limits.h>
 
@@ -28,6 +31,17 @@ ucs_config_field_t uct_mm_md_config_table[] = {
    " try - Try to allocate memory using huge pages and if it fails, allocate regular pages.\n",
    ucs_offsetof(uct_mm_md_config_t, hugetlb_mode), UCS_CONFIG_TYPE_TERNARY},
 
+  {"NUMA_BIND", "n",
+   "Place allocated shared memory segments, such as the receive FIFO and the\n"
+   "receive buffers, on the NUMA node of the allocating (receiving) thread.\n"
+   "This implies pre-faulting the segments.",
+   ucs_offsetof(uct_mm_md_config_t, numa_bind), UCS_CONFIG_TYPE_BOOL},
+
+  {"PREFAULT", "n",
+   "Touch all pages of allocated shared memory segments when they are created,\n"
+   "rather than taking the page faults on the first access in the data path.",
+   ucs_offsetof(uct_mm_md_config_t, prefault), UCS_CONFIG_TYPE_BOOL},
+
   {NULL}
 };
 
@@ -63,10 +77,50 @@ ucs_status_t uct_mm_seg_new(void *address, size_t length, uct_mm_seg_t **seg_p)
     seg->address = address;
     seg->length  = length;
     seg->seg_id  = 0;
+    seg->uuid    = ucs_generate_uuid((uintptr_t)seg);
     *seg_p       = seg;
     return UCS_OK;
 }
 
+static void uct_mm_md_seg_prefault(uct_mm_seg_t *seg)
+{
+    size_t page_size = ucs_get_page_size();
+    volatile char *ptr;
+
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(seg->address, seg->length, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+
+    /* The segment was just created, so no one else accesses it yet */
+    for (ptr = seg->address; ptr < (char*)seg->address + seg->length;
+         ptr += page_size) {
+        *ptr = *ptr;
+    }
+}
+
+void uct_mm_md_seg_place(uct_mm_md_t *md, uct_mm_seg_t *seg)
+{
+    ucs_numa_node_t node;
+
+    if (!md->config->prefault && !md->config->numa_bind) {
+        return;
+    }
+
+    /* Map all pages first, so the pages which were already allocated by the
+     * mapper are migrated by the binding below */
+    uct_mm_md_seg_prefault(seg);
+
+    if (md->config->numa_bind) {
+        node = ucs_numa_node_of_current_cpu();
+        if (ucs_numa_mem_bind(seg->address, seg->length, node) != UCS_OK) {
+            ucs_debug("could not bind mm segment %p length %zu to numa node %d",
+                      seg->address, seg->length, node);
+        }
+    }
+}
+
 void uct_mm_md_query(uct_md_h md, uct_md_attr_v2_t *md_attr, uint64_t max_alloc)
 {
     md_attr->flags            = UCT_MD_FLAG_RKEY_PTR | UCT_MD_FLAG_NEED_RKEY;
@@ -118,10 +172,17 @@ ucs_status_t uct_mm_md_open(uct_component_t *component, const char *md_name,
     md->super.component = &mmc->super;
     md->iface_addr_len  = mmc->md_ops->iface_addr_length(md);
 
+    status = mmc->md_ops->md_init(md);
+    if (status != UCS_OK) {
+        goto err_release_mm_md_config;
+    }
+
     /* cppcheck-suppress autoVariables */
     *md_p = &md->super;
     return UCS_OK;
 
+err_release_mm_md_config:
+    ucs_config_parser_release_opts(md->config, mmc->super.md_config.table);
 err_free_mm_md_config:
     ucs_free(md->config);
 err_free_mm_md:
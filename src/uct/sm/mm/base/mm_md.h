@@ -29,6 +29,8 @@ typedef struct uct_mm_seg {
     uct_mm_seg_id_t       seg_id;     /* Shared memory ID */
     void                  *address;   /* Virtual address */
     size_t                length;     /* Size of the memory */
+    uint64_t              uuid;       /* Unique allocation ID, unlike seg_id
+                                         it is never reused by the mapper */
 } uct_mm_seg_t;
 
 
@@ -47,6 +49,9 @@ typedef struct uct_mm_remote_seg {
 typedef struct uct_mm_md_config {
     uct_md_config_t          super;
     ucs_ternary_auto_value_t hugetlb_mode;     /* Enable using huge pages */
+    int                      numa_bind;        /* Place allocated segments on
+                                                  the local NUMA node */
+    int                      prefault;         /* Pre-fault allocated segments */
 } uct_mm_md_config_t;
 
 
@@ -112,6 +117,10 @@ typedef void
                                    const uct_mm_remote_seg_t *rseg);
 
 
+/* Apply the configuration of a new memory domain to the mapper */
+typedef ucs_status_t (*uct_mm_mapper_md_init_func_t)(uct_mm_md_t *md);
+
+
 /*
  * Memory mapper operations - used to implement MD and TL functionality
  */
@@ -123,6 +132,7 @@ typedef struct uct_mm_mapper_ops {
     uct_mm_mapper_mem_attach_func_t        mem_attach;
     uct_mm_mapper_mem_detach_func_t        mem_detach;
     uct_mm_mapper_is_reachable_func_t      is_reachable;
+    uct_mm_mapper_md_init_func_t           md_init;
 } uct_mm_md_mapper_ops_t;
 
 
@@ -199,6 +209,8 @@ ucs_status_t uct_mm_query_md_resources(uct_component_t *component,
 
 ucs_status_t uct_mm_seg_new(void *address, size_t length, uct_mm_seg_t **seg_p);
 
+void uct_mm_md_seg_place(uct_mm_md_t *md, uct_mm_seg_t *seg);
+
 void uct_mm_md_query(uct_md_h md, uct_md_attr_v2_t *md_attr,
                      uint64_t max_alloc);
 
@@ -13,10 +13,13 @@
 #include <uct/sm/mm/base/mm_iface.h>
 #include <ucs/debug/memtrack_int.h>
 #include <uct/sm/mm/coll/mm_coll_iface.h>
+#include <ucs/datastruct/khash.h>
+#include <ucs/datastruct/lru.h>
 #include <ucs/debug/log.h>
 #include <ucs/sys/string.h>
 #include <ucs/profile/profile.h>
 #include <ucs/sys/sys.h>
+#include <ucs/type/spinlock.h>
 #include <sys/mman.h>
 #include <sys/statvfs.h>
 #include <uct/api/v2/uct_v2.h>
@@ -56,8 +59,11 @@ typedef struct uct_posix_md_config {
     char               *dir;
     int                use_proc_link;
     size_t             shm_min_size;
+    unsigned           attach_cache_max_regions;
+    size_t             attach_cache_max_size;
 } uct_posix_md_config_t;
 
+/* The backing file directory and the allocation uuid follow the packed rkey */
 typedef struct uct_posix_packed_rkey {
     uint64_t                  seg_id;     /* flags + mmid */
     uintptr_t                 address;
@@ -65,6 +71,40 @@ typedef struct uct_posix_packed_rkey {
 } UCS_S_PACKED uct_posix_packed_rkey_t;
 
 
+/*
+ * Remote segment attached by rkey_unpack(). The mapping stays in the attach
+ * cache after the last rkey referring to it is released, so unpacking an rkey
+ * of the same segment again does not open and map the file.
+ */
+typedef struct uct_posix_attach_entry {
+    uct_mm_remote_seg_t       rseg;
+    uint64_t                  seg_id;
+    uint64_t                  uuid;
+    unsigned                  refcount;
+    int                       cached;     /* Whether found in the hash */
+} uct_posix_attach_entry_t;
+
+
+KHASH_MAP_INIT_INT64(uct_posix_attach, uct_posix_attach_entry_t*);
+
+
+/*
+ * Cache of remote segments attached by rkey_unpack(), keyed by the allocation
+ * uuid. Idle entries are ordered by the LRU and unmapped when evicted.
+ */
+typedef struct uct_posix_attach_cache {
+    ucs_spinlock_t            lock;
+    khash_t(uct_posix_attach) hash;
+    ucs_lru_h                 lru;        /* Idle entries */
+    size_t                    idle_size;  /* Total length of idle entries */
+    unsigned                  max_regions;
+    size_t                    max_size;
+} uct_posix_attach_cache_t;
+
+
+static uct_posix_attach_cache_t uct_posix_attach_cache;
+
+
 static ucs_config_field_t uct_posix_md_config_table[] = {
     {"MM_", "", NULL, ucs_offsetof(uct_posix_md_config_t, super),
      UCS_CONFIG_TYPE_TABLE(uct_mm_md_config_table)},
@@ -88,6 +128,20 @@ static ucs_config_field_t uct_posix_md_config_table[] = {
      " n   - Use original file path to share posix file.\n",
      ucs_offsetof(uct_posix_md_config_t, use_proc_link), UCS_CONFIG_TYPE_BOOL},
 
+    {"ATTACH_CACHE_MAX_REGIONS", "256",
+     "Maximal number of remote segments which are kept attached after their\n"
+     "remote keys are released. The cache is shared by the process, and uses\n"
+     "the limits of the last opened memory domain.",
+     ucs_offsetof(uct_posix_md_config_t, attach_cache_max_regions),
+     UCS_CONFIG_TYPE_UINT},
+
+    {"ATTACH_CACHE_MAX_SIZE", "256m",
+     "Maximal total size of remote segments which are kept attached after\n"
+     "their remote keys are released. The cache is shared by the process, and\n"
+     "uses the limits of the last opened memory domain.",
+     ucs_offsetof(uct_posix_md_config_t, attach_cache_max_size),
+     UCS_CONFIG_TYPE_MEMUNITS},
+
     {NULL}
 };
 
@@ -150,7 +204,8 @@ uct_posix_md_query(uct_md_h tl_md, uct_md_attr_v2_t *md_attr)
     uct_mm_md_query(&md->super, md_attr, shm_size);
 
     md_attr->rkey_packed_size = sizeof(uct_posix_packed_rkey_t) +
-                                uct_posix_iface_addr_length(md);
+                                uct_posix_iface_addr_length(md) +
+                                sizeof(uint64_t);
     return UCS_OK;
 }
 
@@ -303,31 +358,43 @@ static ucs_status_t uct_posix_unlink(uct_mm_md_t *md, uint64_t seg_id)
     return UCS_OK;
 }
 
+#ifdef MAP_HUGETLB
+static ucs_status_t uct_posix_hugetlb_length(size_t *length_p)
+{
+    ssize_t huge_page_size = ucs_get_huge_page_size();
+    size_t huge_aligned_length;
+
+    if (huge_page_size <= 0) {
+        ucs_debug("huge pages are not supported on the system");
+        return UCS_ERR_NO_MEMORY; /* Huge pages not supported */
+    }
+
+    huge_aligned_length = ucs_align_up_pow2(*length_p, huge_page_size);
+    if (huge_aligned_length > (2 * *length_p)) {
+        return UCS_ERR_EXCEEDS_LIMIT; /* Do not align up by more than 2x */
+    }
+
+    *length_p = huge_aligned_length;
+    return UCS_OK;
+}
+#endif
+
 static ucs_status_t
 uct_posix_mmap(void **address_p, size_t *length_p, int flags, int fd,
                const char *alloc_name, ucs_log_level_t err_level)
 {
     size_t aligned_length;
+    ucs_status_t status;
     void *result;
 
     aligned_length = ucs_align_up_pow2(*length_p, ucs_get_page_size());
 
 #ifdef MAP_HUGETLB
     if (flags & MAP_HUGETLB) {
-        ssize_t huge_page_size = ucs_get_huge_page_size();
-        size_t huge_aligned_length;
-
-        if (huge_page_size <= 0) {
-            ucs_debug("huge pages are not supported on the system");
-            return UCS_ERR_NO_MEMORY; /* Huge pages not supported */
-        }
-
-        huge_aligned_length = ucs_align_up_pow2(aligned_length, huge_page_size);
-        if (huge_aligned_length > (2 * aligned_length)) {
-            return UCS_ERR_EXCEEDS_LIMIT; /* Do not align up by more than 2x */
+        status = uct_posix_hugetlb_length(&aligned_length);
+        if (status != UCS_OK) {
+            return status;
         }
-
-        aligned_length = huge_aligned_length;
     }
 #endif
 
@@ -395,7 +462,6 @@ uct_posix_mem_attach_common(uct_mm_seg_id_t seg_id, size_t length,
     int mmap_flags, fd;
 
     ucs_assert(length > 0);
-    rseg->cookie = (void*)length;
 
     status = uct_posix_mem_open(seg_id, dir, &fd);
     if (status != UCS_OK) {
@@ -411,6 +477,9 @@ uct_posix_mem_attach_common(uct_mm_seg_id_t seg_id, size_t length,
     status = uct_posix_mmap(&rseg->address, &length, mmap_flags, fd,
                             "posix_attach", UCS_LOG_LEVEL_ERROR);
     close(fd);
+
+    /* Keep the aligned length, huge page mappings must be unmapped whole */
+    rseg->cookie = (void*)length;
     return status;
 }
 
@@ -477,6 +546,77 @@ uct_posix_segment_open(uct_mm_md_t *md, uct_mm_seg_id_t *seg_id_p, int *fd_p)
     }
 }
 
+/* Create an anonymous file backed by huge pages, to be shared by procfs link */
+static ucs_status_t
+uct_posix_memfd_hugetlb_open(size_t length, ucs_log_level_t err_level,
+                             int *fd_p)
+{
+#ifdef MFD_HUGETLB
+    size_t huge_length = ucs_align_up_pow2(length, ucs_get_page_size());
+    ucs_status_t status;
+    int fd;
+
+    status = uct_posix_hugetlb_length(&huge_length);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    fd = memfd_create("ucx_shm_posix", MFD_CLOEXEC | MFD_HUGETLB);
+    if (fd < 0) {
+        ucs_log(err_level, "memfd_create(MFD_HUGETLB) failed: %m");
+        return UCS_ERR_SHMEM_SEGMENT;
+    }
+
+    if (ftruncate(fd, huge_length) < 0) {
+        ucs_log(err_level,
+                "ftruncate(fd=%d, length=%zu) of hugetlb memfd failed: %m", fd,
+                huge_length);
+        close(fd);
+        return UCS_ERR_SHMEM_SEGMENT;
+    }
+
+    *fd_p = fd;
+    return UCS_OK;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
+/* Try to allocate a segment from a hugetlb memfd, which is shared by procfs
+ * link like any other segment in this mode. Unlike a file in /dev/shm, the
+ * memfd can be mapped with MAP_HUGETLB. */
+static ucs_status_t
+uct_posix_mem_alloc_memfd_hugetlb(uct_mm_seg_t *seg, int mmap_flags,
+                                  const char *alloc_name,
+                                  ucs_log_level_t err_level)
+{
+#ifdef MAP_HUGETLB
+    ucs_status_t status;
+    int fd;
+
+    status = uct_posix_memfd_hugetlb_open(seg->length, err_level, &fd);
+    if (status != UCS_OK) {
+        return status;
+    }
+
+    status = uct_posix_mmap(&seg->address, &seg->length,
+                            mmap_flags | MAP_HUGETLB, fd, alloc_name,
+                            err_level);
+    if (status != UCS_OK) {
+        close(fd);
+        return status;
+    }
+
+    seg->seg_id = uct_posix_mmid_procfs_pack(fd) |
+                  UCT_POSIX_SEG_FLAG_PROCFS | UCT_POSIX_SEG_FLAG_HUGETLB |
+                  (ucs_sys_ns_is_default(UCS_SYS_NS_TYPE_PID) ? 0 :
+                   UCT_POSIX_SEG_FLAG_PID_NS);
+    return UCS_OK;
+#else
+    return UCS_ERR_UNSUPPORTED;
+#endif
+}
+
 static ucs_status_t
 uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
                     ucs_memory_type_t mem_type, unsigned flags,
@@ -489,7 +629,6 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
     uct_mm_seg_t *seg;
     int force_hugetlb;
     int mmap_flags;
-    void *address;
     int fd;
 
     if (mem_type != UCS_MEMORY_TYPE_HOST) {
@@ -501,6 +640,27 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
         goto err;
     }
 
+    /* mmap flags of the shared memory segment */
+    if (flags & UCT_MD_MEM_FLAG_FIXED) {
+        mmap_flags   = MAP_FIXED;
+    } else {
+        seg->address = NULL;
+        mmap_flags   = 0;
+    }
+
+    /* Huge pages are required explicitly, so use a HUGETLB memfd, which can
+     * be shared only by procfs link */
+    force_hugetlb = (posix_config->super.hugetlb_mode == UCS_YES);
+    if (force_hugetlb && posix_config->use_proc_link) {
+        status = uct_posix_mem_alloc_memfd_hugetlb(seg, mmap_flags, alloc_name,
+                                                   UCS_LOG_LEVEL_ERROR);
+        if (status != UCS_OK) {
+            goto err_free_seg;
+        }
+
+        goto out;
+    }
+
     status = uct_posix_segment_open(md, &seg->seg_id, &fd);
     if (status != UCS_OK) {
         goto err_free_seg;
@@ -529,18 +689,9 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
                        UCT_POSIX_SEG_FLAG_PID_NS);
     }
 
-    /* mmap the shared memory segment that was created by shm_open */
-    if (flags & UCT_MD_MEM_FLAG_FIXED) {
-        mmap_flags   = MAP_FIXED;
-    } else {
-        seg->address = NULL;
-        mmap_flags   = 0;
-    }
-
     /* try HUGETLB mmap */
-    address = MAP_FAILED;
+    status = UCS_ERR_UNSUPPORTED;
     if (posix_config->super.hugetlb_mode != UCS_NO) {
-        force_hugetlb = (posix_config->super.hugetlb_mode == UCS_YES);
 #ifdef MAP_HUGETLB
         status = uct_posix_mmap(&seg->address, &seg->length,
                                 mmap_flags | MAP_HUGETLB, fd, alloc_name,
@@ -561,7 +712,7 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
     }
 
     /* fallback to regular mmap */
-    if (address == MAP_FAILED) {
+    if (status != UCS_OK) {
         ucs_assert(posix_config->super.hugetlb_mode != UCS_YES);
         status = uct_posix_mmap(&seg->address, &seg->length, mmap_flags, fd,
                                 alloc_name, UCS_LOG_LEVEL_ERROR);
@@ -570,15 +721,18 @@ uct_posix_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
         }
     }
 
-    /* create new memory segment */
-    ucs_debug("allocated posix shared memory at %p length %zu", seg->address,
-              seg->length);
-
     if (!posix_config->use_proc_link) {
         /* closing the file here since the peers will open it by file system path */
         close(fd);
     }
 
+out:
+    /* create new memory segment */
+    ucs_debug("allocated posix shared memory at %p length %zu%s", seg->address,
+              seg->length,
+              (seg->seg_id & UCT_POSIX_SEG_FLAG_HUGETLB) ? " hugetlb" : "");
+
+    uct_mm_md_seg_place(md, seg);
     *address_p = seg->address;
     *length_p  = seg->length;
      *memh_p   = seg;
@@ -650,6 +804,26 @@ static ucs_status_t uct_posix_iface_addr_pack(uct_mm_md_t *md, void *buffer)
     return UCS_OK;
 }
 
+static int
+uct_posix_packed_rkey_has_dir(const uct_posix_packed_rkey_t *packed_rkey)
+{
+    return !(packed_rkey->seg_id & UCT_POSIX_SEG_FLAG_SHM_OPEN) &&
+           !(packed_rkey->seg_id & UCT_POSIX_SEG_FLAG_PROCFS);
+}
+
+/* The uuid is packed last, so older versions can still unpack the rkey */
+static void *
+uct_posix_packed_rkey_uuid(const uct_posix_packed_rkey_t *packed_rkey)
+{
+    const char *dir = (const char*)(packed_rkey + 1);
+
+    if (uct_posix_packed_rkey_has_dir(packed_rkey)) {
+        return (void*)(dir + strlen(dir) + 1);
+    }
+
+    return (void*)dir;
+}
+
 static ucs_status_t
 uct_posix_md_mkey_pack(uct_md_h tl_md, uct_mem_h memh, void *address,
                        size_t length, const uct_md_mkey_pack_params_t *params,
@@ -662,11 +836,11 @@ uct_posix_md_mkey_pack(uct_md_h tl_md, uct_mem_h memh, void *address,
     packed_rkey->seg_id  = seg->seg_id;
     packed_rkey->address = (uintptr_t)seg->address;
     packed_rkey->length  = seg->length;
-    if (!(seg->seg_id & UCT_POSIX_SEG_FLAG_SHM_OPEN) &&
-        !(seg->seg_id & UCT_POSIX_SEG_FLAG_PROCFS)) {
+    if (uct_posix_packed_rkey_has_dir(packed_rkey)) {
         uct_posix_copy_dir(md, packed_rkey + 1);
     }
 
+    *(uint64_t*)uct_posix_packed_rkey_uuid(packed_rkey) = seg->uuid;
     return UCS_OK;
 }
 
@@ -682,46 +856,182 @@ static void uct_posix_mem_detach(uct_mm_md_t *md, const uct_mm_remote_seg_t *rse
     uct_posix_mem_detach_common(rseg);
 }
 
-UCS_PROFILE_FUNC(ucs_status_t, uct_posix_rkey_unpack,
-                 (component, rkey_buffer, rkey_p, handle_p),
-                 uct_component_t *component, const void *rkey_buffer,
-                 uct_rkey_t *rkey_p, void **handle_p)
+static void uct_posix_attach_entry_destroy(uct_posix_attach_entry_t *entry)
 {
-    const uct_posix_packed_rkey_t *packed_rkey = rkey_buffer;
-    uct_mm_remote_seg_t *rseg;
+    ucs_trace("posix detaching seg_id 0x%" PRIx64 " uuid 0x%" PRIx64
+              " address %p", entry->seg_id, entry->uuid, entry->rseg.address);
+    uct_posix_mem_detach_common(&entry->rseg);
+    ucs_free(entry);
+}
+
+static size_t uct_posix_attach_entry_length(uct_posix_attach_entry_t *entry)
+{
+    return (size_t)entry->rseg.cookie;
+}
+
+/* Unmap the least recently used idle entries until the cache fits its limits */
+static void uct_posix_attach_cache_trim(uct_posix_attach_cache_t *cache)
+{
+    uct_posix_attach_entry_t *entry;
+    ucs_lru_element_t *lru_elem;
+    khiter_t iter;
+
+    while ((ucs_lru_size(cache->lru) > cache->max_regions) ||
+           (cache->idle_size > cache->max_size)) {
+        lru_elem = ucs_lru_pop(cache->lru);
+        iter     = kh_get(uct_posix_attach, &cache->hash,
+                          (uint64_t)lru_elem->key);
+        ucs_free(lru_elem);
+
+        ucs_assert(iter != kh_end(&cache->hash));
+        entry = kh_val(&cache->hash, iter);
+        ucs_assert(entry->refcount == 0);
+
+        cache->idle_size -= uct_posix_attach_entry_length(entry);
+        kh_del(uct_posix_attach, &cache->hash, iter);
+        uct_posix_attach_entry_destroy(entry);
+    }
+}
+
+static void
+uct_posix_attach_cache_set_limits(unsigned max_regions, size_t max_size)
+{
+    uct_posix_attach_cache_t *cache = &uct_posix_attach_cache;
+
+    ucs_spin_lock(&cache->lock);
+    cache->max_regions = max_regions;
+    cache->max_size    = max_size;
+    uct_posix_attach_cache_trim(cache);
+    ucs_spin_unlock(&cache->lock);
+}
+
+static ucs_status_t
+uct_posix_attach_cache_get(const uct_posix_packed_rkey_t *packed_rkey,
+                           uct_posix_attach_entry_t **entry_p)
+{
+    uct_posix_attach_cache_t *cache = &uct_posix_attach_cache;
+    uint64_t uuid                   =
+            *(const uint64_t*)uct_posix_packed_rkey_uuid(packed_rkey);
+    uct_posix_attach_entry_t *entry;
     ucs_status_t status;
+    khiter_t iter;
+    int ret;
+
+    ucs_spin_lock(&cache->lock);
+
+    iter = kh_get(uct_posix_attach, &cache->hash, uuid);
+    if (iter != kh_end(&cache->hash)) {
+        entry = kh_val(&cache->hash, iter);
+        if (ucs_likely((entry->seg_id == packed_rkey->seg_id) &&
+                       (uct_posix_attach_entry_length(entry) >=
+                        packed_rkey->length))) {
+            if (entry->refcount++ == 0) {
+                ucs_lru_remove(cache->lru, (void*)uuid);
+                cache->idle_size -= uct_posix_attach_entry_length(entry);
+            }
+            goto out;
+        }
+    }
 
-    rseg = ucs_malloc(sizeof(*rseg), "posix_remote_seg");
-    if (rseg == NULL) {
+    entry = ucs_malloc(sizeof(*entry), "posix_attach_entry");
+    if (entry == NULL) {
         ucs_error("failed to allocate posix remote segment descriptor");
-        return UCS_ERR_NO_MEMORY;
+        status = UCS_ERR_NO_MEMORY;
+        goto err_unlock;
     }
 
     status = uct_posix_mem_attach_common(packed_rkey->seg_id,
                                          packed_rkey->length,
-                                         (const char*)(packed_rkey + 1), rseg);
+                                         (const char*)(packed_rkey + 1),
+                                         &entry->rseg);
     if (status != UCS_OK) {
-        ucs_free(rseg);
-        return status;
+        goto err_free;
+    }
+
+    entry->seg_id   = packed_rkey->seg_id;
+    entry->uuid     = uuid;
+    entry->refcount = 1;
+    entry->cached   = 0;
+
+    if (iter == kh_end(&cache->hash)) {
+        /* A mismatching entry with the same uuid is not expected, but if it
+         * exists the new one is used without caching */
+        iter = kh_put(uct_posix_attach, &cache->hash, entry->uuid, &ret);
+        if (ret != UCS_KH_PUT_FAILED) {
+            kh_val(&cache->hash, iter) = entry;
+            entry->cached              = 1;
+        }
     }
 
-    uct_mm_md_make_rkey(rseg->address, packed_rkey->address, rkey_p);
-    *handle_p = rseg;
+out:
+    ucs_spin_unlock(&cache->lock);
+    *entry_p = entry;
     return UCS_OK;
+
+err_free:
+    ucs_free(entry);
+err_unlock:
+    ucs_spin_unlock(&cache->lock);
+    return status;
 }
 
-UCS_PROFILE_FUNC(ucs_status_t, uct_posix_rkey_release,(component, rkey, handle),
-                 uct_component_t *component, uct_rkey_t rkey, void *handle)
+static void uct_posix_attach_cache_put(uct_posix_attach_entry_t *entry)
 {
-    uct_mm_remote_seg_t *rseg = handle;
+    uct_posix_attach_cache_t *cache = &uct_posix_attach_cache;
+
+    ucs_spin_lock(&cache->lock);
+
+    ucs_assert(entry->refcount > 0);
+    if (--entry->refcount > 0) {
+        goto out;
+    }
+
+    if (!entry->cached) {
+        uct_posix_attach_entry_destroy(entry);
+        goto out;
+    }
+
+    ucs_lru_push(cache->lru, (void*)entry->uuid);
+    cache->idle_size += uct_posix_attach_entry_length(entry);
+    uct_posix_attach_cache_trim(cache);
+
+out:
+    ucs_spin_unlock(&cache->lock);
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, uct_posix_rkey_unpack,
+                 (component, rkey_buffer, rkey_p, handle_p),
+                 uct_component_t *component, const void *rkey_buffer,
+                 uct_rkey_t *rkey_p, void **handle_p)
+{
+    const uct_posix_packed_rkey_t *packed_rkey = rkey_buffer;
+    uct_posix_attach_entry_t *entry;
     ucs_status_t status;
 
-    status = uct_posix_mem_detach_common(rseg);
+    status = uct_posix_attach_cache_get(packed_rkey, &entry);
     if (status != UCS_OK) {
         return status;
     }
 
-    ucs_free(rseg);
+    uct_mm_md_make_rkey(entry->rseg.address, packed_rkey->address, rkey_p);
+    *handle_p = entry;
+    return UCS_OK;
+}
+
+UCS_PROFILE_FUNC(ucs_status_t, uct_posix_rkey_release,(component, rkey, handle),
+                 uct_component_t *component, uct_rkey_t rkey, void *handle)
+{
+    uct_posix_attach_cache_put(handle);
+    return UCS_OK;
+}
+
+static ucs_status_t uct_posix_md_init(uct_mm_md_t *md)
+{
+    const uct_posix_md_config_t *posix_config =
+                    ucs_derived_of(md->config, uct_posix_md_config_t);
+
+    uct_posix_attach_cache_set_limits(posix_config->attach_cache_max_regions,
+                                      posix_config->attach_cache_max_size);
     return UCS_OK;
 }
 
@@ -743,10 +1053,41 @@ static uct_mm_md_mapper_ops_t uct_posix_md_ops = {
     .iface_addr_pack   = uct_posix_iface_addr_pack,
     .mem_attach        = uct_posix_mem_attach,
     .mem_detach        = uct_posix_mem_detach,
-    .is_reachable      = uct_posix_is_reachable
+    .is_reachable      = uct_posix_is_reachable,
+    .md_init           = uct_posix_md_init
 };
 
 UCT_MM_TL_DEFINE(posix, &uct_posix_md_ops, uct_posix_rkey_unpack,
                  uct_posix_rkey_release, "POSIX_")
 
 UCT_MM_TL_INIT(posix,,,)
+
+UCS_STATIC_INIT {
+    ucs_status_t status;
+
+    ucs_spinlock_init(&uct_posix_attach_cache.lock, 0);
+    kh_init_inplace(uct_posix_attach, &uct_posix_attach_cache.hash);
+    uct_posix_attach_cache.idle_size   = 0;
+    uct_posix_attach_cache.max_regions = 0;
+    uct_posix_attach_cache.max_size    = 0;
+
+    /* Eviction is driven by the cache limits, not by the LRU capacity */
+    status = ucs_lru_create(SIZE_MAX, &uct_posix_attach_cache.lru);
+    ucs_assert_always(status == UCS_OK);
+}
+
+UCS_STATIC_CLEANUP {
+    uct_posix_attach_entry_t *entry;
+
+    kh_foreach_value(&uct_posix_attach_cache.hash, entry, {
+        if (entry->refcount > 0) {
+            ucs_warn("posix remote segment uuid 0x%" PRIx64 " is not released "
+                     "(refcount %u)", entry->uuid, entry->refcount);
+        }
+        uct_posix_attach_entry_destroy(entry);
+    })
+
+    ucs_lru_destroy(uct_posix_attach_cache.lru);
+    kh_destroy_inplace(uct_posix_attach, &uct_posix_attach_cache.hash);
+    ucs_spinlock_destroy(&uct_posix_attach_cache.lock);
+}
@@ -118,6 +118,7 @@ uct_sysv_mem_alloc(uct_md_h tl_md, size_t *length_p, void **address_p,
 
 out_ok:
     seg->seg_id = shmid;
+    uct_mm_md_seg_place(md, seg);
     *address_p  = seg->address;
     *length_p   = seg->length;
     *memh_p     = seg;
@@ -212,7 +213,9 @@ static uct_mm_md_mapper_ops_t uct_sysv_md_ops = {
     .iface_addr_pack   = ucs_empty_function_return_success,
     .mem_attach        = uct_sysv_mem_attach,
     .mem_detach        = uct_sysv_mem_detach,
-    .is_reachable      = ucs_empty_function_return_one_int
+    .is_reachable      = ucs_empty_function_return_one_int,
+    .md_init           = (uct_mm_mapper_md_init_func_t)
+            ucs_empty_function_return_success
 };
 
 UCT_MM_TL_DEFINE(sysv, &uct_sysv_md_ops, uct_sysv_rkey_unpack,
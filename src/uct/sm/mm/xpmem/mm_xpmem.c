@@ -559,7 +559,9 @@ static uct_mm_md_mapper_ops_t uct_xpmem_md_ops = {
     .iface_addr_pack   = uct_xpmem_iface_addr_pack,
     .mem_attach        = uct_xpmem_mem_attach,
     .mem_detach        = uct_xpmem_mem_detach,
-    .is_reachable      = ucs_empty_function_return_one_int
+    .is_reachable      = ucs_empty_function_return_one_int,
+    .md_init           = (uct_mm_mapper_md_init_func_t)
+            ucs_empty_function_return_success
 };
 
 static void uct_xpmem_global_init()
@@ -124,6 +124,95 @@ ucs_status_t uct_scopy_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
                                 rkey, comp, UCT_SCOPY_TX_GET_ZCOPY);
 }
 
+static UCS_F_ALWAYS_INLINE int uct_scopy_ep_tx_is_done(uct_scopy_tx_t *tx)
+{
+    return tx->iov_iter.iov_index >= tx->iov_cnt;
+}
+
+static UCS_F_ALWAYS_INLINE size_t
+uct_scopy_ep_tx_remaining_length(uct_scopy_tx_t *tx)
+{
+    return uct_iov_total_length(tx->iov, tx->iov_cnt) -
+           uct_iov_iter_flat_offset(tx->iov, tx->iov_cnt, &tx->iov_iter);
+}
+
+/* Transfer the remaining data of the TX operation at the head of the endpoint
+ * queue together with the following operations of the same type, in a single
+ * batched call. The following operations which were transferred completely are
+ * left in the queue, and are completed when the arbiter reaches them.
+ *
+ * @return Nonzero if the remaining data of the head operation was transferred.
+ */
+static int uct_scopy_ep_tx_batch(uct_scopy_iface_t *iface, uct_scopy_ep_t *ep,
+                                 uct_scopy_tx_t *tx)
+{
+    uct_scopy_tx_t *txs[UCT_SCOPY_TX_BATCH_MAX];
+    size_t lengths[UCT_SCOPY_TX_BATCH_MAX];
+    ucs_iov_iter_t iov_iters[UCT_SCOPY_TX_BATCH_MAX];
+    ucs_arbiter_elem_t *elem = NULL;
+    size_t total_length      = 0;
+    size_t total_iov_cnt     = 0;
+    unsigned count           = 0;
+    ucs_status_t status;
+    size_t length, iov_cnt;
+    unsigned i;
+
+    for (;;) {
+        length  = uct_scopy_ep_tx_remaining_length(tx);
+        iov_cnt = tx->iov_cnt - tx->iov_iter.iov_index;
+        if (((total_length + length) > iface->config.seg_size) ||
+            ((total_iov_cnt + iov_cnt) > UCT_SCOPY_TX_BATCH_MAX_IOV)) {
+            break;
+        }
+
+        txs[count]       = tx;
+        lengths[count]   = length;
+        iov_iters[count] = tx->iov_iter;
+        total_length    += length;
+        total_iov_cnt   += iov_cnt;
+        if (++count == iface->config.tx_batch) {
+            break;
+        }
+
+        elem = ucs_arbiter_group_next_elem(&ep->arb_group, elem);
+        if (elem == NULL) {
+            break;
+        }
+
+        tx = ucs_container_of(elem, uct_scopy_tx_t, arb_elem);
+        if ((tx->op != txs[0]->op) || uct_scopy_ep_tx_is_done(tx)) {
+            break;
+        }
+    }
+
+    if (count < 2) {
+        return 0;
+    }
+
+    status = iface->tx_batch(&ep->super.super, txs, lengths, count,
+                             &total_length);
+    if (status != UCS_OK) {
+        /* Let the operations report the error one by one */
+        total_length = 0;
+    }
+
+    for (i = 0; i < count; ++i) {
+        if (total_length < lengths[i]) {
+            /* Retry the operations that were not completed on their own */
+            for (; i < count; ++i) {
+                txs[i]->iov_iter = iov_iters[i];
+            }
+            break;
+        }
+
+        total_length        -= lengths[i];
+        txs[i]->remote_addr += lengths[i];
+        uct_scopy_trace_data(txs[i]);
+    }
+
+    return uct_scopy_ep_tx_is_done(txs[0]);
+}
+
 ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
                                                  ucs_arbiter_group_t *group,
                                                  ucs_arbiter_elem_t *elem,
@@ -139,6 +228,11 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
     ucs_status_t status      = UCS_OK;
     size_t seg_size;
 
+    if ((tx->op != UCT_SCOPY_TX_FLUSH_COMP) && uct_scopy_ep_tx_is_done(tx)) {
+        /* The data was transferred as a part of a batch */
+        goto out_complete;
+    }
+
     if (*count == iface->config.tx_quota) {
         return UCS_ARBITER_CB_RESULT_STOP;
     }
@@ -146,6 +240,12 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
     if (tx->op != UCT_SCOPY_TX_FLUSH_COMP) {
         ucs_assert((tx->op == UCT_SCOPY_TX_GET_ZCOPY) ||
                    (tx->op == UCT_SCOPY_TX_PUT_ZCOPY));
+        if ((iface->tx_batch != NULL) && (iface->config.tx_batch > 1) &&
+            uct_scopy_ep_tx_batch(iface, ep, tx)) {
+            (*count)++;
+            goto out_complete;
+        }
+
         seg_size = iface->config.seg_size;
         status   = iface->tx(&ep->super.super, tx->iov, tx->iov_cnt,
                              &tx->iov_iter, &seg_size, tx->remote_addr,
@@ -165,6 +265,7 @@ ucs_arbiter_cb_result_t uct_scopy_ep_progress_tx(ucs_arbiter_t *arbiter,
         }
     }
 
+out_complete:
     ucs_assert((tx->comp != NULL) ||
                (tx->op != UCT_SCOPY_TX_FLUSH_COMP));
     if (tx->comp != NULL) {
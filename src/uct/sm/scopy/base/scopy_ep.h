@@ -11,6 +11,12 @@
 #include <ucs/sys/iovec.h>
 
 
+/* Maximal number of TX operations, and of their local IOVs, which can be
+ * transferred by a single batched TX call */
+#define UCT_SCOPY_TX_BATCH_MAX       16
+#define UCT_SCOPY_TX_BATCH_MAX_IOV   64
+
+
 extern const char* uct_scopy_tx_op_str[];
 
 
@@ -57,6 +63,29 @@ typedef struct uct_scopy_tx {
 } uct_scopy_tx_t;
 
 
+/**
+ * Batched TX operation executor, transfers the remaining data of several TX
+ * operations of the same type in a single call
+ *
+ * @param [in]     tl_ep             Transport EP.
+ * @param [in]     txs               The array of TX operations. Their IOV
+ *                                   iterators are advanced past the data which
+ *                                   is posted to the transfer.
+ * @param [in]     lengths           The remaining length of each TX operation.
+ * @param [in]     count             The number of TX operations, up to
+ *                                   @ref UCT_SCOPY_TX_BATCH_MAX, with up to
+ *                                   @ref UCT_SCOPY_TX_BATCH_MAX_IOV local IOVs.
+ * @param [out]    length_p          The resulted length of the data that was
+ *                                   transferred, in the order of the operations.
+ *
+ * @return UCS_OK if the operations were completed, otherwise - error status.
+ */
+typedef ucs_status_t
+(*uct_scopy_ep_tx_batch_func_t)(uct_ep_h tl_ep, uct_scopy_tx_t *const *txs,
+                                const size_t *lengths, unsigned count,
+                                size_t *length_p);
+
+
 typedef struct uct_scopy_ep {
     uct_base_ep_t                   super;
     ucs_arbiter_group_t             arb_group;          /* TX arbiter group */
@@ -48,6 +48,12 @@ ucs_config_field_t uct_scopy_iface_config_table[] = {
      "How many TX segments can be dispatched during iface progress",
      ucs_offsetof(uct_scopy_iface_config_t, tx_quota), UCS_CONFIG_TYPE_UINT},
 
+    {"TX_BATCH", UCS_PP_MAKE_STRING(UCT_SCOPY_TX_BATCH_MAX),
+     "Maximal number of pending GET/PUT Zcopy operations to the same peer which\n"
+     "can be transferred by a single system call, if the transport supports it.\n"
+     "The operations must fit in one segment in total. 1 disables batching.",
+     ucs_offsetof(uct_scopy_iface_config_t, tx_batch), UCS_CONFIG_TYPE_UINT},
+
     UCT_IFACE_MPOOL_CONFIG_FIELDS("TX_", -1, 8, 128m, 1.0, "send",
                                   ucs_offsetof(uct_scopy_iface_config_t, tx_mpool), ""),
 
@@ -131,9 +137,11 @@ UCS_CLASS_INIT_FUNC(uct_scopy_iface_t, uct_iface_ops_t *ops,
                               worker, params, tl_config);
 
     self->tx              = scopy_ops->ep_tx;
+    self->tx_batch        = scopy_ops->ep_tx_batch;
     self->config.max_iov  = ucs_min(config->max_iov, ucs_iov_get_max());
     self->config.seg_size = config->seg_size;
     self->config.tx_quota = config->tx_quota;
+    self->config.tx_batch = ucs_min(config->tx_batch, UCT_SCOPY_TX_BATCH_MAX);
 
     elem_size             = sizeof(uct_scopy_tx_t) +
                             self->config.max_iov * sizeof(uct_iov_t);
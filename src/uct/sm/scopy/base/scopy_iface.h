@@ -31,6 +31,8 @@ typedef struct uct_scopy_iface_config {
                                                * data transfer for RMA operations */
     unsigned                      tx_quota;   /* How many TX segments can be dispatched
                                                * during iface progress */
+    unsigned                      tx_batch;   /* How many TX operations can be
+                                               * merged into a single transfer */
     uct_iface_mpool_config_t      tx_mpool;   /* TX memory pool configuration */
 } uct_scopy_iface_config_t;
 
@@ -40,6 +42,7 @@ typedef struct uct_scopy_iface {
     ucs_arbiter_t                 arbiter;     /* TX arbiter */
     ucs_mpool_t                   tx_mpool;    /* TX memory pool */
     uct_scopy_ep_tx_func_t        tx;          /* TX function */
+    uct_scopy_ep_tx_batch_func_t  tx_batch;    /* Batched TX function, or NULL */
     struct {
         size_t                    max_iov;     /* Maximum supported IOVs limited by
                                                 * user configuration and system
@@ -49,13 +52,16 @@ typedef struct uct_scopy_iface {
                                                 * Zcopy transfers */
         unsigned                  tx_quota;    /* How many TX segments can be dispatched
                                                 * during iface progress */
+        unsigned                  tx_batch;    /* How many TX operations can be
+                                                * merged into a single transfer */
     } config;
 } uct_scopy_iface_t;
 
 
 typedef struct uct_scopy_iface_ops {
     uct_iface_internal_ops_t super;
-    uct_scopy_ep_tx_func_t   ep_tx;
+    uct_scopy_ep_tx_func_t       ep_tx;
+    uct_scopy_ep_tx_batch_func_t ep_tx_batch;
 } uct_scopy_iface_ops_t;
 
 
@@ -138,6 +138,47 @@ ucs_status_t uct_cma_ep_tx(uct_ep_h tl_ep, const uct_iov_t *iov, size_t iov_cnt,
     return UCS_OK;
 }
 
+ucs_status_t uct_cma_ep_tx_batch(uct_ep_h tl_ep, uct_scopy_tx_t *const *txs,
+                                 const size_t *lengths, unsigned count,
+                                 size_t *length_p)
+{
+    uct_cma_ep_t *ep             = ucs_derived_of(tl_ep, uct_cma_ep_t);
+    uct_scopy_tx_op_t tx_op      = txs[0]->op;
+    size_t local_iov_cnt         = 0;
+    struct iovec local_iov[UCT_SCOPY_TX_BATCH_MAX_IOV];
+    struct iovec remote_iov[UCT_SCOPY_TX_BATCH_MAX];
+    size_t iov_cnt, length;
+    unsigned i;
+    ssize_t ret;
+
+    ucs_assert(count <= UCT_SCOPY_TX_BATCH_MAX);
+
+    for (i = 0; i < count; ++i) {
+        ucs_assert(txs[i]->op == tx_op);
+        iov_cnt = UCT_SCOPY_TX_BATCH_MAX_IOV - local_iov_cnt;
+        length  = uct_iov_to_iovec(&local_iov[local_iov_cnt], &iov_cnt,
+                                   txs[i]->iov, txs[i]->iov_cnt, lengths[i],
+                                   &txs[i]->iov_iter);
+        ucs_assert(length == lengths[i]);
+
+        local_iov_cnt         += iov_cnt;
+        remote_iov[i].iov_base = (void*)(uintptr_t)txs[i]->remote_addr;
+        remote_iov[i].iov_len  = length;
+    }
+
+    ret = uct_cma_ep_fn[tx_op].fn(ep->remote_pid, local_iov, local_iov_cnt,
+                                  remote_iov, count, 0);
+    if (ucs_unlikely(ret < 0)) {
+        ucs_debug("%s(pid=%d, local_iov_cnt=%zu, remote_iov_cnt=%u) "
+                  "failed: %m", uct_cma_ep_fn[tx_op].name, ep->remote_pid,
+                  local_iov_cnt, count);
+        return UCS_ERR_IO_ERROR;
+    }
+
+    *length_p = ret;
+    return UCS_OK;
+}
+
 ucs_status_t uct_cma_ep_check(const uct_ep_h tl_ep, unsigned flags,
                               uct_completion_t *comp)
 {
@@ -144,7 +144,8 @@ static uct_scopy_iface_ops_t uct_cma_iface_ops = {
         .iface_is_reachable_v2 = uct_cma_iface_is_reachable_v2,
         .ep_is_connected       = uct_cma_ep_is_connected
     },
-    .ep_tx = uct_cma_ep_tx,
+    .ep_tx       = uct_cma_ep_tx,
+    .ep_tx_batch = uct_cma_ep_tx_batch
 };
 
 static UCS_CLASS_INIT_FUNC(uct_cma_iface_t, uct_md_h md, uct_worker_h worker,
@@ -83,7 +83,8 @@ static uct_scopy_iface_ops_t uct_knem_iface_ops = {
         .iface_is_reachable_v2 = uct_knem_iface_is_reachable_v2,
         .ep_is_connected       = uct_base_ep_is_connected
     },
-    .ep_tx = uct_knem_ep_tx,
+    .ep_tx       = uct_knem_ep_tx,
+    .ep_tx_batch = NULL
 };
 
 static UCS_CLASS_INIT_FUNC(uct_knem_iface_t, uct_md_h md, uct_worker_h worker,
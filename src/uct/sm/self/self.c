@@ -77,9 +77,12 @@ static ucs_status_t uct_self_iface_query(uct_iface_h tl_iface, uct_iface_attr_t
     attr->cap.flags              = UCT_IFACE_FLAG_CONNECT_TO_IFACE |
                                    UCT_IFACE_FLAG_AM_SHORT         |
                                    UCT_IFACE_FLAG_AM_BCOPY         |
+                                   UCT_IFACE_FLAG_AM_ZCOPY         |
                                    UCT_IFACE_FLAG_PUT_SHORT        |
                                    UCT_IFACE_FLAG_PUT_BCOPY        |
+                                   UCT_IFACE_FLAG_PUT_ZCOPY        |
                                    UCT_IFACE_FLAG_GET_BCOPY        |
+                                   UCT_IFACE_FLAG_GET_ZCOPY        |
                                    UCT_IFACE_FLAG_ATOMIC_CPU       |
                                    UCT_IFACE_FLAG_PENDING          |
                                    UCT_IFACE_FLAG_CB_SYNC          |
@@ -102,26 +105,26 @@ static ucs_status_t uct_self_iface_query(uct_iface_h tl_iface, uct_iface_attr_t
     attr->cap.put.max_short       = UINT_MAX;
     attr->cap.put.max_bcopy       = SIZE_MAX;
     attr->cap.put.min_zcopy       = 0;
-    attr->cap.put.max_zcopy       = 0;
+    attr->cap.put.max_zcopy       = SIZE_MAX;
     attr->cap.put.opt_zcopy_align = 1;
     attr->cap.put.align_mtu       = attr->cap.put.opt_zcopy_align;
-    attr->cap.put.max_iov         = 1;
+    attr->cap.put.max_iov         = UCT_SM_MAX_IOV;
 
     attr->cap.get.max_bcopy       = SIZE_MAX;
     attr->cap.get.min_zcopy       = 0;
-    attr->cap.get.max_zcopy       = 0;
+    attr->cap.get.max_zcopy       = SIZE_MAX;
     attr->cap.get.opt_zcopy_align = 1;
     attr->cap.get.align_mtu       = attr->cap.get.opt_zcopy_align;
-    attr->cap.get.max_iov         = 1;
+    attr->cap.get.max_iov         = UCT_SM_MAX_IOV;
 
     attr->cap.am.max_short        = iface->send_size;
     attr->cap.am.max_bcopy        = iface->send_size;
     attr->cap.am.min_zcopy        = 0;
-    attr->cap.am.max_zcopy        = 0;
+    attr->cap.am.max_zcopy        = iface->send_size;
     attr->cap.am.opt_zcopy_align  = 1;
     attr->cap.am.align_mtu        = attr->cap.am.opt_zcopy_align;
-    attr->cap.am.max_hdr          = 0;
-    attr->cap.am.max_iov          = SIZE_MAX;
+    attr->cap.am.max_hdr          = iface->send_size;
+    attr->cap.am.max_iov          = UCT_SM_MAX_IOV;
 
     attr->latency                 = UCS_LINEAR_FUNC_ZERO;
     attr->bandwidth.dedicated     = 19360 * UCS_MBYTE;
@@ -367,6 +370,94 @@ ssize_t uct_self_ep_am_bcopy(uct_ep_h tl_ep, uint8_t id,
     return length;
 }
 
+ucs_status_t uct_self_ep_am_zcopy(uct_ep_h tl_ep, uint8_t id, const void *header,
+                                  unsigned header_length, const uct_iov_t *iov,
+                                  size_t iovcnt, unsigned flags,
+                                  uct_completion_t *comp)
+{
+    uct_self_iface_t *iface        = ucs_derived_of(tl_ep->iface,
+                                                    uct_self_iface_t);
+    uct_self_ep_t UCS_V_UNUSED *ep = ucs_derived_of(tl_ep, uct_self_ep_t);
+    ucs_status_t UCS_V_UNUSED status;
+    ucs_iov_iter_t iov_iter;
+    void *send_buffer;
+    size_t length;
+
+    UCT_CHECK_AM_ID(id);
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_SM_MAX_IOV, "uct_self_ep_am_zcopy");
+
+    length = header_length + uct_iov_total_length(iov, iovcnt);
+    UCT_CHECK_LENGTH(length, 0, iface->send_size, "am_zcopy");
+    UCT_TL_EP_STAT_OP(&ep->super, AM, ZCOPY, length);
+
+    if ((header_length == 0) && (iovcnt == 1)) {
+        /* The payload is contiguous, so pass the user buffer to the handler,
+         * which is invoked without UCT_CB_PARAM_FLAG_DESC and therefore does
+         * not keep it after returning */
+        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, id,
+                           iov->buffer, length, "TX: AM_ZCOPY");
+        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_RECV, id,
+                           iov->buffer, length, "RX: AM_ZCOPY");
+        status = uct_iface_invoke_am(&iface->super, id, iov->buffer, length, 0);
+        ucs_assert(status == UCS_OK);
+        return UCS_OK;
+    }
+
+    send_buffer = UCT_SELF_IFACE_SEND_BUFFER_GET(iface);
+    memcpy(send_buffer, header, header_length);
+    ucs_iov_iter_init(&iov_iter);
+    uct_iov_to_buffer(iov, iovcnt, &iov_iter,
+                      UCS_PTR_BYTE_OFFSET(send_buffer, header_length), SIZE_MAX);
+
+    uct_self_iface_sendrecv_am(iface, id, send_buffer, length, "ZCOPY");
+    return UCS_OK;
+}
+
+ucs_status_t uct_self_ep_put_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                   size_t iovcnt, uint64_t remote_addr,
+                                   uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_self_ep_t UCS_V_UNUSED *ep = ucs_derived_of(tl_ep, uct_self_ep_t);
+    ucs_iov_iter_t iov_iter;
+    size_t length;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_SM_MAX_IOV, "uct_self_ep_put_zcopy");
+
+    /* The target is in the same address space, so copy directly from the
+     * source buffers without staging the data */
+    ucs_iov_iter_init(&iov_iter);
+    length = uct_iov_to_buffer(iov, iovcnt, &iov_iter,
+                               (void*)(rkey + remote_addr), SIZE_MAX);
+    ucs_trace_data("PUT_ZCOPY [length %zu] to 0x%" PRIx64 "(%+ld)", length,
+                   remote_addr, rkey);
+    UCT_TL_EP_STAT_OP(&ep->super, PUT, ZCOPY, length);
+    return UCS_OK;
+}
+
+ucs_status_t uct_self_ep_get_zcopy(uct_ep_h tl_ep, const uct_iov_t *iov,
+                                   size_t iovcnt, uint64_t remote_addr,
+                                   uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_self_ep_t UCS_V_UNUSED *ep = ucs_derived_of(tl_ep, uct_self_ep_t);
+    const void *src                = (const void*)(rkey + remote_addr);
+    size_t length                  = 0;
+    size_t iov_length;
+    size_t i;
+
+    UCT_CHECK_IOV_SIZE(iovcnt, (size_t)UCT_SM_MAX_IOV, "uct_self_ep_get_zcopy");
+
+    for (i = 0; i < iovcnt; ++i) {
+        iov_length = uct_iov_get_length(&iov[i]);
+        memcpy(iov[i].buffer, UCS_PTR_BYTE_OFFSET(src, length), iov_length);
+        length    += iov_length;
+    }
+
+    ucs_trace_data("GET_ZCOPY [length %zu] from 0x%" PRIx64 "(%+ld)", length,
+                   remote_addr, rkey);
+    UCT_TL_EP_STAT_OP(&ep->super, GET, ZCOPY, length);
+    return UCS_OK;
+}
+
 static uct_iface_internal_ops_t uct_self_iface_internal_ops = {
     .iface_estimate_perf   = uct_base_iface_estimate_perf,
     .iface_vfs_refresh     = (uct_iface_vfs_refresh_func_t)ucs_empty_function,
@@ -379,10 +470,13 @@ static uct_iface_internal_ops_t uct_self_iface_internal_ops = {
 static uct_iface_ops_t uct_self_iface_ops = {
     .ep_put_short             = uct_sm_ep_put_short,
     .ep_put_bcopy             = uct_sm_ep_put_bcopy,
+    .ep_put_zcopy             = uct_self_ep_put_zcopy,
     .ep_get_bcopy             = uct_sm_ep_get_bcopy,
+    .ep_get_zcopy             = uct_self_ep_get_zcopy,
     .ep_am_short              = uct_self_ep_am_short,
     .ep_am_short_iov          = uct_self_ep_am_short_iov,
     .ep_am_bcopy              = uct_self_ep_am_bcopy,
+    .ep_am_zcopy              = uct_self_ep_am_zcopy,
     .ep_atomic_cswap64        = uct_sm_ep_atomic_cswap64,
     .ep_atomic64_post         = uct_sm_ep_atomic64_post,
     .ep_atomic64_fetch        = uct_sm_ep_atomic64_fetch,
@@ -53,10 +53,16 @@
 
 #define UCT_TCP_CONFIG_MAX_CONN_RETRIES      "MAX_CONN_RETRIES"
 
+/* Maximum number of connections that an EP can stripe PUT Zcopy over */
+#define UCT_TCP_EP_MAX_CONNS                 16
+
 /* TX and RX caps */
 #define UCT_TCP_EP_CTX_CAPS                  (UCT_TCP_EP_FLAG_CTX_TYPE_TX | \
                                               UCT_TCP_EP_FLAG_CTX_TYPE_RX)
 
+/* Buffer group ID of io_uring receive buffers */
+#define UCT_TCP_URING_RX_BGID                0
+
 /* Maximal value for connection sequence number */
 #define UCT_TCP_CM_CONN_SN_MAX               UINT64_MAX
 
@@ -111,7 +117,21 @@ enum {
     /* EP is on EP PTR map. */
     UCT_TCP_EP_FLAG_ON_PTR_MAP         = UCS_BIT(9),
     /* EP has some operations done without flush */
-    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10)
+    UCT_TCP_EP_FLAG_NEED_FLUSH         = UCS_BIT(10),
+    /* EP TX buffer is waiting to be submitted to io_uring. More AM data can
+     * be appended to the buffer until it is submitted. */
+    UCT_TCP_EP_FLAG_URING_TX_QUEUED    = UCS_BIT(11),
+    /* EP has received data from io_uring which is not consumed yet. */
+    UCT_TCP_EP_FLAG_URING_RX_READY     = UCS_BIT(12),
+    /* Kernel reported that data sent with MSG_ZEROCOPY was copied (e.g. on
+     * loopback), so MSG_ZEROCOPY is not used on a given EP anymore. */
+    UCT_TCP_EP_FLAG_MSG_ZCOPY_COPIED   = UCS_BIT(13),
+    /* Fence was requested while PUT fragments were in-flight on additional
+     * connections, TX is blocked until they are acknowledged. */
+    UCT_TCP_EP_FLAG_STRIPE_FENCE       = UCS_BIT(14),
+    /* io_uring receive could not be armed due to lack of resources, and it
+     * is retried from iface progress. */
+    UCT_TCP_EP_FLAG_URING_RX_ARM       = UCS_BIT(15)
 };
 
 
@@ -143,8 +163,10 @@ typedef enum uct_tcp_ep_conn_state {
     UCT_TCP_EP_CONN_STATE_CONNECTED
 } uct_tcp_ep_conn_state_t;
 
-/* Forward declaration */
+/* Forward declarations */
 typedef struct uct_tcp_ep uct_tcp_ep_t;
+typedef struct uct_tcp_uring uct_tcp_uring_t;
+typedef struct uct_tcp_uring_op uct_tcp_uring_op_t;
 
 typedef ucs_callback_t uct_tcp_ep_progress_t;
 
@@ -271,6 +293,23 @@ typedef struct uct_tcp_ep_ctx {
 } uct_tcp_ep_ctx_t;
 
 
+/**
+ * TCP MSG_ZEROCOPY completion. User's buffers sent with MSG_ZEROCOPY can't be
+ * released before the kernel notifies that it doesn't use them anymore.
+ */
+typedef struct uct_tcp_ep_msg_zcopy_comp {
+    ucs_queue_elem_t              elem;       /* Element in TCP EP MSG_ZEROCOPY
+                                               * completion queue */
+    uct_completion_t              *comp;      /* User's completion */
+    uint32_t                      end_sn;     /* Notification ID following the
+                                               * last MSG_ZEROCOPY send of the
+                                               * operation */
+    uint32_t                      remaining;  /* Number of sends which were not
+                                               * notified yet, +1 while the
+                                               * operation is being sent */
+} uct_tcp_ep_msg_zcopy_comp_t;
+
+
 /**
  * TCP AM/PUT Zcopy communication context mapped to
  * buffer from TCP EP context
@@ -280,6 +319,12 @@ typedef struct uct_tcp_ep_zcopy_tx {
     uct_completion_t              *comp;     /* Local UCT completion object */
     size_t                        iov_index; /* Current IOV index */
     size_t                        iov_cnt;   /* Number of IOVs that should be sent */
+    size_t                        msg_zcopy_iov; /* Index of the first payload IOV
+                                                  * if the payload should be sent
+                                                  * with MSG_ZEROCOPY, or 0 */
+    uct_tcp_ep_msg_zcopy_comp_t   *msg_zcopy; /* MSG_ZEROCOPY completion, NULL
+                                               * if nothing was sent with
+                                               * MSG_ZEROCOPY yet */
     struct iovec                  iov[0];    /* IOVs that should be sent */
 } uct_tcp_ep_zcopy_tx_t;
 
@@ -346,6 +391,42 @@ struct uct_tcp_ep {
     ucs_queue_head_t              pending_q;    /* Pending operations */
     ucs_queue_head_t              put_comp_q;   /* Flush completions waiting for
                                                  * outstanding PUTs acknowledgment */
+    struct {
+        uct_tcp_uring_op_t        *rx_op;       /* Armed multishot receive */
+        uct_tcp_uring_op_t        *tx_op;       /* Send in progress */
+        ucs_queue_head_t          rx_q;         /* Received buffers which were
+                                                 * not consumed yet */
+        ucs_status_t              rx_status;    /* Status which terminated the
+                                                 * multishot receive */
+        ucs_list_link_t           rx_elem;      /* Element in io_uring list of
+                                                 * EPs with received data */
+        ucs_list_link_t           tx_elem;      /* Element in io_uring list of
+                                                 * EPs with data to submit */
+        ucs_list_link_t           arm_elem;     /* Element in io_uring list of
+                                                 * EPs waiting to arm a receive */
+    } uring;
+    struct {
+        uint32_t                  tx_sn;        /* Notification ID of the next
+                                                 * MSG_ZEROCOPY send */
+        uint32_t                  head_sn;      /* Notification ID of the first
+                                                 * send of the completion queue */
+        ucs_queue_head_t          comp_q;       /* Completions waiting for
+                                                 * MSG_ZEROCOPY notifications */
+        ucs_list_link_t           list;         /* Element in iface list of EPs
+                                                 * waiting for notifications */
+    } msg_zcopy;
+    struct {
+        uct_tcp_ep_t              *parent;      /* EP which owns this EP as an
+                                                 * additional connection */
+        uct_tcp_ep_t              **conns;      /* Additional connections to
+                                                 * stripe PUT Zcopy over */
+        unsigned                  num_conns;    /* Size of conns array */
+        uint32_t                  fence_sn;     /* PUT sequence number which
+                                                 * acknowledges the data sent
+                                                 * before the fence */
+        int                       fence_acked;  /* Whether the PUT with
+                                                 * fence_sn was acknowledged */
+    } stripe;
     union {
         ucs_list_link_t           list;         /* List element to insert into TCP EP list */
         ucs_conn_match_elem_t     elem;         /* Connection matching element, used by EPs
@@ -374,11 +455,18 @@ typedef struct uct_tcp_iface {
     ucs_sys_event_set_t           *event_set;        /* Event set identifier */
     ucs_mpool_t                   tx_mpool;          /* TX memory pool */
     ucs_mpool_t                   rx_mpool;          /* RX memory pool */
+    uct_tcp_uring_t               *uring;            /* io_uring engine, NULL if
+                                                      * epoll and non-blocking
+                                                      * socket calls are used */
+    ucs_list_link_t               msg_zcopy_ep_list; /* EPs waiting for
+                                                      * MSG_ZEROCOPY notifications */
     size_t                        outstanding;       /* How much data in the EP send buffers
                                                       * + how many non-blocking connections
                                                       * are in progress + how many EPs are
                                                       * waiting for PUT Zcopy operation ACKs
-                                                      * (0/1 for each EP) */
+                                                      * (0/1 for each EP) + how many
+                                                      * MSG_ZEROCOPY completions are
+                                                      * not notified by the kernel */
     ucs_range_spec_t              port_range;        /** Range of ports to use for bind() */
 
     struct {
@@ -393,7 +481,14 @@ typedef struct uct_tcp_iface {
             size_t                max_hdr;           /* Maximum supported AM Zcopy header */
             size_t                hdr_offset;        /* Offset in TX buffer to empty space that
                                                       * can be used for AM Zcopy header */
+            size_t                msg_thresh;        /* Minimum Zcopy payload size to send
+                                                      * with MSG_ZEROCOPY */
         } zcopy;
+        struct {
+            unsigned              num_conns;         /* Number of connections per EP */
+            size_t                min_size;          /* Minimum size of a PUT Zcopy
+                                                      * fragment */
+        } stripe;
         struct sockaddr_storage   ifaddr;            /* Network address */
         struct sockaddr_storage   netmask;           /* Network address mask */
         size_t                    sockaddr_len;      /* Network address length */
@@ -437,6 +532,9 @@ typedef struct uct_tcp_iface_config {
     size_t                         rx_seg_size;
     size_t                         max_iov;
     size_t                         sendv_thresh;
+    size_t                         msg_zcopy_thresh;
+    unsigned                       num_conns;
+    size_t                         stripe_min_size;
     int                            prefer_default;
     int                            put_enable;
     int                            conn_nb;
@@ -454,6 +552,12 @@ typedef struct uct_tcp_iface_config {
         unsigned long              cnt;
         ucs_time_t                 intvl;
     } keepalive;
+    struct {
+        int                        enable;
+        unsigned                   entries;
+        unsigned                   rx_bufs;
+        size_t                     rx_buf_size;
+    } io_uring;
 } uct_tcp_iface_config_t;
 
 
@@ -611,6 +715,8 @@ void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
 ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
                               uct_completion_t *comp);
 
+ucs_status_t uct_tcp_ep_fence(uct_ep_h tl_ep, unsigned flags);
+
 ucs_status_t
 uct_tcp_ep_check(uct_ep_h tl_ep, unsigned flags, uct_completion_t *comp);
 
@@ -649,6 +755,36 @@ ucs_status_t uct_tcp_cm_conn_start(uct_tcp_ep_t *ep);
 
 int uct_tcp_keepalive_is_enabled(uct_tcp_iface_t *iface);
 
+unsigned uct_tcp_ep_uring_tx_completed(uct_tcp_ep_t *ep, ucs_status_t status,
+                                       size_t sent_length);
+
+unsigned uct_tcp_ep_msg_zcopy_progress(uct_tcp_ep_t *ep);
+
+void uct_tcp_ep_msg_zcopy_move(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep);
+
+ucs_status_t uct_tcp_uring_create(const uct_tcp_iface_config_t *config,
+                                  uct_tcp_uring_t **uring_p);
+
+void uct_tcp_uring_destroy(uct_tcp_uring_t *uring);
+
+int uct_tcp_uring_fd(uct_tcp_uring_t *uring);
+
+int uct_tcp_uring_is_idle(uct_tcp_uring_t *uring);
+
+unsigned uct_tcp_uring_progress(uct_tcp_iface_t *iface);
+
+ucs_status_t uct_tcp_uring_rx_arm(uct_tcp_ep_t *ep);
+
+void uct_tcp_uring_rx_disarm(uct_tcp_ep_t *ep);
+
+ucs_status_t uct_tcp_uring_recv(uct_tcp_ep_t *ep, void *buf, size_t *length_p);
+
+void uct_tcp_uring_tx_post(uct_tcp_ep_t *ep);
+
+void uct_tcp_uring_tx_detach(uct_tcp_ep_t *ep);
+
+void uct_tcp_uring_ep_move(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep);
+
 static UCS_F_ALWAYS_INLINE int uct_tcp_ep_ctx_buf_empty(uct_tcp_ep_ctx_t *ctx)
 {
     ucs_assert((ctx->length == 0) || (ctx->buf != NULL));
@@ -447,6 +447,8 @@ static unsigned
 uct_tcp_cm_simult_conn_accept_remote_conn(uct_tcp_ep_t *accept_ep,
                                           uct_tcp_ep_t *connect_ep)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(accept_ep->super.super.iface,
+                                            uct_tcp_iface_t);
     uct_tcp_cm_conn_event_t event;
     ucs_status_t status;
 
@@ -459,10 +461,15 @@ uct_tcp_cm_simult_conn_accept_remote_conn(uct_tcp_ep_t *accept_ep,
 
     ucs_close_fd(&connect_ep->fd);
     connect_ep->fd = accept_ep->fd;
+    uct_tcp_ep_msg_zcopy_move(connect_ep, accept_ep);
 
     /* 2. Migrate RX from the EP allocated during accepting connection to
      *    the found EP */
     uct_tcp_ep_move_ctx_cap(accept_ep, connect_ep, UCT_TCP_EP_FLAG_CTX_TYPE_RX);
+    if (iface->uring != NULL) {
+        /* Keep the armed receive and the received data on the socket */
+        uct_tcp_uring_ep_move(connect_ep, accept_ep);
+    }
 
     /* 3. The EP allocated during accepting connection has to be destroyed
      *    upon return from this function (set its socket `fd` to -1 prior
@@ -12,6 +12,11 @@
 
 #include <ucs/async/async.h>
 
+#ifdef UCT_TCP_MSG_ZEROCOPY
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#endif
+
 
 /* Forward declarations */
 static unsigned uct_tcp_ep_progress_data_tx(void *arg);
@@ -60,10 +65,28 @@ static inline int uct_tcp_ep_ctx_buf_need_progress(uct_tcp_ep_ctx_t *ctx)
     return ctx->offset < ctx->length;
 }
 
+static int uct_tcp_ep_stripe_is_inflight(uct_tcp_ep_t *ep)
+{
+    unsigned i;
+
+    for (i = 0; i < ep->stripe.num_conns; ++i) {
+        if ((ep->stripe.conns[i] != NULL) &&
+            (ep->stripe.conns[i]->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 static inline ucs_status_t uct_tcp_ep_check_tx_res(uct_tcp_ep_t *ep)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
     if (ucs_likely((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
-                   uct_tcp_ep_ctx_buf_empty(&ep->tx))) {
+                   uct_tcp_ep_ctx_buf_empty(&ep->tx) &&
+                   !(ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE))) {
         return UCS_OK;
     } else if (ucs_unlikely(ep->conn_state == UCT_TCP_EP_CONN_STATE_CLOSED)) {
         return UCS_ERR_CONNECTION_RESET;
@@ -79,9 +102,32 @@ static inline ucs_status_t uct_tcp_ep_check_tx_res(uct_tcp_ep_t *ep)
     ucs_assertv((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTING) ||
                 (ep->conn_state == UCT_TCP_EP_CONN_STATE_WAITING_ACK) ||
                 ((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
-                 !uct_tcp_ep_ctx_buf_empty(&ep->tx)),
+                 (!uct_tcp_ep_ctx_buf_empty(&ep->tx) ||
+                  (ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE))),
                 "ep=%p", ep);
 
+    if ((ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
+        uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
+        ucs_assert(ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE);
+        if (!uct_tcp_ep_stripe_is_inflight(ep)) {
+            /* The fence suspends only striping over additional connections
+             * until the data sent before the fence is acknowledged */
+            return UCS_OK;
+        }
+
+        /* Pending operations are dispatched when the PUT fragments sent over
+         * additional connections before the fence are acknowledged */
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    if ((iface->uring != NULL) &&
+        (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
+        !(ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX)) {
+        /* TX buffer is owned by io_uring, pending operations are dispatched
+         * upon send completion */
+        return UCS_ERR_NO_RESOURCE;
+    }
+
     uct_tcp_ep_mod_events(ep, UCS_EVENT_SET_EVWRITE, 0);
     return UCS_ERR_NO_RESOURCE;
 }
@@ -136,6 +182,14 @@ int uct_tcp_ep_is_self(const uct_tcp_ep_t *ep)
 
 static void uct_tcp_ep_cleanup(uct_tcp_ep_t *ep)
 {
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    if (iface->uring != NULL) {
+        uct_tcp_uring_tx_detach(ep);
+        uct_tcp_uring_rx_disarm(ep);
+    }
+
     if (ep->tx.buf != NULL) {
         uct_tcp_ep_ctx_reset(&ep->tx);
     }
@@ -246,6 +300,21 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_ep_t, uct_tcp_iface_t *iface, int fd,
     ucs_queue_head_init(&self->pending_q);
     ucs_queue_head_init(&self->put_comp_q);
 
+    self->uring.rx_op     = NULL;
+    self->uring.tx_op     = NULL;
+    self->uring.rx_status = UCS_OK;
+    ucs_queue_head_init(&self->uring.rx_q);
+
+    self->msg_zcopy.tx_sn   = 0;
+    self->msg_zcopy.head_sn = 0;
+    ucs_queue_head_init(&self->msg_zcopy.comp_q);
+
+    self->stripe.parent      = NULL;
+    self->stripe.conns       = NULL;
+    self->stripe.num_conns   = 0;
+    self->stripe.fence_sn    = 0;
+    self->stripe.fence_acked = 0;
+
     if (dest_addr != NULL) {
         memcpy(&self->peer_addr[0], dest_addr, iface->config.sockaddr_len);
     }
@@ -345,14 +414,251 @@ uct_tcp_ep_tx_completed(uct_tcp_ep_t *ep, size_t sent_length)
     ep->tx.offset      += sent_length;
 }
 
+static void uct_tcp_ep_msg_zcopy_comp_push(uct_tcp_ep_t *ep,
+                                           uct_tcp_ep_msg_zcopy_comp_t *msg_comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    if (ucs_queue_is_empty(&ep->msg_zcopy.comp_q)) {
+        ucs_list_add_tail(&iface->msg_zcopy_ep_list, &ep->msg_zcopy.list);
+    }
+
+    ucs_queue_push(&ep->msg_zcopy.comp_q, &msg_comp->elem);
+    uct_tcp_iface_outstanding_inc(iface);
+}
+
+static unsigned
+uct_tcp_ep_msg_zcopy_dispatch(uct_tcp_ep_t *ep, ucs_status_t status)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_msg_zcopy_comp_t *msg_comp;
+    unsigned count = 0;
+
+    /* Complete in order, so that flush completions which don't wait for any
+     * notification are invoked after all preceding operations */
+    ucs_queue_for_each_extract(msg_comp, &ep->msg_zcopy.comp_q, elem,
+                               (status != UCS_OK) ||
+                               (msg_comp->remaining == 0)) {
+        if (UCS_CIRCULAR_COMPARE32(msg_comp->end_sn, >,
+                                   ep->msg_zcopy.head_sn)) {
+            ep->msg_zcopy.head_sn = msg_comp->end_sn;
+        }
+
+        if (msg_comp->comp != NULL) {
+            uct_invoke_completion(msg_comp->comp, status);
+        }
+
+        ucs_mpool_put_inline(msg_comp);
+        uct_tcp_iface_outstanding_dec(iface);
+        ++count;
+    }
+
+    if ((count > 0) && ucs_queue_is_empty(&ep->msg_zcopy.comp_q)) {
+        ucs_list_del(&ep->msg_zcopy.list);
+    }
+
+    return count;
+}
+
+static UCS_F_MAYBE_UNUSED void
+uct_tcp_ep_msg_zcopy_notify(uct_tcp_ep_t *ep, uint32_t lo, uint32_t hi)
+{
+    uint32_t start = ep->msg_zcopy.head_sn;
+    uct_tcp_ep_msg_zcopy_comp_t *msg_comp;
+    uint32_t first, last;
+
+    /* Notifications may arrive out of order, so every operation whose sends
+     * overlap with [lo, hi] range is updated */
+    ucs_queue_for_each(msg_comp, &ep->msg_zcopy.comp_q, elem) {
+        if (UCS_CIRCULAR_COMPARE32(msg_comp->end_sn, <=, start)) {
+            /* Flush completion, no sends of its own */
+            continue;
+        }
+
+        first = UCS_CIRCULAR_COMPARE32(lo, >, start) ? lo : start;
+        last  = UCS_CIRCULAR_COMPARE32(hi + 1, <, msg_comp->end_sn) ?
+                (hi + 1) : msg_comp->end_sn;
+        if (UCS_CIRCULAR_COMPARE32(first, <, last)) {
+            ucs_assertv(msg_comp->remaining >= (last - first),
+                        "ep=%p remaining=%u notified=[%u..%u)", ep,
+                        msg_comp->remaining, first, last);
+            msg_comp->remaining -= last - first;
+        }
+
+        start = msg_comp->end_sn;
+    }
+}
+
+static ucs_status_t
+uct_tcp_ep_msg_zcopy_flush(uct_tcp_ep_t *ep, uct_completion_t *comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_ep_msg_zcopy_comp_t *msg_comp;
+
+    if (ucs_queue_is_empty(&ep->msg_zcopy.comp_q)) {
+        return UCS_OK;
+    }
+
+    if (comp == NULL) {
+        return UCS_INPROGRESS;
+    }
+
+    msg_comp = ucs_mpool_get_inline(&iface->tx_mpool);
+    if (ucs_unlikely(msg_comp == NULL)) {
+        ucs_error("tcp_ep %p: unable to allocate MSG_ZEROCOPY completion "
+                  "from mpool", ep);
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    msg_comp->comp      = comp;
+    msg_comp->end_sn    = ep->msg_zcopy.tx_sn;
+    msg_comp->remaining = 0;
+    uct_tcp_ep_msg_zcopy_comp_push(ep, msg_comp);
+    return UCS_INPROGRESS;
+}
+
+unsigned uct_tcp_ep_msg_zcopy_progress(uct_tcp_ep_t *ep)
+{
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    char cmsg_buf[CMSG_SPACE(sizeof(struct sock_extended_err))];
+    struct sock_extended_err *serr;
+    struct cmsghdr *cmsg;
+    struct msghdr msg;
+
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control    = cmsg_buf;
+        msg.msg_controllen = sizeof(cmsg_buf);
+
+        if (recvmsg(ep->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                ucs_debug("tcp_ep %p: recvmsg(fd=%d, MSG_ERRQUEUE) failed: "
+                          "%m", ep, ep->fd);
+            }
+            break;
+        }
+
+        for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (!(((cmsg->cmsg_level == SOL_IP) &&
+                   (cmsg->cmsg_type == IP_RECVERR)) ||
+                  ((cmsg->cmsg_level == SOL_IPV6) &&
+                   (cmsg->cmsg_type == IPV6_RECVERR)))) {
+                continue;
+            }
+
+            serr = (struct sock_extended_err*)CMSG_DATA(cmsg);
+            if ((serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) ||
+                (serr->ee_errno != 0)) {
+                continue;
+            }
+
+            if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                /* The kernel had to copy the data anyway, so avoid the
+                 * notification overhead for next sends */
+                ep->flags |= UCT_TCP_EP_FLAG_MSG_ZCOPY_COPIED;
+            }
+
+            uct_tcp_ep_msg_zcopy_notify(ep, serr->ee_info, serr->ee_data);
+        }
+    }
+#endif
+
+    return uct_tcp_ep_msg_zcopy_dispatch(ep, UCS_OK);
+}
+
+void uct_tcp_ep_msg_zcopy_move(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep)
+{
+    /* Notification IDs are counted per socket, and only connected EPs send
+     * with MSG_ZEROCOPY */
+    ucs_assertv(ucs_queue_is_empty(&to_ep->msg_zcopy.comp_q) &&
+                ucs_queue_is_empty(&from_ep->msg_zcopy.comp_q),
+                "to_ep=%p from_ep=%p", to_ep, from_ep);
+    to_ep->msg_zcopy.tx_sn   = from_ep->msg_zcopy.tx_sn;
+    to_ep->msg_zcopy.head_sn = from_ep->msg_zcopy.head_sn;
+}
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_tcp_ep_zcopy_sent(uct_tcp_ep_zcopy_tx_t *ctx)
+{
+    if (ctx->msg_zcopy == NULL) {
+        return UCS_OK;
+    }
+
+    /* Sent completely from the first attempt, but the kernel still uses
+     * user's buffers */
+    ucs_assert(ctx->msg_zcopy->remaining > 1);
+    ctx->msg_zcopy->comp = ctx->comp;
+    --ctx->msg_zcopy->remaining;
+    return UCS_INPROGRESS;
+}
+
 static UCS_F_ALWAYS_INLINE void
-uct_tcp_ep_zcopy_completed(uct_tcp_ep_t *ep, uct_completion_t *comp,
+uct_tcp_ep_zcopy_completed(uct_tcp_ep_t *ep, uct_tcp_ep_zcopy_tx_t *ctx,
                            ucs_status_t status)
 {
     ep->flags &= ~UCT_TCP_EP_FLAG_ZCOPY_TX;
-    if (comp != NULL) {
-        uct_invoke_completion(comp, status);
+
+    if (ctx->msg_zcopy == NULL) {
+        if (ctx->comp != NULL) {
+            uct_invoke_completion(ctx->comp, status);
+        }
+        return;
+    }
+
+    /* User's buffers may be still used by the kernel, the completion is
+     * invoked when all sends of the operation are notified */
+    ucs_assert(ctx->msg_zcopy->remaining > 0);
+    ctx->msg_zcopy->comp = ctx->comp;
+    --ctx->msg_zcopy->remaining;
+    ctx->msg_zcopy       = NULL;
+    uct_tcp_ep_msg_zcopy_dispatch(ep, status);
+}
+
+static void uct_tcp_ep_stripe_detach(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_t *parent = ep->stripe.parent;
+    unsigned i;
+
+    if (parent != NULL) {
+        for (i = 0; i < parent->stripe.num_conns; ++i) {
+            if (parent->stripe.conns[i] == ep) {
+                parent->stripe.conns[i] = NULL;
+            }
+        }
+
+        ep->stripe.parent = NULL;
+    }
+
+    for (i = 0; i < ep->stripe.num_conns; ++i) {
+        if (ep->stripe.conns[i] != NULL) {
+            ep->stripe.conns[i]->stripe.parent = NULL;
+        }
+    }
+
+    ucs_free(ep->stripe.conns);
+    ep->stripe.conns     = NULL;
+    ep->stripe.num_conns = 0;
+}
+
+static void uct_tcp_ep_stripe_destroy(uct_tcp_ep_t *ep)
+{
+    uct_tcp_ep_t *conn;
+    unsigned i;
+
+    for (i = 0; i < ep->stripe.num_conns; ++i) {
+        conn = ep->stripe.conns[i];
+        if (conn != NULL) {
+            ep->stripe.conns[i] = NULL;
+            conn->stripe.parent = NULL;
+            uct_tcp_ep_destroy(&conn->super.super);
+        }
     }
+
+    uct_tcp_ep_stripe_detach(ep);
 }
 
 static void uct_tcp_ep_purge(uct_tcp_ep_t *ep, ucs_status_t status)
@@ -365,10 +671,12 @@ static void uct_tcp_ep_purge(uct_tcp_ep_t *ep, ucs_status_t status)
 
     if (ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX) {
         ctx = (uct_tcp_ep_zcopy_tx_t*)ep->tx.buf;
-        uct_tcp_ep_zcopy_completed(ep, ctx->comp, status);
+        uct_tcp_ep_zcopy_completed(ep, ctx, status);
         uct_tcp_ep_tx_completed(ep, ep->tx.length - ep->tx.offset);
     }
 
+    uct_tcp_ep_msg_zcopy_dispatch(ep, status);
+
     ucs_queue_for_each_extract(put_comp, &ep->put_comp_q, elem, 1) {
         uct_invoke_completion(put_comp->comp, status);
         ucs_mpool_put_inline(put_comp);
@@ -393,6 +701,7 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_ep_t)
         uct_tcp_ep_ptr_map_del(self);
     }
 
+    uct_tcp_ep_stripe_detach(self);
     uct_tcp_ep_remove_ctx_cap(self, UCT_TCP_EP_CTX_CAPS);
     uct_tcp_ep_purge(self, UCS_ERR_CANCELED);
 
@@ -455,6 +764,8 @@ void uct_tcp_ep_destroy(uct_ep_h tl_ep)
                                             uct_tcp_iface_t);
     ucs_status_t status;
 
+    uct_tcp_ep_stripe_destroy(ep);
+
     if (/* EPs that are connected as CONNECT_TO_EP have to be full duplex */
         !(ep->flags & UCT_TCP_EP_FLAG_CONNECT_TO_EP) &&
         (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
@@ -505,7 +816,14 @@ void uct_tcp_ep_set_failed(uct_tcp_ep_t *ep, ucs_status_t status)
 
     uct_tcp_ep_mod_events(ep, 0, ep->events);
 
-    if (ep->flags & UCT_TCP_EP_FLAG_CTX_TYPE_TX) {
+    if (ep->stripe.parent != NULL) {
+        /* An additional connection is destroyed together with the EP which
+         * owns it, so report the error on the owner */
+        ucs_debug("tcp_ep %p: failing parent ep %p (flags: %x)", ep,
+                  ep->stripe.parent, ep->flags);
+        uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CLOSED);
+        uct_tcp_ep_set_failed(ep->stripe.parent, status);
+    } else if (ep->flags & UCT_TCP_EP_FLAG_CTX_TYPE_TX) {
         ucs_debug("tcp_ep %p: calling error handler (flags: %x)", ep,
                   ep->flags);
         uct_tcp_cm_change_conn_state(ep, UCT_TCP_EP_CONN_STATE_CLOSED);
@@ -643,9 +961,15 @@ void uct_tcp_ep_replace_ep(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep)
                                             uct_tcp_iface_t);
     int events             = from_ep->events;
 
+    if (iface->uring != NULL) {
+        /* Keep the armed receive and the received data on the socket */
+        uct_tcp_uring_ep_move(to_ep, from_ep);
+    }
+
     uct_tcp_ep_mod_events(from_ep, 0, from_ep->events);
     to_ep->fd   = from_ep->fd;
     from_ep->fd = -1;
+    uct_tcp_ep_msg_zcopy_move(to_ep, from_ep);
     uct_tcp_ep_mod_events(to_ep, events, 0);
 
     to_ep->conn_retries++;
@@ -784,6 +1108,55 @@ uint64_t uct_tcp_ep_get_cm_id(const uct_tcp_ep_t *ep)
            ep->cm_id.ptr_map_key : ep->cm_id.conn_sn;
 }
 
+static void uct_tcp_ep_stripe_create(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    unsigned num_conns     = iface->config.stripe.num_conns - 1;
+    uct_tcp_ep_t *conn;
+    ucs_status_t status;
+
+    if (num_conns == 0) {
+        return;
+    }
+
+    ep->stripe.conns = ucs_calloc(num_conns, sizeof(*ep->stripe.conns),
+                                  "tcp_ep_stripe_conns");
+    if (ep->stripe.conns == NULL) {
+        ucs_diag("tcp_ep %p: failed to allocate additional connections", ep);
+        return;
+    }
+
+    while (ep->stripe.num_conns < num_conns) {
+        status = uct_tcp_ep_init(iface, -1, (struct sockaddr*)ep->peer_addr,
+                                 &conn);
+        if (status != UCS_OK) {
+            break;
+        }
+
+        /* Additional connections use the next connection sequence numbers,
+         * so they are matched with the additional connections of the peer
+         * EP which is created to this iface */
+        conn->stripe.parent = ep;
+        uct_tcp_cm_ep_set_conn_sn(conn);
+        status = uct_tcp_ep_connect(conn);
+        if (status != UCS_OK) {
+            uct_tcp_ep_destroy_internal(&conn->super.super);
+            break;
+        }
+
+        ep->stripe.conns[ep->stripe.num_conns++] = conn;
+    }
+
+    if (ep->stripe.num_conns < num_conns) {
+        ucs_diag("tcp_ep %p: opened %u of %u additional connections", ep,
+                 ep->stripe.num_conns, num_conns);
+    } else {
+        ucs_debug("tcp_ep %p: opened %u additional connections", ep,
+                  ep->stripe.num_conns);
+    }
+}
+
 ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params, uct_ep_h *ep_p)
 {
     uct_tcp_iface_t *iface                = ucs_derived_of(params->iface,
@@ -816,6 +1189,8 @@ ucs_status_t uct_tcp_ep_create(const uct_ep_params_t *params, uct_ep_h *ep_p)
         if (status != UCS_OK) {
             return status;
         }
+
+        uct_tcp_ep_stripe_create(ep);
     }
 
     /* cppcheck-suppress autoVariables */
@@ -914,13 +1289,29 @@ void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, ucs_event_set_types_t add,
         ucs_trace("tcp_ep %p: set events to %c%c", ep,
                   (new_events & UCS_EVENT_SET_EVREAD)  ? 'r' : '-',
                   (new_events & UCS_EVENT_SET_EVWRITE) ? 'w' : '-');
+        if (iface->uring != NULL) {
+            /* Readiness to receive is driven by io_uring multishot receive,
+             * so only write events are left to the event set */
+            if (new_events & ~old_events & UCS_EVENT_SET_EVREAD) {
+                uct_tcp_uring_rx_arm(ep);
+            } else if (old_events & ~new_events & UCS_EVENT_SET_EVREAD) {
+                uct_tcp_uring_rx_disarm(ep);
+            }
+
+            old_events &= ~UCS_EVENT_SET_EVREAD;
+            new_events &= ~UCS_EVENT_SET_EVREAD;
+            if (new_events == old_events) {
+                return;
+            }
+        }
+
         if (new_events == 0) {
             status = ucs_event_set_del(iface->event_set, ep->fd);
         } else if (old_events != 0) {
-            status = ucs_event_set_mod(iface->event_set, ep->fd, ep->events,
+            status = ucs_event_set_mod(iface->event_set, ep->fd, new_events,
                                        (void*)ep);
         } else {
-            status = ucs_event_set_add(iface->event_set, ep->fd, ep->events,
+            status = ucs_event_set_add(iface->event_set, ep->fd, new_events,
                                        (void*)ep);
         }
         if (status != UCS_OK) {
@@ -930,12 +1321,31 @@ void uct_tcp_ep_mod_events(uct_tcp_ep_t *ep, ucs_event_set_types_t add,
     }
 }
 
+static void uct_tcp_ep_stripe_fence_progress(uct_tcp_ep_t *ep)
+{
+    if (!(ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE) ||
+        uct_tcp_ep_stripe_is_inflight(ep)) {
+        return;
+    }
+
+    if (ep->stripe.fence_acked) {
+        ep->flags &= ~UCT_TCP_EP_FLAG_STRIPE_FENCE;
+    }
+
+    if (!ucs_queue_is_empty(&ep->pending_q) &&
+        (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
+        uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
+        uct_tcp_ep_pending_queue_dispatch(ep);
+    }
+}
+
 static inline void uct_tcp_ep_handle_put_ack(uct_tcp_ep_t *ep,
                                              uct_tcp_ep_put_ack_hdr_t *put_ack)
 {
     uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
                                             uct_tcp_iface_t);
     uct_tcp_ep_put_completion_t *put_comp;
+    ucs_status_t status;
 
     if (put_ack->sn == ep->tx.put_sn) {
         /* Since there are no other PUT operations in-flight, can remove flag
@@ -948,9 +1358,25 @@ static inline void uct_tcp_ep_handle_put_ack(uct_tcp_ep_t *ep,
     ucs_queue_for_each_extract(put_comp, &ep->put_comp_q, elem,
                                (UCS_CIRCULAR_COMPARE32(put_comp->wait_put_sn,
                                                        <=, put_ack->sn))) {
-        uct_invoke_completion(put_comp->comp, UCS_OK);
+        /* The peer received the data, but the kernel may still use user's
+         * buffers sent with MSG_ZEROCOPY */
+        status = uct_tcp_ep_msg_zcopy_flush(ep, put_comp->comp);
+        if (status != UCS_INPROGRESS) {
+            uct_invoke_completion(put_comp->comp, status);
+        }
+
         ucs_mpool_put_inline(put_comp);
     }
+
+    if (ep->stripe.parent != NULL) {
+        uct_tcp_ep_stripe_fence_progress(ep->stripe.parent);
+    } else if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE)) {
+        if (UCS_CIRCULAR_COMPARE32(put_ack->sn, >=, ep->stripe.fence_sn)) {
+            ep->stripe.fence_acked = 1;
+        }
+
+        uct_tcp_ep_stripe_fence_progress(ep);
+    }
 }
 
 void uct_tcp_ep_pending_queue_dispatch(uct_tcp_ep_t *ep)
@@ -960,7 +1386,8 @@ void uct_tcp_ep_pending_queue_dispatch(uct_tcp_ep_t *ep)
     uct_pending_queue_dispatch(priv, &ep->pending_q,
                                uct_tcp_ep_ctx_buf_empty(&ep->tx));
     if (uct_tcp_ep_ctx_buf_empty(&ep->tx)) {
-        ucs_assert(ucs_queue_is_empty(&ep->pending_q));
+        ucs_assert(ucs_queue_is_empty(&ep->pending_q) ||
+                   (ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE));
         uct_tcp_ep_mod_events(ep, 0, UCS_EVENT_SET_EVWRITE);
     }
 }
@@ -988,6 +1415,9 @@ static void uct_tcp_ep_handle_disconnected(uct_tcp_ep_t *ep, ucs_status_t status
         }
 
         uct_tcp_ep_tx_completed(ep, ep->tx.length - ep->tx.offset);
+        if (iface->uring != NULL) {
+            uct_tcp_uring_tx_detach(ep);
+        }
     }
 
     uct_tcp_ep_set_failed(ep, UCS_ERR_CONNECTION_RESET);
@@ -1046,6 +1476,99 @@ static inline ssize_t uct_tcp_ep_send(uct_tcp_ep_t *ep)
     return sent_length;
 }
 
+#ifdef UCT_TCP_MSG_ZEROCOPY
+static ucs_status_t
+uct_tcp_ep_msg_zcopy_sendv(uct_tcp_ep_t *ep, uct_tcp_ep_zcopy_tx_t *ctx,
+                           size_t iov_index, size_t *length_p)
+{
+    uct_tcp_iface_t *iface                = ucs_derived_of(ep->super.super.iface,
+                                                           uct_tcp_iface_t);
+    uct_tcp_ep_msg_zcopy_comp_t *msg_comp = ctx->msg_zcopy;
+    size_t hdr_length                     = 0;
+    size_t length                         = 0;
+    size_t hdr_iov_cnt;
+    ucs_status_t status;
+
+    if (iov_index < ctx->msg_zcopy_iov) {
+        /* Headers are located in the TX buffer or on the stack and may be
+         * reused before the kernel releases them, so they are copied */
+        hdr_iov_cnt = ctx->msg_zcopy_iov - iov_index;
+        status      = ucs_socket_sendv_nb(ep->fd, &ctx->iov[iov_index],
+                                          hdr_iov_cnt, &hdr_length);
+        if ((status != UCS_OK) ||
+            (hdr_length < ucs_iovec_total_length(&ctx->iov[iov_index],
+                                                 hdr_iov_cnt))) {
+            *length_p = hdr_length;
+            return status;
+        }
+
+        iov_index = ctx->msg_zcopy_iov;
+    }
+
+    if (msg_comp == NULL) {
+        msg_comp = ucs_mpool_get_inline(&iface->tx_mpool);
+    }
+
+    if (ucs_unlikely(msg_comp == NULL)) {
+        status = UCS_ERR_NO_RESOURCE;
+    } else {
+        status = ucs_socket_sendmsg_nb(ep->fd, &ctx->iov[iov_index],
+                                       ctx->iov_cnt - iov_index, MSG_ZEROCOPY,
+                                       &length);
+        if ((status == UCS_ERR_IO_ERROR) && (errno == ENOBUFS)) {
+            /* Socket memory is exhausted by outstanding notifications */
+            status = UCS_ERR_NO_RESOURCE;
+        }
+
+        if (length > 0) {
+            /* Every sendmsg() which sent some data with MSG_ZEROCOPY gets
+             * the next notification ID of the socket */
+            ++ep->msg_zcopy.tx_sn;
+            if (ctx->msg_zcopy == NULL) {
+                /* +1 is released when the operation is sent completely */
+                msg_comp->comp      = NULL;
+                msg_comp->remaining = 1;
+                ctx->msg_zcopy      = msg_comp;
+                uct_tcp_ep_msg_zcopy_comp_push(ep, msg_comp);
+            }
+
+            ++msg_comp->remaining;
+            msg_comp->end_sn = ep->msg_zcopy.tx_sn;
+        } else if (ctx->msg_zcopy == NULL) {
+            ucs_mpool_put_inline(msg_comp);
+        }
+    }
+
+    if (status == UCS_ERR_NO_RESOURCE) {
+        /* Too many notifications are outstanding, or no memory to track
+         * them - fall back to copying the payload */
+        status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[iov_index],
+                                     ctx->iov_cnt - iov_index, &length);
+    }
+
+    *length_p = hdr_length + length;
+    if ((hdr_length > 0) && (status == UCS_ERR_NO_PROGRESS)) {
+        return UCS_OK;
+    }
+
+    return status;
+}
+#endif /* UCT_TCP_MSG_ZEROCOPY */
+
+static UCS_F_ALWAYS_INLINE ucs_status_t
+uct_tcp_ep_zcopy_sendv(uct_tcp_ep_t *ep, uct_tcp_ep_zcopy_tx_t *ctx,
+                       size_t iov_index, size_t *length_p)
+{
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    if (ctx->msg_zcopy_iov != 0) {
+        return uct_tcp_ep_msg_zcopy_sendv(ep, ctx, iov_index, length_p);
+    }
+#endif
+
+    return ucs_socket_sendv_nb(ep->fd, &ctx->iov[iov_index],
+                               ctx->iov_cnt - iov_index, length_p);
+}
+
 static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
 {
     uct_tcp_ep_zcopy_tx_t *ctx = (uct_tcp_ep_zcopy_tx_t*)ep->tx.buf;
@@ -1055,8 +1578,7 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
     ucs_assertv((ep->tx.offset < ep->tx.length) &&
                 (ctx->iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, &ctx->iov[ctx->iov_index],
-                                 ctx->iov_cnt - ctx->iov_index, &sent_length);
+    status = uct_tcp_ep_zcopy_sendv(ep, ctx, ctx->iov_index, &sent_length);
     if (ucs_unlikely(status != UCS_OK)) {
         if (status == UCS_ERR_NO_PROGRESS) {
             ucs_assert(sent_length == 0);
@@ -1064,7 +1586,7 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
         }
 
         status = uct_tcp_ep_handle_send_err(ep, status);
-        uct_tcp_ep_zcopy_completed(ep, ctx->comp, status);
+        uct_tcp_ep_zcopy_completed(ep, ctx, status);
         return status;
     }
 
@@ -1074,7 +1596,7 @@ static inline ssize_t uct_tcp_ep_sendv(uct_tcp_ep_t *ep)
         ucs_iov_advance(ctx->iov, ctx->iov_cnt,
                         &ctx->iov_index, sent_length);
     } else {
-        uct_tcp_ep_zcopy_completed(ep, ctx->comp, UCS_OK);
+        uct_tcp_ep_zcopy_completed(ep, ctx, UCS_OK);
     }
 
     ucs_assert(sent_length <= SSIZE_MAX);
@@ -1200,6 +1722,19 @@ static inline void uct_tcp_ep_handle_recv_err(uct_tcp_ep_t *ep,
     }
 }
 
+static inline ucs_status_t
+uct_tcp_ep_recv_nb(uct_tcp_ep_t *ep, void *data, size_t *length_p)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+
+    if (iface->uring != NULL) {
+        return uct_tcp_uring_recv(ep, data, length_p);
+    }
+
+    return ucs_socket_recv_nb(ep->fd, data, length_p);
+}
+
 static inline unsigned uct_tcp_ep_recv(uct_tcp_ep_t *ep, size_t recv_length)
 {
     uct_tcp_iface_t UCS_V_UNUSED *iface = ucs_derived_of(ep->super.super.iface,
@@ -1210,8 +1745,8 @@ static inline unsigned uct_tcp_ep_recv(uct_tcp_ep_t *ep, size_t recv_length)
         return 1;
     }
 
-    status = ucs_socket_recv_nb(ep->fd, UCS_PTR_BYTE_OFFSET(ep->rx.buf,
-                                                            ep->rx.length),
+    status = uct_tcp_ep_recv_nb(ep, UCS_PTR_BYTE_OFFSET(ep->rx.buf,
+                                                        ep->rx.length),
                                 &recv_length);
     if (ucs_unlikely(status != UCS_OK)) {
         uct_tcp_ep_handle_recv_err(ep, status);
@@ -1242,12 +1777,22 @@ static void uct_tcp_ep_post_put_ack(uct_tcp_ep_t *ep);
 
 static unsigned uct_tcp_ep_progress_data_tx(void *arg)
 {
-    uct_tcp_ep_t *ep = (uct_tcp_ep_t*)arg;
-    unsigned ret     = 0;
+    uct_tcp_ep_t *ep       = (uct_tcp_ep_t*)arg;
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    unsigned ret           = 0;
     ssize_t offset;
 
     ucs_trace_func("ep=%p", ep);
 
+    if ((iface->uring != NULL) && !uct_tcp_ep_ctx_buf_empty(&ep->tx) &&
+        !(ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX)) {
+        /* Copied data is sent by io_uring, and the pending operations are
+         * dispatched upon its completion */
+        uct_tcp_ep_mod_events(ep, 0, UCS_EVENT_SET_EVWRITE);
+        return 0;
+    }
+
     if (uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
         offset = (!(ep->flags & UCT_TCP_EP_FLAG_ZCOPY_TX) ?
                   uct_tcp_ep_send(ep) : uct_tcp_ep_sendv(ep));
@@ -1280,6 +1825,43 @@ static unsigned uct_tcp_ep_progress_data_tx(void *arg)
     return ret;
 }
 
+unsigned uct_tcp_ep_uring_tx_completed(uct_tcp_ep_t *ep, ucs_status_t status,
+                                       size_t sent_length)
+{
+    if (ucs_unlikely(status != UCS_OK)) {
+        if (status == UCS_ERR_NO_PROGRESS) {
+            uct_tcp_uring_tx_post(ep);
+            return 0;
+        }
+
+        uct_tcp_ep_handle_send_err(ep, status);
+        return 1;
+    }
+
+    uct_tcp_ep_tx_completed(ep, sent_length);
+
+    ucs_trace_data("ep %p fd %d sent %zu/%zu bytes by io_uring", ep, ep->fd,
+                   ep->tx.offset, ep->tx.length);
+
+    if (uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
+        /* Submit the rest of the data */
+        uct_tcp_uring_tx_post(ep);
+        return sent_length > 0;
+    }
+
+    uct_tcp_ep_ctx_reset(&ep->tx);
+
+    if (ep->flags & UCT_TCP_EP_FLAG_PUT_RX_SENDING_ACK) {
+        uct_tcp_ep_post_put_ack(ep);
+    }
+
+    if (!ucs_queue_is_empty(&ep->pending_q)) {
+        uct_tcp_ep_pending_queue_dispatch(ep);
+    }
+
+    return 1;
+}
+
 static inline void
 uct_tcp_ep_comp_recv_am(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                         uct_tcp_am_hdr_t *hdr)
@@ -1467,12 +2049,29 @@ out:
     return handled;
 }
 
+static UCS_F_ALWAYS_INLINE int
+uct_tcp_ep_uring_tx_can_append(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep)
+{
+    /* Until the TX buffer is submitted to io_uring, a message can be appended
+     * to it if there is a room for a message of maximal size, and there are
+     * no pending operations which have to be sent before */
+    return (ep->flags & UCT_TCP_EP_FLAG_URING_TX_QUEUED) &&
+           (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
+           (ep->tx.length <= iface->config.tx_seg_size) &&
+           ucs_queue_is_empty(&ep->pending_q);
+}
+
 static inline ucs_status_t
 uct_tcp_ep_am_prepare(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
                       uint8_t am_id, uct_tcp_am_hdr_t **hdr)
 {
     ucs_status_t status;
 
+    if (uct_tcp_ep_uring_tx_can_append(iface, ep)) {
+        *hdr = UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.length);
+        goto out;
+    }
+
     status = uct_tcp_ep_check_tx_res(ep);
     if (ucs_unlikely(status != UCS_OK)) {
         if (ucs_likely(status == UCS_ERR_NO_RESOURCE)) {
@@ -1487,7 +2086,9 @@ uct_tcp_ep_am_prepare(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
         goto err_no_res;
     }
 
-    *hdr          = ep->tx.buf;
+    *hdr = ep->tx.buf;
+
+out:
     (*hdr)->am_id = am_id;
     ep->flags    |= UCT_TCP_EP_FLAG_NEED_FLUSH;
 
@@ -1506,7 +2107,7 @@ static unsigned uct_tcp_ep_progress_put_rx(uct_tcp_ep_t *ep)
 
     put_req     = (uct_tcp_ep_put_req_hdr_t*)ep->rx.buf;
     recv_length = put_req->length;
-    status      = ucs_socket_recv_nb(ep->fd, (void*)(uintptr_t)put_req->addr,
+    status      = uct_tcp_ep_recv_nb(ep, (void*)(uintptr_t)put_req->addr,
                                      &recv_length);
     if (ucs_unlikely(status != UCS_OK)) {
         uct_tcp_ep_handle_recv_err(ep, status);
@@ -1613,10 +2214,26 @@ uct_tcp_ep_set_outstanding_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep,
 static inline ucs_status_t
 uct_tcp_ep_am_send(uct_tcp_ep_t *ep, const uct_tcp_am_hdr_t *hdr)
 {
-    uct_tcp_iface_t UCS_V_UNUSED *iface = ucs_derived_of(ep->super.super.iface,
-                                                         uct_tcp_iface_t);
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t length;
     ssize_t offset;
 
+    if (iface->uring != NULL) {
+        /* The message is appended to the TX buffer, which is submitted to
+         * io_uring together with the data of other EPs from iface progress */
+        length              = sizeof(*hdr) + hdr->length;
+        ep->tx.length      += length;
+        iface->outstanding += length;
+        uct_tcp_uring_tx_post(ep);
+
+        uct_iface_trace_am(&iface->super, UCT_AM_TRACE_TYPE_SEND, hdr->am_id,
+                           hdr + 1, hdr->length, "SEND: ep %p fd %d posted "
+                           "%zu bytes, total %zu bytes", ep, ep->fd, length,
+                           ep->tx.length - ep->tx.offset);
+        return UCS_OK;
+    }
+
     uct_tcp_ep_tx_started(ep, hdr);
 
     offset = uct_tcp_ep_send(ep);
@@ -1666,7 +2283,17 @@ uct_tcp_ep_am_sendv(uct_tcp_ep_t *ep, int short_sendv, uct_tcp_am_hdr_t *hdr,
     ucs_assertv((ep->tx.length <= send_limit) &&
                 (iov_cnt > 0), "ep=%p", ep);
 
-    status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &sent_length);
+    if (short_sendv) {
+        status = ucs_socket_sendv_nb(ep->fd, iov, iov_cnt, &sent_length);
+    } else {
+        /* Zcopy operations send IOVs of the context located in TX buffer */
+        ucs_assert(iov == ucs_derived_of(hdr, uct_tcp_ep_zcopy_tx_t)->iov);
+        status = uct_tcp_ep_zcopy_sendv(ep,
+                                        ucs_derived_of(hdr,
+                                                       uct_tcp_ep_zcopy_tx_t),
+                                        0, &sent_length);
+    }
+
     if (ucs_unlikely((status != UCS_OK) && (status != UCS_ERR_NO_PROGRESS))) {
         return uct_tcp_ep_handle_send_err(ep, status);
     }
@@ -1691,9 +2318,16 @@ uct_tcp_ep_am_sendv(uct_tcp_ep_t *ep, int short_sendv, uct_tcp_am_hdr_t *hdr,
                        ((iov_cnt > 2) ? iov[2].iov_base : NULL),
                        ((iov_cnt > 2) ? iov[2].iov_len  : 0));
 
+    if (!short_sendv && !uct_tcp_ep_ctx_buf_need_progress(&ep->tx)) {
+        status = uct_tcp_ep_zcopy_sent(ucs_derived_of(hdr,
+                                                      uct_tcp_ep_zcopy_tx_t));
+    } else {
+        status = UCS_OK;
+    }
+
     uct_tcp_ep_check_tx_completion(ep);
 
-    return UCS_OK;
+    return status;
 }
 
 static void uct_tcp_ep_post_put_ack(uct_tcp_ep_t *ep)
@@ -1841,8 +2475,14 @@ ucs_status_t uct_tcp_ep_am_short_iov(uct_ep_h uct_ep, uint8_t am_id,
     hdr->length     = payload_length = uct_iov_to_iovec(&iov[1], &uct_iov_cnt,
                                                         uct_iov, uct_iov_cnt,
                                                         SIZE_MAX, &uct_iov_iter);
-    status          = uct_tcp_ep_am_short_sendv(ep, iface, hdr, 0, iov,
-                                                uct_iov_cnt + 1);
+    if (iface->uring != NULL) {
+        ucs_iov_copy(&iov[1], uct_iov_cnt, 0, hdr + 1, hdr->length,
+                     UCS_IOV_COPY_TO_BUF);
+        status = uct_tcp_ep_am_send(ep, hdr);
+    } else {
+        status = uct_tcp_ep_am_short_sendv(ep, iface, hdr, 0, iov,
+                                           uct_iov_cnt + 1);
+    }
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
@@ -1888,18 +2528,25 @@ ssize_t uct_tcp_ep_am_bcopy(uct_ep_h uct_ep, uint8_t am_id,
 static inline ucs_status_t
 uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id,
                          const void *header, unsigned header_length,
-                         const uct_iov_t *iov, size_t iovcnt, const char *name,
-                         size_t *zcopy_payload_p, uct_tcp_ep_zcopy_tx_t **ctx_p)
+                         const uct_iov_t *iov, size_t iovcnt,
+                         ucs_iov_iter_t *uct_iov_iter, size_t max_length,
+                         const char *name, size_t *zcopy_payload_p,
+                         uct_tcp_ep_zcopy_tx_t **ctx_p)
 {
     uct_tcp_am_hdr_t *hdr = NULL;
     size_t io_vec_cnt;
-    ucs_iov_iter_t uct_iov_iter;
     uct_tcp_ep_zcopy_tx_t *ctx;
     ucs_status_t status;
 
     UCT_CHECK_IOV_SIZE(iovcnt, iface->config.max_iov, name);
     UCT_CHECK_LENGTH(header_length, 0, iface->config.zcopy.max_hdr, name);
 
+    if (ucs_unlikely(ep->flags & UCT_TCP_EP_FLAG_URING_TX_QUEUED)) {
+        /* Zcopy data can't be appended to the copied data */
+        UCS_STATS_UPDATE_COUNTER(ep->super.stats, UCT_EP_STAT_NO_RES, 1);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
     status = uct_tcp_ep_am_prepare(iface, ep, am_id, &hdr);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
@@ -1924,12 +2571,17 @@ uct_tcp_ep_prepare_zcopy(uct_tcp_iface_t *iface, uct_tcp_ep_t *ep, uint8_t am_id
     }
 
     /* User-defined payload */
-    ucs_iov_iter_init(&uct_iov_iter);
     io_vec_cnt       = iovcnt;
     *zcopy_payload_p = uct_iov_to_iovec(&ctx->iov[ctx->iov_cnt], &io_vec_cnt,
-                                        iov, iovcnt, SIZE_MAX, &uct_iov_iter);
+                                        iov, iovcnt, max_length, uct_iov_iter);
     *ctx_p           = ctx;
-    ctx->iov_cnt    += io_vec_cnt;
+
+    ctx->comp          = NULL;
+    ctx->msg_zcopy     = NULL;
+    ctx->msg_zcopy_iov = ((*zcopy_payload_p >= iface->config.zcopy.msg_thresh) &&
+                          !(ep->flags & UCT_TCP_EP_FLAG_MSG_ZCOPY_COPIED)) ?
+                         ctx->iov_cnt : 0;
+    ctx->iov_cnt      += io_vec_cnt;
 
     return UCS_OK;
 }
@@ -1943,6 +2595,7 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
     uct_tcp_iface_t *iface     = ucs_derived_of(uct_ep->iface, uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx = NULL;
     size_t payload_length      = 0;
+    ucs_iov_iter_t iov_iter;
     ucs_status_t status;
 
     UCT_CHECK_LENGTH(header_length + uct_iov_total_length(iov, iovcnt), 0,
@@ -1950,18 +2603,20 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
                      "am_zcopy");
     UCT_CHECK_AM_ID(am_id);
 
+    ucs_iov_iter_init(&iov_iter);
     status = uct_tcp_ep_prepare_zcopy(iface, ep, am_id, header, header_length,
-                                      iov, iovcnt, "am_zcopy", &payload_length,
-                                      &ctx);
+                                      iov, iovcnt, &iov_iter, SIZE_MAX,
+                                      "am_zcopy", &payload_length, &ctx);
     if (ucs_unlikely(status != UCS_OK)) {
         return status;
     }
 
     ctx->super.length = payload_length + header_length;
+    ctx->comp         = comp;
 
     status = uct_tcp_ep_am_sendv(ep, 0, &ctx->super, iface->config.rx_seg_size,
                                  header, ctx->iov, ctx->iov_cnt);
-    if (ucs_unlikely(status != UCS_OK)) {
+    if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
         return status;
     }
 
@@ -1973,7 +2628,8 @@ ucs_status_t uct_tcp_ep_am_zcopy(uct_ep_h uct_ep, uint8_t am_id, const void *hea
         return UCS_INPROGRESS;
     }
 
-    return UCS_OK;
+    /* UCS_INPROGRESS if the kernel still uses user's buffers */
+    return status;
 }
 
 static UCS_F_ALWAYS_INLINE ucs_status_t
@@ -2001,24 +2657,22 @@ uct_tcp_ep_put_comp_add(uct_tcp_ep_t *ep, uct_completion_t *comp, int wait_sn)
     return UCS_OK;
 }
 
-ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
-                                  size_t iovcnt, uint64_t remote_addr,
-                                  uct_rkey_t rkey, uct_completion_t *comp)
+static ucs_status_t
+uct_tcp_ep_put_zcopy_common(uct_tcp_ep_t *ep, const uct_iov_t *iov,
+                            size_t iovcnt, ucs_iov_iter_t *iov_iter,
+                            size_t max_length, uint64_t remote_addr,
+                            uct_completion_t *comp)
 {
-    uct_tcp_ep_t *ep                 = ucs_derived_of(uct_ep, uct_tcp_ep_t);
-    uct_tcp_iface_t *iface           = ucs_derived_of(uct_ep->iface,
+    uct_tcp_iface_t *iface           = ucs_derived_of(ep->super.super.iface,
                                                       uct_tcp_iface_t);
     uct_tcp_ep_zcopy_tx_t *ctx       = NULL;
     uct_tcp_ep_put_req_hdr_t put_req = {0}; /* Suppress Cppcheck false-positive */
     ucs_status_t status;
 
-    UCT_CHECK_LENGTH(sizeof(put_req) + uct_iov_total_length(iov, iovcnt), 0,
-                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
-                     "put_zcopy");
-
     status = uct_tcp_ep_prepare_zcopy(iface, ep, UCT_TCP_EP_PUT_REQ_AM_ID,
                                       &put_req, sizeof(put_req),
-                                      iov, iovcnt, "put_zcopy",
+                                      iov, iovcnt, iov_iter, max_length,
+                                      "put_zcopy",
                                       /* Set a payload length directly to the
                                        * TX length, since PUT Zcopy doesn't
                                        * set the payload length to TCP AM hdr */
@@ -2034,7 +2688,7 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
 
     status = uct_tcp_ep_am_sendv(ep, 0, &ctx->super, UCT_TCP_EP_PUT_ZCOPY_MAX,
                                  &put_req, ctx->iov, ctx->iov_cnt);
-    if (ucs_unlikely(status != UCS_OK)) {
+    if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
         return status;
     }
 
@@ -2065,6 +2719,111 @@ ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
     return UCS_INPROGRESS;
 }
 
+static UCS_F_ALWAYS_INLINE int uct_tcp_ep_stripe_conn_is_ready(uct_tcp_ep_t *ep)
+{
+    return (ep->conn_state == UCT_TCP_EP_CONN_STATE_CONNECTED) &&
+           uct_tcp_ep_ctx_buf_empty(&ep->tx) &&
+           !(ep->flags & (UCT_TCP_EP_FLAG_URING_TX_QUEUED |
+                          UCT_TCP_EP_FLAG_STRIPE_FENCE));
+}
+
+static ucs_status_t
+uct_tcp_ep_put_zcopy_stripe(uct_tcp_ep_t *ep, const uct_iov_t *iov,
+                            size_t iovcnt, uint64_t remote_addr,
+                            uct_completion_t *comp)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    size_t length          = uct_iov_total_length(iov, iovcnt);
+    uct_tcp_ep_t *conns[UCT_TCP_EP_MAX_CONNS];
+    ucs_iov_iter_t iov_iter;
+    unsigned i, num_conns, max_conns;
+    size_t frag_length;
+    ucs_status_t status;
+
+    ucs_iov_iter_init(&iov_iter);
+
+    max_conns = ucs_min(length / iface->config.stripe.min_size,
+                        ep->stripe.num_conns + 1);
+    num_conns = 0;
+    if ((max_conns > 1) && uct_tcp_ep_stripe_conn_is_ready(ep)) {
+        /* Use the EP itself and additional connections which are able to
+         * send right now, so the operation never waits for a busy
+         * connection */
+        conns[num_conns++] = ep;
+        for (i = 0; (i < ep->stripe.num_conns) && (num_conns < max_conns);
+             ++i) {
+            if ((ep->stripe.conns[i] != NULL) &&
+                uct_tcp_ep_stripe_conn_is_ready(ep->stripe.conns[i])) {
+                conns[num_conns++] = ep->stripe.conns[i];
+            }
+        }
+    }
+
+    if (num_conns <= 1) {
+        return uct_tcp_ep_put_zcopy_common(ep, iov, iovcnt, &iov_iter,
+                                           SIZE_MAX, remote_addr, comp);
+    }
+
+    frag_length = ucs_align_up(ucs_div_round_up(length, num_conns),
+                               UCS_SYS_CACHE_LINE_SIZE);
+    num_conns   = ucs_div_round_up(length, frag_length);
+    if (comp != NULL) {
+        /* The completion is invoked when all fragments are acknowledged */
+        comp->count += num_conns - 1;
+    }
+
+    for (i = 0; i < num_conns; ++i) {
+        status = uct_tcp_ep_put_zcopy_common(conns[i], iov, iovcnt, &iov_iter,
+                                             frag_length,
+                                             remote_addr + (i * frag_length),
+                                             comp);
+        if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
+            goto err;
+        }
+    }
+
+    return UCS_INPROGRESS;
+
+err:
+    ucs_debug("tcp_ep %p: failed to send PUT fragment %u/%u: %s", ep, i,
+              num_conns, ucs_status_string(status));
+    if (comp == NULL) {
+        return status;
+    }
+
+    if (i == 0) {
+        comp->count -= num_conns - 1;
+        return status;
+    }
+
+    /* Report the error when the fragments which were sent are acknowledged */
+    comp->count -= num_conns - i;
+    uct_completion_update_status(comp, status);
+    return UCS_INPROGRESS;
+}
+
+ucs_status_t uct_tcp_ep_put_zcopy(uct_ep_h uct_ep, const uct_iov_t *iov,
+                                  size_t iovcnt, uint64_t remote_addr,
+                                  uct_rkey_t rkey, uct_completion_t *comp)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(uct_ep, uct_tcp_ep_t);
+    ucs_iov_iter_t iov_iter;
+
+    UCT_CHECK_LENGTH(sizeof(uct_tcp_ep_put_req_hdr_t) +
+                     uct_iov_total_length(iov, iovcnt), 0,
+                     UCT_TCP_EP_PUT_ZCOPY_MAX - sizeof(uct_tcp_am_hdr_t),
+                     "put_zcopy");
+
+    if (ucs_unlikely(ep->stripe.num_conns != 0)) {
+        return uct_tcp_ep_put_zcopy_stripe(ep, iov, iovcnt, remote_addr, comp);
+    }
+
+    ucs_iov_iter_init(&iov_iter);
+    return uct_tcp_ep_put_zcopy_common(ep, iov, iovcnt, &iov_iter, SIZE_MAX,
+                                       remote_addr, comp);
+}
+
 ucs_status_t uct_tcp_ep_pending_add(uct_ep_h tl_ep, uct_pending_req_t *req,
                                     unsigned flags)
 {
@@ -2106,14 +2865,75 @@ void uct_tcp_ep_pending_purge(uct_ep_h tl_ep, uct_pending_purge_callback_t cb,
                             uct_tcp_ep_pending_purge_cb, &purge_arg);
 }
 
+static ucs_status_t
+uct_tcp_ep_stripe_conn_flush(uct_tcp_ep_t *ep, uct_completion_t *comp)
+{
+    ucs_status_t status;
+
+    /* Additional connections send only PUT fragments which are
+     * acknowledged by the peer, so there is nothing to send for flush */
+    if (ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK) {
+        status = uct_tcp_ep_put_comp_add(ep, comp, ep->tx.put_sn);
+        return (status == UCS_OK) ? UCS_INPROGRESS : status;
+    }
+
+    return uct_tcp_ep_msg_zcopy_flush(ep, comp);
+}
+
+static ucs_status_t
+uct_tcp_ep_stripe_flush(uct_tcp_ep_t *ep, ucs_status_t status,
+                        uct_completion_t *comp)
+{
+    unsigned num_inprogress = (status == UCS_INPROGRESS);
+    uct_tcp_ep_t *conn;
+    unsigned i;
+
+    for (i = 0; i < ep->stripe.num_conns; ++i) {
+        conn = ep->stripe.conns[i];
+        if (conn == NULL) {
+            continue;
+        }
+
+        status = uct_tcp_ep_stripe_conn_flush(conn, comp);
+        if (status == UCS_INPROGRESS) {
+            ++num_inprogress;
+        } else if (ucs_unlikely(status != UCS_OK)) {
+            if (num_inprogress == 0) {
+                return status;
+            }
+
+            uct_completion_update_status(comp, status);
+            break;
+        }
+    }
+
+    if (num_inprogress == 0) {
+        return UCS_OK;
+    }
+
+    if (comp != NULL) {
+        /* Completions are never invoked from flush, so the count can be
+         * adjusted after adding it to all connections */
+        comp->count += num_inprogress - 1;
+    }
+
+    return UCS_INPROGRESS;
+}
+
 ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
                               uct_completion_t *comp)
 {
     uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
     ucs_status_t status;
+    unsigned i;
 
     if (ucs_unlikely(flags & UCT_FLUSH_FLAG_CANCEL)) {
         uct_tcp_ep_purge(ep, UCS_ERR_CANCELED);
+        for (i = 0; i < ep->stripe.num_conns; ++i) {
+            if (ep->stripe.conns[i] != NULL) {
+                uct_tcp_ep_purge(ep->stripe.conns[i], UCS_ERR_CANCELED);
+            }
+        }
         return UCS_OK;
     }
 
@@ -2136,16 +2956,67 @@ ucs_status_t uct_tcp_ep_flush(uct_ep_h tl_ep, unsigned flags,
 
     if (ep->flags & UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK) {
         status = uct_tcp_ep_put_comp_add(ep, comp, ep->tx.put_sn);
-        if (status != UCS_OK) {
-            return status;
+        if (status == UCS_OK) {
+            status = UCS_INPROGRESS;
         }
+    } else {
+        status = uct_tcp_ep_msg_zcopy_flush(ep, comp);
+    }
+
+    if (ucs_unlikely(ep->stripe.num_conns != 0) &&
+        !UCS_STATUS_IS_ERR(status)) {
+        status = uct_tcp_ep_stripe_flush(ep, status, comp);
+    }
 
+    if (status == UCS_INPROGRESS) {
         UCT_TL_EP_STAT_FLUSH_WAIT(&ep->super);
-        return UCS_INPROGRESS;
+    } else if (status == UCS_OK) {
+        UCT_TL_EP_STAT_FLUSH(&ep->super);
     }
 
-    UCT_TL_EP_STAT_FLUSH(&ep->super);
-    return UCS_OK;
+    return status;
+}
+
+ucs_status_t uct_tcp_ep_fence(uct_ep_h tl_ep, unsigned flags)
+{
+    uct_tcp_ep_t *ep = ucs_derived_of(tl_ep, uct_tcp_ep_t);
+    ucs_status_t status;
+
+    if (ucs_likely(ep->stripe.num_conns == 0) ||
+        (ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED)) {
+        return uct_base_ep_fence(tl_ep, flags);
+    }
+
+    /* Operations posted after the fence may be striped over additional
+     * connections, so request an acknowledgment for the data sent by the EP
+     * before the fence */
+    if ((ep->flags & UCT_TCP_EP_FLAG_NEED_FLUSH) &&
+        (uct_tcp_ep_check_tx_res(ep) == UCS_OK)) {
+        status = uct_tcp_ep_put_zcopy(tl_ep, NULL, 0, 0, 0, NULL);
+        ucs_assert(status != UCS_ERR_NO_RESOURCE);
+        if (ucs_unlikely(UCS_STATUS_IS_ERR(status))) {
+            return status;
+        }
+
+        ep->flags &= ~UCT_TCP_EP_FLAG_NEED_FLUSH;
+    }
+
+    if (!(ep->flags & (UCT_TCP_EP_FLAG_NEED_FLUSH |
+                       UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK)) &&
+        !uct_tcp_ep_stripe_is_inflight(ep)) {
+        return uct_base_ep_fence(tl_ep, flags);
+    }
+
+    /* Until the data sent before the fence is acknowledged, new operations
+     * are not striped, and no operation is sent while PUT fragments are
+     * in-flight on additional connections */
+    ep->flags             |= UCT_TCP_EP_FLAG_STRIPE_FENCE;
+    ep->stripe.fence_acked = !(ep->flags &
+                               (UCT_TCP_EP_FLAG_NEED_FLUSH |
+                                UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK));
+    ep->stripe.fence_sn    = (ep->flags & UCT_TCP_EP_FLAG_NEED_FLUSH) ?
+                             (ep->tx.put_sn + 1) : ep->tx.put_sn;
+    return uct_base_ep_fence(tl_ep, flags);
 }
 
 ucs_status_t
@@ -45,6 +45,27 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
    "Threshold for switching from send() to sendmsg() for short active messages",
    ucs_offsetof(uct_tcp_iface_config_t, sendv_thresh), UCS_CONFIG_TYPE_MEMUNITS},
 
+  {"MSG_ZEROCOPY_THRESH", "inf",
+   "Minimal payload size of AM and PUT Zcopy operations to send with\n"
+   "MSG_ZEROCOPY. It saves copying of user's buffers to socket buffers, but\n"
+   "requires to wait for completion notifications from the kernel, so it is\n"
+   "beneficial for large messages only. 'inf' disables MSG_ZEROCOPY.",
+   ucs_offsetof(uct_tcp_iface_config_t, msg_zcopy_thresh),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
+  {"NUM_CONNS", "1",
+   "Number of connections opened by an endpoint to its peer. Large PUT Zcopy\n"
+   "operations are striped over the connections which have free send\n"
+   "resources, so the traffic is spread over several flows and NIC queues.\n"
+   "Additional connections are opened only if PUT Zcopy is enabled.",
+   ucs_offsetof(uct_tcp_iface_config_t, num_conns), UCS_CONFIG_TYPE_UINT},
+
+  {"STRIPE_MIN_SIZE", "64kb",
+   "Minimal size of a PUT Zcopy fragment sent over a single connection when\n"
+   "the operation is striped over several connections",
+   ucs_offsetof(uct_tcp_iface_config_t, stripe_min_size),
+   UCS_CONFIG_TYPE_MEMUNITS},
+
   {"PREFER_DEFAULT", "y",
    "Give higher priority to the default network interface on the host",
    ucs_offsetof(uct_tcp_iface_config_t, prefer_default), UCS_CONFIG_TYPE_BOOL},
@@ -111,6 +132,32 @@ static ucs_config_field_t uct_tcp_iface_config_table[] = {
                 UCS_CONFIG_TYPE_TIME_UNITS},
 #endif /* UCT_TCP_EP_KEEPALIVE */
 
+#ifdef UCT_TCP_IO_URING
+  {"IO_URING", "n",
+   "Use io_uring to send and receive data on connected sockets. Sends and\n"
+   "multishot receives of all endpoints are submitted by a single system call\n"
+   "per progress, and data is received to buffers provided to the kernel.\n"
+   "Requires Linux 6.0 or newer, otherwise epoll and non-blocking socket\n"
+   "calls are used.",
+   ucs_offsetof(uct_tcp_iface_config_t, io_uring.enable), UCS_CONFIG_TYPE_BOOL},
+
+  {"IO_URING_ENTRIES", "256",
+   "Number of io_uring submission queue entries",
+   ucs_offsetof(uct_tcp_iface_config_t, io_uring.entries),
+   UCS_CONFIG_TYPE_UINT},
+
+  {"IO_URING_RX_BUFS", "256",
+   "Number of receive buffers provided to io_uring, rounded up to a power\n"
+   "of 2",
+   ucs_offsetof(uct_tcp_iface_config_t, io_uring.rx_bufs),
+   UCS_CONFIG_TYPE_UINT},
+
+  {"IO_URING_RX_BUF_SIZE", "16kb",
+   "Size of a receive buffer provided to io_uring",
+   ucs_offsetof(uct_tcp_iface_config_t, io_uring.rx_buf_size),
+   UCS_CONFIG_TYPE_MEMUNITS},
+#endif /* UCT_TCP_IO_URING */
+
   {NULL}
 };
 
@@ -348,6 +395,11 @@ static void uct_tcp_iface_handle_events(void *callback_data,
     unsigned *count  = (unsigned*)arg;
     uct_tcp_ep_t *ep = (uct_tcp_ep_t*)callback_data;
 
+    if (ep == NULL) {
+        /* io_uring completions are handled by uct_tcp_uring_progress() */
+        return;
+    }
+
     ucs_assertv(ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED, "ep=%p", ep);
 
     if (events & UCS_EVENT_SET_EVREAD) {
@@ -363,9 +415,19 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
     uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
     unsigned max_events    = iface->config.max_poll;
     unsigned count         = 0;
+    uct_tcp_ep_t *ep, *tmp_ep;
     unsigned read_events;
     ucs_status_t status;
 
+    if (iface->uring != NULL) {
+        count += uct_tcp_uring_progress(iface);
+    }
+
+    ucs_list_for_each_safe(ep, tmp_ep, &iface->msg_zcopy_ep_list,
+                           msg_zcopy.list) {
+        count += uct_tcp_ep_msg_zcopy_progress(ep);
+    }
+
     do {
         read_events = ucs_min(ucs_sys_event_set_max_wait_events, max_events);
         status = ucs_event_set_wait(iface->event_set, &read_events,
@@ -382,6 +444,25 @@ unsigned uct_tcp_iface_progress(uct_iface_h tl_iface)
     return count;
 }
 
+static ucs_status_t uct_tcp_iface_event_arm(uct_iface_h tl_iface,
+                                            unsigned events)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(tl_iface, uct_tcp_iface_t);
+
+    /* Data which was already received by io_uring, or was not submitted yet,
+     * does not make the event fd readable */
+    if ((iface->uring != NULL) && !uct_tcp_uring_is_idle(iface->uring)) {
+        return UCS_ERR_BUSY;
+    }
+
+    /* MSG_ZEROCOPY notifications are polled from socket error queues */
+    if (!ucs_list_is_empty(&iface->msg_zcopy_ep_list)) {
+        return UCS_ERR_BUSY;
+    }
+
+    return UCS_OK;
+}
+
 static ucs_status_t uct_tcp_iface_flush(uct_iface_h tl_iface, unsigned flags,
                                         uct_completion_t *comp)
 {
@@ -437,6 +518,7 @@ uct_tcp_iface_connect_handler(int listen_fd, ucs_event_set_types_t events,
 ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd,
                                        int set_nb)
 {
+    int UCS_V_UNUSED enable = 1;
     ucs_status_t status;
 
     if (set_nb) {
@@ -459,9 +541,46 @@ ucs_status_t uct_tcp_iface_set_sockopt(uct_tcp_iface_t *iface, int fd,
         return status;
     }
 
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    if (iface->config.zcopy.msg_thresh != UCS_MEMUNITS_INF) {
+        status = ucs_socket_setopt(fd, SOL_SOCKET, SO_ZEROCOPY,
+                                   (const void*)&enable, sizeof(int));
+        if (status != UCS_OK) {
+            return status;
+        }
+    }
+#endif
+
     return ucs_tcp_base_set_syn_cnt(fd, iface->config.syn_cnt);
 }
 
+static void uct_tcp_iface_msg_zcopy_check(uct_tcp_iface_t *iface)
+{
+#ifdef UCT_TCP_MSG_ZEROCOPY
+    int enable = 1;
+    ucs_status_t status;
+    int ret, fd;
+
+    if (iface->config.zcopy.msg_thresh == UCS_MEMUNITS_INF) {
+        return;
+    }
+
+    status = ucs_socket_create(iface->config.ifaddr.ss_family, SOCK_STREAM,
+                               &fd);
+    if (status == UCS_OK) {
+        ret = setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable));
+        ucs_close_fd(&fd);
+        if (ret == 0) {
+            return;
+        }
+    }
+
+    ucs_diag("tcp_iface %p: MSG_ZEROCOPY is not supported, disabling it",
+             iface);
+#endif
+    iface->config.zcopy.msg_thresh = UCS_MEMUNITS_INF;
+}
+
 static uct_iface_ops_t uct_tcp_iface_ops = {
     .ep_am_short              = uct_tcp_ep_am_short,
     .ep_am_short_iov          = uct_tcp_ep_am_short_iov,
@@ -471,7 +590,7 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .ep_pending_add           = uct_tcp_ep_pending_add,
     .ep_pending_purge         = uct_tcp_ep_pending_purge,
     .ep_flush                 = uct_tcp_ep_flush,
-    .ep_fence                 = uct_base_ep_fence,
+    .ep_fence                 = uct_tcp_ep_fence,
     .ep_check                 = uct_tcp_ep_check,
     .ep_create                = uct_tcp_ep_create,
     .ep_destroy               = uct_tcp_ep_destroy,
@@ -483,7 +602,7 @@ static uct_iface_ops_t uct_tcp_iface_ops = {
     .iface_progress_disable   = uct_base_iface_progress_disable,
     .iface_progress           = uct_tcp_iface_progress,
     .iface_event_fd_get       = uct_tcp_iface_event_fd_get,
-    .iface_event_arm          = ucs_empty_function_return_success,
+    .iface_event_arm          = uct_tcp_iface_event_arm,
     .iface_close              = UCS_CLASS_DELETE_FUNC_NAME(uct_tcp_iface_t),
     .iface_query              = uct_tcp_iface_query,
     .iface_get_address        = uct_tcp_iface_get_address,
@@ -671,6 +790,14 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         return UCS_ERR_INVALID_PARAM;
     }
 
+    if ((config->num_conns == 0) ||
+        (config->num_conns > UCT_TCP_EP_MAX_CONNS)) {
+        ucs_error("unsupported value was specified (%u) for the number of "
+                  "connections per endpoint, expected 1..%u",
+                  config->num_conns, UCT_TCP_EP_MAX_CONNS);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
     if (config->max_conn_retries > UINT8_MAX) {
         ucs_error("unsupported value was specified (%u) for the maximal "
                   "connection retries, expected lower than %u",
@@ -680,6 +807,9 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
 
     self->config.zcopy.max_hdr     = self->config.tx_seg_size -
                                      self->config.zcopy.hdr_offset;
+    self->config.zcopy.msg_thresh  = config->msg_zcopy_thresh;
+    self->config.stripe.num_conns  = config->put_enable ? config->num_conns : 1;
+    self->config.stripe.min_size   = ucs_max(config->stripe_min_size, 1);
     self->config.prefer_default    = config->prefer_default;
     self->config.put_enable        = config->put_enable;
     self->config.conn_nb           = config->conn_nb;
@@ -717,6 +847,15 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         goto err;
     }
 
+    self->uring = NULL;
+#ifdef UCT_TCP_IO_URING
+    if (config->io_uring.enable &&
+        (uct_tcp_uring_create(config, &self->uring) != UCS_OK)) {
+        ucs_diag("tcp_iface %p: io_uring is not available, using epoll", self);
+        self->uring = NULL;
+    }
+#endif
+
     ucs_mpool_params_reset(&mp_params);
     uct_iface_mpool_config_copy(&mp_params, &config->tx_mpool);
     mp_params.elems_per_chunk = (config->tx_mpool.bufs_grow == 0) ?
@@ -724,9 +863,16 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     mp_params.elem_size       = self->config.tx_seg_size;
     mp_params.ops             = &uct_tcp_mpool_ops;
     mp_params.name            = "uct_tcp_iface_tx_buf_mp";
+    if (self->uring != NULL) {
+        /* AM Short data is copied to the TX buffer, and messages are
+         * appended to it until it is submitted to io_uring */
+        self->config.sendv_thresh = UCS_MEMUNITS_INF;
+        mp_params.elem_size      *= 2;
+    }
+
     status = ucs_mpool_init(&mp_params, &self->tx_mpool);
     if (status != UCS_OK) {
-        goto err;
+        goto err_destroy_uring;
     }
 
     ucs_mpool_params_reset(&mp_params);
@@ -762,6 +908,8 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
     }
 
     ucs_list_head_init(&self->ep_list);
+    ucs_list_head_init(&self->msg_zcopy_ep_list);
+    uct_tcp_iface_msg_zcopy_check(self);
     ucs_conn_match_init(&self->conn_match_ctx, self->config.sockaddr_len,
                         UCT_TCP_CM_CONN_SN_MAX, &uct_tcp_cm_conn_match_ops);
     status = UCS_PTR_MAP_INIT(tcp_ep, &self->ep_ptr_map);
@@ -773,6 +921,16 @@ static UCS_CLASS_INIT_FUNC(uct_tcp_iface_t, uct_md_h md, uct_worker_h worker,
         goto err_cleanup_rx_mpool;
     }
 
+    if (self->uring != NULL) {
+        /* Make the event fd readable when io_uring has completions */
+        status = ucs_event_set_add(self->event_set,
+                                   uct_tcp_uring_fd(self->uring),
+                                   UCS_EVENT_SET_EVREAD, NULL);
+        if (status != UCS_OK) {
+            goto err_cleanup_event_set;
+        }
+    }
+
     status = uct_tcp_iface_listener_init(self);
     if (status != UCS_OK) {
         goto err_cleanup_event_set;
@@ -786,6 +944,10 @@ err_cleanup_rx_mpool:
     ucs_mpool_cleanup(&self->rx_mpool, 1);
 err_cleanup_tx_mpool:
     ucs_mpool_cleanup(&self->tx_mpool, 1);
+err_destroy_uring:
+    if (self->uring != NULL) {
+        uct_tcp_uring_destroy(self->uring);
+    }
 err:
     return status;
 }
@@ -851,6 +1013,11 @@ static UCS_CLASS_CLEANUP_FUNC(uct_tcp_iface_t)
     ucs_conn_match_cleanup(&self->conn_match_ctx);
     UCS_PTR_MAP_DESTROY(tcp_ep, &self->ep_ptr_map);
 
+    if (self->uring != NULL) {
+        ucs_event_set_del(self->event_set, uct_tcp_uring_fd(self->uring));
+        uct_tcp_uring_destroy(self->uring);
+    }
+
     ucs_mpool_cleanup(&self->rx_mpool, 1);
     ucs_mpool_cleanup(&self->tx_mpool, 1);
 
@@ -0,0 +1,1171 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2023. ALL RIGHTS RESERVED.
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "tcp.h"
+
+#include <ucs/async/async.h>
+#include <ucs/arch/cpu.h>
+#include <ucs/debug/memtrack_int.h>
+#include <ucs/sys/sys.h>
+
+
+#ifdef UCT_TCP_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+
+
+/* How many completions to fetch from the completion queue at once */
+#define UCT_TCP_URING_CQE_BATCH  16
+
+
+/**
+ * io_uring operation type
+ */
+typedef enum {
+    UCT_TCP_URING_OP_RECV,
+    UCT_TCP_URING_OP_SEND
+} uct_tcp_uring_op_type_t;
+
+
+/**
+ * io_uring operation flags
+ */
+enum {
+    /* The operation lost its endpoint, and its cancellation is waiting for a
+     * free submission queue entry */
+    UCT_TCP_URING_OP_FLAG_CANCEL = UCS_BIT(0)
+};
+
+
+/**
+ * Operation posted to io_uring, used as the user data of the submission
+ */
+struct uct_tcp_uring_op {
+    uct_tcp_uring_op_type_t  type;    /* Operation type */
+    unsigned                 flags;   /* Operation flags */
+    uct_tcp_ep_t             *ep;     /* Endpoint, or NULL if the endpoint was
+                                       * destroyed while the operation is in
+                                       * progress */
+    void                     *buf;    /* TX buffer released upon completion of
+                                       * an operation without endpoint */
+    ucs_list_link_t          list;    /* Element in the list of operations
+                                       * in flight */
+};
+
+
+/**
+ * Receive buffer provided to io_uring
+ */
+typedef struct {
+    ucs_queue_elem_t         queue;   /* Element in EP receive queue */
+    uint32_t                 offset;  /* Offset of the data to consume */
+    uint32_t                 length;  /* Length of the received data */
+} uct_tcp_uring_rx_buf_t;
+
+
+/**
+ * Completion fetched from the completion queue
+ */
+typedef struct {
+    uint64_t                 user_data;
+    int32_t                  res;
+    uint32_t                 flags;
+} uct_tcp_uring_cqe_t;
+
+
+struct uct_tcp_uring {
+    int                      fd;           /* io_uring file descriptor */
+    struct {
+        void                 *ring;        /* Mapped submission queue ring */
+        size_t               ring_size;    /* Size of the mapped ring */
+        volatile unsigned    *khead;       /* Head, updated by the kernel */
+        volatile unsigned    *ktail;       /* Tail, updated by us */
+        volatile unsigned    *kflags;      /* Ring flags */
+        unsigned             *array;       /* Indexes of SQEs */
+        unsigned             mask;         /* Ring mask */
+        unsigned             entries;      /* Number of ring entries */
+        unsigned             tail;         /* Local copy of the tail */
+        struct io_uring_sqe  *sqes;        /* Mapped submission entries */
+        size_t               sqes_size;    /* Size of mapped entries */
+    } sq;
+    struct {
+        void                 *ring;        /* Mapped completion queue ring */
+        size_t               ring_size;    /* Size of the mapped ring */
+        volatile unsigned    *khead;       /* Head, updated by us */
+        volatile unsigned    *ktail;       /* Tail, updated by the kernel */
+        unsigned             mask;         /* Ring mask */
+        struct io_uring_cqe  *cqes;        /* Completion entries */
+    } cq;
+    struct {
+        struct io_uring_buf_ring *ring;    /* Provided buffers ring */
+        void                 *data;        /* Receive buffers memory */
+        uct_tcp_uring_rx_buf_t *descs;     /* Receive buffer descriptors */
+        unsigned             count;        /* Number of receive buffers */
+        size_t               size;         /* Size of a receive buffer */
+        unsigned             avail;        /* Number of buffers provided to
+                                            * the kernel */
+        uint16_t             tail;         /* Local copy of the tail */
+    } rx;
+    ucs_mpool_t              op_mp;        /* Operations memory pool */
+    ucs_list_link_t          rx_list;      /* EPs with received data */
+    ucs_list_link_t          tx_list;      /* EPs with data to submit */
+    ucs_list_link_t          arm_list;     /* EPs waiting to arm a receive */
+    ucs_list_link_t          op_list;      /* Operations in flight */
+    unsigned                 num_cancels;  /* Number of operations waiting to
+                                            * submit their cancellation */
+};
+
+
+static ucs_mpool_ops_t uct_tcp_uring_op_mpool_ops = {
+    .chunk_alloc   = ucs_mpool_chunk_malloc,
+    .chunk_release = ucs_mpool_chunk_free,
+    .obj_init      = NULL,
+    .obj_cleanup   = NULL,
+    .obj_str       = NULL
+};
+
+
+static ucs_status_t uct_tcp_uring_errno_status(int io_errno)
+{
+    switch (io_errno) {
+    case EAGAIN:
+    case EINTR:
+        return UCS_ERR_NO_PROGRESS;
+    case ECONNRESET:
+    case EPIPE:
+        return UCS_ERR_CONNECTION_RESET;
+    case ECONNREFUSED:
+        return UCS_ERR_REJECTED;
+    case ETIMEDOUT:
+        return UCS_ERR_TIMED_OUT;
+    case ENOTCONN:
+        return UCS_ERR_NOT_CONNECTED;
+    default:
+        return UCS_ERR_IO_ERROR;
+    }
+}
+
+static UCS_F_ALWAYS_INLINE uct_tcp_uring_t *
+uct_tcp_ep_uring(const uct_tcp_ep_t *ep)
+{
+    return ucs_derived_of(ep->super.super.iface, uct_tcp_iface_t)->uring;
+}
+
+static ucs_status_t uct_tcp_uring_submit(uct_tcp_uring_t *uring)
+{
+    unsigned to_submit = uring->sq.tail - *uring->sq.khead;
+    unsigned flags     = 0;
+    int ret;
+
+    if (*uring->sq.kflags & IORING_SQ_CQ_OVERFLOW) {
+        /* Let the kernel flush overflowed completions to the ring */
+        flags |= IORING_ENTER_GETEVENTS;
+    } else if (to_submit == 0) {
+        return UCS_OK;
+    }
+
+    ret = syscall(__NR_io_uring_enter, uring->fd, to_submit, 0, flags, NULL,
+                  0);
+    if (ret >= 0) {
+        return UCS_OK;
+    }
+
+    if ((errno == EAGAIN) || (errno == EBUSY) || (errno == EINTR)) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    ucs_error("io_uring_enter(fd=%d, to_submit=%u) failed: %m", uring->fd,
+              to_submit);
+    return UCS_ERR_IO_ERROR;
+}
+
+static struct io_uring_sqe *uct_tcp_uring_get_sqe(uct_tcp_uring_t *uring)
+{
+    struct io_uring_sqe *sqe;
+
+    if ((uring->sq.tail - *uring->sq.khead) >= uring->sq.entries) {
+        uct_tcp_uring_submit(uring);
+        if ((uring->sq.tail - *uring->sq.khead) >= uring->sq.entries) {
+            return NULL;
+        }
+    }
+
+    sqe = &uring->sq.sqes[uring->sq.tail & uring->sq.mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static void uct_tcp_uring_sqe_commit(uct_tcp_uring_t *uring)
+{
+    ++uring->sq.tail;
+    ucs_memory_cpu_store_fence();
+    *uring->sq.ktail = uring->sq.tail;
+}
+
+static void uct_tcp_uring_rx_buf_recycle(uct_tcp_uring_t *uring, uint16_t bid)
+{
+    struct io_uring_buf *buf;
+
+    ucs_assert(bid < uring->rx.count);
+
+    /* Don't assign the whole structure, since the ring tail overlays the
+     * reserved field of the first entry */
+    buf       = &uring->rx.ring->bufs[uring->rx.tail & (uring->rx.count - 1)];
+    buf->addr = (uintptr_t)UCS_PTR_BYTE_OFFSET(uring->rx.data,
+                                               bid * uring->rx.size);
+    buf->len  = uring->rx.size;
+    buf->bid  = bid;
+
+    ++uring->rx.tail;
+    ++uring->rx.avail;
+    ucs_memory_cpu_store_fence();
+    uring->rx.ring->tail = uring->rx.tail;
+}
+
+static UCS_F_ALWAYS_INLINE uint16_t
+uct_tcp_uring_rx_buf_id(uct_tcp_uring_t *uring, uct_tcp_uring_rx_buf_t *desc)
+{
+    return desc - uring->rx.descs;
+}
+
+static void uct_tcp_uring_rx_purge(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    uct_tcp_uring_rx_buf_t *desc;
+
+    ucs_queue_for_each_extract(desc, &ep->uring.rx_q, queue, 1) {
+        uct_tcp_uring_rx_buf_recycle(uring,
+                                     uct_tcp_uring_rx_buf_id(uring, desc));
+    }
+}
+
+static void uct_tcp_uring_rx_schedule(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    if (!(ep->flags & UCT_TCP_EP_FLAG_URING_RX_READY)) {
+        ucs_list_add_tail(&uring->rx_list, &ep->uring.rx_elem);
+        ep->flags |= UCT_TCP_EP_FLAG_URING_RX_READY;
+    }
+}
+
+static void
+uct_tcp_uring_rx_unschedule(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    if (ep->flags & UCT_TCP_EP_FLAG_URING_RX_READY) {
+        ucs_list_del(&ep->uring.rx_elem);
+        ep->flags &= ~UCT_TCP_EP_FLAG_URING_RX_READY;
+    }
+}
+
+static int uct_tcp_uring_rx_has_data(const uct_tcp_ep_t *ep)
+{
+    return !ucs_queue_is_empty(&ep->uring.rx_q) ||
+           (ep->uring.rx_status != UCS_OK);
+}
+
+static ucs_status_t
+uct_tcp_uring_rx_arm_submit(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    struct io_uring_sqe *sqe;
+    uct_tcp_uring_op_t *op;
+
+    op = ucs_mpool_get(&uring->op_mp);
+    if (op == NULL) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    sqe = uct_tcp_uring_get_sqe(uring);
+    if (sqe == NULL) {
+        ucs_mpool_put(op);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = ep->fd;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = UCT_TCP_URING_RX_BGID;
+    sqe->user_data = (uintptr_t)op;
+    uct_tcp_uring_sqe_commit(uring);
+
+    op->type        = UCT_TCP_URING_OP_RECV;
+    op->flags       = 0;
+    op->ep          = ep;
+    op->buf         = NULL;
+    ep->uring.rx_op = op;
+    ucs_list_add_tail(&uring->op_list, &op->list);
+    ucs_trace("tcp_ep %p: armed io_uring receive on fd %d", ep, ep->fd);
+    return UCS_OK;
+}
+
+static void
+uct_tcp_uring_rx_arm_schedule(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    if (!(ep->flags & UCT_TCP_EP_FLAG_URING_RX_ARM)) {
+        ucs_list_add_tail(&uring->arm_list, &ep->uring.arm_elem);
+        ep->flags |= UCT_TCP_EP_FLAG_URING_RX_ARM;
+    }
+}
+
+static void
+uct_tcp_uring_rx_arm_unschedule(uct_tcp_uring_t *uring, uct_tcp_ep_t *ep)
+{
+    if (ep->flags & UCT_TCP_EP_FLAG_URING_RX_ARM) {
+        ucs_list_del(&ep->uring.arm_elem);
+        ep->flags &= ~UCT_TCP_EP_FLAG_URING_RX_ARM;
+    }
+}
+
+static ucs_status_t
+uct_tcp_uring_cancel_submit(uct_tcp_uring_t *uring, uct_tcp_uring_op_t *op)
+{
+    struct io_uring_sqe *sqe;
+
+    sqe = uct_tcp_uring_get_sqe(uring);
+    if (sqe == NULL) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+    sqe->fd        = -1;
+    sqe->addr      = (uintptr_t)op;
+    sqe->user_data = 0;
+    uct_tcp_uring_sqe_commit(uring);
+    return UCS_OK;
+}
+
+ucs_status_t uct_tcp_uring_rx_arm(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface = ucs_derived_of(ep->super.super.iface,
+                                            uct_tcp_iface_t);
+    uct_tcp_uring_t *uring = iface->uring;
+    ucs_status_t status    = UCS_OK;
+
+    ucs_assert(ep->fd != -1);
+
+    if ((ep->uring.rx_op == NULL) &&
+        !(ep->flags & UCT_TCP_EP_FLAG_URING_RX_ARM)) {
+        UCS_ASYNC_BLOCK(iface->super.worker->async);
+        status = uct_tcp_uring_rx_arm_submit(uring, ep);
+        if (status != UCS_OK) {
+            /* Out of operations or submission queue entries, arming is
+             * retried from iface progress */
+            ucs_debug("tcp_ep %p: failed to arm io_uring receive on fd %d, "
+                      "will retry", ep, ep->fd);
+            uct_tcp_uring_rx_arm_schedule(uring, ep);
+        }
+        UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+    }
+
+    if (uct_tcp_uring_rx_has_data(ep)) {
+        uct_tcp_uring_rx_schedule(uring, ep);
+    }
+
+    return status;
+}
+
+void uct_tcp_uring_rx_disarm(uct_tcp_ep_t *ep)
+{
+    uct_tcp_iface_t *iface  = ucs_derived_of(ep->super.super.iface,
+                                             uct_tcp_iface_t);
+    uct_tcp_uring_t *uring  = iface->uring;
+    uct_tcp_uring_op_t *op  = ep->uring.rx_op;
+    struct linger linger    = {.l_onoff = 1, .l_linger = 0};
+
+    uct_tcp_uring_rx_arm_unschedule(uring, ep);
+
+    if (op != NULL) {
+        /* The kernel holds a reference to the socket until the multishot
+         * receive is terminated, so the cancellation has to be submitted
+         * before the socket is closed */
+        op->ep          = NULL;
+        ep->uring.rx_op = NULL;
+
+        UCS_ASYNC_BLOCK(iface->super.worker->async);
+        if (uct_tcp_uring_cancel_submit(uring, op) == UCS_OK) {
+            uct_tcp_uring_submit(uring);
+        } else {
+            ucs_debug("tcp_ep %p: failed to cancel io_uring receive on fd %d, "
+                      "will retry", ep, ep->fd);
+            op->flags |= UCT_TCP_URING_OP_FLAG_CANCEL;
+            ++uring->num_cancels;
+        }
+        UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+    }
+
+    if (!ucs_queue_is_empty(&ep->uring.rx_q) && (ep->fd != -1)) {
+        /* Unread data is dropped, so reset the connection upon closing the
+         * socket, as the kernel does when unread data is left in a socket */
+        ucs_socket_setopt(ep->fd, SOL_SOCKET, SO_LINGER, &linger,
+                          sizeof(linger));
+    }
+
+    uct_tcp_uring_rx_purge(uring, ep);
+    uct_tcp_uring_rx_unschedule(uring, ep);
+    ep->uring.rx_status = UCS_OK;
+}
+
+ucs_status_t uct_tcp_uring_recv(uct_tcp_ep_t *ep, void *buf, size_t *length_p)
+{
+    uct_tcp_uring_t *uring = uct_tcp_ep_uring(ep);
+    size_t length          = 0;
+    uct_tcp_uring_rx_buf_t *desc;
+    size_t copy_length;
+
+    while ((length < *length_p) && !ucs_queue_is_empty(&ep->uring.rx_q)) {
+        desc        = ucs_queue_head_elem_non_empty(&ep->uring.rx_q,
+                                                    uct_tcp_uring_rx_buf_t,
+                                                    queue);
+        copy_length = ucs_min(desc->length - desc->offset,
+                              *length_p - length);
+        memcpy(UCS_PTR_BYTE_OFFSET(buf, length),
+               UCS_PTR_BYTE_OFFSET(uring->rx.data,
+                                   (uct_tcp_uring_rx_buf_id(uring, desc) *
+                                    uring->rx.size) + desc->offset),
+               copy_length);
+        length       += copy_length;
+        desc->offset += copy_length;
+        if (desc->offset == desc->length) {
+            ucs_queue_pull_non_empty(&ep->uring.rx_q);
+            uct_tcp_uring_rx_buf_recycle(uring,
+                                         uct_tcp_uring_rx_buf_id(uring, desc));
+        }
+    }
+
+    if (length == 0) {
+        return (ep->uring.rx_status != UCS_OK) ? ep->uring.rx_status :
+                                                 UCS_ERR_NO_PROGRESS;
+    }
+
+    if (uct_tcp_uring_rx_has_data(ep)) {
+        /* Emulate level-triggered readiness for the remaining data */
+        uct_tcp_uring_rx_schedule(uring, ep);
+    }
+
+    *length_p = length;
+    return UCS_OK;
+}
+
+static void
+uct_tcp_uring_op_release(uct_tcp_uring_t *uring, uct_tcp_uring_op_t *op)
+{
+    if (op->flags & UCT_TCP_URING_OP_FLAG_CANCEL) {
+        /* Completed before its cancellation was submitted */
+        ucs_assert(uring->num_cancels > 0);
+        --uring->num_cancels;
+    }
+
+    ucs_list_del(&op->list);
+    ucs_mpool_put(op);
+}
+
+static unsigned
+uct_tcp_uring_recv_completed(uct_tcp_uring_t *uring, uct_tcp_uring_op_t *op,
+                             const uct_tcp_uring_cqe_t *cqe)
+{
+    uct_tcp_ep_t *ep = op->ep;
+    uct_tcp_uring_rx_buf_t *desc;
+    uint16_t bid;
+
+    if (cqe->flags & IORING_CQE_F_BUFFER) {
+        bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        ucs_assert(uring->rx.avail > 0);
+        --uring->rx.avail;
+        if ((ep == NULL) || (cqe->res <= 0)) {
+            uct_tcp_uring_rx_buf_recycle(uring, bid);
+        } else {
+            desc         = &uring->rx.descs[bid];
+            desc->offset = 0;
+            desc->length = cqe->res;
+            ucs_queue_push(&ep->uring.rx_q, &desc->queue);
+            ucs_trace_data("tcp_ep %p: io_uring received %d bytes to buffer %u",
+                           ep, cqe->res, bid);
+        }
+    }
+
+    if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        /* The multishot receive was terminated */
+        uct_tcp_uring_op_release(uring, op);
+        if (ep == NULL) {
+            return 0;
+        }
+
+        ucs_assert(ep->uring.rx_op == op);
+        ep->uring.rx_op = NULL;
+        if (cqe->res == 0) {
+            /* Connection closed by peer */
+            ep->uring.rx_status = UCS_ERR_NOT_CONNECTED;
+        } else if (cqe->res == -ENOBUFS) {
+            /* Out of provided buffers - keep receiving once some buffers
+             * are consumed and returned to the kernel */
+            if (ep->events & UCS_EVENT_SET_EVREAD) {
+                uct_tcp_uring_rx_arm_schedule(uring, ep);
+            }
+        } else if (cqe->res > 0) {
+            /* The kernel stopped the receive for an internal reason - keep
+             * receiving */
+            if (ep->events & UCS_EVENT_SET_EVREAD) {
+                uct_tcp_uring_rx_arm(ep);
+            }
+        } else {
+            ucs_debug("tcp_ep %p: io_uring receive on fd %d failed: %s", ep,
+                      ep->fd, strerror(-cqe->res));
+            ep->uring.rx_status = uct_tcp_uring_errno_status(-cqe->res);
+        }
+    } else if (ep == NULL) {
+        return 0;
+    }
+
+    if (uct_tcp_uring_rx_has_data(ep)) {
+        uct_tcp_uring_rx_schedule(uring, ep);
+    }
+
+    return 0;
+}
+
+static unsigned
+uct_tcp_uring_send_completed(uct_tcp_uring_t *uring, uct_tcp_uring_op_t *op,
+                             const uct_tcp_uring_cqe_t *cqe)
+{
+    uct_tcp_ep_t *ep = op->ep;
+
+    if (ep == NULL) {
+        ucs_mpool_put_inline(op->buf);
+        uct_tcp_uring_op_release(uring, op);
+        return 0;
+    }
+
+    ucs_assert(ep->uring.tx_op == op);
+    ep->uring.tx_op = NULL;
+    uct_tcp_uring_op_release(uring, op);
+
+    if (cqe->res < 0) {
+        return uct_tcp_ep_uring_tx_completed(
+                ep, uct_tcp_uring_errno_status(-cqe->res), 0);
+    }
+
+    return uct_tcp_ep_uring_tx_completed(ep, UCS_OK, cqe->res);
+}
+
+static unsigned uct_tcp_uring_handle_cqe(uct_tcp_uring_t *uring,
+                                         const uct_tcp_uring_cqe_t *cqe)
+{
+    uct_tcp_uring_op_t *op = (uct_tcp_uring_op_t*)(uintptr_t)cqe->user_data;
+
+    if (op == NULL) {
+        /* Completion of a cancel request */
+        return 0;
+    }
+
+    if (op->type == UCT_TCP_URING_OP_RECV) {
+        return uct_tcp_uring_recv_completed(uring, op, cqe);
+    }
+
+    ucs_assert(op->type == UCT_TCP_URING_OP_SEND);
+    return uct_tcp_uring_send_completed(uring, op, cqe);
+}
+
+static unsigned uct_tcp_uring_poll_cq(uct_tcp_uring_t *uring)
+{
+    uct_tcp_uring_cqe_t cqes[UCT_TCP_URING_CQE_BATCH];
+    unsigned count = 0;
+    struct io_uring_cqe *cqe;
+    unsigned head, tail, i, num_cqes;
+
+    do {
+        head = *uring->cq.khead;
+        tail = *uring->cq.ktail;
+        ucs_memory_cpu_load_fence();
+
+        /* Copy the completions and release their ring entries before
+         * handling them, since the handlers may post new operations */
+        num_cqes = ucs_min(tail - head, UCT_TCP_URING_CQE_BATCH);
+        for (i = 0; i < num_cqes; ++i) {
+            cqe                = &uring->cq.cqes[(head + i) & uring->cq.mask];
+            cqes[i].user_data = cqe->user_data;
+            cqes[i].res       = cqe->res;
+            cqes[i].flags     = cqe->flags;
+        }
+
+        ucs_memory_cpu_fence();
+        *uring->cq.khead = head + num_cqes;
+
+        for (i = 0; i < num_cqes; ++i) {
+            count += uct_tcp_uring_handle_cqe(uring, &cqes[i]);
+        }
+    } while (num_cqes == UCT_TCP_URING_CQE_BATCH);
+
+    return count;
+}
+
+static ucs_status_t uct_tcp_uring_tx_submit(uct_tcp_uring_t *uring,
+                                            uct_tcp_ep_t *ep)
+{
+    struct io_uring_sqe *sqe;
+    uct_tcp_uring_op_t *op;
+
+    ucs_assert(ep->tx.offset < ep->tx.length);
+
+    op = ucs_mpool_get(&uring->op_mp);
+    if (op == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    sqe = uct_tcp_uring_get_sqe(uring);
+    if (sqe == NULL) {
+        ucs_mpool_put(op);
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    sqe->opcode    = IORING_OP_SEND;
+    sqe->fd        = ep->fd;
+    sqe->addr      = (uintptr_t)UCS_PTR_BYTE_OFFSET(ep->tx.buf, ep->tx.offset);
+    sqe->len       = ep->tx.length - ep->tx.offset;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (uintptr_t)op;
+    uct_tcp_uring_sqe_commit(uring);
+
+    op->type        = UCT_TCP_URING_OP_SEND;
+    op->flags       = 0;
+    op->ep          = ep;
+    op->buf         = NULL;
+    ep->uring.tx_op = op;
+    ucs_list_add_tail(&uring->op_list, &op->list);
+
+    ucs_trace_data("tcp_ep %p: io_uring send %zu bytes on fd %d", ep,
+                   ep->tx.length - ep->tx.offset, ep->fd);
+    return UCS_OK;
+}
+
+static void uct_tcp_uring_retry(uct_tcp_uring_t *uring)
+{
+    unsigned num_armed = 0;
+    uct_tcp_uring_op_t *op;
+    uct_tcp_ep_t *ep;
+
+    /* A receive which is armed while no buffers are provided fails
+     * immediately, so arm no more receives than there are buffers */
+    while (!ucs_list_is_empty(&uring->arm_list) &&
+           (num_armed < uring->rx.avail)) {
+        ep = ucs_list_head(&uring->arm_list, uct_tcp_ep_t, uring.arm_elem);
+        if (uct_tcp_uring_rx_arm_submit(uring, ep) != UCS_OK) {
+            return;
+        }
+
+        uct_tcp_uring_rx_arm_unschedule(uring, ep);
+        ++num_armed;
+    }
+
+    if (uring->num_cancels == 0) {
+        return;
+    }
+
+    ucs_list_for_each(op, &uring->op_list, list) {
+        if (!(op->flags & UCT_TCP_URING_OP_FLAG_CANCEL)) {
+            continue;
+        }
+
+        if (uct_tcp_uring_cancel_submit(uring, op) != UCS_OK) {
+            return;
+        }
+
+        op->flags &= ~UCT_TCP_URING_OP_FLAG_CANCEL;
+        if (--uring->num_cancels == 0) {
+            return;
+        }
+    }
+}
+
+unsigned uct_tcp_uring_progress(uct_tcp_iface_t *iface)
+{
+    uct_tcp_uring_t *uring = iface->uring;
+    unsigned count         = 0;
+    ucs_list_link_t ready_list;
+    uct_tcp_ep_t *ep;
+
+    /* Post the data of all EPs and submit it, together with the receive
+     * requests, by a single system call */
+    UCS_ASYNC_BLOCK(iface->super.worker->async);
+    uct_tcp_uring_retry(uring);
+    while (!ucs_list_is_empty(&uring->tx_list)) {
+        ep = ucs_list_head(&uring->tx_list, uct_tcp_ep_t, uring.tx_elem);
+        if (uct_tcp_uring_tx_submit(uring, ep) != UCS_OK) {
+            break;
+        }
+
+        ucs_list_del(&ep->uring.tx_elem);
+        ep->flags &= ~UCT_TCP_EP_FLAG_URING_TX_QUEUED;
+    }
+
+    uct_tcp_uring_submit(uring);
+    UCS_ASYNC_UNBLOCK(iface->super.worker->async);
+
+    count += uct_tcp_uring_poll_cq(uring);
+
+    /* Deliver received data. EPs which are scheduled while delivering are
+     * handled on the next progress call. An EP could be destroyed from the
+     * callback of another EP, and then it is removed from the local list. */
+    ucs_list_head_init(&ready_list);
+    ucs_list_splice_tail(&ready_list, &uring->rx_list);
+    ucs_list_head_init(&uring->rx_list);
+    while (!ucs_list_is_empty(&ready_list)) {
+        ep = ucs_list_extract_head(&ready_list, uct_tcp_ep_t, uring.rx_elem);
+        ep->flags &= ~UCT_TCP_EP_FLAG_URING_RX_READY;
+        if ((ep->events & UCS_EVENT_SET_EVREAD) &&
+            (ep->conn_state != UCT_TCP_EP_CONN_STATE_CLOSED)) {
+            count += uct_tcp_ep_cm_state[ep->conn_state].rx_progress(ep);
+        }
+    }
+
+    return count;
+}
+
+void uct_tcp_uring_tx_post(uct_tcp_ep_t *ep)
+{
+    uct_tcp_uring_t *uring = uct_tcp_ep_uring(ep);
+
+    ucs_assert(ep->uring.tx_op == NULL);
+
+    if (!(ep->flags & UCT_TCP_EP_FLAG_URING_TX_QUEUED)) {
+        ucs_list_add_tail(&uring->tx_list, &ep->uring.tx_elem);
+        ep->flags |= UCT_TCP_EP_FLAG_URING_TX_QUEUED;
+    }
+}
+
+void uct_tcp_uring_tx_detach(uct_tcp_ep_t *ep)
+{
+    uct_tcp_uring_op_t *op = ep->uring.tx_op;
+
+    if (ep->flags & UCT_TCP_EP_FLAG_URING_TX_QUEUED) {
+        ucs_list_del(&ep->uring.tx_elem);
+        ep->flags &= ~UCT_TCP_EP_FLAG_URING_TX_QUEUED;
+    }
+
+    if (op == NULL) {
+        return;
+    }
+
+    /* The kernel may still read the buffer, so pass its ownership to the
+     * operation */
+    op->ep          = NULL;
+    op->buf         = ep->tx.buf;
+    ep->uring.tx_op = NULL;
+    ep->tx.buf      = NULL;
+    ep->tx.offset   = 0;
+    ep->tx.length   = 0;
+}
+
+void uct_tcp_uring_ep_move(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep)
+{
+    uct_tcp_uring_t *uring = uct_tcp_ep_uring(to_ep);
+
+    ucs_assert(to_ep->uring.rx_op == NULL);
+    ucs_assert(to_ep->uring.tx_op == NULL);
+    ucs_assert(!(to_ep->flags & UCT_TCP_EP_FLAG_URING_TX_QUEUED));
+    ucs_assert(!(to_ep->flags & UCT_TCP_EP_FLAG_URING_RX_ARM));
+
+    if (from_ep->flags & UCT_TCP_EP_FLAG_URING_RX_ARM) {
+        uct_tcp_uring_rx_arm_unschedule(uring, from_ep);
+        uct_tcp_uring_rx_arm_schedule(uring, to_ep);
+    }
+
+    to_ep->uring.rx_op = from_ep->uring.rx_op;
+    if (to_ep->uring.rx_op != NULL) {
+        to_ep->uring.rx_op->ep = to_ep;
+        from_ep->uring.rx_op   = NULL;
+    }
+
+    uct_tcp_uring_rx_purge(uring, to_ep);
+    ucs_queue_splice(&to_ep->uring.rx_q, &from_ep->uring.rx_q);
+    to_ep->uring.rx_status   = from_ep->uring.rx_status;
+    from_ep->uring.rx_status = UCS_OK;
+    uct_tcp_uring_rx_unschedule(uring, from_ep);
+    if (uct_tcp_uring_rx_has_data(to_ep)) {
+        uct_tcp_uring_rx_schedule(uring, to_ep);
+    }
+
+    to_ep->uring.tx_op = from_ep->uring.tx_op;
+    if (to_ep->uring.tx_op != NULL) {
+        to_ep->uring.tx_op->ep = to_ep;
+        from_ep->uring.tx_op   = NULL;
+    }
+
+    if (from_ep->flags & UCT_TCP_EP_FLAG_URING_TX_QUEUED) {
+        ucs_list_del(&from_ep->uring.tx_elem);
+        from_ep->flags &= ~UCT_TCP_EP_FLAG_URING_TX_QUEUED;
+        uct_tcp_uring_tx_post(to_ep);
+    }
+}
+
+int uct_tcp_uring_fd(uct_tcp_uring_t *uring)
+{
+    return uring->fd;
+}
+
+int uct_tcp_uring_is_idle(uct_tcp_uring_t *uring)
+{
+    return ucs_list_is_empty(&uring->rx_list) &&
+           ucs_list_is_empty(&uring->tx_list) &&
+           ucs_list_is_empty(&uring->arm_list) && (uring->num_cancels == 0);
+}
+
+static ucs_status_t uct_tcp_uring_map(uct_tcp_uring_t *uring,
+                                      const struct io_uring_params *params)
+{
+    uring->sq.ring_size = params->sq_off.array +
+                          (params->sq_entries * sizeof(unsigned));
+    uring->cq.ring_size = params->cq_off.cqes +
+                          (params->cq_entries * sizeof(struct io_uring_cqe));
+    uring->sq.sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+
+    if (params->features & IORING_FEAT_SINGLE_MMAP) {
+        uring->sq.ring_size = ucs_max(uring->sq.ring_size,
+                                      uring->cq.ring_size);
+        uring->cq.ring_size = 0;
+    }
+
+    uring->sq.ring = ucs_mmap(NULL, uring->sq.ring_size,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, uring->fd,
+                              IORING_OFF_SQ_RING, "tcp_uring_sq");
+    if (uring->sq.ring == MAP_FAILED) {
+        goto err;
+    }
+
+    if (uring->cq.ring_size == 0) {
+        uring->cq.ring = uring->sq.ring;
+    } else {
+        uring->cq.ring = ucs_mmap(NULL, uring->cq.ring_size,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, uring->fd,
+                                  IORING_OFF_CQ_RING, "tcp_uring_cq");
+        if (uring->cq.ring == MAP_FAILED) {
+            goto err_unmap_sq;
+        }
+    }
+
+    uring->sq.sqes = ucs_mmap(NULL, uring->sq.sqes_size,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, uring->fd,
+                              IORING_OFF_SQES, "tcp_uring_sqes");
+    if (uring->sq.sqes == MAP_FAILED) {
+        goto err_unmap_cq;
+    }
+
+    uring->sq.khead   = UCS_PTR_BYTE_OFFSET(uring->sq.ring,
+                                            params->sq_off.head);
+    uring->sq.ktail   = UCS_PTR_BYTE_OFFSET(uring->sq.ring,
+                                            params->sq_off.tail);
+    uring->sq.kflags  = UCS_PTR_BYTE_OFFSET(uring->sq.ring,
+                                            params->sq_off.flags);
+    uring->sq.array   = UCS_PTR_BYTE_OFFSET(uring->sq.ring,
+                                            params->sq_off.array);
+    uring->sq.mask    = *(unsigned*)UCS_PTR_BYTE_OFFSET(uring->sq.ring,
+                                                        params->sq_off.ring_mask);
+    uring->sq.entries = params->sq_entries;
+    uring->sq.tail    = *uring->sq.ktail;
+    uring->cq.khead   = UCS_PTR_BYTE_OFFSET(uring->cq.ring,
+                                            params->cq_off.head);
+    uring->cq.ktail   = UCS_PTR_BYTE_OFFSET(uring->cq.ring,
+                                            params->cq_off.tail);
+    uring->cq.mask    = *(unsigned*)UCS_PTR_BYTE_OFFSET(uring->cq.ring,
+                                                        params->cq_off.ring_mask);
+    uring->cq.cqes    = UCS_PTR_BYTE_OFFSET(uring->cq.ring,
+                                            params->cq_off.cqes);
+    return UCS_OK;
+
+err_unmap_cq:
+    if (uring->cq.ring_size != 0) {
+        ucs_munmap(uring->cq.ring, uring->cq.ring_size);
+    }
+err_unmap_sq:
+    ucs_munmap(uring->sq.ring, uring->sq.ring_size);
+err:
+    ucs_error("failed to map io_uring fd %d: %m", uring->fd);
+    return UCS_ERR_IO_ERROR;
+}
+
+static void uct_tcp_uring_unmap(uct_tcp_uring_t *uring)
+{
+    ucs_munmap(uring->sq.sqes, uring->sq.sqes_size);
+    if (uring->cq.ring_size != 0) {
+        ucs_munmap(uring->cq.ring, uring->cq.ring_size);
+    }
+    ucs_munmap(uring->sq.ring, uring->sq.ring_size);
+}
+
+static ucs_status_t uct_tcp_uring_rx_init(uct_tcp_uring_t *uring,
+                                          const uct_tcp_iface_config_t *config)
+{
+    unsigned rx_bufs            = ucs_max(config->io_uring.rx_bufs, 2);
+    struct io_uring_buf_reg reg = {};
+    ucs_status_t status;
+    unsigned i;
+    int ret;
+
+    uring->rx.count = ucs_roundup_pow2(rx_bufs);
+    uring->rx.size  = config->io_uring.rx_buf_size;
+    uring->rx.tail  = 0;
+    uring->rx.avail = 0;
+    if (uring->rx.count > UINT16_MAX) {
+        ucs_error("too many io_uring receive buffers (%u), maximum is %u",
+                  uring->rx.count, UINT16_MAX);
+        return UCS_ERR_INVALID_PARAM;
+    }
+
+    ret = ucs_posix_memalign((void**)&uring->rx.ring, ucs_get_page_size(),
+                             uring->rx.count * sizeof(struct io_uring_buf),
+                             "tcp_uring_buf_ring");
+    if (ret != 0) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    memset(uring->rx.ring, 0, uring->rx.count * sizeof(struct io_uring_buf));
+
+    ret = ucs_posix_memalign(&uring->rx.data, ucs_get_page_size(),
+                             uring->rx.count * uring->rx.size,
+                             "tcp_uring_rx_bufs");
+    if (ret != 0) {
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free_ring;
+    }
+
+    uring->rx.descs = ucs_calloc(uring->rx.count, sizeof(*uring->rx.descs),
+                                 "tcp_uring_rx_descs");
+    if (uring->rx.descs == NULL) {
+        status = UCS_ERR_NO_MEMORY;
+        goto err_free_data;
+    }
+
+    reg.ring_addr    = (uintptr_t)uring->rx.ring;
+    reg.ring_entries = uring->rx.count;
+    reg.bgid         = UCT_TCP_URING_RX_BGID;
+    ret = syscall(__NR_io_uring_register, uring->fd,
+                  IORING_REGISTER_PBUF_RING, &reg, 1);
+    if (ret < 0) {
+        ucs_diag("failed to register io_uring provided buffers ring: %m");
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_free_descs;
+    }
+
+    for (i = 0; i < uring->rx.count; ++i) {
+        uct_tcp_uring_rx_buf_recycle(uring, i);
+    }
+
+    return UCS_OK;
+
+err_free_descs:
+    ucs_free(uring->rx.descs);
+err_free_data:
+    ucs_free(uring->rx.data);
+err_free_ring:
+    ucs_free(uring->rx.ring);
+    return status;
+}
+
+static void uct_tcp_uring_rx_cleanup(uct_tcp_uring_t *uring)
+{
+    ucs_free(uring->rx.descs);
+    ucs_free(uring->rx.data);
+    ucs_free(uring->rx.ring);
+}
+
+ucs_status_t uct_tcp_uring_create(const uct_tcp_iface_config_t *config,
+                                  uct_tcp_uring_t **uring_p)
+{
+    unsigned entries              = config->io_uring.entries;
+    struct io_uring_params params = {};
+    ucs_mpool_params_t mp_params;
+    uct_tcp_uring_t *uring;
+    ucs_status_t status;
+    unsigned i;
+
+    uring = ucs_calloc(1, sizeof(*uring), "tcp_uring");
+    if (uring == NULL) {
+        return UCS_ERR_NO_MEMORY;
+    }
+
+    /* Every armed multishot receive can produce many completions, so make
+     * the completion queue larger than the submission queue */
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = ucs_roundup_pow2(entries) * 4;
+    uring->fd         = syscall(__NR_io_uring_setup, entries, &params);
+    if (uring->fd < 0) {
+        ucs_diag("io_uring_setup(entries=%u) failed: %m", entries);
+        status = UCS_ERR_UNSUPPORTED;
+        goto err_free;
+    }
+
+    status = uct_tcp_uring_map(uring, &params);
+    if (status != UCS_OK) {
+        goto err_close;
+    }
+
+    for (i = 0; i < uring->sq.entries; ++i) {
+        uring->sq.array[i] = i;
+    }
+
+    status = uct_tcp_uring_rx_init(uring, config);
+    if (status != UCS_OK) {
+        goto err_unmap;
+    }
+
+    ucs_mpool_params_reset(&mp_params);
+    mp_params.elem_size       = sizeof(uct_tcp_uring_op_t);
+    mp_params.elems_per_chunk = 128;
+    mp_params.ops             = &uct_tcp_uring_op_mpool_ops;
+    mp_params.name            = "uct_tcp_uring_ops";
+    status = ucs_mpool_init(&mp_params, &uring->op_mp);
+    if (status != UCS_OK) {
+        goto err_rx_cleanup;
+    }
+
+    ucs_list_head_init(&uring->rx_list);
+    ucs_list_head_init(&uring->tx_list);
+    ucs_list_head_init(&uring->arm_list);
+    ucs_list_head_init(&uring->op_list);
+    uring->num_cancels = 0;
+
+    ucs_debug("created io_uring fd %d with %u entries, %u receive buffers of "
+              "%zu bytes", uring->fd, uring->sq.entries, uring->rx.count,
+              uring->rx.size);
+    *uring_p = uring;
+    return UCS_OK;
+
+err_rx_cleanup:
+    uct_tcp_uring_rx_cleanup(uring);
+err_unmap:
+    uct_tcp_uring_unmap(uring);
+err_close:
+    ucs_close_fd(&uring->fd);
+err_free:
+    ucs_free(uring);
+    return status;
+}
+
+static void uct_tcp_uring_drain(uct_tcp_uring_t *uring)
+{
+    struct io_uring_sqe *sqe;
+    unsigned to_submit;
+    int ret;
+
+    if (ucs_list_is_empty(&uring->op_list)) {
+        return;
+    }
+
+    /* Cancel all operations by a single request */
+    sqe = uct_tcp_uring_get_sqe(uring);
+    while (sqe == NULL) {
+        uct_tcp_uring_poll_cq(uring);
+        sqe = uct_tcp_uring_get_sqe(uring);
+    }
+
+    sqe->opcode       = IORING_OP_ASYNC_CANCEL;
+    sqe->fd           = -1;
+    sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+    sqe->user_data    = 0;
+    uct_tcp_uring_sqe_commit(uring);
+
+    /* Wait for the final completions of the canceled operations, since the
+     * kernel may access their buffers until then */
+    while (!ucs_list_is_empty(&uring->op_list)) {
+        to_submit = uring->sq.tail - *uring->sq.khead;
+        ret       = syscall(__NR_io_uring_enter, uring->fd, to_submit, 1,
+                            IORING_ENTER_GETEVENTS, NULL, 0);
+        if ((ret < 0) && (errno != EINTR) && (errno != EAGAIN) &&
+            (errno != EBUSY)) {
+            ucs_error("io_uring_enter(fd=%d) failed to wait for %zu "
+                      "operations: %m", uring->fd,
+                      ucs_list_length(&uring->op_list));
+            return;
+        }
+
+        uct_tcp_uring_poll_cq(uring);
+    }
+}
+
+void uct_tcp_uring_destroy(uct_tcp_uring_t *uring)
+{
+    uct_tcp_uring_op_t *op, *tmp;
+
+    ucs_assert(ucs_list_is_empty(&uring->rx_list));
+    ucs_assert(ucs_list_is_empty(&uring->tx_list));
+    ucs_assert(ucs_list_is_empty(&uring->arm_list));
+
+    /* All EPs were destroyed, so only operations without EP are in flight */
+    uct_tcp_uring_drain(uring);
+
+    ucs_close_fd(&uring->fd);
+
+    ucs_list_for_each_safe(op, tmp, &uring->op_list, list) {
+        if (op->type == UCT_TCP_URING_OP_SEND) {
+            ucs_mpool_put_inline(op->buf);
+        }
+    }
+
+    ucs_mpool_cleanup(&uring->op_mp, 0);
+    uct_tcp_uring_rx_cleanup(uring);
+    uct_tcp_uring_unmap(uring);
+    ucs_free(uring);
+}
+
+#else /* UCT_TCP_IO_URING */
+
+ucs_status_t uct_tcp_uring_create(const uct_tcp_iface_config_t *config,
+                                  uct_tcp_uring_t **uring_p)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+void uct_tcp_uring_destroy(uct_tcp_uring_t *uring)
+{
+}
+
+int uct_tcp_uring_fd(uct_tcp_uring_t *uring)
+{
+    return -1;
+}
+
+int uct_tcp_uring_is_idle(uct_tcp_uring_t *uring)
+{
+    return 1;
+}
+
+unsigned uct_tcp_uring_progress(uct_tcp_iface_t *iface)
+{
+    return 0;
+}
+
+ucs_status_t uct_tcp_uring_rx_arm(uct_tcp_ep_t *ep)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+void uct_tcp_uring_rx_disarm(uct_tcp_ep_t *ep)
+{
+}
+
+ucs_status_t uct_tcp_uring_recv(uct_tcp_ep_t *ep, void *buf, size_t *length_p)
+{
+    return UCS_ERR_UNSUPPORTED;
+}
+
+void uct_tcp_uring_tx_post(uct_tcp_ep_t *ep)
+{
+}
+
+void uct_tcp_uring_tx_detach(uct_tcp_ep_t *ep)
+{
+}
+
+void uct_tcp_uring_ep_move(uct_tcp_ep_t *to_ep, uct_tcp_ep_t *from_ep)
+{
+}
+
+#endif /* UCT_TCP_IO_URING */
@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) NVIDIA CORPORATION & AFFILIATES, 2024. ALL RIGHTS RESERVED.
+ *
+ * See file LICENSE for terms.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/mman.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include <ucs/sys/preprocessor.h>
+#include <ucs/type/status.h>
+#include <ucm/api/ucm.h>
+#include <ucm/util/sys.h>
+
+
+/*
+ * Allocator-heavy workload, used to compare the overhead of the memory hook
+ * modes. Run it with UCX_MEM_MMAP_HOOK_MODE=none|reloc|bistro|uffd, or with
+ * UCX_MEM_EVENTS=no to measure the allocator without any hooks.
+ */
+
+
+#define DEFAULT_ITERATIONS 100000
+#define DEFAULT_MAX_SIZE   (256 * 1024)
+#define BATCH_SIZE         64
+#define MMAP_SIZE          (64 * 1024)
+
+
+typedef struct {
+    long           iterations;
+    size_t         max_size;
+    int            watch;
+    volatile long  num_events;
+} context_t;
+
+
+static void unmapped_callback(ucm_event_type_t event_type, ucm_event_t *event,
+                              void *arg)
+{
+    context_t *ctx = arg;
+
+    ++ctx->num_events;
+}
+
+/* Random size with a logarithmic distribution, so most of the allocations are
+ * small, while the largest ones are served by mmap() */
+static size_t random_size(size_t max_size)
+{
+    size_t size = 16ul << (rand() % 15);
+
+    return (size > max_size) ? max_size : size;
+}
+
+static double test_malloc(context_t *ctx)
+{
+    void *ptrs[BATCH_SIZE];
+    double start_time;
+    long iter;
+    int i;
+
+    start_time = ucm_get_time();
+    for (iter = 0; iter < ctx->iterations; iter += BATCH_SIZE) {
+        for (i = 0; i < BATCH_SIZE; ++i) {
+            ptrs[i] = malloc(random_size(ctx->max_size));
+            /* touch the memory so the allocator does not optimize it out */
+            *(volatile char*)ptrs[i] = 0;
+        }
+        for (i = 0; i < BATCH_SIZE; ++i) {
+            free(ptrs[i]);
+        }
+    }
+
+    return (ucm_get_time() - start_time) / iter;
+}
+
+static double test_mmap(context_t *ctx)
+{
+    double start_time;
+    long iter;
+    void *ptr;
+
+    start_time = ucm_get_time();
+    for (iter = 0; iter < ctx->iterations; ++iter) {
+        ptr = mmap(NULL, MMAP_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            printf("mmap() failed: %m\n");
+            return -1;
+        }
+
+        *(volatile char*)ptr = 0;
+        if (ctx->watch) {
+            (void)ucm_mem_watch(ptr, MMAP_SIZE);
+        }
+
+        munmap(ptr, MMAP_SIZE);
+    }
+
+    return (ucm_get_time() - start_time) / iter;
+}
+
+static void usage(const char *argv0)
+{
+    printf("Usage: %s [options]\n", argv0);
+    printf("Options:\n");
+    printf("  -n :  Number of allocations (default: %d)\n", DEFAULT_ITERATIONS);
+    printf("  -s :  Maximal allocation size (default: %d)\n", DEFAULT_MAX_SIZE);
+    printf("  -e :  Do not install a memory event handler\n");
+    printf("  -w :  Watch every mapped block with ucm_mem_watch()\n");
+    printf("  -h :  Display help message\n");
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    int set_handler = 1;
+    double malloc_time, mmap_time;
+    ucs_status_t status;
+    context_t ctx;
+    int c;
+
+    ctx.iterations = DEFAULT_ITERATIONS;
+    ctx.max_size   = DEFAULT_MAX_SIZE;
+    ctx.watch      = 0;
+    ctx.num_events = 0;
+
+    while ((c = getopt(argc, argv, "n:s:ewh")) != -1) {
+        switch (c) {
+        case 'n':
+            ctx.iterations = atol(optarg);
+            break;
+        case 's':
+            ctx.max_size = strtoul(optarg, NULL, 0);
+            break;
+        case 'e':
+            set_handler = 0;
+            break;
+        case 'w':
+            ctx.watch = 1;
+            break;
+        case 'h':
+        default:
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (set_handler) {
+        status = ucm_set_event_handler(UCM_EVENT_VM_UNMAPPED, 0,
+                                       unmapped_callback, &ctx);
+        printf("memory event handler: %s\n", ucs_status_string(status));
+    }
+
+    malloc_time = test_malloc(&ctx);
+    mmap_time   = test_mmap(&ctx);
+    if (mmap_time < 0) {
+        return -1;
+    }
+
+    printf("malloc+free:   %.1f nsec\n", malloc_time * 1e9);
+    printf("mmap+munmap:   %.1f nsec\n", mmap_time * 1e9);
+
+    /* events may be delivered asynchronously */
+    usleep(10000);
+    printf("unmap events:  %ld\n", ctx.num_events);
+
+    if (set_handler) {
+        ucm_unset_event_handler(UCM_EVENT_VM_UNMAPPED, unmapped_callback, &ctx);
+    }
+
+    return 0;
+}
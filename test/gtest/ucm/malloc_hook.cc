@@ -17,6 +17,7 @@
 #include <stdint.h>
 #include <dlfcn.h>
 #include <libgen.h>
+#include <sys/syscall.h>
 
 extern "C" {
 #include <ucs/time/time.h>
@@ -1239,6 +1240,142 @@ UCS_TEST_SKIP_COND_F(malloc_hook, test_event_unmap,
     EXPECT_TRUE(status == UCS_OK);
 }
 
+#if defined(HAVE_LINUX_USERFAULTFD_H) && HAVE_DECL_SYS_USERFAULTFD
+/*
+ * The hook mode is switched at runtime, so the tests can't run if BISTRO hooks
+ * are installed: the original functions would be called through the patched
+ * ones.
+ */
+class malloc_hook_uffd : public ucs::test {
+public:
+    malloc_hook_uffd() :
+        m_orig_mode(ucm_global_opts.mmap_hook_mode),
+        m_address(NULL),
+        m_size(0),
+        m_unmapped(0)
+    {
+    }
+
+    void mem_event(ucm_event_type_t event_type, ucm_event_t *event)
+    {
+        /* Count only the events of the tested range, since memory released
+         * by other threads is reported as well */
+        if ((event->vm_unmapped.address < UCS_PTR_BYTE_OFFSET(m_address,
+                                                               m_size)) &&
+            (UCS_PTR_BYTE_OFFSET(event->vm_unmapped.address,
+                                 event->vm_unmapped.size) > m_address)) {
+            ucs_atomic_add32(&m_unmapped, 1);
+        }
+    }
+
+protected:
+    virtual void init()
+    {
+        ucs_status_t status;
+
+        ucs::test::init();
+
+        ucm_global_opts.mmap_hook_mode = UCM_MMAP_HOOK_UFFD;
+        status = ucm_set_event_handler(UCM_EVENT_VM_UNMAPPED, 0,
+                                       event_callback, this);
+        if (status == UCS_ERR_UNSUPPORTED) {
+            ucm_global_opts.mmap_hook_mode = m_orig_mode;
+            UCS_TEST_SKIP_R("userfaultfd is not supported");
+        }
+        ASSERT_UCS_OK(status);
+    }
+
+    virtual void cleanup()
+    {
+        ucm_unset_event_handler(UCM_EVENT_VM_UNMAPPED, event_callback, this);
+        ucm_global_opts.mmap_hook_mode = m_orig_mode;
+        ucs::test::cleanup();
+    }
+
+    void *map_watched(size_t size)
+    {
+        m_size    = size;
+        m_address = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        EXPECT_NE(MAP_FAILED, m_address);
+        memset(m_address, 0, size);
+        EXPECT_UCS_OK(ucm_mem_watch(m_address, size));
+        return m_address;
+    }
+
+    /* Wait until the monitor thread reports another event of the range */
+    void wait_unmapped(uint32_t prev_count)
+    {
+        ucs_time_t deadline = ucs::get_deadline();
+
+        while ((m_unmapped == prev_count) && (ucs_get_time() < deadline)) {
+            sched_yield();
+        }
+        EXPECT_GT(m_unmapped, prev_count);
+    }
+
+    static void event_callback(ucm_event_type_t event_type, ucm_event_t *event,
+                               void *arg)
+    {
+        static_cast<malloc_hook_uffd*>(arg)->mem_event(event_type, event);
+    }
+
+    ucm_mmap_hook_mode_t m_orig_mode;
+    void                 *m_address;
+    size_t               m_size;
+    volatile uint32_t    m_unmapped;
+};
+
+/* Release memory with raw system calls, so only userfaultfd can report it */
+UCS_TEST_SKIP_COND_F(malloc_hook_uffd, unmap,
+                     RUNNING_ON_VALGRIND || skip_on_bistro()) {
+    size_t size   = ucs_get_page_size() * 4;
+    void *address = map_watched(size);
+    uint32_t prev_count;
+
+    prev_count = m_unmapped;
+    ASSERT_EQ(0, syscall(SYS_madvise, address, ucs_get_page_size(),
+                         MADV_DONTNEED));
+    wait_unmapped(prev_count);
+
+    prev_count = m_unmapped;
+    ASSERT_EQ(0, syscall(SYS_munmap, address, size));
+    wait_unmapped(prev_count);
+}
+
+UCS_TEST_SKIP_COND_F(malloc_hook_uffd, mremap,
+                     RUNNING_ON_VALGRIND || skip_on_bistro()) {
+    size_t size   = ucs_get_page_size() * 4;
+    void *address = map_watched(size);
+    uint32_t prev_count;
+    void *new_address;
+
+    prev_count  = m_unmapped;
+    new_address = (void*)syscall(SYS_mremap, address, size, size * 2,
+                                 MREMAP_MAYMOVE);
+    ASSERT_NE(MAP_FAILED, new_address);
+    if (new_address != address) {
+        wait_unmapped(prev_count);
+    }
+
+    syscall(SYS_munmap, new_address, size * 2);
+}
+
+UCS_TEST_SKIP_COND_F(malloc_hook_uffd, not_watched,
+                     RUNNING_ON_VALGRIND || skip_on_bistro()) {
+    size_t size = ucs_get_page_size();
+
+    m_size    = size;
+    m_address = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, m_address);
+
+    ASSERT_EQ(0, syscall(SYS_munmap, m_address, size));
+    usleep(10000);
+    EXPECT_EQ(0u, m_unmapped);
+}
+#endif
+
 class memtype_hooks : public ucs::test_with_param<ucs_memory_type_t> {
 public:
     void mem_event(ucm_event_type_t event_type, ucm_event_t *event)
@@ -5,7 +5,12 @@
  */
 
 #include "ucp_test.h"
+
+extern "C" {
 #include <ucp/core/ucp_context.h>
+#include <ucp/core/ucp_ep.h>
+#include <ucp/core/ucp_worker.h>
+}
 
 class test_ucp_ep : public ucp_test {
 public:
@@ -93,3 +98,112 @@ UCS_TEST_P(test_ucp_ep, ucp_query_transport)
 }
 
 UCP_INSTANTIATE_TEST_CASE(test_ucp_ep);
+
+
+class test_ucp_ep_idle : public test_ucp_ep {
+public:
+    /// @override
+    virtual void init()
+    {
+        modify_config("EP_IDLE_TIMEOUT", "10ms");
+        test_ucp_ep::init();
+    }
+
+protected:
+    void touch_lane_stats()
+    {
+        UCS_ASYNC_BLOCK(&sender().worker()->async);
+        ASSERT_TRUE(ucp_ep_lane_stats_get(sender().ep()) != NULL);
+        UCS_ASYNC_UNBLOCK(&sender().worker()->async);
+    }
+};
+
+UCS_TEST_P(test_ucp_ep_idle, release_cached_resources)
+{
+    ucp_worker_h worker = sender().worker();
+    ucp_ep_h ep         = sender().ep();
+
+    touch_lane_stats();
+
+    /* Used endpoint keeps its resources */
+    ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(0.1);
+    while (ucs_get_time() < deadline) {
+        touch_lane_stats();
+        progress();
+    }
+    EXPECT_TRUE(ep->ext->lane_stats != NULL);
+    EXPECT_EQ(0ul, worker->counters.ep_compactions);
+
+    /* Idle endpoint releases them */
+    wait_for_value(&ep->ext->lane_stats, (ucp_ep_lane_stats_t*)NULL);
+    EXPECT_TRUE(ep->ext->lane_stats == NULL);
+    EXPECT_EQ(1ul, worker->counters.ep_compactions);
+
+    /* And allocates again on next use */
+    touch_lane_stats();
+    EXPECT_TRUE(ep->ext->lane_stats != NULL);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_ep_idle);
+
+
+class test_ucp_ep_hot : public test_ucp_ep {
+public:
+    /// @override
+    virtual void init()
+    {
+        modify_config("HOT_EPS_NUM", "1");
+        modify_config("HOT_EPS_INTERVAL", "1ms");
+        test_ucp_ep::init();
+    }
+
+protected:
+    void send_recv(int ep_index)
+    {
+        uint64_t send_data = 0, recv_data = 0;
+        ucp_request_param_t param;
+
+        param.op_attr_mask = 0;
+        void *rreq = ucp_tag_recv_nbx(receiver().worker(), &recv_data,
+                                      sizeof(recv_data), 0, 0, &param);
+        void *sreq = ucp_tag_send_nbx(sender().ep(0, ep_index), &send_data,
+                                      sizeof(send_data), 0, &param);
+        ASSERT_UCS_OK(request_wait(sreq));
+        ASSERT_UCS_OK(request_wait(rreq));
+    }
+
+    /* Send on the endpoint until it becomes hot */
+    void promote(int ep_index)
+    {
+        ucp_ep_h ep         = sender().ep(0, ep_index);
+        ucs_time_t deadline = ucs_get_time() + ucs_time_from_sec(10.0);
+
+        while (!(ep->flags & UCP_EP_FLAG_HOT) &&
+               (ucs_get_time() < deadline)) {
+            send_recv(ep_index);
+            /* Operations on self transport may complete without progress */
+            progress();
+        }
+        ASSERT_TRUE(ep->flags & UCP_EP_FLAG_HOT);
+    }
+};
+
+UCS_TEST_P(test_ucp_ep_hot, promote_demote)
+{
+    ucp_worker_h worker = sender().worker();
+
+    /* Another endpoint to the same worker, tracked separately */
+    sender().connect(&receiver(), get_ep_params(), 1);
+
+    promote(0);
+    EXPECT_FALSE(sender().ep(0, 1)->flags & UCP_EP_FLAG_HOT);
+    EXPECT_EQ(1ul, worker->counters.ep_promotions);
+
+    /* The other endpoint becomes more active and replaces the hot one */
+    promote(1);
+    EXPECT_FALSE(sender().ep(0, 0)->flags & UCP_EP_FLAG_HOT);
+    EXPECT_EQ(2ul, worker->counters.ep_promotions);
+    EXPECT_EQ(1ul, worker->counters.ep_demotions);
+}
+
+UCP_INSTANTIATE_TEST_CASE(test_ucp_ep_hot);
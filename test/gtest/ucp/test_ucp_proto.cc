@@ -16,6 +16,7 @@ extern "C" {
 #include <ucp/proto/proto_debug.h>
 #include <ucs/datastruct/linear_func.h>
 #include <ucp/proto/proto_select.inl>
+#include <ucp/proto/proto_multi.inl>
 #include <ucp/core/ucp_worker.inl>
 }
 
@@ -148,6 +149,46 @@ UCS_TEST_P(test_ucp_proto, dump_protocols) {
     ucp_ep_print_info(sender().ep(), stdout);
 }
 
+UCS_TEST_P(test_ucp_proto, select_cache) {
+    static const unsigned num_iters = 16;
+    ucp_proto_select_param_t select_params[2];
+    ucp_memory_info_t mem_info;
+
+    mem_info.type    = UCS_MEMORY_TYPE_HOST;
+    mem_info.sys_dev = UCS_SYS_DEVICE_ID_UNKNOWN;
+    ucp_proto_select_param_init(&select_params[0], UCP_OP_ID_TAG_SEND, 0, 0,
+                                UCP_DATATYPE_CONTIG, &mem_info, 1);
+    ucp_proto_select_param_init(&select_params[1], UCP_OP_ID_TAG_SEND,
+                                UCP_OP_ATTR_FLAG_FAST_CMPL, 0,
+                                UCP_DATATYPE_CONTIG, &mem_info, 1);
+
+    ucp_worker_cfg_index_t ep_cfg_index = sender().ep()->cfg_index;
+    auto proto_select = &ucs_array_elem(&worker()->ep_config,
+                                        ep_cfg_index).proto_select;
+
+    ucp_proto_select_key_t key0, key1;
+    key0.param = select_params[0];
+    key1.param = select_params[1];
+    if (ucp_proto_select_cache_entry(proto_select, key0.u64) ==
+        ucp_proto_select_cache_entry(proto_select, key1.u64)) {
+        UCS_TEST_SKIP_R("selection keys use the same cache entry");
+    }
+
+    /* Alternating operation types should not evict each other */
+    for (unsigned i = 0; i < num_iters; ++i) {
+        auto thresh_elem = ucp_proto_select_lookup(worker(), proto_select,
+                                                   ep_cfg_index,
+                                                   UCP_WORKER_CFG_INDEX_NULL,
+                                                   &select_params[i % 2], 0);
+        EXPECT_NE(nullptr, thresh_elem);
+    }
+
+    EXPECT_EQ(key0.u64, ucp_proto_select_cache_entry(proto_select,
+                                                     key0.u64)->key);
+    EXPECT_EQ(key1.u64, ucp_proto_select_cache_entry(proto_select,
+                                                     key1.u64)->key);
+}
+
 UCS_TEST_P(test_ucp_proto, rkey_config) {
     ucp_rkey_config_key_t rkey_config_key = create_rkey_config_key(0);
     ucs_status_t status;
@@ -204,6 +245,69 @@ UCS_TEST_P(test_ucp_proto, dt_iter_mem_reg)
     }
 }
 
+static const size_t multi_frag_size = 1024;
+
+/* Lane 0 is always out of resources, other lanes send a fragment */
+static ucs_status_t
+multi_send_congested(ucp_request_t *req,
+                     const ucp_proto_multi_lane_priv_t *lpriv,
+                     ucp_datatype_iter_t *next_iter,
+                     ucp_lane_index_t *lane_shift)
+{
+    if (lpriv->super.lane == 0) {
+        return UCS_ERR_NO_RESOURCE;
+    }
+
+    *next_iter        = req->send.state.dt_iter;
+    next_iter->offset = req->send.state.dt_iter.offset + multi_frag_size;
+    return UCS_OK;
+}
+
+static ucs_status_t multi_complete(ucp_request_t *req)
+{
+    return UCS_OK;
+}
+
+UCS_TEST_P(test_ucp_proto, multi_adaptive_skip_lane)
+{
+    static const ucp_lane_index_t num_lanes = 2;
+    std::vector<char> mpriv_buf(sizeof(ucp_proto_multi_priv_t) +
+                                (num_lanes *
+                                 sizeof(ucp_proto_multi_lane_priv_t)), 0);
+    auto mpriv = reinterpret_cast<ucp_proto_multi_priv_t*>(&mpriv_buf[0]);
+    ucp_request_t req;
+
+    mpriv->num_lanes = num_lanes;
+    mpriv->adaptive  = 1;
+    for (ucp_lane_index_t i = 0; i < num_lanes; ++i) {
+        mpriv->lanes[i].super.lane = i;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.send.ep                     = sender().ep();
+    req.send.multi_lane_idx         = 0;
+    req.send.state.dt_iter.dt_class = UCP_DATATYPE_CONTIG;
+    req.send.state.dt_iter.length   = 2 * multi_frag_size;
+    req.send.state.dt_iter.offset   = 0;
+
+    /* Both fragments are sent on lane 1, since lane 0 is congested */
+    EXPECT_EQ(UCS_INPROGRESS,
+              ucp_proto_multi_progress(&req, mpriv, multi_send_congested,
+                                       multi_complete, UINT_MAX));
+    EXPECT_EQ(UCS_OK,
+              ucp_proto_multi_progress(&req, mpriv, multi_send_congested,
+                                       multi_complete, UINT_MAX));
+
+    const ucp_ep_lane_stats_t *lane_stats = sender().ep()->ext->lane_stats;
+    ASSERT_TRUE(lane_stats != NULL);
+    EXPECT_EQ(2u, lane_stats[0].stalls);
+    EXPECT_EQ(0u, lane_stats[0].frags);
+    EXPECT_EQ(0u, lane_stats[0].bytes);
+    EXPECT_EQ(0u, lane_stats[1].stalls);
+    EXPECT_EQ(2u, lane_stats[1].frags);
+    EXPECT_EQ(2 * multi_frag_size, lane_stats[1].bytes);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_proto)
 UCP_INSTANTIATE_TEST_CASE_TLS_GPU_AWARE(test_ucp_proto, shm_ipc,
                                         "shm,cuda_ipc,rocm_ipc")
@@ -343,3 +447,73 @@ UCS_TEST_P(test_perf_node, replace_null)
 }
 
 UCP_INSTANTIATE_TEST_CASE_TLS(test_perf_node, all, "all")
+
+class test_ucp_proto_calib : public test_ucp_proto {
+protected:
+    virtual void init() {
+        char filename[] = "/tmp/ucp_proto_calib.XXXXXX";
+        int fd          = mkstemp(filename);
+        ASSERT_GE(fd, 0);
+
+        std::string calib = "# calibration test\n"
+                            "*/* am_bcopy lat=3us bw=1000MBs\n"
+                            "*/* am_bcopy lat=5us send_post=7ns\n"
+                            "*/* put_zcopy send_pre=500ns"
+                            " sample=1000:2us sample=1001000:1002us\n";
+        ASSERT_EQ((ssize_t)calib.size(),
+                  write(fd, calib.c_str(), calib.size()));
+        close(fd);
+
+        m_filename = filename;
+        modify_config("PROTO_PERF_CALIB_FILE", m_filename);
+        test_ucp_proto::init();
+    }
+
+    virtual void cleanup() {
+        test_ucp_proto::cleanup();
+        unlink(m_filename.c_str());
+    }
+
+    void estimate_perf(ucp_rsc_index_t rsc_index, uct_ep_operation_t op,
+                       uct_perf_attr_t *perf_attr)
+    {
+        ucp_worker_iface_t *wiface = ucp_worker_iface(worker(), rsc_index);
+
+        perf_attr->field_mask = UCT_PERF_ATTR_FIELD_OPERATION |
+                                UCT_PERF_ATTR_FIELD_SEND_PRE_OVERHEAD |
+                                UCT_PERF_ATTR_FIELD_SEND_POST_OVERHEAD |
+                                UCT_PERF_ATTR_FIELD_RECV_OVERHEAD |
+                                UCT_PERF_ATTR_FIELD_BANDWIDTH |
+                                UCT_PERF_ATTR_FIELD_LATENCY;
+        perf_attr->operation  = op;
+        ASSERT_UCS_OK(uct_iface_estimate_perf(wiface->iface, perf_attr));
+        ucp_proto_calib_apply(context(), rsc_index, perf_attr);
+    }
+
+private:
+    std::string m_filename;
+};
+
+UCS_TEST_P(test_ucp_proto_calib, apply)
+{
+    ucp_rsc_index_t rsc_index;
+    uct_perf_attr_t perf_attr;
+
+    ASSERT_EQ(3u, ucs_array_length(&context()->proto_calib));
+
+    UCS_BITMAP_FOR_EACH_BIT(context()->tl_bitmap, rsc_index) {
+        estimate_perf(rsc_index, UCT_EP_OP_AM_BCOPY, &perf_attr);
+        EXPECT_NEAR(3e-6, perf_attr.latency.c, 1e-12);
+        EXPECT_NEAR(1000.0 * UCS_MBYTE, perf_attr.bandwidth.dedicated, 1.0);
+        EXPECT_EQ(0.0, perf_attr.bandwidth.shared);
+        EXPECT_NEAR(7e-9, perf_attr.send_post_overhead, 1e-15);
+
+        estimate_perf(rsc_index, UCT_EP_OP_PUT_ZCOPY, &perf_attr);
+        EXPECT_NEAR(5e-7, perf_attr.send_pre_overhead, 1e-12);
+        /* The samples fit 1us + 1ns/byte, minus the send overhead */
+        EXPECT_NEAR(5e-7, perf_attr.latency.c, 1e-12);
+        EXPECT_NEAR(1e9, perf_attr.bandwidth.dedicated, 1e3);
+    }
+}
+
+UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_proto_calib, all, "all")
@@ -573,7 +573,8 @@ public:
         RNDV_SCHEME_GET_ZCOPY,
         RNDV_SCHEME_LAST,
         RNDV_GET_ZCOPY_MANY_LANES,
-        PUT_ZCOPY_FLUSH = DISABLE_PROTO << 1
+        PUT_ZCOPY_FLUSH = DISABLE_PROTO << 1,
+        ADAPTIVE_STRIPING = DISABLE_PROTO << 2
     };
 
     static const std::string rndv_schemes[];
@@ -584,9 +585,13 @@ public:
         modify_config("RNDV_THRESH", "0");
         modify_config("RNDV_SCHEME", rndv_schemes[rndv_scheme()]);
         modify_config("RNDV_PUT_FORCE_FLUSH", force_flush() ? "y" : "n");
-        if (get_variant_value() & RNDV_GET_ZCOPY_MANY_LANES) {
+        if (get_variant_value() & (RNDV_GET_ZCOPY_MANY_LANES |
+                                   ADAPTIVE_STRIPING)) {
             modify_config("MAX_RNDV_LANES", "3");
         }
+        if (get_variant_value() & ADAPTIVE_STRIPING) {
+            modify_config("RNDV_ADAPTIVE_STRIPING", "y");
+        }
         test_ucp_tag_match::init();
     }
 
@@ -609,6 +614,13 @@ public:
                                RNDV_SCHEME_GET_ZCOPY | DISABLE_PROTO |
                                        RNDV_GET_ZCOPY_MANY_LANES,
                                "rndv_get_zcopy,proto_v1,many_lanes");
+        // Add variants with adaptive multi-lane striping
+        add_variant_with_value(variants, get_ctx_params(),
+                               RNDV_SCHEME_GET_ZCOPY | ADAPTIVE_STRIPING,
+                               "rndv_get_zcopy,adaptive");
+        add_variant_with_value(variants, get_ctx_params(),
+                               RNDV_SCHEME_PUT_ZCOPY | ADAPTIVE_STRIPING,
+                               "rndv_put_zcopy,adaptive");
     }
 
 protected:
@@ -965,6 +977,61 @@ UCS_TEST_P(test_ucp_tag_match_rndv, bidir_multi_exp_post,
     }
 }
 
+UCS_TEST_P(test_ucp_tag_match_rndv, adaptive_lane_stats)
+{
+    static const size_t size = 4 * UCS_MBYTE;
+    ucp_tag_recv_info_t info;
+    ucs_status_t status;
+    request *my_send_req;
+
+    if (!(get_variant_value() & ADAPTIVE_STRIPING)) {
+        UCS_TEST_SKIP_R("adaptive striping is disabled");
+    }
+
+    std::vector<char> sendbuf(size, 0);
+    std::vector<char> recvbuf(size, 0);
+    ucs::fill_random(sendbuf);
+
+    my_send_req = send_nb(&sendbuf[0], sendbuf.size(), DATATYPE, 0x111337);
+    ASSERT_TRUE(!UCS_PTR_IS_ERR(my_send_req));
+    status = recv_b(&recvbuf[0], recvbuf.size(), DATATYPE, 0x1337, 0xffff,
+                    &info);
+    ASSERT_UCS_OK(status);
+    wait_and_validate(my_send_req);
+    EXPECT_EQ(sendbuf, recvbuf);
+
+    /* Bulk data is fetched by the receiver with get, and pushed by the sender
+     * with put. The receiver uses the endpoint created by wireup. */
+    entity &e = (rndv_scheme() == RNDV_SCHEME_GET_ZCOPY) ? receiver() :
+                                                           sender();
+    size_t total_bytes = 0;
+    unsigned num_used  = 0;
+    bool found         = false;
+    ucp_ep_ext_t *ep_ext;
+
+    ucs_list_for_each(ep_ext, &e.worker()->all_eps, ep_list) {
+        const ucp_ep_lane_stats_t *lane_stats = ep_ext->lane_stats;
+        if (lane_stats == NULL) {
+            continue;
+        }
+
+        found = true;
+        for (ucp_lane_index_t lane = 0; lane < UCP_MAX_LANES; ++lane) {
+            EXPECT_EQ(lane_stats[lane].bytes == 0, lane_stats[lane].frags == 0)
+                    << "lane " << (int)lane;
+            total_bytes += lane_stats[lane].bytes;
+            num_used    += (lane_stats[lane].frags > 0);
+        }
+    }
+
+    if (!found) {
+        UCS_TEST_SKIP_R("rendezvous protocol uses a single lane");
+    }
+
+    EXPECT_EQ(size, total_bytes);
+    EXPECT_GE(num_used, 1u);
+}
+
 UCP_INSTANTIATE_TEST_CASE(test_ucp_tag_match_rndv)
 UCP_INSTANTIATE_TEST_CASE_TLS(test_ucp_tag_match_rndv, mm_tcp, "posix,sysv,tcp")
 
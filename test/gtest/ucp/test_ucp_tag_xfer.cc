@@ -30,7 +30,9 @@ public:
         VARIANT_RNDV_AM_BCOPY,
         VARIANT_RNDV_AM_ZCOPY,
         VARIANT_SEND_NBR,
-        VARIANT_PROTO_V1
+        VARIANT_PROTO_V1,
+        VARIANT_RNDV_GET_PPLN,
+        VARIANT_RNDV_PUT_PPLN
     };
 
     test_ucp_tag_xfer() {
@@ -60,6 +62,13 @@ public:
             modify_config("ZCOPY_THRESH", "0");
         } else if (get_variant_value() == VARIANT_PROTO_V1) {
             modify_config("PROTO_ENABLE", "n");
+        } else if (get_variant_value() == VARIANT_RNDV_GET_PPLN) {
+            /* Non-contiguous data is staged through host bounce buffers */
+            modify_config("RNDV_SCHEME", "get_ppln");
+            modify_config("RNDV_FRAG_SIZE", "host:64K");
+        } else if (get_variant_value() == VARIANT_RNDV_PUT_PPLN) {
+            modify_config("RNDV_SCHEME", "put_ppln");
+            modify_config("RNDV_FRAG_SIZE", "host:64K");
         }
 
         /* Init number of lanes according to test requirement
@@ -93,6 +102,10 @@ public:
                                VARIANT_RNDV_AM_ZCOPY, "rndv_am_zcopy");
         add_variant_with_value(variants, get_ctx_params(),
                                VARIANT_SEND_NBR, "send_nbr");
+        add_variant_with_value(variants, get_ctx_params(),
+                               VARIANT_RNDV_GET_PPLN, "rndv_get_ppln");
+        add_variant_with_value(variants, get_ctx_params(),
+                               VARIANT_RNDV_PUT_PPLN, "rndv_put_ppln");
         if (!RUNNING_ON_VALGRIND) {
             add_variant_with_value(variants, get_ctx_params(), VARIANT_PROTO_V1,
                                    "proto_v1");
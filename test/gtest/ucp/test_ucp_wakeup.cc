@@ -6,6 +6,10 @@
 
 #include "ucp_test.h"
 
+extern "C" {
+#include <ucp/core/ucp_worker.h>
+}
+
 #include <algorithm>
 #include <sys/epoll.h>
 #include <sys/poll.h>
@@ -42,6 +46,32 @@ protected:
         ASSERT_EQ(UCS_OK, status);
     }
 
+    /* Signals the worker from another thread after a delay */
+    class delayed_signal {
+    public:
+        delayed_signal(ucp_worker_h worker, double delay_sec) :
+            m_worker(worker), m_delay_sec(delay_sec) {
+            pthread_create(&m_thread, NULL, run, reinterpret_cast<void*>(this));
+        }
+
+        ~delayed_signal() {
+            pthread_join(m_thread, NULL);
+        }
+
+    private:
+        static void* run(void *arg) {
+            delayed_signal *self = reinterpret_cast<delayed_signal*>(arg);
+
+            usleep(self->m_delay_sec * UCS_USEC_PER_SEC);
+            EXPECT_UCS_OK(ucp_worker_signal(self->m_worker));
+            return NULL;
+        }
+
+        ucp_worker_h m_worker;
+        double       m_delay_sec;
+        pthread_t    m_thread;
+    };
+
     static size_t comp_cntr;
 };
 
@@ -148,6 +178,74 @@ UCS_TEST_SKIP_COND_P(test_ucp_wakeup, tx_wait, has_transport("tcp"),
     EXPECT_EQ(send_data, recv_data);
 }
 
+UCS_TEST_P(test_ucp_wakeup, wait_spin_adjust, "WAIT_SPIN_MAX=200ms")
+{
+    ucp_worker_h worker = sender().worker();
+    ucs_time_t spin_max = worker->context->config.ext.wait_spin_max;
+
+    EXPECT_EQ(spin_max, worker->wait_spin.budget);
+
+    /* The event arrives long after the spin time elapsed, so the spin time
+     * shrinks */
+    {
+        delayed_signal signal(worker, 1.0);
+        ASSERT_UCS_OK(ucp_worker_wait(worker));
+    }
+    EXPECT_EQ(spin_max / 2, worker->wait_spin.budget);
+
+    /* Consume the signal */
+    arm(worker);
+
+    /* The event arrives after the spin time elapsed, but within the maximal
+     * spin time, so the spin time grows */
+    {
+        delayed_signal signal(worker, 0.15);
+        ASSERT_UCS_OK(ucp_worker_wait(worker));
+    }
+    EXPECT_EQ((spin_max / 2) * 2, worker->wait_spin.budget);
+}
+
+UCS_TEST_P(test_ucp_wakeup, wait_spin_no_arm, "WAIT_SPIN_MAX=1s")
+{
+    const ucp_datatype_t DATATYPE = ucp_dt_make_contig(1);
+    const uint64_t TAG            = 0xdeadbeef;
+    ucp_worker_h worker           = receiver().worker();
+    ucs_time_t spin_max           = worker->context->config.ext.wait_spin_max;
+    uint64_t send_data            = 0x12121212;
+    uint64_t recv_data            = 0;
+    ucs_time_t start;
+    void *sreq, *rreq;
+
+    sender().connect(&receiver(), get_ep_params());
+    flush_workers();
+
+    rreq = ucp_tag_recv_nb(worker, &recv_data, sizeof(recv_data), DATATYPE,
+                           TAG, (ucp_tag_t)-1, recv_completion);
+    sreq = ucp_tag_send_nb(sender().ep(), &send_data, sizeof(send_data),
+                           DATATYPE, TAG, send_completion);
+    ASSERT_FALSE(UCS_PTR_IS_ERR(sreq));
+
+    /* The signal is consumed only if the worker is armed */
+    ASSERT_UCS_OK(ucp_worker_signal(worker));
+
+    start = ucs_get_time();
+    while (!ucp_request_is_completed(rreq)) {
+        ASSERT_UCS_OK(ucp_worker_wait(worker));
+    }
+
+    /* The message was received by spinning, without arming the worker and
+     * sleeping */
+    EXPECT_LT(ucs_get_time() - start, spin_max);
+    EXPECT_EQ(UCS_ERR_BUSY, ucp_worker_arm(worker));
+    EXPECT_EQ(spin_max, worker->wait_spin.budget);
+    EXPECT_EQ(send_data, recv_data);
+
+    ucp_request_release(rreq);
+    if (sreq != NULL) {
+        wait(sreq);
+    }
+}
+
 UCS_TEST_P(test_ucp_wakeup, signal)
 {
     int efd;
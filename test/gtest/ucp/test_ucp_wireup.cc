@@ -505,6 +505,130 @@ UCS_TEST_P(test_ucp_wireup_1sided, address) {
     ASSERT_TRUE(packed_sys_devices == unpacked_sys_devices);
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, address_cache) {
+    const unsigned unpack_flags = UCP_ADDRESS_PACK_FLAGS_ALL &
+                                  ~UCP_ADDRESS_PACK_FLAG_EP_ADDR;
+    ucp_object_version_t addr_v = address_version();
+    ucp_unpacked_address unpacked_address[2];
+    unsigned packed_count, unpacked_count, init_unpacked_count;
+    ucs_status_t status;
+    size_t size[2];
+    void *buffer[2];
+
+    /* Memory type endpoints may have cached their addresses already */
+    ucp_address_cache_count(sender().worker(), &packed_count,
+                            &init_unpacked_count);
+
+    for (int i = 0; i < 2; ++i) {
+        status = ucp_address_pack(sender().worker(), NULL, &ucp_tl_bitmap_max,
+                                  0, UCP_ADDRESS_PACK_FLAGS_ALL, addr_v, NULL,
+                                  UINT_MAX, &size[i], &buffer[i]);
+        ASSERT_UCS_OK(status);
+    }
+
+    /* The second address is a copy of the cached one */
+    EXPECT_TRUE(sender().worker()->address_cache != NULL);
+    EXPECT_NE(buffer[0], buffer[1]);
+    ASSERT_EQ(size[0], size[1]);
+    EXPECT_EQ(0, memcmp(buffer[0], buffer[1], size[0]));
+
+    /* Addresses unpacked with endpoint addresses are not kept */
+    status = ucp_address_unpack(sender().worker(), buffer[0],
+                                UCP_ADDRESS_PACK_FLAGS_ALL,
+                                &unpacked_address[0]);
+    ASSERT_UCS_OK(status);
+    ucs_free(unpacked_address[0].address_list);
+    ucp_address_cache_count(sender().worker(), &packed_count, &unpacked_count);
+    EXPECT_EQ(init_unpacked_count, unpacked_count);
+
+    for (int i = 0; i < 2; ++i) {
+        status = ucp_address_unpack(sender().worker(), buffer[i], unpack_flags,
+                                    &unpacked_address[i]);
+        ASSERT_UCS_OK(status);
+    }
+
+    ucp_address_cache_count(sender().worker(), &packed_count, &unpacked_count);
+    EXPECT_EQ(init_unpacked_count + 1, unpacked_count);
+
+    /* The memoized address must refer to the buffer it was unpacked from */
+    EXPECT_EQ(unpacked_address[0].uuid, unpacked_address[1].uuid);
+    ASSERT_EQ(unpacked_address[0].address_count,
+              unpacked_address[1].address_count);
+    for (unsigned i = 0; i < unpacked_address[1].address_count; ++i) {
+        const ucp_address_entry_t *ae0 = &unpacked_address[0].address_list[i];
+        const ucp_address_entry_t *ae1 = &unpacked_address[1].address_list[i];
+
+        EXPECT_EQ(ae0->tl_name_csum, ae1->tl_name_csum);
+        EXPECT_EQ(ae0->dev_index, ae1->dev_index);
+        EXPECT_EQ(ae0->iface_attr.flags, ae1->iface_attr.flags);
+        ASSERT_EQ(ae0->dev_addr_len, ae1->dev_addr_len);
+        if (ae1->dev_addr != NULL) {
+            EXPECT_EQ(UCS_PTR_BYTE_DIFF(buffer[0], ae0->dev_addr),
+                      UCS_PTR_BYTE_DIFF(buffer[1], ae1->dev_addr));
+        }
+        if (ae1->iface_addr != NULL) {
+            EXPECT_EQ(UCS_PTR_BYTE_DIFF(buffer[0], ae0->iface_addr),
+                      UCS_PTR_BYTE_DIFF(buffer[1], ae1->iface_addr));
+        }
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        ucs_free(unpacked_address[i].address_list);
+        ucs_free(buffer[i]);
+    }
+}
+
+UCS_TEST_P(test_ucp_wireup_1sided, address_cache_invalidate) {
+    const unsigned unpack_flags = UCP_ADDRESS_PACK_FLAGS_ALL &
+                                  ~UCP_ADDRESS_PACK_FLAG_EP_ADDR;
+    ucp_worker_h worker         = sender().worker();
+    ucp_unpacked_address unpacked_address;
+    unsigned packed_count, unpacked_count;
+    ucp_tl_bitmap_t coll_tl_bitmap;
+    ucs_status_t status;
+    size_t size;
+    void *buffer;
+
+    status = ucp_address_pack(worker, NULL, &ucp_tl_bitmap_max, 0,
+                              UCP_ADDRESS_PACK_FLAGS_ALL, address_version(),
+                              NULL, UINT_MAX, &size, &buffer);
+    ASSERT_UCS_OK(status);
+
+    status = ucp_address_unpack(worker, buffer, unpack_flags,
+                                &unpacked_address);
+    ASSERT_UCS_OK(status);
+    ucs_free(unpacked_address.address_list);
+
+    ucp_address_cache_count(worker, &packed_count, &unpacked_count);
+    EXPECT_GE(packed_count, 1u);
+    EXPECT_GE(unpacked_count, 1u);
+
+    /* Removing worker interfaces drops the cached addresses */
+    UCS_BITMAP_CLEAR(&coll_tl_bitmap);
+    ucp_worker_del_resource_ifaces(worker, 0, coll_tl_bitmap);
+    ucp_address_cache_count(worker, &packed_count, &unpacked_count);
+    EXPECT_EQ(0u, packed_count);
+    EXPECT_EQ(0u, unpacked_count);
+
+    /* The address is packed and unpacked again after invalidation */
+    status = ucp_address_unpack(worker, buffer, unpack_flags,
+                                &unpacked_address);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(worker->uuid, unpacked_address.uuid);
+    ucs_free(unpacked_address.address_list);
+    ucs_free(buffer);
+
+    status = ucp_address_pack(worker, NULL, &ucp_tl_bitmap_max, 0,
+                              UCP_ADDRESS_PACK_FLAGS_ALL, address_version(),
+                              NULL, UINT_MAX, &size, &buffer);
+    ASSERT_UCS_OK(status);
+    ucs_free(buffer);
+
+    ucp_address_cache_count(worker, &packed_count, &unpacked_count);
+    EXPECT_EQ(1u, packed_count);
+    EXPECT_EQ(1u, unpacked_count);
+}
+
 UCS_TEST_P(test_ucp_wireup_1sided, ep_address, "IB_NUM_PATHS?=2") {
     ucs_status_t status;
     size_t size;
@@ -601,6 +725,40 @@ UCS_TEST_P(test_ucp_wireup_1sided, multi_wireup) {
     }
 }
 
+UCS_TEST_P(test_ucp_wireup_1sided, multi_wireup_select_cache) {
+    skip_loopback();
+
+    const size_t count = 4;
+    while (entities().size() < count) {
+        create_entity();
+    }
+
+    ucp_worker_h worker = sender().worker();
+    uint64_t hits       = worker->counters.lanes_select_cache_hits;
+    uint64_t misses     = worker->counters.lanes_select_cache_misses;
+
+    /* All peers have the same transports and devices, so only the first
+     * connection runs the lanes selection */
+    for (size_t i = 1; i < count; ++i) {
+        sender().connect(&entities().at(i), get_ep_params(), i);
+    }
+
+    EXPECT_GE(worker->counters.lanes_select_cache_misses, misses + 1);
+    EXPECT_GE(worker->counters.lanes_select_cache_hits, hits + count - 2);
+
+    /* The cached lanes are the same as selected without the cache */
+    modify_config("LANES_SELECT_CACHE", "n");
+    entity *uncached = create_entity();
+    for (size_t i = 1; i < count; ++i) {
+        uncached->connect(&entities().at(i), get_ep_params(), i);
+        /* The endpoints are stored in connection order */
+        EXPECT_TRUE(ucp_ep_config_is_equal(
+                            &ucp_ep_config(sender().ep(0, i - 1))->key,
+                            &ucp_ep_config(uncached->ep(0, i - 1))->key))
+                << "peer " << i;
+    }
+}
+
 UCS_TEST_P(test_ucp_wireup_1sided, stress_connect) {
     for (int i = 0; i < 30; ++i) {
         sender().connect(&receiver(), get_ep_params());
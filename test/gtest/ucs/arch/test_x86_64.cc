@@ -14,9 +14,27 @@ extern "C" {
 }
 
 #include <sys/mman.h>
+#include <algorithm>
+#include <vector>
 
 class test_arch : public ucs::test {
 protected:
+    /* restores the threshold also when an assertion fails */
+    class scoped_nt_memcpy_min {
+    public:
+        scoped_nt_memcpy_min(size_t value) :
+            m_prev_value(ucs_global_opts.arch.nt_memcpy_min) {
+            ucs_global_opts.arch.nt_memcpy_min = value;
+        }
+
+        ~scoped_nt_memcpy_min() {
+            ucs_global_opts.arch.nt_memcpy_min = m_prev_value;
+        }
+
+    private:
+        const size_t m_prev_value;
+    };
+
     /* have to add wrapper for ucs_memcpy_relaxed because pure "C" inline call could
      * not be used as template argument */
     static inline void *memcpy_relaxed(void *dst, const void *src, size_t size)
@@ -102,4 +120,32 @@ UCS_TEST_SKIP_COND_F(test_arch, memcpy, RUNNING_ON_VALGRIND || !ucs::perf_retry_
     }
 }
 
+UCS_TEST_F(test_arch, memcpy_nt) {
+    const size_t max_size = 4 * UCS_KBYTE;
+    std::vector<uint8_t> src(max_size + 64), dst(max_size + 128);
+
+    for (size_t i = 0; i < src.size(); ++i) {
+        src[i] = ucs::rand();
+    }
+
+    /* force the non-temporal copy for all lengths */
+    scoped_nt_memcpy_min nt_memcpy_min(0);
+    for (size_t size = 0; size <= max_size; size += 1 + (size / 7)) {
+        for (size_t src_offset = 0; src_offset < 64; src_offset += 13) {
+            for (size_t dst_offset = 0; dst_offset < 64; dst_offset += 5) {
+                std::fill(dst.begin(), dst.end(), 0xff);
+                ucs_memcpy_relaxed(&dst[dst_offset], &src[src_offset], size);
+                ASSERT_EQ(0, memcmp(&dst[dst_offset], &src[src_offset], size))
+                        << "size " << size << " src_offset " << src_offset
+                        << " dst_offset " << dst_offset;
+                /* bytes around the destination were not modified */
+                for (size_t i = 0; i < dst_offset; ++i) {
+                    ASSERT_EQ(0xff, dst[i]);
+                }
+                ASSERT_EQ(0xff, dst[dst_offset + size]);
+            }
+        }
+    }
+}
+
 #endif
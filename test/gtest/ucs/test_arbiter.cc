@@ -12,6 +12,7 @@ extern "C" {
 #include <ucs/sys/sys.h>
 #include <ucs/datastruct/arbiter.h>
 }
+#include <algorithm>
 #include <set>
 
 class test_arbiter : public ucs::test {
@@ -752,7 +753,8 @@ UCS_TEST_F(test_arbiter, result_stop) {
     for (int i = 0; i < N + 3; i++) {
        ucs_arbiter_dispatch(&m_arb1, 1, stop_cb, this);
        /* arbiter current position must not change on STOP */
-       EXPECT_EQ(m_arb1.list.next, &groups[0].tail->next->list);
+       EXPECT_EQ(m_arb1.list[UCS_ARBITER_PRIO_NORMAL].next,
+                 &groups[0].tail->next->list);
     }
 
     m_count = 0;
@@ -765,6 +767,315 @@ UCS_TEST_F(test_arbiter, result_stop) {
     delete [] elems;
 }
 
+static ucs_arbiter_cb_result_t next_elem_cb(ucs_arbiter_t *arbiter,
+                                            ucs_arbiter_group_t *group,
+                                            ucs_arbiter_elem_t *elem,
+                                            void *arg)
+{
+    std::vector<ucs_arbiter_elem_t*> *elems =
+            (std::vector<ucs_arbiter_elem_t*>*)arg;
+    ucs_arbiter_elem_t *next;
+    size_t i;
+
+    /* the dispatched element is the first one which was not removed yet */
+    i = std::find(elems->begin(), elems->end(), elem) - elems->begin();
+    EXPECT_LT(i, elems->size());
+
+    for (next = ucs_arbiter_group_next_elem(group, NULL); next != NULL;
+         next = ucs_arbiter_group_next_elem(group, next)) {
+        ++i;
+        EXPECT_LT(i, elems->size());
+        EXPECT_EQ((*elems)[i], next);
+    }
+
+    EXPECT_EQ(elems->size() - 1, i);
+    return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+}
+
+UCS_TEST_F(test_arbiter, next_elem) {
+    const int nelems = 4;
+    std::vector<ucs_arbiter_elem_t*> elem_ptrs;
+    ucs_arbiter_group_t group;
+    ucs_arbiter_elem_t elems[nelems];
+
+    ucs_arbiter_init(&m_arb1);
+    ucs_arbiter_group_init(&group);
+    for (int i = 0; i < nelems; i++) {
+        ucs_arbiter_elem_init(&elems[i]);
+        ucs_arbiter_group_push_elem(&group, &elems[i]);
+        elem_ptrs.push_back(&elems[i]);
+    }
+
+    EXPECT_EQ(&elems[1], ucs_arbiter_group_next_elem(&group, NULL));
+    EXPECT_EQ(&elems[2], ucs_arbiter_group_next_elem(&group, &elems[1]));
+    EXPECT_TRUE(ucs_arbiter_group_next_elem(&group, &elems[nelems - 1]) ==
+                NULL);
+
+    ucs_arbiter_group_schedule(&m_arb1, &group);
+    ucs_arbiter_dispatch(&m_arb1, nelems, next_elem_cb, &elem_ptrs);
+    EXPECT_TRUE(ucs_arbiter_group_is_empty(&group));
+
+    ucs_arbiter_group_cleanup(&group);
+    ucs_arbiter_cleanup(&m_arb1);
+}
+
+static ucs_arbiter_cb_result_t prio_order_cb(ucs_arbiter_t *arbiter,
+                                             ucs_arbiter_group_t *group,
+                                             ucs_arbiter_elem_t *elem,
+                                             void *arg)
+{
+    std::vector<ucs_arbiter_group_t*> *order =
+            (std::vector<ucs_arbiter_group_t*>*)arg;
+
+    order->push_back(group);
+    return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+}
+
+UCS_TEST_F(test_arbiter, prio_classes) {
+    const int nelems = 10;
+    ucs_arbiter_group_t groups[UCS_ARBITER_PRIO_LAST];
+    ucs_arbiter_elem_t elems[UCS_ARBITER_PRIO_LAST][nelems];
+    std::vector<ucs_arbiter_group_t*> order;
+    ucs_arbiter_group_t *expected;
+    int prio;
+
+    ucs_arbiter_init(&m_arb1);
+
+    /* schedule the lowest class first */
+    for (prio = UCS_ARBITER_PRIO_LAST - 1; prio >= 0; --prio) {
+        ucs_arbiter_group_init(&groups[prio]);
+        for (int i = 0; i < nelems; i++) {
+            ucs_arbiter_elem_init(&elems[prio][i]);
+            ucs_arbiter_group_push_elem_prio(&m_arb1, &groups[prio],
+                                             &elems[prio][i],
+                                             (ucs_arbiter_prio_t)prio);
+        }
+        EXPECT_EQ(prio, ucs_arbiter_group_prio(&groups[prio]));
+        ucs_arbiter_group_schedule(&m_arb1, &groups[prio]);
+    }
+
+    ucs_arbiter_dispatch(&m_arb1, 1, prio_order_cb, &order);
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb1));
+    ASSERT_EQ(size_t(UCS_ARBITER_PRIO_LAST * nelems), order.size());
+
+    /* strict priority class goes first */
+    for (int i = 0; i < nelems; i++) {
+        EXPECT_EQ(&groups[UCS_ARBITER_PRIO_HIGH], order[i]) << i;
+    }
+
+    /* the weighted classes share the dispatch cycles */
+    for (int i = 0; i < nelems; i++) {
+        prio     = ((i % (UCS_ARBITER_PRIO_NORMAL_WEIGHT +
+                          UCS_ARBITER_PRIO_BULK_WEIGHT)) <
+                    UCS_ARBITER_PRIO_NORMAL_WEIGHT) ?
+                   UCS_ARBITER_PRIO_NORMAL : UCS_ARBITER_PRIO_BULK;
+        expected = &groups[prio];
+        EXPECT_EQ(expected, order[nelems + i]) << i;
+    }
+
+    for (prio = 0; prio < UCS_ARBITER_PRIO_LAST; prio++) {
+        ucs_arbiter_group_cleanup(&groups[prio]);
+    }
+    ucs_arbiter_cleanup(&m_arb1);
+}
+
+UCS_TEST_F(test_arbiter, prio_raise) {
+    const int ngroups = 4;
+    ucs_arbiter_group_t groups[ngroups];
+    ucs_arbiter_elem_t elems[ngroups];
+    ucs_arbiter_elem_t high_elem, bulk_elem;
+    std::vector<ucs_arbiter_group_t*> order;
+
+    ucs_arbiter_init(&m_arb1);
+    prepare_groups(groups, elems, ngroups, 1, false);
+
+    /* raise the class of the last group while it's scheduled */
+    ucs_arbiter_elem_init(&high_elem);
+    ucs_arbiter_group_push_elem_prio(&m_arb1, &groups[ngroups - 1], &high_elem,
+                                     UCS_ARBITER_PRIO_HIGH);
+    EXPECT_EQ(UCS_ARBITER_PRIO_HIGH,
+              ucs_arbiter_group_prio(&groups[ngroups - 1]));
+
+    /* a lower priority hint does not lower the class of the group */
+    ucs_arbiter_elem_init(&bulk_elem);
+    ucs_arbiter_group_push_elem_prio(&m_arb1, &groups[0], &bulk_elem,
+                                     UCS_ARBITER_PRIO_BULK);
+    EXPECT_EQ(UCS_ARBITER_PRIO_NORMAL, ucs_arbiter_group_prio(&groups[0]));
+
+    ucs_arbiter_dispatch(&m_arb1, 1, prio_order_cb, &order);
+    ASSERT_EQ(size_t(ngroups + 2), order.size());
+    EXPECT_EQ(&groups[ngroups - 1], order[0]);
+    EXPECT_EQ(&groups[ngroups - 1], order[1]);
+    for (int i = 0; i < ngroups - 1; i++) {
+        EXPECT_EQ(&groups[i], order[i + 2]) << i;
+    }
+    EXPECT_EQ(&groups[0], order[ngroups + 1]);
+
+    /* an empty group returns to the default class */
+    ucs_arbiter_elem_init(&elems[0]);
+    ucs_arbiter_group_push_elem(&groups[ngroups - 1], &elems[0]);
+    EXPECT_EQ(UCS_ARBITER_PRIO_NORMAL,
+              ucs_arbiter_group_prio(&groups[ngroups - 1]));
+    ucs_arbiter_group_schedule(&m_arb1, &groups[ngroups - 1]);
+
+    /* zero weight makes the normal class strict */
+    ucs_arbiter_set_weight(&m_arb1, UCS_ARBITER_PRIO_NORMAL, 0);
+    ucs_arbiter_elem_init(&elems[1]);
+    ucs_arbiter_group_push_elem_prio(&m_arb1, &groups[0], &elems[1],
+                                     UCS_ARBITER_PRIO_BULK);
+    ucs_arbiter_group_schedule(&m_arb1, &groups[0]);
+    EXPECT_EQ(UCS_ARBITER_PRIO_BULK, ucs_arbiter_group_prio(&groups[0]));
+
+    order.clear();
+    ucs_arbiter_dispatch(&m_arb1, 1, prio_order_cb, &order);
+    ASSERT_EQ(2u, order.size());
+    EXPECT_EQ(&groups[ngroups - 1], order[0]);
+    EXPECT_EQ(&groups[0], order[1]);
+
+    for (int i = 0; i < ngroups; i++) {
+        ucs_arbiter_group_cleanup(&groups[i]);
+    }
+    ucs_arbiter_cleanup(&m_arb1);
+}
+
+static ucs_arbiter_cb_result_t purge_elem_cb(ucs_arbiter_t *arbiter,
+                                             ucs_arbiter_group_t *group,
+                                             ucs_arbiter_elem_t *elem,
+                                             void *arg)
+{
+    return (elem == arg) ? UCS_ARBITER_CB_RESULT_REMOVE_ELEM :
+                           UCS_ARBITER_CB_RESULT_NEXT_GROUP;
+}
+
+UCS_TEST_F(test_arbiter, prio_demote) {
+    const int ngroups = 3;
+    const int nelems  = 2;
+    ucs_arbiter_group_t groups[ngroups];
+    ucs_arbiter_elem_t elems[ngroups][nelems];
+    ucs_arbiter_elem_t high_elem;
+    std::vector<ucs_arbiter_group_t*> order;
+
+    ucs_arbiter_init(&m_arb1);
+    for (int i = 0; i < ngroups; i++) {
+        ucs_arbiter_group_init(&groups[i]);
+        ucs_arbiter_elem_init(&elems[i][0]);
+        ucs_arbiter_group_push_elem(&groups[i], &elems[i][0]);
+        if (i == 0) {
+            /* the class of the group is raised by its second element */
+            ucs_arbiter_elem_init(&high_elem);
+            ucs_arbiter_group_push_elem_prio(&m_arb1, &groups[i], &high_elem,
+                                             UCS_ARBITER_PRIO_HIGH);
+        }
+        ucs_arbiter_elem_init(&elems[i][1]);
+        ucs_arbiter_group_push_elem(&groups[i], &elems[i][1]);
+        ucs_arbiter_group_schedule(&m_arb1, &groups[i]);
+    }
+
+    EXPECT_EQ(UCS_ARBITER_PRIO_HIGH, ucs_arbiter_group_prio(&groups[0]));
+    EXPECT_FALSE(ucs_arbiter_is_empty(&m_arb1));
+
+    /* after the high priority element is dispatched, the group returns to the
+     * normal class and takes its turn after the other groups */
+    ucs_arbiter_dispatch(&m_arb1, 1, prio_order_cb, &order);
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb1));
+    ASSERT_EQ(size_t(ngroups * nelems + 1), order.size());
+    EXPECT_EQ(&groups[0], order[0]);
+    EXPECT_EQ(&groups[0], order[1]);
+    for (int i = 0; i < 2 * ngroups - 1; i++) {
+        EXPECT_EQ(&groups[(i + 1) % ngroups], order[i + 2]) << i;
+    }
+
+    /* the class is not lowered by purging the elements which did not raise
+     * it, but is restored once the raising element is purged */
+    ucs_arbiter_elem_init(&elems[0][0]);
+    ucs_arbiter_group_push_elem(&groups[0], &elems[0][0]);
+    ucs_arbiter_elem_init(&high_elem);
+    ucs_arbiter_group_push_elem_prio(&m_arb1, &groups[0], &high_elem,
+                                     UCS_ARBITER_PRIO_HIGH);
+    ucs_arbiter_group_schedule(&m_arb1, &groups[0]);
+    EXPECT_EQ(UCS_ARBITER_PRIO_HIGH, ucs_arbiter_group_prio(&groups[0]));
+
+    ucs_arbiter_group_purge(&m_arb1, &groups[0], purge_elem_cb, &elems[0][0]);
+    EXPECT_EQ(UCS_ARBITER_PRIO_HIGH, ucs_arbiter_group_prio(&groups[0]));
+    ucs_arbiter_elem_init(&elems[0][0]);
+    ucs_arbiter_group_push_elem(&groups[0], &elems[0][0]);
+
+    ucs_arbiter_group_purge(&m_arb1, &groups[0], purge_elem_cb, &high_elem);
+    EXPECT_EQ(UCS_ARBITER_PRIO_NORMAL, ucs_arbiter_group_prio(&groups[0]));
+    EXPECT_FALSE(ucs_arbiter_is_empty(&m_arb1));
+
+    ucs_arbiter_group_desched(&m_arb1, &groups[0]);
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb1));
+    ucs_arbiter_group_purge(&m_arb1, &groups[0], prio_order_cb, &order);
+
+    for (int i = 0; i < ngroups; i++) {
+        ucs_arbiter_group_cleanup(&groups[i]);
+    }
+    ucs_arbiter_cleanup(&m_arb1);
+}
+
+static ucs_arbiter_cb_result_t prio_stop_cb(ucs_arbiter_t *arbiter,
+                                            ucs_arbiter_group_t *group,
+                                            ucs_arbiter_elem_t *elem,
+                                            void *arg)
+{
+    std::pair<ucs_arbiter_elem_t*, std::vector<ucs_arbiter_group_t*> > *ctx =
+            (std::pair<ucs_arbiter_elem_t*,
+                       std::vector<ucs_arbiter_group_t*> >*)arg;
+
+    if (elem == ctx->first) {
+        /* stop only once */
+        ctx->first = NULL;
+        return UCS_ARBITER_CB_RESULT_STOP;
+    }
+
+    ctx->second.push_back(group);
+    return UCS_ARBITER_CB_RESULT_REMOVE_ELEM;
+}
+
+UCS_TEST_F(test_arbiter, prio_stop_resume) {
+    const int nelems = 4;
+    ucs_arbiter_group_t normal_group, bulk_group;
+    ucs_arbiter_elem_t normal_elems[nelems], bulk_elems[nelems];
+    std::pair<ucs_arbiter_elem_t*, std::vector<ucs_arbiter_group_t*> > ctx;
+
+    ucs_arbiter_init(&m_arb1);
+    ucs_arbiter_set_weight(&m_arb1, UCS_ARBITER_PRIO_NORMAL, 1);
+    ucs_arbiter_set_weight(&m_arb1, UCS_ARBITER_PRIO_BULK, 1);
+
+    ucs_arbiter_group_init(&normal_group);
+    ucs_arbiter_group_init(&bulk_group);
+    for (int i = 0; i < nelems; i++) {
+        ucs_arbiter_elem_init(&normal_elems[i]);
+        ucs_arbiter_group_push_elem(&normal_group, &normal_elems[i]);
+        ucs_arbiter_elem_init(&bulk_elems[i]);
+        ucs_arbiter_group_push_elem_prio(&m_arb1, &bulk_group, &bulk_elems[i],
+                                         UCS_ARBITER_PRIO_BULK);
+    }
+    ucs_arbiter_group_schedule(&m_arb1, &normal_group);
+    ucs_arbiter_group_schedule(&m_arb1, &bulk_group);
+
+    /* the bulk group stops the dispatch after both classes used their
+     * credits */
+    ctx.first = &bulk_elems[0];
+    ucs_arbiter_dispatch(&m_arb1, 1, prio_stop_cb, &ctx);
+    ASSERT_EQ(1u, ctx.second.size());
+    EXPECT_EQ(&normal_group, ctx.second[0]);
+
+    /* next dispatch resumes from the group which stopped */
+    ucs_arbiter_dispatch(&m_arb1, 1, prio_stop_cb, &ctx);
+    EXPECT_TRUE(ucs_arbiter_is_empty(&m_arb1));
+    ASSERT_EQ(size_t(2 * nelems), ctx.second.size());
+    EXPECT_EQ(&bulk_group, ctx.second[1]);
+    for (int i = 2; i < 2 * nelems; i++) {
+        EXPECT_EQ((i % 2) ? &bulk_group : &normal_group, ctx.second[i]) << i;
+    }
+
+    ucs_arbiter_group_cleanup(&normal_group);
+    ucs_arbiter_group_cleanup(&bulk_group);
+    ucs_arbiter_cleanup(&m_arb1);
+}
+
 class test_arbiter_resched_from_dispatch : public ucs::test {
 public:
     virtual void init() {
@@ -453,6 +453,27 @@ UCS_TEST_P(test_async, many_timers) {
     }
 }
 
+UCS_TEST_P(test_async, sharded_timers) {
+    static const int NUM_CONTEXTS = 6;
+
+    /* Spread the contexts over several threads, all bound to the first CPU */
+    modify_config("ASYNC_THREADS", "4");
+    modify_config("ASYNC_THREAD_AFFINITY", "0");
+
+    std::vector<local_timer*> timers;
+    for (int i = 0; i < NUM_CONTEXTS; ++i) {
+        timers.push_back(new local_timer(GetParam()));
+    }
+
+    for (int i = 0; i < NUM_CONTEXTS; ++i) {
+        expect_count_GE(*timers[i], TIMER_EXP_COUNT);
+    }
+
+    for (int i = 0; i < NUM_CONTEXTS; ++i) {
+        delete timers[i];
+    }
+}
+
 UCS_TEST_P(test_async, ctx_event) {
     local_event le(GetParam());
     le.push_event();
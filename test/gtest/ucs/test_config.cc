@@ -743,6 +743,36 @@ UCS_TEST_F(test_config, test_allow_list_negative)
                                            &ucs_config_array_string), 0);
 }
 
+UCS_TEST_F(test_config, test_cpu_set) {
+    ucs_cpu_set_t cpu_set;
+    char buf[256];
+
+    EXPECT_EQ(1, ucs_config_sscanf_cpu_set("0-3,8,10-11", &cpu_set, NULL));
+    EXPECT_EQ(7, ucs_cpu_set_count(&cpu_set));
+    EXPECT_TRUE(ucs_cpu_is_set(3, &cpu_set));
+    EXPECT_FALSE(ucs_cpu_is_set(9, &cpu_set));
+    ucs_config_sprintf_cpu_set(buf, sizeof(buf), &cpu_set, NULL);
+    EXPECT_EQ(std::string("0-3,8,10-11"), buf);
+
+    EXPECT_EQ(1, ucs_config_sscanf_cpu_set("none", &cpu_set, NULL));
+    EXPECT_EQ(0, ucs_cpu_set_count(&cpu_set));
+    ucs_config_sprintf_cpu_set(buf, sizeof(buf), &cpu_set, NULL);
+    EXPECT_EQ(std::string("none"), buf);
+
+    /* a range which ends at the last CPU of the set */
+    UCS_CPU_ZERO(&cpu_set);
+    UCS_CPU_SET(UCS_CPU_SETSIZE - 2, &cpu_set);
+    UCS_CPU_SET(UCS_CPU_SETSIZE - 1, &cpu_set);
+    ucs_config_sprintf_cpu_set(buf, sizeof(buf), &cpu_set, NULL);
+    EXPECT_EQ(ucs::to_string(UCS_CPU_SETSIZE - 2) + "-" +
+              ucs::to_string(UCS_CPU_SETSIZE - 1), buf);
+
+    EXPECT_EQ(0, ucs_config_sscanf_cpu_set("3-1", &cpu_set, NULL));
+    EXPECT_EQ(0, ucs_config_sscanf_cpu_set("1,x", &cpu_set, NULL));
+    EXPECT_EQ(0, ucs_config_sscanf_cpu_set("1-2-3", &cpu_set, NULL));
+    EXPECT_EQ(0, ucs_config_sscanf_cpu_set("100000", &cpu_set, NULL));
+}
+
 UCS_TEST_F(test_config, test_key_value_generic_value) {
     /* coverity[tainted_string_argument] */
     ucs::scoped_setenv env1("UCX_TEMP", "42");
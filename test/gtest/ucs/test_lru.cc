@@ -64,6 +64,7 @@ UCS_TEST_F(test_lru, full_capacity) {
     std::vector<uint64_t> expected(elements.begin() + m_capacity,
                                    elements.end());
     run(elements, expected);
+    EXPECT_EQ(expected.size(), ucs_lru_size(m_lru));
 }
 
 UCS_TEST_F(test_lru, partial_capacity) {
@@ -94,6 +95,26 @@ UCS_TEST_F(test_lru, reset) {
     run(elements2, elements2);
 }
 
+UCS_TEST_F(test_lru, remove) {
+    std::vector<uint64_t> elements;
+    init_vector(elements, m_capacity, 0);
+    run(elements, elements);
+
+    EXPECT_UCS_OK(ucs_lru_remove(m_lru, (void*)elements[0]));
+    EXPECT_EQ(UCS_ERR_NO_ELEM, ucs_lru_remove(m_lru, (void*)elements[0]));
+    EXPECT_FALSE(ucs_lru_is_present(m_lru, (void*)elements[0]));
+    EXPECT_EQ(m_capacity - 1, ucs_lru_size(m_lru));
+
+    std::vector<uint64_t> expected(elements.begin() + 1, elements.end());
+    int elem_index = 0;
+    void **item;
+    ucs_lru_for_each(item, m_lru) {
+        EXPECT_EQ(expected[expected.size() - 1 - elem_index], (uint64_t)*item);
+        elem_index++;
+    }
+    EXPECT_EQ(expected.size(), elem_index);
+}
+
 UCS_TEST_F(test_lru, pop_oldest) {
     std::vector<uint64_t> elements1;
     init_vector(elements1, m_capacity, 0);
@@ -15,6 +15,8 @@ extern "C" {
 #include <ucm/api/ucm.h>
 }
 #include <set>
+#include <sys/syscall.h>
+#include <sys/wait.h>
 
 static ucs_rcache_params_t
 get_default_rcache_params(void *context, const ucs_rcache_ops_t *ops)
@@ -26,7 +28,10 @@ get_default_rcache_params(void *context, const ucs_rcache_ops_t *ops)
                                   context,
                                   0,
                                   ULONG_MAX,
-                                  SIZE_MAX};
+                                  SIZE_MAX,
+                                  SIZE_MAX,
+                                  UCS_MEMUNITS_INF,
+                                  1};
 
     return params;
 }
@@ -867,6 +872,184 @@ UCS_TEST_F(test_rcache_with_limit, by_size_inuse) {
     free(ptr1);
 }
 
+class test_rcache_evict_scan : public test_rcache_with_limit {
+protected:
+    virtual ucs_rcache_params_t rcache_params()
+    {
+        ucs_rcache_params_t params = test_rcache_with_limit::rcache_params();
+        params.max_regions         = ULONG_MAX;
+        params.max_size            = 5 * ucs_get_page_size();
+        params.evict_scan          = 4;
+        return params;
+    }
+};
+
+UCS_TEST_F(test_rcache_evict_scan, prefer_large) {
+    const size_t page_size = ucs_get_page_size();
+    const size_t size      = 16 * page_size;
+    char *mem              = (char*)alloc_pages(size, PROT_READ | PROT_WRITE);
+
+    /* Regions are separated by unused pages to avoid merging */
+    char *small1 = mem;
+    char *large  = mem + (2 * page_size);
+    char *small2 = mem + (8 * page_size);
+
+    uint32_t small1_id = get_put(small1, page_size);
+    uint32_t large_id  = get_put(large, 4 * page_size);
+    EXPECT_EQ(2, m_rcache->num_regions);
+
+    /* Exceeding the size limit evicts the large region, even though the small
+     * one is less recently used */
+    get_put(small2, page_size);
+    EXPECT_EQ(2, m_rcache->num_regions);
+    EXPECT_EQ(1u, m_rcache->counters.evictions);
+    EXPECT_EQ(small1_id, get_put(small1, page_size));
+    EXPECT_NE(large_id, get_put(large, 4 * page_size));
+
+    munmap(mem, size);
+}
+
+class test_rcache_node_limit : public test_rcache {
+protected:
+    test_rcache_node_limit() : m_node_max_size(UCS_MEMUNITS_INF), m_probe(NULL)
+    {
+    }
+
+    virtual void init()
+    {
+        /* Other processes of the same user may account registrations in the
+         * node object, so set the limit relative to its current value. The
+         * object is mapped while there is an rcache which uses a node limit,
+         * so keep the probe rcache until the test ends. */
+        m_probe         = create_probe();
+        m_node_max_size = ucs_rcache_node_registered_size() +
+                          (2 * ucs_get_page_size());
+        test_rcache::init();
+    }
+
+    virtual void cleanup()
+    {
+        test_rcache::cleanup();
+        if (m_probe != NULL) {
+            ucs_rcache_destroy(m_probe);
+        }
+    }
+
+    virtual ucs_rcache_params_t rcache_params()
+    {
+        ucs_rcache_params_t params = test_rcache::rcache_params();
+        params.node_max_size       = m_node_max_size;
+        return params;
+    }
+
+    ucs_rcache_t *create_probe()
+    {
+        ucs_rcache_params_t params;
+        ucs_rcache_t *rcache;
+        size_t max_size;
+
+        max_size        = m_node_max_size;
+        m_node_max_size = SIZE_MAX - 1;
+        params          = rcache_params();
+        m_node_max_size = max_size;
+
+        if (ucs_rcache_create(&params, "probe", ucs_stats_get_root(),
+                              &rcache) != UCS_OK) {
+            return NULL;
+        }
+
+        return rcache;
+    }
+
+    ucs_status_t try_get(void *address, size_t length)
+    {
+        ucs_rcache_region_t *r;
+        ucs_status_t status;
+
+        status = ucs_rcache_get(m_rcache, address, length, UCS_PGT_ADDR_ALIGN,
+                                PROT_READ | PROT_WRITE, NULL, &r);
+        if (status == UCS_OK) {
+            ucs_rcache_region_put(m_rcache, r);
+        }
+        return status;
+    }
+
+    size_t       m_node_max_size;
+    ucs_rcache_t *m_probe;
+};
+
+UCS_TEST_F(test_rcache_node_limit, evict_and_fail) {
+    const size_t page_size = ucs_get_page_size();
+    const size_t size      = 8 * page_size;
+    char *mem              = (char*)alloc_pages(size, PROT_READ | PROT_WRITE);
+    size_t node_size       = ucs_rcache_node_registered_size();
+
+    region *region1 = get(mem, page_size);
+    region *region2 = get(mem + (2 * page_size), page_size);
+    EXPECT_EQ(node_size + (2 * page_size), ucs_rcache_node_registered_size());
+
+    /* Both regions are in use, so the limit cannot be kept */
+    EXPECT_EQ(UCS_ERR_EXCEEDS_LIMIT, try_get(mem + (4 * page_size), page_size));
+    EXPECT_EQ(1u, m_rcache->counters.limit_fails);
+    EXPECT_EQ(2u, m_reg_count);
+
+    /* An idle region is evicted to make room */
+    put(region2);
+    EXPECT_EQ(UCS_OK, try_get(mem + (4 * page_size), page_size));
+    EXPECT_EQ(1u, m_rcache->counters.evictions);
+    EXPECT_EQ(2u, m_reg_count);
+
+    put(region1);
+    m_rcache.reset();
+    EXPECT_EQ(node_size, ucs_rcache_node_registered_size());
+
+    munmap(mem, size);
+}
+
+UCS_TEST_F(test_rcache_node_limit, exited_process) {
+    const size_t page_size = ucs_get_page_size();
+    const size_t size      = 4 * page_size;
+    char *mem              = (char*)alloc_pages(size, PROT_READ | PROT_WRITE);
+    size_t node_size;
+    int child_status;
+    pid_t pid;
+
+    /* Detach from the node object, so the child takes its own slot */
+    m_rcache.reset();
+    ucs_rcache_destroy(m_probe);
+    m_probe = NULL;
+
+    pid = fork();
+    if (pid == 0) {
+        ucs_rcache_t *rcache = create_probe();
+        ucs_rcache_region_t *r;
+
+        /* Exit without releasing the registration */
+        _exit((rcache == NULL) ||
+              (ucs_rcache_get(rcache, mem, size, UCS_PGT_ADDR_ALIGN,
+                              PROT_READ | PROT_WRITE, NULL, &r) != UCS_OK));
+    }
+
+    ASSERT_GE(pid, 0);
+    ASSERT_EQ(pid, waitpid(pid, &child_status, 0));
+    ASSERT_TRUE(WIFEXITED(child_status));
+    ASSERT_EQ(0, WEXITSTATUS(child_status));
+
+    m_probe = create_probe();
+    ASSERT_TRUE(m_probe != NULL);
+    node_size = ucs_rcache_node_registered_size();
+    ASSERT_GE(node_size, size);
+
+    /* The size of the exited process is released when the limit is reached */
+    m_node_max_size = node_size - size + page_size;
+    test_rcache::init();
+    EXPECT_EQ(UCS_OK, try_get(mem, page_size));
+    EXPECT_EQ(0u, m_rcache->counters.limit_fails);
+    EXPECT_LE(ucs_rcache_node_registered_size(), node_size - size + page_size);
+
+    munmap(mem, size);
+}
+
 #ifdef ENABLE_STATS
 class test_rcache_stats : public test_rcache {
 protected:
@@ -1052,6 +1235,91 @@ UCS_TEST_F(test_rcache_stats, hits_slow) {
 }
 #endif
 
+#if defined(HAVE_LINUX_USERFAULTFD_H) && HAVE_DECL_SYS_USERFAULTFD
+/*
+ * The hook mode is switched at runtime, so the tests can't run if BISTRO hooks
+ * are installed: the original functions would be called through the patched
+ * ones.
+ */
+class test_rcache_uffd : public test_rcache {
+protected:
+    test_rcache_uffd() : m_orig_mode(ucm_global_opts.mmap_hook_mode)
+    {
+    }
+
+    virtual void init()
+    {
+        if (RUNNING_ON_VALGRIND ||
+            (m_orig_mode == UCM_MMAP_HOOK_BISTRO)) {
+            UCS_TEST_SKIP_R("cannot switch to userfaultfd hook mode");
+        }
+
+        ucm_global_opts.mmap_hook_mode = UCM_MMAP_HOOK_UFFD;
+        test_rcache::init();
+    }
+
+    virtual void cleanup()
+    {
+        test_rcache::cleanup();
+        ucm_global_opts.mmap_hook_mode = m_orig_mode;
+    }
+
+    ucm_mmap_hook_mode_t m_orig_mode;
+};
+
+/* Release memory with raw system calls, so only userfaultfd can report it,
+ * and map new memory at the same address right after */
+UCS_TEST_F(test_rcache_uffd, unmap_remap) {
+    size_t size = ucs_get_page_size() * 4;
+    void *mem   = alloc_pages(size, PROT_READ | PROT_WRITE);
+    region *r1, *r2;
+    uint32_t id1;
+
+    r1  = get(mem, size);
+    id1 = r1->id;
+    put(r1);
+    EXPECT_EQ(1u, m_reg_count) << "region was not cached";
+
+    ASSERT_EQ(0, syscall(SYS_munmap, mem, size));
+    ASSERT_EQ(mem, (void*)syscall(SYS_mmap, mem, size, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1,
+                                  0));
+
+    r2 = get(mem, size);
+    EXPECT_NE(id1, r2->id);
+    put(r2);
+
+    munmap(mem, size);
+}
+
+UCS_TEST_F(test_rcache_uffd, mremap) {
+    size_t size = ucs_get_page_size() * 4;
+    void *mem   = alloc_pages(size, PROT_READ | PROT_WRITE);
+    region *r1, *r2;
+    void *new_mem;
+    uint32_t id1;
+
+    r1  = get(mem, size);
+    id1 = r1->id;
+    put(r1);
+
+    /* move the memory elsewhere, and map new memory at the old address */
+    new_mem = alloc_pages(size, PROT_READ | PROT_WRITE);
+    ASSERT_EQ(new_mem, (void*)syscall(SYS_mremap, mem, size, size,
+                                      MREMAP_MAYMOVE | MREMAP_FIXED,
+                                      new_mem));
+    ASSERT_EQ(mem, (void*)syscall(SYS_mmap, mem, size, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1,
+                                  0));
+
+    r2 = get(mem, size);
+    EXPECT_NE(id1, r2->id);
+    put(r2);
+
+    munmap(mem, size);
+    munmap(new_mem, size);
+}
+#endif
 
 class test_rcache_pfn : public ucs::test {
 public:
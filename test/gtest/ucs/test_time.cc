@@ -13,6 +13,11 @@ extern "C" {
 #include <time.h>
 
 class test_time : public ucs::test {
+protected:
+    static ucs_time_t timer_interval(int id) {
+        const ucs_time_t interval = ucs_time_from_msec(10);
+        return interval + ((id % 1000) * interval) / 1000;
+    }
 };
 
 UCS_TEST_F(test_time, time_calc) {
@@ -143,3 +148,65 @@ UCS_TEST_F(test_time, timerq) {
 }
 
 
+
+UCS_TEST_F(test_time, timerq_many) {
+    const int num_timers        = 100000 / ucs::test_time_multiplier();
+    const ucs_time_t step       = ucs_time_from_usec(100);
+    const unsigned num_steps    = 1000;
+    ucs_time_t current_time     = ucs_get_time();
+    std::vector<unsigned> counters(num_timers);
+    ucs_time_t start_time, add_time, dispatch_time, remove_time;
+    ucs_timer_queue_t timerq;
+    ucs_timer_t *timer;
+    size_t num_dispatched;
+
+    ASSERT_UCS_OK(ucs_timerq_init(&timerq));
+
+    /* Intervals of 1..2 x interval, so the timers spread over many slots */
+    start_time = ucs_get_time();
+    for (int id = 0; id < num_timers; ++id) {
+        ASSERT_UCS_OK(ucs_timerq_add(&timerq, id, timer_interval(id)));
+    }
+    add_time = ucs_get_time() - start_time;
+
+    EXPECT_EQ(num_timers, ucs_timerq_size(&timerq));
+    EXPECT_EQ(timer_interval(0), ucs_timerq_min_interval(&timerq));
+
+    num_dispatched = 0;
+    start_time     = ucs_get_time();
+    for (unsigned count = 0; count < num_steps; ++count) {
+        current_time += step;
+        ucs_timerq_for_each_expired(timer, &timerq, current_time, {
+            ++counters[timer->id];
+            ++num_dispatched;
+        })
+    }
+    dispatch_time = ucs_get_time() - start_time;
+
+    /* Every timer fires right away, and then at least once more */
+    for (int id = 0; id < num_timers; ++id) {
+        EXPECT_NEAR((num_steps * step) / timer_interval(id) + 1, counters[id], 1)
+                << "timer " << id;
+        if (HasFailure()) {
+            break;
+        }
+    }
+
+    start_time = ucs_get_time();
+    for (int id = 0; id < num_timers; ++id) {
+        ASSERT_UCS_OK(ucs_timerq_remove(&timerq, id));
+    }
+    remove_time = ucs_get_time() - start_time;
+
+    EXPECT_TRUE(ucs_timerq_is_empty(&timerq));
+    EXPECT_EQ(UCS_TIME_INFINITY, ucs_timerq_min_interval(&timerq));
+    EXPECT_EQ(UCS_TIME_INFINITY, ucs_timerq_next_expiration(&timerq));
+    ucs_timerq_cleanup(&timerq);
+
+    UCS_TEST_MESSAGE << num_timers << " timers: add "
+                     << ucs_time_to_nsec(add_time) / num_timers
+                     << " ns, dispatch "
+                     << ucs_time_to_nsec(dispatch_time) / num_dispatched
+                     << " ns, remove "
+                     << ucs_time_to_nsec(remove_time) / num_timers << " ns";
+}
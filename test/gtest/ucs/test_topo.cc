@@ -11,6 +11,8 @@ extern "C" {
 #include <ucs/sys/topo/base/topo.h>
 }
 
+#include <sys/mman.h>
+
 class test_topo : public ucs::test {
 };
 
@@ -151,3 +153,27 @@ UCS_TEST_F(test_topo, numa_distance) {
         }
     }
 }
+
+UCS_TEST_F(test_topo, numa_mem_bind) {
+    ucs_numa_node_t node = ucs_numa_node_of_current_cpu();
+    size_t length        = 4 * ucs_get_page_size();
+    ucs_status_t status;
+    void *address;
+
+    EXPECT_GE(node, 0);
+    EXPECT_LT(node, (ucs_numa_node_t)ucs_numa_num_configured_nodes());
+
+    address = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(MAP_FAILED, address);
+    memset(address, 0, length);
+
+    EXPECT_EQ(UCS_ERR_INVALID_PARAM,
+              ucs_numa_mem_bind(address, length, UCS_NUMA_NODE_UNDEFINED));
+
+    status = ucs_numa_mem_bind(address, length, node);
+    munmap(address, length);
+    if (status != UCS_OK) {
+        UCS_TEST_SKIP_R("mbind() is not supported or not permitted");
+    }
+}
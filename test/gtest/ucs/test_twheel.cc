@@ -257,3 +257,91 @@ UCS_TEST_F(twheel, delayed_sweep) {
     GTEST_FAIL() << "Timers were not triggered after timeout";
 }
 
+
+
+class hwheel : public ucs::test {
+protected:
+    struct hw_timer {
+        ucs_hwtimer_t timer;
+        ucs_time_t    expiration;
+        bool          scheduled;
+    };
+
+    virtual void init() {
+        ucs::test::init();
+        ASSERT_UCS_OK(ucs_hwheel_init(&m_wheel, ucs::rand()));
+    }
+
+    virtual void cleanup() {
+        ucs_hwheel_cleanup(&m_wheel);
+        ucs::test::cleanup();
+    }
+
+    static uint64_t rand64() {
+        return ((uint64_t)ucs::rand() << 32) ^ ucs::rand();
+    }
+
+    void add_timer(hw_timer *t) {
+        /* Distances of all orders of magnitude, to cover all the levels */
+        ucs_time_t delta = rand64() & UCS_MASK(ucs::rand() % 48);
+
+        t->expiration = m_wheel.now + delta;
+        t->scheduled  = true;
+        ucs_hwtimer_add(&m_wheel, &t->timer, t->expiration);
+    }
+
+    ucs_hwheel_t m_wheel;
+};
+
+UCS_TEST_F(hwheel, expiration) {
+    const unsigned num_timers = 1000 / ucs::test_time_multiplier();
+    std::vector<hw_timer> t(num_timers);
+    ucs_time_t now, next;
+    ucs_hwtimer_t *expired;
+    hw_timer *timer;
+
+    for (unsigned i = 0; i < num_timers; ++i) {
+        add_timer(&t[i]);
+    }
+
+    now = m_wheel.now;
+    for (unsigned step = 0; step < 20000; ++step) {
+        /* The next expiration is never later than the earliest timer */
+        next = ucs_hwheel_next_expiration(&m_wheel);
+        for (unsigned i = 0; i < num_timers; ++i) {
+            if (t[i].scheduled) {
+                ASSERT_LE(next, std::max(now, t[i].expiration)) << "timer " << i;
+            }
+        }
+
+        now += rand64() & UCS_MASK(ucs::rand() % 36);
+        ucs_hwheel_advance(&m_wheel, now);
+        EXPECT_EQ(now, m_wheel.now);
+
+        while ((expired = ucs_hwheel_get_expired(&m_wheel)) != NULL) {
+            timer = ucs_container_of(expired, hw_timer, timer);
+            ASSERT_TRUE(timer->scheduled);
+            ASSERT_LE(timer->expiration, now);
+            timer->scheduled = false;
+        }
+
+        for (unsigned i = 0; i < num_timers; ++i) {
+            /* No timer is left behind */
+            if (t[i].scheduled) {
+                ASSERT_GT(t[i].expiration, now) << "timer " << i;
+            } else {
+                add_timer(&t[i]);
+            }
+        }
+
+        /* Remove a random timer, and schedule it again */
+        timer = &t[ucs::rand() % num_timers];
+        ucs_hwtimer_remove(&m_wheel, &timer->timer);
+        add_timer(timer);
+    }
+
+    for (unsigned i = 0; i < num_timers; ++i) {
+        ucs_hwtimer_remove(&m_wheel, &t[i].timer);
+    }
+    EXPECT_EQ(UCS_TIME_INFINITY, ucs_hwheel_next_expiration(&m_wheel));
+}
@@ -162,3 +162,20 @@ UCS_TEST_F(test_usage_tracker, demote) {
     promoted.insert(promoted.end(), elements2.begin(), elements2.end());
     verify(promoted, demoted);
 }
+
+/* Tests that a removed entry is not tracked anymore */
+UCS_TEST_F(test_usage_tracker, remove) {
+    entries_vec_t elements = {1, 2};
+
+    touch_all(elements);
+    EXPECT_UCS_OK(ucs_usage_tracker_remove(m_usage_tracker, (void*)1));
+    EXPECT_EQ(UCS_ERR_NO_ELEM,
+              ucs_usage_tracker_remove(m_usage_tracker, (void*)1));
+
+    ucs_usage_tracker_progress(m_usage_tracker);
+    verify({2}, {});
+
+    double score;
+    EXPECT_EQ(UCS_ERR_NO_ELEM,
+              ucs_usage_tracker_get_score(m_usage_tracker, (void*)1, &score));
+}
@@ -288,3 +288,260 @@ UCS_TEST_P(test_uct_tcp, check_addr_len)
 
 
 _UCT_INSTANTIATE_TEST_CASE(test_uct_tcp, tcp)
+
+
+class test_uct_tcp_uring : public test_uct_tcp {
+public:
+    void init() {
+        modify_config("TCP_IO_URING", "y", IGNORE_IF_NOT_EXIST);
+        /* Run out of receive buffers quickly */
+        modify_config("TCP_IO_URING_RX_BUFS", "4", IGNORE_IF_NOT_EXIST);
+
+        test_uct_tcp::init();
+
+        if (m_tcp_iface->uring == NULL) {
+            UCS_TEST_SKIP_R("io_uring is not available");
+        }
+
+        m_am_count = 0;
+        ASSERT_UCS_OK(uct_iface_set_am_handler(m_ent->iface(), AM_ID,
+                                               am_handler, this, 0));
+    }
+
+    entity *create_sender() {
+        entity *sender = uct_test::create_entity(0);
+        m_entities.push_back(sender);
+        sender->connect_to_iface(0, *m_ent);
+        return sender;
+    }
+
+    ucs_status_t am_short(entity &sender, size_t length) {
+        std::vector<char> buf(length, 'u');
+        return uct_ep_am_short(sender.ep(0), AM_ID, 0, &buf[0], length);
+    }
+
+    void send_am(entity &sender, size_t length) {
+        ucs_status_t status;
+
+        do {
+            status = am_short(sender, length);
+            progress();
+        } while (status == UCS_ERR_NO_RESOURCE);
+
+        ASSERT_UCS_OK(status);
+    }
+
+    static ucs_status_t
+    am_handler(void *arg, void *data, size_t length, unsigned flags) {
+        test_uct_tcp_uring *self = static_cast<test_uct_tcp_uring*>(arg);
+
+        ++self->m_am_count;
+        return UCS_OK;
+    }
+
+protected:
+    static const uint8_t AM_ID = 1;
+
+    size_t               m_am_count;
+};
+
+UCS_TEST_P(test_uct_tcp_uring, listener_flood_connect_and_send_large) {
+    const size_t max_conn =
+        ucs_min(static_cast<size_t>(max_connections()), 128lu) /
+        ucs::test_time_multiplier();
+    const size_t msg_size = m_tcp_iface->config.rx_seg_size * 4;
+    test_listener_flood(*m_ent, max_conn, msg_size);
+}
+
+UCS_TEST_P(test_uct_tcp_uring, listener_flood_connect_and_send_small) {
+    const size_t max_conn =
+        ucs_min(static_cast<size_t>(max_connections()), 128lu) /
+        ucs::test_time_multiplier();
+    test_listener_flood(*m_ent, max_conn, 1);
+}
+
+UCS_TEST_P(test_uct_tcp_uring, listener_flood_connect_and_close) {
+    const size_t max_conn =
+        ucs_min(static_cast<size_t>(max_connections()), 128lu) /
+        ucs::test_time_multiplier();
+    test_listener_flood(*m_ent, max_conn, 0);
+}
+
+UCS_TEST_P(test_uct_tcp_uring, am_rx_bufs_exhausted) {
+    const size_t num_msgs = 10000 / ucs::test_time_multiplier();
+    entity *sender        = create_sender();
+    const size_t length   = ucs_min(sender->iface_attr().cap.am.max_short -
+                                    sizeof(uint64_t), 1024lu);
+
+    /* More data than the receive buffers can hold arrives before the
+     * receiver consumes it, so the receive is re-armed from progress */
+    for (size_t i = 0; i < num_msgs; ++i) {
+        send_am(*sender, length);
+    }
+
+    wait_for_value(&m_am_count, num_msgs, true);
+    EXPECT_EQ(num_msgs, m_am_count);
+}
+
+UCS_TEST_P(test_uct_tcp_uring, destroy_with_send_in_flight) {
+    const size_t length   = ucs_min(m_tcp_iface->config.tx_seg_size,
+                                    UCS_KBYTE);
+    entity *sender        = create_sender();
+    uct_tcp_ep_t *ep      = ucs_derived_of(sender->ep(0), uct_tcp_ep_t);
+    ucs_time_t deadline   = ucs::get_deadline();
+    unsigned num_no_resource;
+
+    /* Establish the connection */
+    send_am(*sender, length);
+    wait_for_value(&m_am_count, (size_t)1, true);
+
+    /* Fill the socket buffers without progressing the receiver, until the
+     * kernel holds a send which can't complete */
+    num_no_resource = 0;
+    while ((num_no_resource < 1000) && (ucs_get_time() < deadline)) {
+        if (am_short(*sender, length) == UCS_ERR_NO_RESOURCE) {
+            ++num_no_resource;
+        } else {
+            num_no_resource = 0;
+        }
+        sender->progress();
+    }
+
+    ASSERT_TRUE(ep->uring.tx_op != NULL);
+
+    /* The send is canceled and drained before its buffer is released */
+    scoped_log_handler slh(wrap_errors_logger);
+    m_entities.remove(sender);
+    short_progress_loop();
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_tcp_uring, tcp)
+
+
+class test_uct_tcp_stripe : public uct_test {
+public:
+    void init() {
+        modify_config("TCP_NUM_CONNS", ucs::to_string(NUM_CONNS));
+        modify_config("TCP_STRIPE_MIN_SIZE", "1kb");
+
+        uct_test::init();
+
+        m_sender = uct_test::create_entity(0);
+        m_entities.push_back(m_sender);
+        m_receiver = uct_test::create_entity(0);
+        m_entities.push_back(m_receiver);
+
+        check_skip_test();
+
+        m_sender->connect_to_iface(0, *m_receiver);
+        m_ep = ucs_derived_of(m_sender->ep(0), uct_tcp_ep_t);
+    }
+
+    void check_skip_test() {
+        if (!(m_sender->iface_attr().cap.flags & UCT_IFACE_FLAG_PUT_ZCOPY)) {
+            UCS_TEST_SKIP_R("PUT Zcopy is not supported");
+        }
+    }
+
+    void wait_for_conns() {
+        ucs_time_t deadline = ucs::get_deadline();
+        unsigned num_connected;
+
+        do {
+            progress();
+            num_connected = 0;
+            for (unsigned i = 0; i < m_ep->stripe.num_conns; ++i) {
+                num_connected += (m_ep->stripe.conns[i]->conn_state ==
+                                  UCT_TCP_EP_CONN_STATE_CONNECTED);
+            }
+        } while (((num_connected < m_ep->stripe.num_conns) ||
+                  (m_ep->conn_state != UCT_TCP_EP_CONN_STATE_CONNECTED)) &&
+                 (ucs_get_time() < deadline));
+
+        ASSERT_EQ(m_ep->stripe.num_conns, num_connected);
+    }
+
+    unsigned num_conns_waiting_ack() const {
+        unsigned num = 0;
+
+        for (unsigned i = 0; i < m_ep->stripe.num_conns; ++i) {
+            num += !!(m_ep->stripe.conns[i]->flags &
+                      UCT_TCP_EP_FLAG_PUT_TX_WAITING_ACK);
+        }
+
+        return num;
+    }
+
+    void put_zcopy(const mapped_buffer &sendbuf, const mapped_buffer &recvbuf,
+                   uct_completion_t *comp) {
+        ucs_status_t status;
+
+        do {
+            status = uct_ep_put_zcopy(m_sender->ep(0), sendbuf.iov(), 1,
+                                      recvbuf.addr(), recvbuf.rkey(), comp);
+            if (status == UCS_ERR_NO_RESOURCE) {
+                progress();
+            }
+        } while (status == UCS_ERR_NO_RESOURCE);
+
+        ASSERT_UCS_OK_OR_INPROGRESS(status);
+    }
+
+    static void completion_cb(uct_completion_t *self) {
+    }
+
+protected:
+    static const unsigned NUM_CONNS = 4;
+    static const uint64_t SEED1     = 0x1111111111111111lu;
+    static const uint64_t SEED2     = 0x2222222222222222lu;
+
+    entity       *m_sender;
+    entity       *m_receiver;
+    uct_tcp_ep_t *m_ep;
+};
+
+const unsigned test_uct_tcp_stripe::NUM_CONNS;
+
+UCS_TEST_P(test_uct_tcp_stripe, put_zcopy) {
+    const size_t length = 256 * UCS_KBYTE;
+    mapped_buffer sendbuf(length, SEED1, *m_sender);
+    mapped_buffer recvbuf(length, 0, *m_receiver);
+    uct_completion_t comp = {completion_cb, 1, UCS_OK};
+
+    ASSERT_EQ(NUM_CONNS - 1, m_ep->stripe.num_conns);
+    wait_for_conns();
+
+    put_zcopy(sendbuf, recvbuf, &comp);
+
+    /* All connections had free send resources, so every additional
+     * connection got a fragment */
+    EXPECT_EQ(NUM_CONNS - 1, num_conns_waiting_ack());
+
+    wait_for_value(&comp.count, 0, true);
+    EXPECT_UCS_OK(comp.status);
+    recvbuf.pattern_check(SEED1);
+    EXPECT_EQ(0u, num_conns_waiting_ack());
+}
+
+UCS_TEST_P(test_uct_tcp_stripe, put_zcopy_fence_flush) {
+    const size_t length = 64 * UCS_KBYTE;
+    mapped_buffer sendbuf1(length, SEED1, *m_sender);
+    mapped_buffer sendbuf2(length, SEED2, *m_sender);
+    mapped_buffer recvbuf(length, 0, *m_receiver);
+
+    wait_for_conns();
+
+    put_zcopy(sendbuf1, recvbuf, NULL);
+    ASSERT_UCS_OK(uct_ep_fence(m_sender->ep(0), 0));
+    EXPECT_TRUE(m_ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE);
+
+    /* The second PUT must not overtake the fragments of the first one */
+    put_zcopy(sendbuf2, recvbuf, NULL);
+    flush();
+
+    EXPECT_EQ(0u, num_conns_waiting_ack());
+    EXPECT_FALSE(m_ep->flags & UCT_TCP_EP_FLAG_STRIPE_FENCE);
+    recvbuf.pattern_check(SEED2);
+}
+
+_UCT_INSTANTIATE_TEST_CASE(test_uct_tcp_stripe, tcp)
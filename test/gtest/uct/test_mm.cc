@@ -6,6 +6,7 @@
 
 extern "C" {
 #include <uct/api/uct.h>
+#include <uct/sm/mm/base/mm_iface.h>
 #include <uct/sm/mm/base/mm_md.h>
 #include <ucs/time/time.h>
 }
@@ -13,6 +14,10 @@ extern "C" {
 #include <common/test.h>
 #include "uct_test.h"
 
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
 
 class test_uct_mm : public uct_test {
 public:
@@ -48,7 +53,7 @@ public:
             std::vector<const resource*> r = uct_test::enum_resources("");
             for (std::vector<const resource*>::iterator iter = r.begin();
                  iter != r.end(); ++iter) {
-                if ((*iter)->tl_name == "posix") {
+                if ((*iter)->tl_name == "posix_p2p") {
                     enum_posix_variants(**iter, all_resources);
                 } else {
                     all_resources.push_back(mm_resource(**iter));
@@ -61,7 +66,7 @@ public:
     }
 
     test_uct_mm() : m_e1(NULL), m_e2(NULL) {
-        if (GetParam()->tl_name == "posix") {
+        if (GetParam()->tl_name == "posix_p2p") {
             set_posix_config();
         }
     }
@@ -110,6 +115,127 @@ public:
         return UCS_OK;
     }
 
+    static ucs_status_t burst_am_handler(void *arg, void *data, size_t length,
+                                         unsigned flags) {
+        std::vector<uint64_t> *seqs = (std::vector<uint64_t>*)arg;
+
+        seqs->push_back(*(uint64_t*)data);
+        return UCS_OK;
+    }
+
+    static size_t burst_pack_cb(void *dest, void *arg) {
+        uint64_t seq = *(uint64_t*)arg;
+
+        *(uint64_t*)dest = seq;
+        memset(UCS_PTR_BYTE_OFFSET(dest, sizeof(seq)), 0xaa,
+               BURST_BCOPY_SIZE - sizeof(seq));
+        return BURST_BCOPY_SIZE;
+    }
+
+    /* Fill the receive FIFO with short and bcopy messages before letting the
+     * receiver progress, so it picks up several ready elements at once */
+    void test_rx_burst() {
+        const unsigned num_msgs = 1000;
+        std::vector<uint64_t> seqs;
+        ucs_status_t status;
+        ssize_t packed_len;
+        uint64_t seq;
+
+        uct_iface_set_am_handler(m_e2->iface(), 0, burst_am_handler, &seqs, 0);
+
+        for (seq = 0; seq < num_msgs; ++seq) {
+            do {
+                if (seq % 2) {
+                    packed_len = uct_ep_am_bcopy(m_e1->ep(0), 0, burst_pack_cb,
+                                                 &seq, 0);
+                    status     = (packed_len >= 0) ? UCS_OK :
+                                 (ucs_status_t)packed_len;
+                } else {
+                    status = uct_ep_am_short(m_e1->ep(0), 0, seq, NULL, 0);
+                }
+
+                if (status == UCS_ERR_NO_RESOURCE) {
+                    progress();
+                }
+            } while (status == UCS_ERR_NO_RESOURCE);
+            ASSERT_UCS_OK(status);
+        }
+
+        ucs_time_t deadline = ucs_get_time() +
+                              ucs_time_from_sec(DEFAULT_TIMEOUT_SEC);
+        while ((seqs.size() < num_msgs) && (ucs_get_time() < deadline)) {
+            progress();
+        }
+
+        ASSERT_EQ(num_msgs, seqs.size());
+        for (seq = 0; seq < num_msgs; ++seq) {
+            EXPECT_EQ(seq, seqs[seq]);
+        }
+    }
+
+    /* Open another interface on the worker of the receiver entity, and check
+     * whether it draws its receive descriptors from the same pool */
+    void test_recv_pool(bool expect_shared) {
+        uct_iface_params_t params = m_e2->iface_params();
+        uct_iface_h iface;
+
+        ASSERT_UCS_OK(uct_iface_open(m_e2->md(), m_e2->worker(), &params,
+                                     m_iface_config, &iface));
+
+        uct_mm_base_iface_t *mm_iface1 = ucs_derived_of(m_e2->iface(),
+                                                        uct_mm_base_iface_t);
+        uct_mm_base_iface_t *mm_iface2 = ucs_derived_of(iface,
+                                                        uct_mm_base_iface_t);
+        EXPECT_EQ(expect_shared,
+                  mm_iface1->recv_desc_mp == mm_iface2->recv_desc_mp);
+        uct_iface_close(iface);
+
+        /* the remaining interface must still be able to receive */
+        test_rx_burst();
+    }
+
+    /* Close the interface which created a shared pool while another one still
+     * uses it, and make the remaining interface grow and release the pool */
+    void test_recv_pool_owner_closed() {
+        uct_iface_params_t params = m_e2->iface_params();
+        std::vector<void*> descs;
+        uct_iface_h iface1, iface2;
+        uct_worker_h worker;
+
+        ASSERT_UCS_OK(uct_worker_create(&m_e2->async(), UCS_THREAD_MODE_SINGLE,
+                                        &worker));
+        ASSERT_UCS_OK(uct_iface_open(m_e2->md(), worker, &params,
+                                     m_iface_config, &iface1));
+        ASSERT_UCS_OK(uct_iface_open(m_e2->md(), worker, &params,
+                                     m_iface_config, &iface2));
+
+        uct_mm_base_iface_t *mm_iface1 = ucs_derived_of(iface1,
+                                                        uct_mm_base_iface_t);
+        uct_mm_base_iface_t *mm_iface2 = ucs_derived_of(iface2,
+                                                        uct_mm_base_iface_t);
+        EXPECT_EQ(mm_iface1->recv_desc_mp, mm_iface2->recv_desc_mp);
+        uct_iface_close(iface1);
+
+        /* allocate more than one chunk, on behalf of the new owner */
+        for (unsigned i = 0; i < 1024; ++i) {
+            void *desc = ucs_mpool_get(mm_iface2->recv_desc_mp);
+            ASSERT_TRUE(desc != NULL) << "i=" << i;
+            descs.push_back(desc);
+        }
+
+        /* release them as the active message callback would */
+        for (std::vector<void*>::iterator iter = descs.begin();
+             iter != descs.end(); ++iter) {
+            void *data = UCS_PTR_BYTE_OFFSET(*iter, sizeof(uct_mm_recv_desc_t));
+
+            uct_recv_desc(data) = &mm_iface2->release_desc;
+            uct_iface_release_desc(data);
+        }
+
+        uct_iface_close(iface2);
+        uct_worker_destroy(worker);
+    }
+
     bool check_md_caps(uint64_t flags) {
         FOR_EACH_ENTITY(iter) {
             if (!(ucs_test_all_flags((*iter)->md_attr().flags, flags))) {
@@ -187,7 +313,135 @@ public:
         test_rkey(ptr, memh, size);
     }
 
+    void alloc_mem(size_t size, uct_allocated_memory_t *mem) {
+        uct_md_h md_ref           = m_e1->md();
+        uct_alloc_method_t method = UCT_ALLOC_METHOD_MD;
+        uct_mem_alloc_params_t params;
+
+        params.field_mask      = UCT_MEM_ALLOC_PARAM_FIELD_FLAGS      |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_ADDRESS    |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_MEM_TYPE   |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_MDS        |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_NAME;
+        params.flags           = UCT_MD_MEM_ACCESS_ALL;
+        params.name            = "test_mm";
+        params.mem_type        = UCS_MEMORY_TYPE_HOST;
+        params.address         = NULL;
+        params.mds.mds         = &md_ref;
+        params.mds.count       = 1;
+
+        ASSERT_UCS_OK(uct_mem_alloc(size, &method, 1, &params, mem));
+    }
+
+    /* Attach the memory through its remote key and release the key, return
+     * the attached address */
+    void *attach_rkey(const uct_allocated_memory_t *mem, uint64_t magic) {
+        std::vector<uint8_t> rkey_buffer(m_e1->md_attr().rkey_packed_size);
+        uct_rkey_bundle_t rkey_ob;
+        void *attach_ptr;
+
+        ASSERT_UCS_OK(uct_md_mkey_pack(m_e1->md(), mem->memh, &rkey_buffer[0]));
+        ASSERT_UCS_OK(uct_rkey_unpack(GetParam()->component, &rkey_buffer[0],
+                                      &rkey_ob));
+
+        attach_ptr = UCS_PTR_BYTE_OFFSET(mem->address, rkey_ob.rkey);
+        test_attach_ptr(mem->address, attach_ptr, magic);
+
+        uct_rkey_release(GetParam()->component, &rkey_ob);
+        return attach_ptr;
+    }
+
+    static bool is_mapped(void *ptr) {
+        size_t page_size = ucs_get_page_size();
+        unsigned char vec;
+
+        return mincore(ucs_align_down_pow2_ptr(ptr, page_size), page_size,
+                       &vec) == 0;
+    }
+
+    static bool is_resident(void *address, size_t length) {
+        size_t page_size = ucs_get_page_size();
+        void *start      = ucs_align_down_pow2_ptr(address, page_size);
+        size_t num_pages = ucs_div_round_up(UCS_PTR_BYTE_DIFF(start, address) +
+                                            length, page_size);
+        std::vector<unsigned char> vec(num_pages);
+
+        if (mincore(start, num_pages * page_size, &vec[0]) != 0) {
+            UCS_TEST_ABORT("mincore(" << start << ") failed: " << strerror(errno));
+        }
+
+        for (size_t i = 0; i < num_pages; ++i) {
+            if (!(vec[i] & 1)) {
+                UCS_TEST_MESSAGE << "page " << i << " of " << address
+                                 << " is not resident";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /* Check that the memory is placed by its memory policy on one node */
+    static void check_numa_bind(void *address, size_t length) {
+        size_t page_size = ucs_get_page_size();
+        unsigned long nodemask[16] = {0};
+        int mode, node, page_node;
+        long ret;
+
+        ret = syscall(__NR_get_mempolicy, &mode, nodemask,
+                      sizeof(nodemask) * 8, address, MPOL_F_ADDR);
+        ASSERT_EQ(0, ret) << "get_mempolicy(" << address << ") failed: "
+                          << strerror(errno);
+        ASSERT_EQ(MPOL_PREFERRED, mode);
+
+        node = ucs_ffs64(nodemask[0]);
+        ASSERT_NE(0ul, nodemask[0]) << "no preferred node in the first word";
+
+        for (size_t offset = 0; offset < length; offset += page_size) {
+            void *page = UCS_PTR_BYTE_OFFSET(address, offset);
+
+            page_node = -1;
+            ret       = syscall(__NR_move_pages, 0, 1, &page, NULL, &page_node,
+                                0);
+            ASSERT_EQ(0, ret) << "move_pages(" << page << ") failed: "
+                              << strerror(errno);
+            EXPECT_EQ(node, page_node) << "page " << page;
+        }
+    }
+
+    void test_alloc() {
+        size_t size               = ucs_min(100000u, m_e1->md_attr().max_alloc);
+        void *address             = NULL;
+        uct_md_h md_ref           = m_e1->md();
+        uct_alloc_method_t method = UCT_ALLOC_METHOD_MD;
+        ucs_status_t status;
+        uct_mem_alloc_params_t params;
+        uct_allocated_memory_t mem;
+
+        params.field_mask      = UCT_MEM_ALLOC_PARAM_FIELD_FLAGS      |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_ADDRESS    |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_MEM_TYPE   |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_MDS        |
+                                 UCT_MEM_ALLOC_PARAM_FIELD_NAME;
+        params.flags           = UCT_MD_MEM_ACCESS_ALL;
+        params.name            = "test_mm";
+        params.mem_type        = UCS_MEMORY_TYPE_HOST;
+        params.address         = address;
+        params.mds.mds         = &md_ref;
+        params.mds.count       = 1;
+
+        status = uct_mem_alloc(size, &method, 1, &params, &mem);
+        ASSERT_UCS_OK(status);
+
+        test_memh(mem.address, mem.memh, mem.length);
+
+        status = uct_mem_free(&mem);
+        ASSERT_UCS_OK(status);
+    }
+
 protected:
+    static const size_t BURST_BCOPY_SIZE = 512;
+
     entity *m_e1, *m_e2;
 };
 
@@ -218,16 +472,91 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, open_for_posix,
     free(recv_buffer);
 }
 
+UCS_TEST_SKIP_COND_P(test_uct_mm, rx_burst,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_AM_BCOPY))
+{
+    test_rx_burst();
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, rx_burst_no_batch,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_AM_BCOPY),
+                     "MM_FIFO_RX_BATCH=n")
+{
+    test_rx_burst();
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, shared_recv_pool,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_AM_BCOPY),
+                     "MM_SHARED_RX_POOL=y")
+{
+    test_recv_pool(true);
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, shared_recv_pool_owner_closed,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_AM_BCOPY),
+                     "MM_SHARED_RX_POOL=y")
+{
+    test_recv_pool_owner_closed();
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, private_recv_pool,
+                     !check_caps(UCT_IFACE_FLAG_AM_SHORT |
+                                 UCT_IFACE_FLAG_AM_BCOPY))
+{
+    test_recv_pool(false);
+}
+
 UCS_TEST_SKIP_COND_P(test_uct_mm, alloc,
                      !check_md_caps(UCT_MD_FLAG_ALLOC)) {
+    test_alloc();
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, alloc_prefault,
+                     !check_md_caps(UCT_MD_FLAG_ALLOC),
+                     "MM_PREFAULT=y")
+{
+    uct_allocated_memory_t mem;
+
+    alloc_mem(ucs_min(100000u, m_e1->md_attr().max_alloc), &mem);
+
+    /* All pages are mapped before the memory is accessed */
+    EXPECT_TRUE(is_resident(mem.address, mem.length));
+
+    test_memh(mem.address, mem.memh, mem.length);
+    ASSERT_UCS_OK(uct_mem_free(&mem));
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, alloc_numa_bind,
+                     !check_md_caps(UCT_MD_FLAG_ALLOC),
+                     "MM_NUMA_BIND=y")
+{
+    uct_allocated_memory_t mem;
+
+    alloc_mem(ucs_min(100000u, m_e1->md_attr().max_alloc), &mem);
+
+    EXPECT_TRUE(is_resident(mem.address, mem.length));
+    check_numa_bind(mem.address, mem.length);
+
+    test_memh(mem.address, mem.memh, mem.length);
+    ASSERT_UCS_OK(uct_mem_free(&mem));
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, rkey_attach_cache,
+                     !check_md_caps(UCT_MD_FLAG_ALLOC) ||
+                     (GetParam()->tl_name != "posix_p2p")) {
 
     size_t size               = ucs_min(100000u, m_e1->md_attr().max_alloc);
-    void *address             = NULL;
     uct_md_h md_ref           = m_e1->md();
     uct_alloc_method_t method = UCT_ALLOC_METHOD_MD;
-    ucs_status_t status;
+    std::vector<uint8_t> rkey_buffer(m_e1->md_attr().rkey_packed_size);
+    uct_rkey_bundle_t rkey_ob[2];
     uct_mem_alloc_params_t params;
     uct_allocated_memory_t mem;
+    ucs_status_t status;
 
     params.field_mask      = UCT_MEM_ALLOC_PARAM_FIELD_FLAGS      |
                              UCT_MEM_ALLOC_PARAM_FIELD_ADDRESS    |
@@ -237,17 +566,94 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, alloc,
     params.flags           = UCT_MD_MEM_ACCESS_ALL;
     params.name            = "test_mm";
     params.mem_type        = UCS_MEMORY_TYPE_HOST;
-    params.address         = address;
+    params.address         = NULL;
     params.mds.mds         = &md_ref;
     params.mds.count       = 1;
 
-    status = uct_mem_alloc(size, &method, 1, &params, &mem);
-    ASSERT_UCS_OK(status);
+    /* Every allocation gets a new mapping, even if it reuses the address and
+     * the file descriptor of a released one */
+    for (int i = 0; i < 3; ++i) {
+        status = uct_mem_alloc(size, &method, 1, &params, &mem);
+        ASSERT_UCS_OK(status);
 
-    test_memh(mem.address, mem.memh, mem.length);
+        status = uct_md_mkey_pack(m_e1->md(), mem.memh, &rkey_buffer[0]);
+        ASSERT_UCS_OK(status);
 
-    status = uct_mem_free(&mem);
-    ASSERT_UCS_OK(status);
+        /* The same segment is attached only once */
+        for (int j = 0; j < 2; ++j) {
+            status = uct_rkey_unpack(GetParam()->component, &rkey_buffer[0],
+                                     &rkey_ob[j]);
+            ASSERT_UCS_OK(status);
+        }
+
+        EXPECT_EQ(rkey_ob[0].handle, rkey_ob[1].handle);
+        EXPECT_EQ(rkey_ob[0].rkey, rkey_ob[1].rkey);
+        test_attach_ptr(mem.address,
+                        UCS_PTR_BYTE_OFFSET(mem.address, rkey_ob[0].rkey),
+                        0xdeadbeef33333 + i);
+
+        uct_rkey_release(GetParam()->component, &rkey_ob[0]);
+        uct_rkey_release(GetParam()->component, &rkey_ob[1]);
+
+        /* The idle mapping is reused by a later unpack */
+        status = uct_rkey_unpack(GetParam()->component, &rkey_buffer[0],
+                                 &rkey_ob[1]);
+        ASSERT_UCS_OK(status);
+        EXPECT_EQ(rkey_ob[0].rkey, rkey_ob[1].rkey);
+        uct_rkey_release(GetParam()->component, &rkey_ob[1]);
+
+        status = uct_mem_free(&mem);
+        ASSERT_UCS_OK(status);
+    }
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, rkey_attach_cache_max_regions,
+                     !check_md_caps(UCT_MD_FLAG_ALLOC) ||
+                     (GetParam()->tl_name != "posix_p2p"),
+                     "POSIX_ATTACH_CACHE_MAX_REGIONS~=1")
+{
+    size_t size = ucs_min(100000u, m_e1->md_attr().max_alloc);
+    uct_allocated_memory_t mem[2];
+    void *attach_ptr[2];
+
+    for (int i = 0; i < 2; ++i) {
+        alloc_mem(size, &mem[i]);
+
+        /* The segment stays attached after its remote key is released */
+        attach_ptr[i] = attach_rkey(&mem[i], 0xdeadbeef44444 + i);
+        EXPECT_TRUE(is_mapped(attach_ptr[i]));
+    }
+
+    /* The second segment evicted the first one from the cache */
+    EXPECT_FALSE(is_mapped(attach_ptr[0]));
+
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_UCS_OK(uct_mem_free(&mem[i]));
+    }
+}
+
+UCS_TEST_SKIP_COND_P(test_uct_mm, rkey_attach_cache_max_size,
+                     !check_md_caps(UCT_MD_FLAG_ALLOC) ||
+                     (GetParam()->tl_name != "posix_p2p"),
+                     "POSIX_ATTACH_CACHE_MAX_SIZE~=512k",
+                     "MM_HUGETLB_MODE=n")
+{
+    uct_allocated_memory_t small_mem, large_mem;
+    void *attach_ptr;
+
+    alloc_mem(ucs_get_page_size(), &small_mem);
+    alloc_mem(UCS_MBYTE, &large_mem);
+
+    /* A segment larger than the cache is detached when its remote key is
+     * released */
+    attach_ptr = attach_rkey(&large_mem, 0xdeadbeef55555);
+    EXPECT_FALSE(is_mapped(attach_ptr));
+
+    attach_ptr = attach_rkey(&small_mem, 0xdeadbeef66666);
+    EXPECT_TRUE(is_mapped(attach_ptr));
+
+    ASSERT_UCS_OK(uct_mem_free(&small_mem));
+    ASSERT_UCS_OK(uct_mem_free(&large_mem));
 }
 
 UCS_TEST_SKIP_COND_P(test_uct_mm, reg,
@@ -269,6 +675,6 @@ UCS_TEST_SKIP_COND_P(test_uct_mm, reg,
     ASSERT_UCS_OK(status);
 }
 
-_UCT_INSTANTIATE_TEST_CASE(test_uct_mm, posix)
-_UCT_INSTANTIATE_TEST_CASE(test_uct_mm, sysv)
-_UCT_INSTANTIATE_TEST_CASE(test_uct_mm, xpmem)
+_UCT_INSTANTIATE_TEST_CASE(test_uct_mm, posix_p2p)
+_UCT_INSTANTIATE_TEST_CASE(test_uct_mm, sysv_p2p)
+_UCT_INSTANTIATE_TEST_CASE(test_uct_mm, xpmem_p2p)
@@ -617,6 +617,55 @@ UCS_TEST_SKIP_COND_P(uct_p2p_am_test, am_zcopy,
                     TEST_UCT_FLAG_DIR_SEND_TO_RECV);
 }
 
+UCS_TEST_SKIP_COND_P(uct_p2p_am_test, am_zcopy_msg_zerocopy,
+                     !has_transport("tcp") ||
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY,
+                                 UCT_IFACE_FLAG_AM_DUP),
+                     "TCP_MSG_ZEROCOPY_THRESH=1") {
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_am_test::am_zcopy),
+                    0ul,
+                    sender().iface_attr().cap.am.max_zcopy,
+                    TEST_UCT_FLAG_DIR_SEND_TO_RECV);
+}
+
+static ucs_status_t
+am_zcopy_data_ptr_handler(void *arg, void *data, size_t length, unsigned flags)
+{
+    *static_cast<void**>(arg) = data;
+    return UCS_OK;
+}
+
+UCS_TEST_SKIP_COND_P(uct_p2p_am_test, am_zcopy_self_no_copy,
+                     !has_transport("self") ||
+                     !check_caps(UCT_IFACE_FLAG_AM_ZCOPY)) {
+    mapped_buffer sendbuf(sender().iface_attr().cap.am.max_zcopy, SEED1,
+                          sender());
+    void *rx_data = NULL;
+    ucs_status_t status;
+
+    status = uct_iface_set_am_handler(receiver().iface(), AM_ID,
+                                      am_zcopy_data_ptr_handler, &rx_data, 0);
+    ASSERT_UCS_OK(status);
+
+    /* A contiguous payload without a header is passed to the handler as is */
+    UCS_TEST_GET_BUFFER_IOV(iov, iovcnt, sendbuf.ptr(), sendbuf.length(),
+                            sendbuf.memh(), 1);
+    status = uct_ep_am_zcopy(sender_ep(), AM_ID, NULL, 0, iov, iovcnt, 0,
+                             NULL);
+    ASSERT_UCS_OK(status);
+    EXPECT_EQ(sendbuf.ptr(), rx_data);
+
+    /* With a header, the handler gets header and payload in one buffer */
+    rx_data = NULL;
+    status  = uct_ep_am_zcopy(sender_ep(), AM_ID, sendbuf.ptr(),
+                              sizeof(uint64_t), iov, iovcnt - 1, 0, NULL);
+    ASSERT_UCS_OK(status);
+    EXPECT_NE((void*)NULL, rx_data);
+    EXPECT_NE(sendbuf.ptr(), rx_data);
+
+    uct_iface_set_am_handler(receiver().iface(), AM_ID, NULL, NULL, 0);
+}
+
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_am_test)
 
 const unsigned uct_p2p_am_misc::RX_MAX_BUFS  = 1024; /* due to hard coded 'grow'
@@ -112,6 +112,15 @@ UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, put_zcopy,
                     TEST_UCT_FLAG_SEND_ZCOPY);
 }
 
+UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, put_zcopy_msg_zerocopy,
+                     !has_transport("tcp") ||
+                     !check_caps(UCT_IFACE_FLAG_PUT_ZCOPY),
+                     "TCP_MSG_ZEROCOPY_THRESH=1") {
+    test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::put_zcopy),
+                    0ul, sender().iface_attr().cap.put.max_zcopy,
+                    TEST_UCT_FLAG_SEND_ZCOPY);
+}
+
 UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, get_short,
                      !check_caps(UCT_IFACE_FLAG_GET_SHORT)) {
     test_xfer_multi(static_cast<send_func_t>(&uct_p2p_rma_test::get_short),
@@ -134,6 +143,54 @@ UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, get_zcopy,
                     TEST_UCT_FLAG_RECV_ZCOPY);
 }
 
+UCS_TEST_SKIP_COND_P(uct_p2p_rma_test, get_zcopy_concurrent,
+                     !check_caps(UCT_IFACE_FLAG_GET_ZCOPY)) {
+    const unsigned num_ops = 32;
+    const size_t length    = ucs_min(4096ul,
+                                     sender().iface_attr().cap.get.max_zcopy);
+    uct_completion_t comp;
+
+    if (length < sender().iface_attr().cap.get.min_zcopy) {
+        UCS_TEST_SKIP_R("min_zcopy is too large");
+    }
+
+    mapped_buffer sendbuf(length * num_ops, SEED1, sender());
+    mapped_buffer recvbuf(length * num_ops, SEED2, receiver());
+
+    comp.func   = (uct_completion_callback_t)ucs_empty_function;
+    comp.count  = num_ops;
+    comp.status = UCS_OK;
+
+    /* Post all operations before progressing, so transports which merge
+     * outstanding requests to the same peer get a chance to do it */
+    for (unsigned i = 0; i < num_ops; ++i) {
+        ucs_status_t status;
+
+        UCS_TEST_GET_BUFFER_IOV(iov, iovcnt,
+                                UCS_PTR_BYTE_OFFSET(sendbuf.ptr(), i * length),
+                                length, sendbuf.memh(), 1);
+        do {
+            status = uct_ep_get_zcopy(sender_ep(), iov, iovcnt,
+                                      recvbuf.addr() + (i * length),
+                                      recvbuf.rkey(), &comp);
+            if (status == UCS_ERR_NO_RESOURCE) {
+                progress();
+            }
+        } while (status == UCS_ERR_NO_RESOURCE);
+
+        if (status == UCS_OK) {
+            --comp.count;
+        } else {
+            ASSERT_UCS_STATUS_EQ(UCS_INPROGRESS, status);
+        }
+    }
+
+    wait_for_value(&comp.count, 0, true);
+    ASSERT_EQ(0, comp.count);
+    EXPECT_UCS_OK(comp.status);
+    sendbuf.pattern_check(SEED2);
+}
+
 UCT_INSTANTIATE_TEST_CASE(uct_p2p_rma_test)
 
 class test_p2p_rma_madvise : private ucs::clear_dontcopy_regions,